@@ -0,0 +1,97 @@
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "common/transcoder.h"
+
+namespace
+{
+int usage()
+{
+    std::cerr << "usage: serialization_transcode <to-json|to-binary> <input> <output>\n"
+                 "                               [--schema <file>] [--indent <n>]\n"
+                 "\n"
+                 "  to-json    binary archive to JSON; without a schema the values are\n"
+                 "             listed by type tag\n"
+                 "  to-binary  JSON archive to binary; requires a schema\n"
+                 "\n"
+                 "Schemas are written by serialization::schema::export_schema<T>().\n";
+    return 2;
+}
+}  // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        return usage();
+    }
+
+    const std::string_view              direction = argv[1];
+    std::optional<std::string>          schema_path;
+    serialization::transcode_options    options;
+    for (int i = 4; i < argc; ++i)
+    {
+        const std::string_view option = argv[i];
+        if (option == "--schema" && i + 1 < argc)
+        {
+            schema_path = argv[++i];
+        }
+        else if (option == "--indent" && i + 1 < argc)
+        {
+            options.indent = std::atoi(argv[++i]);
+        }
+        else
+        {
+            return usage();
+        }
+    }
+    if ((direction != "to-json" && direction != "to-binary") ||
+        (direction == "to-binary" && !schema_path))
+    {
+        return usage();
+    }
+
+    try
+    {
+        std::optional<serialization::json> schema;
+        if (schema_path)
+        {
+            std::ifstream file(*schema_path);
+            if (!file)
+            {
+                std::cerr << "cannot open " << *schema_path << '\n';
+                return 1;
+            }
+            schema = serialization::json::parse(file);
+        }
+
+        const bool    to_json = direction == "to-json";
+        std::ifstream in(argv[2], to_json ? std::ios::binary : std::ios::in);
+        std::ofstream out(argv[3], to_json ? std::ios::out : std::ios::binary);
+        if (!in || !out)
+        {
+            std::cerr << "cannot open " << (!in ? argv[2] : argv[3]) << '\n';
+            return 1;
+        }
+
+        if (to_json)
+        {
+            serialization::transcode_to_json(in, out, schema ? &*schema : nullptr, options);
+        }
+        else
+        {
+            serialization::transcode_to_binary(in, out, *schema, options);
+        }
+    }
+    catch (const std::exception& error)
+    {
+        std::cerr << error.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
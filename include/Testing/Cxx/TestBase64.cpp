@@ -0,0 +1,96 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "util/base64.h"
+
+//=============================================================================
+// Base64 Tests
+//=============================================================================
+
+class Base64Test : public ::testing::Test
+{
+protected:
+    static std::string encode(std::string_view bytes)
+    {
+        std::string text;
+        serialization::append_base64(text, bytes.data(), bytes.size());
+        return text;
+    }
+
+    static std::string decode(std::string_view text)
+    {
+        const auto size = serialization::base64_decoded_size(text);
+        if (size == std::string_view::npos)
+        {
+            return "(invalid)";
+        }
+        std::string bytes(size, '\0');
+        return serialization::decode_base64(text, bytes.data()) ? bytes : "(invalid)";
+    }
+};
+
+TEST_F(Base64Test, Rfc4648Vectors)
+{
+    const std::pair<std::string_view, std::string_view> vectors[] = {
+        {"", ""},
+        {"f", "Zg=="},
+        {"fo", "Zm8="},
+        {"foo", "Zm9v"},
+        {"foob", "Zm9vYg=="},
+        {"fooba", "Zm9vYmE="},
+        {"foobar", "Zm9vYmFy"},
+    };
+    for (const auto& [bytes, text] : vectors)
+    {
+        EXPECT_EQ(encode(bytes), text);
+        EXPECT_EQ(decode(text), bytes);
+    }
+}
+
+TEST_F(Base64Test, EveryByteAtEveryOffset)
+{
+    // Long enough for the vector blocks, with every tail length
+    for (std::size_t size = 0; size < 100; ++size)
+    {
+        std::string bytes(size, '\0');
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            bytes[i] = static_cast<char>(i * 37 + size);
+        }
+        const auto text = encode(bytes);
+        EXPECT_EQ(text.size(), (size + 2) / 3 * 4);
+        EXPECT_EQ(decode(text), bytes);
+    }
+
+    std::string all(256, '\0');
+    for (int i = 0; i < 256; ++i)
+    {
+        all[i] = static_cast<char>(i);
+    }
+    EXPECT_EQ(decode(encode(all)), all);
+}
+
+TEST_F(Base64Test, RejectsForeignCharacters)
+{
+    const std::string text = encode(std::string(60, 'x'));
+    for (std::size_t i = 0; i < text.size(); ++i)
+    {
+        for (const char c : {'*', '=', '-', '\x80', '\0', ' '})
+        {
+            if (c == '=' && i + 1 == text.size())
+            {
+                continue;  // Well-formed padding
+            }
+            std::string corrupt = text;
+            corrupt[i]          = c;
+            EXPECT_EQ(decode(corrupt), "(invalid)") << i;
+        }
+    }
+    EXPECT_EQ(decode("abc"), "(invalid)");
+    EXPECT_EQ(decode("a==="), "(invalid)");
+    EXPECT_EQ(decode("ab=c"), "(invalid)");
+}
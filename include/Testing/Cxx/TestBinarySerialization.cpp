@@ -3,13 +3,16 @@
 
 #include <algorithm>
 #include <array>
+#include <bitset>
 #include <cassert>
 #include <cstdint>
+#include <deque>
 #include <iostream>
 #include <map>
 #include <optional>
 #include <set>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -45,6 +48,84 @@ private:
 };
 }  // namespace serialization
 
+namespace test
+{
+class market_quote
+{
+public:
+    double bid_{0};
+    double ask_{0};
+    float  rate_{0};
+    double spot_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(market_quote, bid_, ask_, rate_, spot_);
+    SERIALIZATION_FIELD_ENCODINGS(
+        serialization::encode("bid_", serialization::encoding::fixed_point(4)),
+        serialization::encode("ask_", serialization::encoding::fixed_point(4)),
+        serialization::encode("rate_", serialization::encoding::quantized(-1.0, 1.0, 1e-4)));
+};
+
+class annotated_quote
+{
+public:
+    double price_{0};
+    double volume_{0};
+
+    constexpr static auto properties()
+    {
+        return std::make_tuple(
+            serialization::reflection(&annotated_quote::price_, "price_")
+                .with_encoding(serialization::encoding::float32()),
+            serialization::reflection(&annotated_quote::volume_, "volume_"));
+    }
+
+private:
+    void initialize() {}
+    friend struct serialization::access::serializer;
+    SERIALIZATION_CODEC_TABLE;
+};
+
+class tick_series
+{
+public:
+    std::vector<int64_t> timestamps_;
+    std::vector<int32_t> sequence_;
+    std::vector<int64_t> sizes_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(tick_series, timestamps_, sequence_, sizes_);
+    SERIALIZATION_FIELD_ENCODINGS(
+        serialization::encode("timestamps_", serialization::encoding::delta_of_delta()),
+        serialization::encode("sequence_", serialization::encoding::delta_of_delta()));
+};
+
+enum class order_side
+{
+    buy,
+    sell,
+    cross
+};
+
+class order_flags
+{
+public:
+    bool       active_{false};
+    bool       hidden_{false};
+    order_side side_{order_side::buy};
+    bool       urgent_{false};
+    int        quantity_{0};
+    bool       cancelled_{false};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(order_flags, active_, hidden_, side_, urgent_, quantity_, cancelled_);
+    SERIALIZATION_FIELD_ENCODINGS(serialization::encode("side_", serialization::encoding::bits(2)));
+};
+}  // namespace test
+
 //=============================================================================
 // Binary Serialization Tests
 //=============================================================================
@@ -230,6 +311,27 @@ TEST_F(BinarySerializationTest, ArrayOfShortsSerialization)
     EXPECT_TRUE(std::equal(rhs.begin(), rhs.end(), lhs.begin()));
 }
 
+TEST_F(BinarySerializationTest, LegacyShortTag)
+{
+    // Older streams wrote a short as the int32 tag followed by two bytes
+    buffer << 0;
+    auto data = buffer.GetRawData();
+    data.erase(data.begin() + 3, data.end() - 1);
+
+    serialization::multi_process_stream legacy;
+    legacy.SetRawData(data);
+    short value = -1;
+    legacy >> value;
+    EXPECT_FALSE(legacy.HasError());
+    EXPECT_EQ(value, 0);
+    EXPECT_TRUE(legacy.Empty());
+
+    serialization::multi_process_stream current;
+    current << static_cast<short>(-12);
+    EXPECT_TRUE(current.Skip());
+    EXPECT_TRUE(current.Empty());
+}
+
 TEST_F(BinarySerializationTest, ArrayOfUnsignedIntSerialization)
 {
     std::array<unsigned int, 3> rhs{10, 20, 30};
@@ -411,3 +513,615 @@ TEST_F(BinarySerializationTest, VectorOfOptionalsSerialization)
     EXPECT_FALSE(lhs[3].has_value());
     EXPECT_TRUE(lhs[4].has_value() && *lhs[4] == 5);
 }
+
+//=============================================================================
+// Non-throwing Load Tests
+//=============================================================================
+
+TEST_F(BinarySerializationTest, TryLoadSuccess)
+{
+    std::map<std::string, std::vector<int>> rhs{{"first", {1, 2, 3}}, {"second", {4, 5}}};
+    serialization::save(buffer, rhs);
+
+    auto lhs = serialization::try_load<std::map<std::string, std::vector<int>>>(buffer);
+    ASSERT_TRUE(lhs.has_value());
+    EXPECT_EQ(rhs, *lhs);
+}
+
+TEST_F(BinarySerializationTest, TryLoadTruncatedInput)
+{
+    std::vector<std::string> rhs{"alpha", "beta", "gamma"};
+    serialization::save(buffer, rhs);
+
+    auto raw = buffer.GetRawData();
+    raw.resize(raw.size() / 2);
+    buffer.SetRawData(raw);
+
+    std::vector<std::string> lhs;
+    const auto               status = serialization::try_load(buffer, lhs);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(
+        status.error().code(), serialization::serialization_error::error_code::malformed_input);
+}
+
+TEST_F(BinarySerializationTest, TryLoadCorruptSize)
+{
+    // A size far larger than the remaining data must fail before allocating.
+    buffer << static_cast<unsigned int>(0x7fffffff);
+
+    std::vector<double> lhs;
+    const auto          status = serialization::try_load(buffer, lhs);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_TRUE(lhs.empty());
+}
+
+TEST_F(BinarySerializationTest, TryLoadOversizedLengthOfLargeElements)
+{
+    using element = std::array<double, 64>;
+    const std::string payload(2'000'000, 'x');
+
+    // More elements than bytes left: rejected before reserving anything
+    buffer.PushLength(8'000'000);
+    buffer << payload;
+    std::vector<element> lhs;
+    auto                 status = serialization::try_load(buffer, lhs);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(
+        status.error().code(), serialization::serialization_error::error_code::malformed_input);
+    EXPECT_EQ(lhs.capacity(), 0u);
+
+    // A length within the remaining bytes reserves no more memory than they hold
+    buffer.Reset();
+    buffer.PushLength(1'000'000);
+    buffer << payload;
+    status = serialization::try_load(buffer, lhs);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_LE(lhs.capacity() * sizeof(element), payload.size() + 16);
+
+    // Bools packed one bit each still load with more elements than bytes
+    buffer.Reset();
+    buffer.EnableBitPacking(true);
+    const std::deque<bool>                   flags(1000, true);
+    const std::tuple<bool, bool, bool, bool> quad{true, false, true, true};
+    serialization::save(buffer, flags);
+    serialization::save(buffer, quad);
+    std::deque<bool>                   loaded_flags;
+    std::tuple<bool, bool, bool, bool> loaded_quad;
+    serialization::load(buffer, loaded_flags);
+    serialization::load(buffer, loaded_quad);
+    EXPECT_EQ(loaded_flags, flags);
+    EXPECT_EQ(loaded_quad, quad);
+}
+
+TEST_F(BinarySerializationTest, LoadTruncatedInputThrows)
+{
+    serialization::save(buffer, std::string("payload"));
+
+    auto raw = buffer.GetRawData();
+    raw.resize(2);
+    buffer.SetRawData(raw);
+
+    std::string lhs;
+    EXPECT_THROW(serialization::load(buffer, lhs), serialization::serialization_error);
+}
+
+TEST_F(BinarySerializationTest, VarintLengths)
+{
+    // Tag and one length byte before the elements and the characters
+    serialization::save(buffer, std::vector<int>{1, 2, 3});
+    EXPECT_EQ(buffer.Size(), 2u + 3 * 5);
+
+    buffer.Reset();
+    serialization::save(buffer, std::string(300, 'x'));
+    EXPECT_EQ(buffer.Size(), 1u + 2 + 300);
+
+    std::string lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, std::string(300, 'x'));
+}
+
+TEST_F(BinarySerializationTest, ReadsFixedWidthLengths)
+{
+    // Sizes as unsigned int and strings with an int length, as earlier archives wrote them
+    std::vector<unsigned char> raw{1, 2, 0, 0, 0, 6, 3, 0, 0, 0, 'a', 'b', 'c', 6, 1, 0, 0, 0, 'd'};
+    raw.push_back(buffer.endianness());
+    buffer.SetRawData(raw);
+
+    std::vector<std::string> lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, (std::vector<std::string>{"abc", "d"}));
+    EXPECT_TRUE(buffer.Empty());
+}
+
+TEST_F(BinarySerializationTest, LongArrayCount)
+{
+    // Counts of 2^32 - 1 or more follow an escape value as 64 bits
+    const double               values[] = {1.5, 2.5};
+    std::vector<unsigned char> raw{4, 0xff, 0xff, 0xff, 0xff};
+    const uint64_t             count = 2;
+    raw.insert(
+        raw.end(),
+        reinterpret_cast<const unsigned char*>(&count),
+        reinterpret_cast<const unsigned char*>(&count + 1));
+    raw.insert(
+        raw.end(),
+        reinterpret_cast<const unsigned char*>(values),
+        reinterpret_cast<const unsigned char*>(values + 2));
+    raw.push_back(buffer.endianness());
+    buffer.SetRawData(raw);
+
+    double*     lhs  = nullptr;
+    std::size_t size = 0;
+    buffer.Pop(lhs, size);
+    ASSERT_EQ(size, 2u);
+    EXPECT_EQ(lhs[1], 2.5);
+    delete[] lhs;
+    EXPECT_FALSE(buffer.HasError());
+}
+
+//=============================================================================
+// Bulk Array Tests
+//=============================================================================
+
+TEST_F(BinarySerializationTest, SpanRoundTripAllWidths)
+{
+    const std::vector<int8_t>   i8{-1, 0, 127};
+    const std::vector<int16_t>  i16{-32768, 0, 32767};
+    const std::vector<uint16_t> u16{0, 1, 65535};
+    const std::vector<uint64_t> u64{0, 1, 0xffffffffffffffffull};
+    const std::array<float, 2>  f32{1.5f, -2.5f};
+
+    buffer.PushSpan(i8);
+    buffer.PushSpan(i16);
+    buffer.PushSpan(u16);
+    buffer.PushSpan(u64);
+    buffer.PushSpan(f32);
+
+    EXPECT_EQ(buffer.PopVector<int8_t>(), i8);
+    EXPECT_EQ(buffer.PopVector<int16_t>(), i16);
+    EXPECT_EQ(buffer.PopVector<uint16_t>(), u16);
+    EXPECT_EQ(buffer.PopVector<uint64_t>(), u64);
+
+    std::array<float, 2> lhs{};
+    EXPECT_TRUE(buffer.PopSpan(lhs));
+    EXPECT_EQ(lhs, f32);
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_FALSE(buffer.HasError());
+}
+
+TEST_F(BinarySerializationTest, SpanReadsLegacyArrays)
+{
+    const double values[] = {1.0, 2.0, 3.0};
+    buffer.Push(values, 3);
+
+    const auto lhs = buffer.PopVector<double>();
+    EXPECT_EQ(lhs, std::vector<double>(std::begin(values), std::end(values)));
+}
+
+TEST_F(BinarySerializationTest, SpanSizeOrTypeMismatch)
+{
+    buffer.PushSpan(std::vector<int>{1, 2, 3});
+
+    std::vector<int> lhs(2);
+    EXPECT_FALSE(buffer.PopSpan(lhs));
+    EXPECT_TRUE(buffer.HasError());
+
+    buffer.Reset();
+    buffer.PushSpan(std::vector<int>{1, 2, 3});
+    EXPECT_TRUE(buffer.PopVector<unsigned int>().empty());
+    EXPECT_TRUE(buffer.HasError());
+}
+
+TEST_F(BinarySerializationTest, RawDataRoundTrip)
+{
+    buffer.PushSpan(std::vector<int16_t>{1, 2, 3});
+    buffer << std::string("tail");
+
+    const auto raw = buffer.GetRawData();
+    EXPECT_EQ(raw.size(), static_cast<size_t>(buffer.RawSize()));
+
+    serialization::multi_process_stream copy;
+    copy.SetRawData(raw);
+    EXPECT_EQ(copy.GetRawData(), raw);
+    EXPECT_EQ(copy.PopVector<int16_t>(), (std::vector<int16_t>{1, 2, 3}));
+
+    std::string_view tail;
+    copy >> tail;
+    EXPECT_EQ(tail, "tail");
+    EXPECT_TRUE(copy.Empty());
+}
+
+//=============================================================================
+// Field Encoding Tests
+//=============================================================================
+
+TEST_F(BinarySerializationTest, FieldEncodingsByName)
+{
+    test::market_quote rhs;
+    rhs.bid_  = 1.23456789;
+    rhs.ask_  = 1.23471234;
+    rhs.rate_ = 0.04321f;
+    rhs.spot_ = 1.000000001;
+    serialization::save(buffer, rhs);
+
+    const auto size = buffer.Size();
+
+    test::market_quote lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_DOUBLE_EQ(lhs.bid_, 1.2346);
+    EXPECT_DOUBLE_EQ(lhs.ask_, 1.2347);
+    EXPECT_NEAR(lhs.rate_, rhs.rate_, 1e-4);
+    EXPECT_EQ(lhs.spot_, rhs.spot_);
+    EXPECT_TRUE(buffer.Empty());
+
+    // Class name, two fixed-point fields (5 bytes each instead of 9), a 16-bit
+    // quantized float (3 instead of 5) and a plain double
+    const auto name_size = 1 + 1 + serialization::type_name<test::market_quote>().size();
+    EXPECT_EQ(static_cast<size_t>(size), name_size + 5 + 5 + 3 + 9);
+
+    // JSON keeps the full value
+    serialization::json json_buffer;
+    serialization::save(json_buffer, rhs);
+    EXPECT_EQ(json_buffer["bid_"].get<double>(), rhs.bid_);
+}
+
+TEST_F(BinarySerializationTest, FieldEncodingWithCodecTable)
+{
+    test::annotated_quote rhs;
+    rhs.price_  = 101.123456789;
+    rhs.volume_ = 5e6 + 0.25;
+    serialization::save(buffer, rhs);
+
+    test::annotated_quote lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs.price_, static_cast<double>(static_cast<float>(rhs.price_)));
+    EXPECT_EQ(lhs.volume_, rhs.volume_);
+}
+
+TEST_F(BinarySerializationTest, FieldEncodingOutOfRange)
+{
+    test::market_quote rhs;
+    rhs.rate_ = 2.0f;
+    EXPECT_THROW(serialization::save(buffer, rhs), serialization::serialization_error);
+}
+
+TEST_F(BinarySerializationTest, QuantizedParametersChecked)
+{
+    using serialization::encoding::quantized;
+    static_assert(serialization::encoding_applies_to<double>(quantized(0.0, 1e9, 0.5)));
+    static_assert(!serialization::encoding_applies_to<double>(quantized(0.0, 1.0, 0.0)));
+    static_assert(!serialization::encoding_applies_to<double>(quantized(1.0, 1.0, 0.1)));
+    static_assert(!serialization::encoding_applies_to<double>(quantized(1.0, 0.0, 0.1)));
+    static_assert(!serialization::encoding_applies_to<double>(quantized(0.0, 1e10, 1e-3)));
+
+    // Encodings built at run time are not checked up front, so the wide path
+    // rejects step counts it cannot store instead of truncating them
+    EXPECT_THROW(
+        serialization::detail::save_encoded(buffer, 0.5, quantized(0.0, 1.0, 0.0)),
+        serialization::serialization_error);
+    EXPECT_THROW(
+        serialization::detail::save_encoded(buffer, 1e10, quantized(0.0, 1e10, 1e-3)),
+        serialization::serialization_error);
+    EXPECT_TRUE(buffer.Empty());
+}
+
+//=============================================================================
+// Delta-of-Delta Encoding Tests
+//=============================================================================
+
+TEST_F(BinarySerializationTest, DeltaEncodedTimestamps)
+{
+    // Nanosecond timestamps at a 1ms cadence with occasional jitter
+    std::vector<int64_t> rhs;
+    int64_t              timestamp = 1'700'000'000'000'000'000;
+    for (int i = 0; i < 10000; ++i)
+    {
+        timestamp += 1'000'000 + (i % 100 == 0 ? 3 : 0);
+        rhs.push_back(timestamp);
+    }
+
+    buffer.PushDeltaEncoded(rhs);
+    EXPECT_LT(static_cast<size_t>(buffer.Size()) * 10, rhs.size() * sizeof(int64_t));
+
+    const auto lhs = buffer.PopDeltaEncoded<int64_t>();
+    EXPECT_EQ(rhs, lhs);
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_FALSE(buffer.HasError());
+}
+
+TEST_F(BinarySerializationTest, DeltaEncodedArbitraryValues)
+{
+    // Random, negative and wrapping values still round-trip exactly
+    std::vector<int64_t> wide{
+        0, -1, INT64_MAX, INT64_MIN, 42, INT64_MIN, INT64_MAX, -7, 1'000'000'007};
+    uint64_t state = 0x9e3779b97f4a7c15ULL;
+    for (int i = 0; i < 300; ++i)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        wide.push_back(static_cast<int64_t>(state >> (i % 64)));
+    }
+    std::vector<int32_t>  narrow{-5, 7, INT32_MIN, INT32_MAX, 0, 0, 0, 3};
+    std::vector<uint16_t> ports{8080, 8081, 8082, 65535, 0, 443};
+    std::vector<uint64_t> ids{UINT64_MAX, 0, UINT64_MAX - 1};
+
+    buffer.PushDeltaEncoded(wide);
+    buffer.PushDeltaEncoded(narrow);
+    buffer.PushDeltaEncoded(ports);
+    buffer.PushDeltaEncoded(ids);
+    buffer.PushDeltaEncoded(std::vector<int64_t>{});
+    buffer.PushDeltaEncoded(std::vector<int64_t>{5});
+
+    EXPECT_EQ(buffer.PopDeltaEncoded<int64_t>(), wide);
+    EXPECT_EQ(buffer.PopDeltaEncoded<int32_t>(), narrow);
+    EXPECT_EQ(buffer.PopDeltaEncoded<uint16_t>(), ports);
+    EXPECT_EQ(buffer.PopDeltaEncoded<uint64_t>(), ids);
+    EXPECT_TRUE(buffer.PopDeltaEncoded<int64_t>().empty());
+    EXPECT_EQ(buffer.PopDeltaEncoded<int64_t>(), std::vector<int64_t>{5});
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_FALSE(buffer.HasError());
+}
+
+TEST_F(BinarySerializationTest, DeltaEncodedFields)
+{
+    test::tick_series rhs;
+    for (int64_t i = 0; i < 1000; ++i)
+    {
+        rhs.timestamps_.push_back(1'700'000'000'000 + 250 * i);
+        rhs.sequence_.push_back(static_cast<int32_t>(9000 + i));
+        rhs.sizes_.push_back(i % 7);
+    }
+    serialization::save(buffer, rhs);
+
+    // The encoded vectors add little on top of the plain sizes_ vector
+    serialization::multi_process_stream plain;
+    serialization::save(plain, rhs.sizes_);
+    EXPECT_LT(buffer.Size(), plain.Size() + 200);
+
+    test::tick_series lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs.timestamps_, rhs.timestamps_);
+    EXPECT_EQ(lhs.sequence_, rhs.sequence_);
+    EXPECT_EQ(lhs.sizes_, rhs.sizes_);
+
+    // JSON keeps the plain arrays
+    serialization::json json_buffer;
+    serialization::save(json_buffer, rhs);
+    EXPECT_EQ(json_buffer["timestamps_"].size(), rhs.timestamps_.size());
+}
+
+TEST_F(BinarySerializationTest, DeltaEncodedCorruptInput)
+{
+    buffer.PushDeltaEncoded(std::vector<int64_t>{1, 2, 4, 8});
+
+    // A count far larger than the remaining bytes could hold
+    auto raw = buffer.GetRawData();
+    raw[1]   = 0xff;
+    raw.insert(raw.begin() + 2, {0xff, 0xff, 0x7f});
+    buffer.SetRawData(raw);
+    EXPECT_TRUE(buffer.PopDeltaEncoded<int64_t>().empty());
+    EXPECT_TRUE(buffer.HasError());
+
+    // Truncated block
+    buffer.Reset();
+    buffer.PushDeltaEncoded(std::vector<int64_t>{1, 2, 4, 8, 16, 32});
+    raw = buffer.GetRawData();
+    raw.erase(raw.end() - 2);
+    buffer.SetRawData(raw);
+    EXPECT_TRUE(buffer.PopDeltaEncoded<int64_t>().empty());
+    EXPECT_TRUE(buffer.HasError());
+}
+
+//=============================================================================
+// String Dictionary Tests
+//=============================================================================
+
+TEST_F(BinarySerializationTest, StringDictionaryRoundTrip)
+{
+    std::vector<std::string> rhs;
+    for (int i = 0; i < 1000; ++i)
+    {
+        rhs.emplace_back(i % 3 == 0 ? "USD" : (i % 3 == 1 ? "EUR" : "XLON"));
+    }
+    rhs.emplace_back(std::string(1000, 'x'));
+
+    serialization::save(buffer, rhs);
+    const auto plain_size = buffer.Size();
+
+    buffer.Reset();
+    buffer.EnableStringDictionary(true);
+    serialization::save(buffer, rhs);
+    // Repeated strings take two bytes instead of a tag, a length byte and the text
+    EXPECT_LT(buffer.Size() * 2, plain_size);
+
+    std::vector<std::string> lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(rhs, lhs);
+    EXPECT_FALSE(buffer.HasError());
+}
+
+TEST_F(BinarySerializationTest, StringDictionaryAcrossRawData)
+{
+    buffer.EnableStringDictionary(true);
+    std::vector<std::map<std::string, int>> rhs{{{"bid", 1}, {"ask", 2}}, {{"bid", 3}}};
+    serialization::save(buffer, rhs);
+
+    // The reader needs no setup, and views of repeated strings share storage
+    serialization::multi_process_stream reader;
+    reader.SetRawData(buffer.GetRawData());
+    std::vector<std::map<std::string, int>> lhs;
+    serialization::load(reader, lhs);
+    EXPECT_EQ(rhs, lhs);
+
+    buffer.Reset();
+    buffer << std::string_view("venue") << std::string_view("venue");
+    std::string_view first;
+    std::string_view second;
+    buffer >> first >> second;
+    EXPECT_EQ(first, "venue");
+    EXPECT_EQ(first.data(), second.data());
+}
+
+TEST_F(BinarySerializationTest, StringDictionaryCorruptIndex)
+{
+    buffer.EnableStringDictionary(true);
+    buffer << std::string("code") << std::string("code");
+
+    // Drop the definition so that the reference points past the dictionary
+    auto raw = buffer.GetRawData();
+    raw.erase(raw.begin(), raw.begin() + 6);
+    buffer.SetRawData(raw);
+
+    std::string lhs;
+    const auto  status = serialization::try_load(buffer, lhs);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(
+        status.error().code(), serialization::serialization_error::error_code::malformed_input);
+}
+
+//=============================================================================
+// Bit Packing Tests
+//=============================================================================
+
+TEST_F(BinarySerializationTest, BitVectorsAndBitsets)
+{
+    for (const size_t size : {0, 1, 2, 7, 8, 9, 64, 65, 1000})
+    {
+        std::vector<bool> rhs(size);
+        for (size_t i = 0; i < size; ++i)
+        {
+            rhs[i] = i % 3 == 0 || i % 7 == 0;
+        }
+        buffer.Reset();
+        serialization::save(buffer, rhs);
+
+        std::vector<bool> lhs{true};
+        serialization::load(buffer, lhs);
+        EXPECT_EQ(rhs, lhs);
+        EXPECT_TRUE(buffer.Empty());
+    }
+
+    // A length and one bit per element, not two bytes
+    buffer.Reset();
+    serialization::save(buffer, std::vector<bool>(1000, true));
+    EXPECT_LT(buffer.Size(), 1000u / 8 + 8);
+
+    std::bitset<70> flags;
+    flags.set(0).set(5).set(64).set(69);
+    buffer.Reset();
+    serialization::save(buffer, flags);
+    std::bitset<70> loaded;
+    serialization::load(buffer, loaded);
+    EXPECT_EQ(flags, loaded);
+
+    // Bitsets of another size are rejected
+    serialization::save(buffer, flags);
+    std::bitset<8> narrow;
+    const auto     status = serialization::try_load(buffer, narrow);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().code(), serialization::serialization_error::error_code::size_mismatch);
+
+    // JSON holds arrays of bools
+    serialization::json json_buffer;
+    serialization::save(json_buffer, flags);
+    ASSERT_EQ(json_buffer.size(), 70u);
+    EXPECT_TRUE(json_buffer[69].get<bool>());
+    loaded.reset();
+    serialization::load(json_buffer, loaded);
+    EXPECT_EQ(flags, loaded);
+
+    const std::vector<bool> bits{true, false, true};
+    json_buffer = serialization::json();
+    serialization::save(json_buffer, bits);
+    std::vector<bool> loaded_bits;
+    serialization::load(json_buffer, loaded_bits);
+    EXPECT_EQ(bits, loaded_bits);
+}
+
+TEST_F(BinarySerializationTest, BitVectorsReadUnpackedBools)
+{
+    // As archived before bits were packed: a length and a char value per bool
+    buffer.PushLength(3);
+    buffer << static_cast<char>(1) << static_cast<char>(0) << static_cast<char>(1);
+
+    std::vector<bool> lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, (std::vector<bool>{true, false, true}));
+    EXPECT_FALSE(buffer.HasError());
+}
+
+TEST_F(BinarySerializationTest, PackedBoolMembers)
+{
+    std::vector<test::order_flags> rhs(3);
+    rhs[0].active_    = true;
+    rhs[0].side_      = test::order_side::cross;
+    rhs[0].quantity_  = 100;
+    rhs[1].hidden_    = true;
+    rhs[1].urgent_    = true;
+    rhs[1].side_      = test::order_side::sell;
+    rhs[2].cancelled_ = true;
+
+    serialization::save(buffer, rhs);
+    const auto unpacked_size = buffer.Size();
+
+    buffer.Reset();
+    buffer.EnableBitPacking(true);
+    serialization::save(buffer, rhs);
+    // Per object, the five bits of active_, hidden_, side_ and urgent_ share a
+    // 3-byte group instead of taking three 2-byte bools and a group of their own
+    EXPECT_EQ(buffer.Size() + 3 * 6, unpacked_size);
+
+    std::vector<test::order_flags> lhs;
+    serialization::load(buffer, lhs);
+    ASSERT_EQ(lhs.size(), rhs.size());
+    for (size_t i = 0; i < rhs.size(); ++i)
+    {
+        EXPECT_EQ(lhs[i].active_, rhs[i].active_);
+        EXPECT_EQ(lhs[i].hidden_, rhs[i].hidden_);
+        EXPECT_EQ(lhs[i].side_, rhs[i].side_);
+        EXPECT_EQ(lhs[i].urgent_, rhs[i].urgent_);
+        EXPECT_EQ(lhs[i].quantity_, rhs[i].quantity_);
+        EXPECT_EQ(lhs[i].cancelled_, rhs[i].cancelled_);
+    }
+    EXPECT_TRUE(buffer.Empty());
+
+    // Enumerators that do not fit the encoding are rejected
+    test::order_flags invalid;
+    invalid.side_ = static_cast<test::order_side>(4);
+    EXPECT_THROW(serialization::save(buffer, invalid), serialization::serialization_error);
+}
+
+TEST_F(BinarySerializationTest, SkipBitGroups)
+{
+    buffer.EnableBitPacking(true);
+    buffer << true << false << true << 7 << false;
+    buffer.PushBits(0x2d, 6);
+    EXPECT_EQ(buffer.Size(), 3u + 5u + 3u);
+
+    EXPECT_TRUE(buffer.Skip(2));
+    bool third = false;
+    int  seven = 0;
+    buffer >> third >> seven;
+    EXPECT_TRUE(third);
+    EXPECT_EQ(seven, 7);
+    EXPECT_TRUE(buffer.Skip(3));
+    EXPECT_EQ(buffer.PopBits(4), 0xbu);
+    EXPECT_TRUE(buffer.Empty());
+
+    // A value cannot be read from the middle of a group
+    buffer.PushBits(0x3, 2);
+    buffer << 1;
+    EXPECT_EQ(buffer.PopBits(1), 1u);
+    int value = 0;
+    buffer >> value;
+    EXPECT_TRUE(buffer.HasError());
+}
+
+TEST_F(BinarySerializationTest, BitGroupCorruptCount)
+{
+    buffer.PushBits(0xff, 8);
+    auto raw = buffer.GetRawData();
+    raw[1]   = 9;
+    buffer.SetRawData(raw);
+    buffer.PopBits(8);
+    EXPECT_TRUE(buffer.HasError());
+}
@@ -0,0 +1,250 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization_impl.h"
+#include "util/multi_process_stream.h"
+#include "util/pointer.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+// Same members and order as table_sample, serialized the default way
+class unrolled_sample
+{
+public:
+    unrolled_sample() = default;
+
+    int                              id_{0};
+    std::string                      name_;
+    std::vector<double>              values_;
+    std::optional<int>               limit_;
+    std::map<std::string, int>       counts_;
+    std::shared_ptr<unrolled_sample> child_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(unrolled_sample, id_, name_, values_, limit_, counts_, child_);
+};
+
+class table_sample
+{
+public:
+    table_sample() = default;
+
+    int                           id_{0};
+    std::string                   name_;
+    std::vector<double>           values_;
+    std::optional<int>            limit_;
+    std::map<std::string, int>    counts_;
+    std::shared_ptr<table_sample> child_;
+    bool                          initialized_{false};
+
+protected:
+    void initialize() { initialized_ = true; }
+    SERIALIZATION_MACRO(table_sample, id_, name_, values_, limit_, counts_, child_);
+    SERIALIZATION_CODEC_TABLE;
+};
+
+class table_derived : public table_sample
+{
+public:
+    table_derived() = default;
+
+    std::string label_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO_DERIVED(table_derived, table_sample, label_);
+    SERIALIZATION_CODEC_TABLE;
+};
+
+class virtual_base
+{
+public:
+    virtual_base() = default;
+
+    int id_{0};
+
+protected:
+    void initialize() {}
+    SERIALIZATION_MACRO(virtual_base, id_);
+};
+
+// Members of a virtual base have no fixed offset, so they cannot use a table
+class virtual_derived : public virtual virtual_base
+{
+public:
+    virtual_derived() = default;
+
+    std::string label_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO_DERIVED(virtual_derived, virtual_base, label_);
+};
+
+template <typename T>
+void fill(T& sample)
+{
+    sample.id_            = 42;
+    sample.name_          = "sample";
+    sample.values_        = {1.5, 2.5, 3.5};
+    sample.limit_         = 7;
+    sample.counts_        = {{"a", 1}, {"b", 2}};
+    sample.child_         = std::make_shared<T>();
+    sample.child_->id_    = 43;
+    sample.child_->name_  = "child";
+    sample.child_->limit_ = std::nullopt;
+}
+
+template <typename T, typename U>
+void expect_same(const T& lhs, const U& rhs)
+{
+    EXPECT_EQ(lhs.id_, rhs.id_);
+    EXPECT_EQ(lhs.name_, rhs.name_);
+    EXPECT_EQ(lhs.values_, rhs.values_);
+    EXPECT_EQ(lhs.limit_, rhs.limit_);
+    EXPECT_EQ(lhs.counts_, rhs.counts_);
+    ASSERT_NE(lhs.child_, nullptr);
+    ASSERT_NE(rhs.child_, nullptr);
+    EXPECT_EQ(lhs.child_->id_, rhs.child_->id_);
+    EXPECT_EQ(lhs.child_->name_, rhs.child_->name_);
+    EXPECT_EQ(lhs.child_->limit_, rhs.child_->limit_);
+}
+}  // namespace test
+
+//=============================================================================
+// Codec Table Tests
+//=============================================================================
+
+class CodecTableTest : public ::testing::Test
+{
+};
+
+TEST_F(CodecTableTest, Selection)
+{
+    static_assert(
+        serialization::detail::uses_codec_table<serialization::json, test::table_sample>);
+    static_assert(serialization::detail::
+                      uses_codec_table<serialization::multi_process_stream, test::table_derived>);
+#if !SERIALIZATION_CODEC_TABLES
+    static_assert(
+        !serialization::detail::uses_codec_table<serialization::json, test::unrolled_sample>);
+#endif
+    static_assert(serialization::detail::fixed_member_offsets_v<test::table_derived>);
+    static_assert(!serialization::detail::fixed_member_offsets_v<test::virtual_derived>);
+    static_assert(
+        !serialization::detail::uses_codec_table<serialization::json, test::virtual_derived>);
+
+    // Offsets measured on one object hold for every other
+    const test::table_derived probe;
+    const auto& codec = serialization::detail::codec_of<serialization::json>(probe);
+    ASSERT_EQ(codec.members.size(), 7u);
+    EXPECT_EQ(codec.members[6].name, "label_");
+
+    const test::table_derived object;
+    const auto*               base = reinterpret_cast<const std::byte*>(&object);
+    EXPECT_EQ(
+        codec.members[1].offset,
+        static_cast<std::size_t>(reinterpret_cast<const std::byte*>(&object.name_) - base));
+    EXPECT_EQ(
+        codec.members[6].offset,
+        static_cast<std::size_t>(reinterpret_cast<const std::byte*>(&object.label_) - base));
+}
+
+TEST_F(CodecTableTest, BinaryRoundTrip)
+{
+    test::table_sample rhs;
+    test::fill(rhs);
+
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+
+    test::table_sample lhs;
+    serialization::load(buffer, lhs);
+
+    test::expect_same(lhs, rhs);
+    EXPECT_TRUE(lhs.initialized_);
+    EXPECT_TRUE(lhs.child_->initialized_);
+}
+
+TEST_F(CodecTableTest, JsonMatchesUnrolledFormat)
+{
+    test::table_sample    table;
+    test::unrolled_sample unrolled;
+    test::fill(table);
+    test::fill(unrolled);
+
+    serialization::json table_archive;
+    serialization::json unrolled_archive;
+    serialization::save(table_archive, table);
+    serialization::save(unrolled_archive, unrolled);
+
+    // Only the class names differ
+    table_archive["Class"]              = "";
+    table_archive["child_"]["Class"]    = "";
+    unrolled_archive["Class"]           = "";
+    unrolled_archive["child_"]["Class"] = "";
+    EXPECT_EQ(table_archive, unrolled_archive);
+
+    test::unrolled_sample lhs;
+    serialization::save(table_archive, table);
+    serialization::load(table_archive, lhs);
+    test::expect_same(lhs, table);
+}
+
+TEST_F(CodecTableTest, BinaryReadsUnrolledFormat)
+{
+    test::unrolled_sample rhs;
+    test::fill(rhs);
+
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+
+    test::table_sample lhs;
+    serialization::load(buffer, lhs);
+    test::expect_same(lhs, rhs);
+}
+
+TEST_F(CodecTableTest, DerivedMembers)
+{
+    test::table_derived rhs;
+    test::fill(rhs);
+    rhs.label_ = "derived";
+
+    serialization::json buffer;
+    serialization::save(buffer, rhs);
+
+    test::table_derived lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs.id_, 42);
+    EXPECT_EQ(lhs.label_, "derived");
+    EXPECT_EQ(lhs.values_, rhs.values_);
+}
+
+TEST_F(CodecTableTest, TryLoadStopsAtFirstError)
+{
+    test::table_sample rhs;
+    test::fill(rhs);
+
+    serialization::json buffer;
+    serialization::save(buffer, rhs);
+    buffer["name_"] = 3;
+
+    test::table_sample lhs;
+    const auto         status = serialization::try_load(buffer, lhs);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(lhs.id_, 42);
+    EXPECT_TRUE(lhs.values_.empty());
+    EXPECT_FALSE(lhs.initialized_);
+}
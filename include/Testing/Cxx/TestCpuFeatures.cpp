@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include "util/base64.h"
+#include "util/cpu_features.h"
+#include "util/crc32c.h"
+#include "util/json_text.h"
+
+//=============================================================================
+// CPU Feature Dispatch Tests
+//=============================================================================
+
+class CpuFeaturesTest : public ::testing::Test
+{
+protected:
+    static constexpr serialization::simd_level levels[] = {
+        serialization::simd_level::scalar,
+        serialization::simd_level::sse42,
+        serialization::simd_level::avx2,
+        serialization::simd_level::avx512,
+        serialization::simd_level::neon};
+
+    // Restore the default kernels for the tests that follow
+    void TearDown() override { serialization::set_simd_level(serialization::best_simd_level()); }
+
+    // ASCII text longer than the widest vector
+    static std::string sample(std::size_t size)
+    {
+        std::string text;
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            text += static_cast<char>('a' + i % 26);
+        }
+        return text;
+    }
+};
+
+TEST_F(CpuFeaturesTest, LevelsAndNames)
+{
+    EXPECT_TRUE(serialization::simd_level_supported(serialization::simd_level::scalar));
+    EXPECT_TRUE(serialization::simd_level_supported(serialization::best_simd_level()));
+    if (std::getenv("SERIALIZATION_SIMD_LEVEL") == nullptr)
+    {
+        EXPECT_EQ(serialization::active_simd_level(), serialization::best_simd_level());
+    }
+
+    for (const auto level : levels)
+    {
+        EXPECT_EQ(
+            serialization::set_simd_level(level), serialization::simd_level_supported(level));
+        if (serialization::simd_level_supported(level))
+        {
+            EXPECT_EQ(serialization::active_simd_level(), level);
+        }
+    }
+    EXPECT_EQ(serialization::simd_level_name(serialization::simd_level::avx512), "avx512");
+
+#if defined(__x86_64__) || defined(_M_X64)
+    EXPECT_FALSE(serialization::simd_level_supported(serialization::simd_level::neon));
+    const auto& features = serialization::detected_cpu_features();
+    EXPECT_EQ(
+        serialization::simd_level_supported(serialization::simd_level::avx2),
+        features.avx2 && features.sse42 && features.ssse3);
+#endif
+}
+
+TEST_F(CpuFeaturesTest, EveryLevelComputesTheSameResults)
+{
+    const std::string          check = "123456789";
+    std::vector<unsigned char> bytes(1000);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<unsigned char>(i * 131 + 7);
+    }
+
+    for (const auto level : levels)
+    {
+        if (!serialization::set_simd_level(level))
+        {
+            continue;
+        }
+        SCOPED_TRACE(std::string(serialization::simd_level_name(level)));
+
+        EXPECT_EQ(serialization::crc32c(check.data(), check.size()), 0xe3069283u);
+        EXPECT_EQ(
+            serialization::crc32c(bytes.data(), bytes.size()),
+            serialization::crc32c(
+                bytes.data() + 500, 500, serialization::crc32c(bytes.data(), 500)));
+
+        std::string text;
+        serialization::append_base64(text, bytes.data(), bytes.size());
+        std::vector<unsigned char> decoded(serialization::base64_decoded_size(text));
+        ASSERT_TRUE(serialization::decode_base64(text, decoded.data()));
+        EXPECT_EQ(decoded, bytes);
+        text[700] = '*';
+        EXPECT_FALSE(serialization::decode_base64(text, decoded.data()));
+
+        for (const std::size_t position : {0, 15, 31, 63, 64, 130, 199})
+        {
+            auto plain = sample(200);
+            EXPECT_EQ(serialization::json_escape_position(plain.data(), plain.size()), 200u);
+            EXPECT_TRUE(serialization::is_valid_utf8(plain));
+
+            plain[position] = '"';
+            EXPECT_EQ(serialization::json_escape_position(plain.data(), plain.size()), position);
+
+            plain[position] = '\xff';
+            EXPECT_FALSE(serialization::is_valid_utf8(plain));
+        }
+    }
+}
@@ -0,0 +1,240 @@
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/interning.h"
+#include "common/serialization_macros.h"
+#include "serialization.h"
+#include "serialization_impl.h"
+#include "serialization_iterative.h"
+#include "util/multi_process_stream.h"
+#include "util/pointer.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class calendar
+{
+public:
+    calendar() = default;
+    explicit calendar(std::string name) : name_(std::move(name)) {}
+
+    std::string      name_;
+    std::vector<int> holidays_{1, 359, 360};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(calendar, name_, holidays_);
+    SERIALIZATION_INTERNED;
+};
+
+class instrument
+{
+public:
+    instrument() = default;
+    instrument(std::string isin, serialization::ptr_const<calendar> cal)
+        : isin_(std::move(isin)), calendar_(std::move(cal))
+    {
+    }
+
+    std::string                        isin_;
+    serialization::ptr_const<calendar> calendar_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(instrument, isin_, calendar_);
+    SERIALIZATION_INTERNED;
+};
+
+class order
+{
+public:
+    order() = default;
+    order(int id, serialization::ptr_const<instrument> inst)
+        : id_(id), instrument_(std::move(inst))
+    {
+    }
+
+    int                                  id_{0};
+    serialization::ptr_const<instrument> instrument_;
+    serialization::ptr_mutable<calendar> settlement_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(order, id_, instrument_, settlement_);
+};
+
+class level
+{
+public:
+    level() = default;
+    explicit level(int value) : value_(value) {}
+
+    int value_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(level, value_);
+    SERIALIZATION_INTERNED;
+};
+
+inline std::vector<order> make_orders()
+{
+    auto target = std::make_shared<const calendar>("TARGET");
+    auto bund   = std::make_shared<const instrument>("DE0001102580", target);
+    auto bobl   = std::make_shared<const instrument>("DE0001141869", target);
+
+    std::vector<order> orders;
+    for (int i = 0; i < 50; ++i)
+    {
+        orders.emplace_back(i, i % 2 == 0 ? bund : bobl);
+        orders.back().settlement_ = std::make_shared<calendar>("TARGET");
+    }
+    return orders;
+}
+}  // namespace test
+
+//=============================================================================
+// Interning Tests
+//=============================================================================
+
+class InterningTest : public ::testing::Test
+{
+protected:
+    void SetUp() override { serialization::clear_interning_table(); }
+};
+
+TEST_F(InterningTest, BinaryDuplicatesShareInstance)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, test::make_orders());
+
+    std::vector<test::order> lhs;
+    serialization::load(buffer, lhs);
+    ASSERT_EQ(lhs.size(), 50u);
+
+    EXPECT_EQ(lhs[0].instrument_, lhs[2].instrument_);
+    EXPECT_EQ(lhs[1].instrument_, lhs[3].instrument_);
+    EXPECT_NE(lhs[0].instrument_, lhs[1].instrument_);
+    EXPECT_EQ(lhs[1].instrument_->isin_, "DE0001141869");
+
+    // Nested objects are interned too, across different parents
+    EXPECT_EQ(lhs[0].instrument_->calendar_, lhs[1].instrument_->calendar_);
+
+    // Mutable pointers are never shared
+    EXPECT_NE(lhs[0].settlement_, lhs[2].settlement_);
+
+    const auto stats = serialization::interning_stats();
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.hits, 50u - 2u + 49u);
+}
+
+TEST_F(InterningTest, SharedAcrossArchives)
+{
+    using access      = serialization::serialization_impl::access;
+    const auto orders = test::make_orders();
+    const auto first  = access::binary_serialize(
+        serialization::util::make_ptr_const<test::order>(orders[0]));
+    const auto second = access::binary_serialize(
+        serialization::util::make_ptr_const<test::order>(orders[2]));
+
+    const auto lhs = access::binary_deserialize<test::order>(first);
+    const auto rhs = access::binary_deserialize<test::order>(second);
+    EXPECT_EQ(lhs->instrument_, rhs->instrument_);
+
+    // JSON and dictionary streams resolve to the same instance
+    serialization::json json_buffer;
+    serialization::save(json_buffer, orders[4]);
+    test::order from_json;
+    serialization::load(json_buffer, from_json);
+    EXPECT_EQ(from_json.instrument_, lhs->instrument_);
+
+    serialization::multi_process_stream dictionary_buffer;
+    dictionary_buffer.EnableStringDictionary(true);
+    serialization::save(dictionary_buffer, orders[6]);
+    test::order from_dictionary;
+    serialization::load(dictionary_buffer, from_dictionary);
+    EXPECT_EQ(from_dictionary.instrument_, lhs->instrument_);
+}
+
+TEST_F(InterningTest, ExpiredInstancesAreReplaced)
+{
+    serialization::multi_process_stream buffer;
+    const auto                          orders = test::make_orders();
+    serialization::save(buffer, orders[0]);
+    const auto raw = buffer.GetRawData();
+
+    test::order first;
+    serialization::load(buffer, first);
+    std::weak_ptr<const test::instrument> weak = first.instrument_;
+    first.instrument_.reset();
+    EXPECT_TRUE(weak.expired());
+
+    buffer.SetRawData(raw);
+    test::order second;
+    serialization::load(buffer, second);
+    ASSERT_NE(second.instrument_, nullptr);
+    EXPECT_EQ(second.instrument_->isin_, "DE0001102580");
+}
+
+TEST_F(InterningTest, IterativeLoadsShareInstance)
+{
+    const auto orders = test::make_orders();
+
+    serialization::multi_process_stream buffer;
+    serialization::save_iterative(buffer, orders[0].instrument_);
+    serialization::save_iterative(buffer, orders[2].instrument_);
+    serialization::save_iterative(buffer, orders[1].instrument_);
+
+    serialization::ptr_const<test::instrument> first;
+    serialization::ptr_const<test::instrument> second;
+    serialization::ptr_const<test::instrument> other;
+    serialization::load_iterative(buffer, first);
+    serialization::load_iterative(buffer, second);
+    serialization::load(buffer, other);
+    ASSERT_NE(first, nullptr);
+    EXPECT_EQ(first, second);
+    EXPECT_NE(first, other);
+    EXPECT_EQ(first->calendar_, other->calendar_);
+
+    // The same instances as the recursive load
+    serialization::json json_buffer;
+    serialization::save(json_buffer, orders[0].instrument_);
+    serialization::ptr_const<test::instrument> from_json;
+    serialization::load_iterative(json_buffer, from_json);
+    EXPECT_EQ(from_json, first);
+
+    // Misses: TARGET, bund and bobl; every other instrument and calendar hits
+    const auto stats = serialization::interning_stats();
+    EXPECT_EQ(stats.misses, 3u);
+    EXPECT_EQ(stats.hits, 5u);
+}
+
+TEST_F(InterningTest, ForeignByteOrderKeyedByValue)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, std::make_shared<const test::level>(0x01000000));
+    auto raw = buffer.GetRawData();
+
+    serialization::ptr_const<test::level> native;
+    serialization::load(buffer, native);
+    ASSERT_NE(native, nullptr);
+
+    // A stream stamped with the other byte order is keyed by a native encoding
+    // of what was loaded from it, so it shares an instance only with equal values
+    raw.back() = static_cast<unsigned char>(1 - raw.back());
+    buffer.SetRawData(raw);
+    serialization::ptr_const<test::level> foreign;
+    serialization::load(buffer, foreign);
+    ASSERT_NE(foreign, nullptr);
+    EXPECT_EQ(foreign == native, foreign->value_ == native->value_);
+
+    const auto stats = serialization::interning_stats();
+    EXPECT_EQ(stats.misses + stats.hits, 2u);
+}
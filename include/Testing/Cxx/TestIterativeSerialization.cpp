@@ -0,0 +1,321 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization_impl.h"
+#include "serialization_iterative.h"
+#include "util/multi_process_stream.h"
+#include "util/pointer.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class linked_node
+{
+public:
+    explicit linked_node(int value) : value_(value) {}
+
+    int                                 value() const { return value_; }
+    const std::shared_ptr<linked_node>& next() const { return next_; }
+    std::shared_ptr<linked_node>&       next() { return next_; }
+
+private:
+    void initialize() {}
+    linked_node() = default;
+    SERIALIZATION_MACRO(linked_node, value_, next_);
+
+    int                          value_{0};
+    std::shared_ptr<linked_node> next_;
+};
+
+class tree_node
+{
+public:
+    explicit tree_node(std::string name) : name_(std::move(name)) {}
+
+    const std::string&                             name() const { return name_; }
+    const std::vector<std::shared_ptr<tree_node>>& children() const { return children_; }
+    std::vector<std::shared_ptr<tree_node>>&       children() { return children_; }
+    bool                                           initialized() const { return initialized_; }
+
+private:
+    void initialize() { initialized_ = true; }
+    tree_node() = default;
+    SERIALIZATION_MACRO(tree_node, name_, children_);
+
+    std::string                             name_;
+    std::vector<std::shared_ptr<tree_node>> children_;
+    bool                                    initialized_{false};
+};
+
+class quote_node
+{
+public:
+    quote_node() = default;
+
+    double                      bid_{0};
+    double                      ask_{0};
+    int                         side_{0};
+    bool                        firm_{false};
+    bool                        stale_{false};
+    std::vector<int64_t>        times_;
+    std::shared_ptr<quote_node> next_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(quote_node, bid_, ask_, side_, firm_, stale_, times_, next_);
+    SERIALIZATION_FIELD_ENCODINGS(
+        serialization::encode("bid_", serialization::encoding::fixed_point(4)),
+        serialization::encode("ask_", serialization::encoding::quantized(0.0, 200.0, 0.005)),
+        serialization::encode("side_", serialization::encoding::bits(2)),
+        serialization::encode("times_", serialization::encoding::delta_of_delta()));
+};
+
+inline std::shared_ptr<quote_node> make_quotes(int length)
+{
+    std::shared_ptr<quote_node> head;
+    for (int i = length - 1; i >= 0; --i)
+    {
+        auto node    = std::make_shared<quote_node>();
+        node->bid_   = 100.25 + i;
+        node->ask_   = 100.5 + i;
+        node->side_  = i % 3;
+        node->firm_  = i % 2 == 0;
+        node->stale_ = i % 5 == 0;
+        node->times_ = {1'700'000'000 + i, 1'700'000'010 + i, 1'700'000'030 + i};
+        node->next_  = std::move(head);
+        head         = std::move(node);
+    }
+    return head;
+}
+
+// Builds a list head -> ... of the given length, without recursion.
+inline std::shared_ptr<linked_node> make_list(int length)
+{
+    std::shared_ptr<linked_node> head;
+    for (int i = length - 1; i >= 0; --i)
+    {
+        auto node    = std::make_shared<linked_node>(i);
+        node->next() = std::move(head);
+        head         = std::move(node);
+    }
+    return head;
+}
+
+// Unlinks the list node by node so that destruction does not recurse.
+inline void release_list(std::shared_ptr<linked_node>& head)
+{
+    while (head)
+    {
+        head = std::move(head->next());
+    }
+}
+
+inline std::shared_ptr<tree_node> make_tree()
+{
+    auto root = std::make_shared<tree_node>("root");
+    auto left = std::make_shared<tree_node>("left");
+    left->children().push_back(std::make_shared<tree_node>("leaf"));
+    root->children().push_back(left);
+    root->children().push_back(nullptr);
+    root->children().push_back(std::make_shared<tree_node>("right"));
+    return root;
+}
+}  // namespace test
+
+//=============================================================================
+// Iterative Serialization Tests
+//=============================================================================
+
+class IterativeSerializationTest : public ::testing::Test
+{
+protected:
+    static constexpr int deep_length = 100000;
+};
+
+TEST_F(IterativeSerializationTest, BinaryMatchesRecursiveFormat)
+{
+    const auto rhs = test::make_tree();
+
+    serialization::multi_process_stream recursive;
+    serialization::multi_process_stream iterative;
+    serialization::save(recursive, rhs);
+    serialization::save_iterative(iterative, rhs);
+    EXPECT_EQ(recursive.GetRawData(), iterative.GetRawData());
+
+    std::shared_ptr<test::tree_node> lhs;
+    serialization::load_iterative(recursive, lhs);
+
+    ASSERT_NE(lhs, nullptr);
+    EXPECT_EQ(lhs->name(), "root");
+    EXPECT_TRUE(lhs->initialized());
+    ASSERT_EQ(lhs->children().size(), 3u);
+    EXPECT_EQ(lhs->children()[0]->children()[0]->name(), "leaf");
+    EXPECT_EQ(lhs->children()[1], nullptr);
+    EXPECT_EQ(lhs->children()[2]->name(), "right");
+}
+
+TEST_F(IterativeSerializationTest, EncodedMembersMatchRecursiveFormat)
+{
+    const auto rhs = test::make_quotes(4);
+
+    for (const bool pack : {false, true})
+    {
+        serialization::multi_process_stream recursive;
+        serialization::multi_process_stream iterative;
+        recursive.EnableBitPacking(pack);
+        iterative.EnableBitPacking(pack);
+        serialization::save(recursive, rhs);
+        serialization::save_iterative(iterative, rhs);
+        EXPECT_EQ(recursive.GetRawData(), iterative.GetRawData());
+
+        // Each reader accepts the other's archive
+        std::shared_ptr<test::quote_node> lhs;
+        serialization::load_iterative(recursive, lhs);
+        std::shared_ptr<test::quote_node> other;
+        serialization::load(iterative, other);
+        EXPECT_TRUE(recursive.Empty());
+        EXPECT_TRUE(iterative.Empty());
+
+        for (const auto* node : {lhs.get(), other.get()})
+        {
+            const auto* expected = rhs.get();
+            for (int i = 0; i < 4; ++i)
+            {
+                ASSERT_NE(node, nullptr);
+                EXPECT_EQ(node->bid_, expected->bid_);
+                EXPECT_NEAR(node->ask_, expected->ask_, 0.005);
+                EXPECT_EQ(node->side_, expected->side_);
+                EXPECT_EQ(node->firm_, expected->firm_);
+                EXPECT_EQ(node->stale_, expected->stale_);
+                EXPECT_EQ(node->times_, expected->times_);
+                node     = node->next_.get();
+                expected = expected->next_.get();
+            }
+            EXPECT_EQ(node, nullptr);
+        }
+    }
+}
+
+TEST_F(IterativeSerializationTest, JsonMatchesRecursiveFormat)
+{
+    const auto rhs = test::make_tree();
+
+    serialization::json recursive;
+    serialization::json iterative;
+    serialization::save(recursive, rhs);
+    serialization::save_iterative(iterative, rhs);
+    EXPECT_EQ(recursive, iterative);
+
+    std::shared_ptr<test::tree_node> lhs;
+    serialization::load_iterative(iterative, lhs);
+
+    ASSERT_NE(lhs, nullptr);
+    EXPECT_EQ(lhs->children()[0]->name(), "left");
+    EXPECT_TRUE(lhs->children()[0]->children()[0]->initialized());
+}
+
+TEST_F(IterativeSerializationTest, BinaryDeepLinkedList)
+{
+    auto rhs = test::make_list(deep_length);
+
+    serialization::multi_process_stream buffer;
+    serialization::save_iterative(buffer, rhs);
+
+    std::shared_ptr<test::linked_node> lhs;
+    serialization::load_iterative(buffer, lhs);
+
+    int count = 0;
+    for (const auto* node = lhs.get(); node != nullptr; node = node->next().get())
+    {
+        EXPECT_EQ(node->value(), count);
+        ++count;
+    }
+    EXPECT_EQ(count, deep_length);
+
+    test::release_list(rhs);
+    test::release_list(lhs);
+}
+
+TEST_F(IterativeSerializationTest, JsonDeepLinkedList)
+{
+    auto rhs = test::make_list(deep_length);
+
+    serialization::json buffer;
+    serialization::save_iterative(buffer, rhs);
+
+    std::shared_ptr<test::linked_node> lhs;
+    serialization::load_iterative(buffer, lhs);
+
+    int count = 0;
+    for (const auto* node = lhs.get(); node != nullptr; node = node->next().get())
+    {
+        ++count;
+    }
+    EXPECT_EQ(count, deep_length);
+
+    test::release_list(rhs);
+    test::release_list(lhs);
+}
+
+TEST_F(IterativeSerializationTest, MalformedInputUnderErrorScope)
+{
+    auto rhs = test::make_list(1000);
+
+    // A truncated list stops at the first error instead of reading on
+    serialization::multi_process_stream buffer;
+    serialization::save_iterative(buffer, rhs);
+    auto raw = buffer.GetRawData();
+    raw.resize(raw.size() / 2);
+    buffer.SetRawData(raw);
+
+    std::shared_ptr<test::linked_node> lhs;
+    {
+        serialization::detail::error_scope scope;
+        serialization::load_iterative(buffer, lhs);
+        ASSERT_TRUE(scope.failed());
+        EXPECT_EQ(
+            scope.take_error().code(),
+            serialization::serialization_error::error_code::malformed_input);
+    }
+    test::release_list(lhs);
+
+    // A node without a class name is rejected like load() does, leaving the document as is
+    serialization::json document;
+    serialization::save_iterative(document, test::make_list(3));
+    document["next_"].erase("Class");
+    const auto original = document;
+    {
+        serialization::detail::error_scope scope;
+        serialization::load_iterative(document, lhs);
+        ASSERT_TRUE(scope.failed());
+        EXPECT_EQ(
+            scope.take_error().code(),
+            serialization::serialization_error::error_code::missing_field);
+    }
+    EXPECT_EQ(document, original);
+    EXPECT_THROW(serialization::load(document, lhs), serialization::serialization_error);
+
+    test::release_list(rhs);
+    test::release_list(lhs);
+}
+
+TEST_F(IterativeSerializationTest, RecursiveDepthLimit)
+{
+    auto rhs = test::make_list(2 * serialization::detail::serialization_context::max_depth);
+
+    serialization::multi_process_stream buffer;
+    EXPECT_THROW(serialization::save(buffer, rhs), serialization::serialization_error);
+    EXPECT_EQ(serialization::detail::serialization_context::current().depth, 0u);
+
+    test::release_list(rhs);
+}
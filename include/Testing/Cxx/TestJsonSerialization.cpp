@@ -2,13 +2,19 @@
 
 #include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
 #include <map>
+#include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
 #include "common/serialization_macros.h"
 #include "serialization.h"
@@ -51,6 +57,68 @@ private:
 };
 
 SERIALIZATION_REGISTER_DERIVED_SERIALIZATION(test_derived_serialization);
+
+struct leading_base
+{
+    virtual ~leading_base() = default;
+
+    std::int64_t tag_{42};
+};
+
+// The reflected base does not sit at offset 0 of this type
+class offset_derived_serialization final : public leading_base, public test_serialization
+{
+public:
+    offset_derived_serialization(double d, int64_t k) : test_serialization(d), k_(k) {}
+
+private:
+    void initialize() {};
+    offset_derived_serialization() = default;
+    SERIALIZATION_MACRO_DERIVED(offset_derived_serialization, test_serialization, k_);
+
+    int64_t k_{0};
+};
+
+SERIALIZATION_REGISTER_DERIVED_SERIALIZATION(offset_derived_serialization);
+
+// Registered by the LateRegistration test only
+class late_derived_serialization final : public test_serialization
+{
+public:
+    late_derived_serialization(double d, int64_t k) : test_serialization(d), k_(k) {}
+
+private:
+    void initialize() {};
+    late_derived_serialization() = default;
+    SERIALIZATION_MACRO_DERIVED(late_derived_serialization, test_serialization, k_);
+
+    int64_t k_{0};
+};
+
+class attachment
+{
+public:
+    attachment() = default;
+    attachment(std::string title, std::string body)
+        : title_(std::move(title)), body_(std::move(body))
+    {
+    }
+
+    std::string              title_;
+    std::string              body_;
+    std::vector<std::string> lines_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(attachment, title_, body_, lines_);
+};
+
+enum class risk_bucket
+{
+    low,
+    medium,
+    high
+};
 }  // namespace test
 
 //=============================================================================
@@ -143,6 +211,59 @@ TEST_F(JsonSerializationTest, UnorderedMapSerialization)
     EXPECT_EQ(lhs, rhs);
 }
 
+TEST_F(JsonSerializationTest, StringKeyedMapIsObject)
+{
+    std::map<std::string, std::vector<double>> rhs{{"EUR", {1.5, 2.5}}, {"USD", {3.0}}};
+    std::map<std::string, std::vector<double>> lhs;
+    serialization::save(buffer, rhs);
+    EXPECT_EQ(buffer, serialization::json::parse(R"({"EUR": [1.5, 2.5], "USD": [3.0]})"));
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, rhs);
+
+    // Repeated keys cannot be object members
+    std::multimap<std::string, int> fills{{"XLON", 1}, {"XLON", 2}};
+    std::multimap<std::string, int> loaded_fills;
+    buffer = serialization::json();
+    serialization::save(buffer, fills);
+    EXPECT_TRUE(buffer.is_array());
+    serialization::load(buffer, loaded_fills);
+    EXPECT_EQ(loaded_fills, fills);
+
+    std::unordered_map<std::string, int> limits{{"daily", 1000}, {"single", 50}};
+    std::unordered_map<std::string, int> loaded;
+    serialization::save(buffer, limits);
+    ASSERT_TRUE(buffer.is_object());
+    EXPECT_EQ(buffer["daily"], 1000);
+    serialization::load(buffer, loaded);
+    EXPECT_EQ(loaded, limits);
+}
+
+TEST_F(JsonSerializationTest, EnumKeyedMapIsObject)
+{
+    std::map<test::risk_bucket, double> rhs{
+        {test::risk_bucket::low, 0.1}, {test::risk_bucket::high, 0.9}};
+    std::map<test::risk_bucket, double> lhs;
+    serialization::save(buffer, rhs);
+    ASSERT_TRUE(buffer.is_object());
+    EXPECT_EQ(buffer.size(), 2u);
+    EXPECT_EQ(
+        buffer[std::string(serialization::enum_to_string(test::risk_bucket::high))], 0.9);
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, rhs);
+}
+
+TEST_F(JsonSerializationTest, StringKeyedMapReadsFlatArrays)
+{
+    // Layout written before string-keyed maps became objects
+    buffer = serialization::json::parse(R"(["daily", 1000, "single", 50])");
+    std::map<std::string, int> lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, (std::map<std::string, int>{{"daily", 1000}, {"single", 50}}));
+
+    buffer = serialization::json::parse(R"({"daily": "many"})");
+    EXPECT_FALSE(serialization::try_load(buffer, lhs));
+}
+
 //=============================================================================
 // Smart Pointer Tests
 //=============================================================================
@@ -189,6 +310,73 @@ TEST_F(JsonSerializationTest, DerivedTypeSerialization)
     EXPECT_EQ(rhs->n(), lhs_derived->n());
 }
 
+TEST_F(JsonSerializationTest, DerivedTypeThroughBasePointer)
+{
+    serialization::ptr_const<test::test_serialization> rhs =
+        std::make_shared<test::test_derived_serialization>(6.7, "me");
+    serialization::ptr_const<test::test_serialization> lhs;
+    serialization::save(buffer, rhs);
+    serialization::load(buffer, lhs);
+
+    auto lhs_derived = std::dynamic_pointer_cast<const test::test_derived_serialization>(lhs);
+
+    ASSERT_NE(lhs_derived, nullptr);
+    EXPECT_EQ(rhs->d(), lhs->d());
+    EXPECT_EQ(lhs_derived->n(), "me");
+}
+
+TEST_F(JsonSerializationTest, DerivedTypeWithOffsetBaseThroughBasePointer)
+{
+    auto derived = std::make_shared<test::offset_derived_serialization>(2.5, 17);
+    serialization::ptr_const<test::test_serialization>             through_base = derived;
+    serialization::ptr_const<test::offset_derived_serialization> direct       = derived;
+    ASSERT_NE(
+        static_cast<const void*>(through_base.get()), static_cast<const void*>(direct.get()));
+
+    serialization::json expected;
+    serialization::save(buffer, through_base);
+    serialization::save(expected, direct);
+    EXPECT_EQ(buffer, expected);
+}
+
+TEST_F(JsonSerializationTest, LateRegistration)
+{
+    serialization::ptr_const<test::test_serialization> rhs =
+        std::make_shared<test::late_derived_serialization>(1.5, 3);
+
+    // Unregistered: saved as the base type under the demangled RTTI name
+    serialization::save(buffer, rhs);
+    EXPECT_FALSE(buffer.contains("k_"));
+
+    // Types registered later, e.g. by a library loaded at run time, are found
+    serialization::register_polymorphic_entry(
+        serialization::polymorphic_entry_v<test::late_derived_serialization>);
+    buffer = serialization::json();
+    serialization::save(buffer, rhs);
+    EXPECT_EQ(buffer["k_"], 3);
+    EXPECT_EQ(buffer["Class"], "test::late_derived_serialization");
+}
+
+TEST_F(JsonSerializationTest, CompileTimeTypeNames)
+{
+    static_assert(serialization::type_name<int>() == "int");
+    static_assert(serialization::type_name<double>() == "double");
+    static_assert(
+        serialization::type_name<test::test_serialization>() == "test::test_serialization");
+
+    const auto* entry = serialization::find_polymorphic_entry("test::test_derived_serialization");
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(
+        entry, serialization::find_polymorphic_entry(typeid(test::test_derived_serialization)));
+
+    // Archives written with demangled RTTI names still resolve
+    EXPECT_EQ(
+        entry,
+        serialization::find_polymorphic_entry(
+            serialization::demangle(typeid(test::test_derived_serialization).name())));
+    EXPECT_EQ(serialization::find_polymorphic_entry("test::not_registered"), nullptr);
+}
+
 //=============================================================================
 // Variant Tests
 //=============================================================================
@@ -201,3 +389,132 @@ TEST_F(JsonSerializationTest, VariantSerialization)
     serialization::load(buffer, lhs);
     EXPECT_EQ(rhs, lhs);
 }
+
+TEST_F(JsonSerializationTest, ByteContainersAreBase64)
+{
+    const std::vector<unsigned char> rhs{'s', 'e', 'r', 'i', 'a', 'l', 0x00, 0xff};
+    serialization::save(buffer, rhs);
+    EXPECT_EQ(buffer, "c2VyaWFsAP8=");
+
+    std::vector<unsigned char> lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, rhs);
+
+    std::vector<std::byte> bytes(1000);
+    for (std::size_t i = 0; i < bytes.size(); ++i)
+    {
+        bytes[i] = static_cast<std::byte>(i * 7);
+    }
+    std::vector<std::byte> bytes_out;
+    serialization::save(buffer, bytes);
+    ASSERT_TRUE(buffer.is_string());
+    EXPECT_EQ(buffer.get_ref<const std::string&>().size(), 1336u);
+    serialization::load(buffer, bytes_out);
+    EXPECT_EQ(bytes_out, bytes);
+
+    const std::array<unsigned char, 4> digest{0xde, 0xad, 0xbe, 0xef};
+    std::array<unsigned char, 4>       digest_out{};
+    serialization::save(buffer, digest);
+    EXPECT_EQ(buffer, "3q2+7w==");
+    serialization::load(buffer, digest_out);
+    EXPECT_EQ(digest_out, digest);
+}
+
+TEST_F(JsonSerializationTest, ByteContainersReadArrays)
+{
+    // Layout written before byte containers became base64 strings
+    buffer = serialization::json::parse("[1, 2, 255]");
+    std::vector<unsigned char> lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs, (std::vector<unsigned char>{1, 2, 255}));
+
+    buffer = "not base64";
+    EXPECT_FALSE(serialization::try_load(buffer, lhs));
+    buffer = "AAA*";
+    EXPECT_FALSE(serialization::try_load(buffer, lhs));
+
+    std::array<unsigned char, 3> array{};
+    buffer = "AAAA";
+    EXPECT_TRUE(serialization::try_load(buffer, array));
+    buffer = "AAAAAA==";
+    EXPECT_FALSE(serialization::try_load(buffer, array));
+}
+
+//=============================================================================
+// Non-throwing Load Tests
+//=============================================================================
+
+TEST_F(JsonSerializationTest, TryLoadTypeMismatch)
+{
+    std::vector<std::string> rhs{"one", "two"};
+    serialization::save(buffer, rhs);
+
+    std::vector<int> lhs;
+    const auto       status = serialization::try_load(buffer, lhs);
+    ASSERT_FALSE(status.has_value());
+    EXPECT_EQ(status.error().code(), serialization::serialization_error::error_code::type_mismatch);
+
+    EXPECT_THROW(serialization::load(buffer, lhs), serialization::serialization_error);
+}
+
+TEST_F(JsonSerializationTest, TryJsonDeserialize)
+{
+    serialization::ptr_const<test::test_serialization> rhs =
+        std::make_shared<test::test_derived_serialization>(1.5, "name");
+    serialization::serialization_impl::access::json_serialize(buffer, rhs);
+
+    const auto lhs =
+        serialization::serialization_impl::access::try_json_deserialize<test::test_serialization>(
+            buffer);
+    ASSERT_TRUE(lhs.has_value());
+    EXPECT_EQ((*lhs)->d(), 1.5);
+
+    const auto missing = serialization::serialization_impl::access::
+        try_json_deserialize<test::test_serialization>(serialization::json::object());
+    ASSERT_FALSE(missing.has_value());
+    EXPECT_EQ(
+        missing.error().code(), serialization::serialization_error::error_code::missing_field);
+}
+
+TEST_F(JsonSerializationTest, WriteToJsonFile)
+{
+    using access    = serialization::serialization_impl::access;
+    const auto path = std::string("test_attachment.json");
+
+    auto rhs = std::make_shared<test::attachment>(
+        "caf\xc3\xa9 \xe2\x82\xac",
+        std::string(5000, 'x') + "<note a=\"1\">\n\t\\path\r</note>\x01" + std::string(70, 'y'));
+    rhs->lines_ = {"", "\"", "\xf0\x9f\x98\x80"};
+    access::write_to_json(path, serialization::ptr_const<test::attachment>(rhs));
+
+    // The file and print() read as nlohmann::json::dump() writes them
+    serialization::json root;
+    access::json_serialize(root, serialization::ptr_const<test::attachment>(rhs));
+    {
+        std::ifstream     in(path, std::ios::binary);
+        const std::string text(std::istreambuf_iterator<char>(in), {});
+        EXPECT_EQ(text, root.dump(1) + "\n");
+    }
+    EXPECT_EQ(
+        access::print(serialization::ptr_const<test::attachment>(rhs)), root["root"].dump(2));
+
+    const auto lhs = access::read_from_json<test::attachment>(path);
+    ASSERT_NE(lhs, nullptr);
+    EXPECT_EQ(lhs->title_, rhs->title_);
+    EXPECT_EQ(lhs->body_, rhs->body_);
+    EXPECT_EQ(lhs->lines_, rhs->lines_);
+
+    // Invalid UTF-8 is rejected on both sides
+    rhs->title_ = "caf\xc3";
+    EXPECT_THROW(
+        access::write_to_json(path, serialization::ptr_const<test::attachment>(rhs)),
+        serialization::serialization_error);
+    {
+        std::ofstream out(path, std::ios::binary);
+        out << R"({"root": {"Class": "test::attachment", "title_": "caf)" << '\xc3'
+            << R"(", "body_": "", "lines_": []}})";
+    }
+    EXPECT_THROW(
+        access::read_from_json<test::attachment>(path), serialization::serialization_error);
+    std::filesystem::remove(path);
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+
+#include "common/serialization_error.h"
+#include "common/transcoder.h"
+#include "util/json_text.h"
+
+//=============================================================================
+// JSON Text Tests
+//=============================================================================
+
+class JsonTextTest : public ::testing::Test
+{
+protected:
+    static std::string escaped(std::string_view text)
+    {
+        std::string out;
+        serialization::append_json_escaped(out, text);
+        return out;
+    }
+
+    // nlohmann::json::dump() without the surrounding quotes
+    static std::string reference(const std::string& text)
+    {
+        const auto dumped = serialization::json(text).dump();
+        return dumped.substr(1, dumped.size() - 2);
+    }
+};
+
+TEST_F(JsonTextTest, EscapePosition)
+{
+    // Every offset within and across vector blocks
+    for (std::size_t size : {0, 1, 15, 16, 17, 31, 32, 33, 64, 100})
+    {
+        std::string text(size, 'a');
+        EXPECT_EQ(serialization::json_escape_position(text.data(), text.size()), size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            for (const char c : {'"', '\\', '\n', '\x1f', '\0'})
+            {
+                text[i] = c;
+                EXPECT_EQ(serialization::json_escape_position(text.data(), text.size()), i);
+                text[i] = 'a';
+            }
+        }
+    }
+
+    // Bytes above 0x7f and DEL are copied as they are
+    const std::string high = "\x7f\x80\xc3\xa9\xff plain text of some length";
+    EXPECT_EQ(serialization::json_escape_position(high.data(), high.size()), high.size());
+}
+
+TEST_F(JsonTextTest, EscapeMatchesDump)
+{
+    std::string every_ascii;
+    for (int c = 0; c < 0x80; ++c)
+    {
+        every_ascii += static_cast<char>(c);
+    }
+    EXPECT_EQ(escaped(every_ascii), reference(every_ascii));
+
+    const std::string text = std::string(40, 'x') + "\"quoted\"\tand\\slashed\r\n" +
+                             std::string(20, 'y') + "caf\xc3\xa9";
+    EXPECT_EQ(escaped(text), reference(text));
+    EXPECT_EQ(escaped(""), "");
+}
+
+TEST_F(JsonTextTest, Utf8Validation)
+{
+    const std::string padding(37, 'a');
+    for (const std::string valid : {
+             "",
+             "ascii only",
+             "caf\xc3\xa9",
+             "\xe2\x82\xac euro",
+             "\xf0\x9f\x98\x80 emoji",
+             "\xef\xbf\xbf\xf4\x8f\xbf\xbf",
+         })
+    {
+        EXPECT_TRUE(serialization::is_valid_utf8(valid)) << valid;
+        EXPECT_TRUE(serialization::is_valid_utf8(padding + valid + padding)) << valid;
+    }
+
+    for (const std::string invalid : {
+             "\x80",              // Lone continuation byte
+             "\xc3",              // Truncated sequence
+             "\xc0\xaf",          // Overlong '/'
+             "\xe0\x80\xaf",      // Overlong '/'
+             "\xed\xa0\x80",      // UTF-16 surrogate
+             "\xf4\x90\x80\x80",  // Above U+10FFFF
+             "\xff",
+         })
+    {
+        EXPECT_FALSE(serialization::is_valid_utf8(invalid));
+        EXPECT_FALSE(serialization::is_valid_utf8(padding + invalid + padding));
+        EXPECT_FALSE(serialization::is_valid_utf8(padding + invalid));
+    }
+}
+
+TEST_F(JsonTextTest, DumpMatchesNlohmann)
+{
+    using json    = serialization::json;
+    json document = {
+        {"text", std::string(40, 'x') + "\"quoted\"\n\tcaf\xc3\xa9 \xf0\x9f\x98\x80"},
+        {"integers",
+         {0, -1, 42, std::numeric_limits<int64_t>::min(), std::numeric_limits<uint64_t>::max()}},
+        {"floats", {0.1, -0.0, 1.0, 1e300, 2.5e-8, 123456789.125}},
+        {"literals", {true, false, nullptr}},
+        {"empty", {{"object", json::object()}, {"array", json::array()}}},
+        {"nested", {{"a", {{"b", {1, {2, {3}}}}}}}},
+    };
+    document["floats"].push_back(std::numeric_limits<double>::quiet_NaN());
+
+    for (const int indent : {-1, 0, 1, 2, 4})
+    {
+        std::string out;
+        serialization::dump_json(out, document, indent);
+        EXPECT_EQ(out, document.dump(indent)) << indent;
+    }
+
+    std::string out;
+    serialization::dump_json(out, serialization::json("scalar"));
+    EXPECT_EQ(out, "\"scalar\"");
+
+    // dump() throws type_error 316 on the same strings
+    EXPECT_THROW(
+        serialization::dump_json(out, serialization::json({{"bad", "caf\xc3"}})),
+        serialization::serialization_error);
+}
+
+TEST_F(JsonTextTest, ParseMatchesNlohmann)
+{
+    for (const std::string text : {
+             R"({"a": [1, -2, 3.5, "x\"y\\z\/\b\f\n\r\t"], "b": {"c": null, "d": true}})",
+             R"(["\u00e9\u20ac\ud83d\ude00", "\u0000", "caf)" "\xc3\xa9" R"("])",
+             "  \n\t[ ] ",
+             "\xef\xbb\xbf{}",
+             "[-0, 0, 1E5, 1e-5, -1.5e+3, 18446744073709551615, 18446744073709551616]",
+             "[-9223372036854775808, -9223372036854775809, 1e-400]",
+             R"({"k": 1, "k": 2, "j": 3})",
+             "\"just a string\"",
+             "12",
+         })
+    {
+        serialization::json lhs;
+        serialization::parse_json(text, lhs);
+        const auto rhs = serialization::json::parse(text);
+        EXPECT_EQ(lhs.dump(), rhs.dump()) << text;
+        EXPECT_EQ(lhs, rhs) << text;
+    }
+
+    for (const std::string text : {
+             "",
+             "   ",
+             "[1,]",
+             "[,1]",
+             R"({"a":1,})",
+             R"({"a" 1})",
+             "{1:2}",
+             "[1 2]",
+             "01",
+             "1.",
+             ".5",
+             "+1",
+             "-",
+             "1e",
+             "1e400",
+             "tru",
+             "nul",
+             "[]x",
+             "\"unterminated",
+             "\"\\x\"",
+             "\"\\u12\"",
+             "\"\x01\"",
+             "\"\\ud800\"",
+             "\"\\udc00\"",
+             "\"\\ud800\\u0041\"",
+             "\"\xff\"",
+             "[",
+             R"({"a":)",
+         })
+    {
+        EXPECT_FALSE(serialization::json::accept(text)) << text;
+        serialization::json value;
+        EXPECT_THROW(serialization::parse_json(text, value), serialization::serialization_error)
+            << text;
+    }
+}
+
+TEST_F(JsonTextTest, DeepDocuments)
+{
+    // Far deeper than the call stack would allow with recursion
+    constexpr std::size_t depth = 100'000;
+    const std::string     text  = std::string(depth, '[') + std::string(depth, ']');
+
+    serialization::json value;
+    serialization::parse_json(text, value);
+
+    std::string out;
+    serialization::dump_json(out, value);
+    EXPECT_EQ(out, text);
+}
@@ -0,0 +1,304 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization_impl.h"
+#include "serialization_lazy.h"
+#include "serialization_projection.h"
+#include "util/multi_process_stream.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class audit_entry
+{
+public:
+    audit_entry() = default;
+    audit_entry(int version, std::string user) : version_(version), user_(std::move(user)) {}
+
+    int         version_{0};
+    std::string user_;
+    bool        initialized_{false};
+
+private:
+    void initialize() { initialized_ = true; }
+    SERIALIZATION_MACRO(audit_entry, version_, user_);
+};
+
+class document
+{
+public:
+    document() = default;
+
+    std::string                                    title_;
+    serialization::lazy<std::vector<audit_entry>> audit_;
+    serialization::lazy<std::string>               payload_;
+    int                                            revision_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(document, title_, audit_, payload_, revision_);
+};
+
+// Bits around and inside the lazy members share groups when bit packing is on
+class lazy_flags
+{
+public:
+    bool                                   a_{false};
+    serialization::lazy<bool>              b_;
+    serialization::lazy<std::vector<bool>> v_;
+    bool                                   c_{false};
+    bool                                   d_{false};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(lazy_flags, a_, b_, v_, c_, d_);
+};
+
+// Same members without lazy, as written by a writer that did not end the groups
+class packed_flags
+{
+public:
+    bool              a_{false};
+    bool              b_{false};
+    std::vector<bool> v_;
+    bool              c_{false};
+    bool              d_{false};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(packed_flags, a_, b_, v_, c_, d_);
+};
+
+inline document make_document()
+{
+    document d;
+    d.title_ = "quarterly report";
+    std::vector<audit_entry> audit;
+    for (int i = 0; i < 50; ++i)
+    {
+        audit.emplace_back(i, i % 2 == 0 ? "alice" : "bob");
+    }
+    d.audit_    = std::move(audit);
+    d.payload_  = std::string(1000, 'p');
+    d.revision_ = 7;
+    return d;
+}
+}  // namespace test
+
+//=============================================================================
+// Lazy Member Tests
+//=============================================================================
+
+class LazyTest : public ::testing::Test
+{
+protected:
+    test::document rhs = test::make_document();
+
+    static void expect_same(const test::document& lhs, const test::document& rhs)
+    {
+        EXPECT_EQ(lhs.title_, rhs.title_);
+        EXPECT_EQ(lhs.revision_, rhs.revision_);
+        EXPECT_EQ(*lhs.payload_, *rhs.payload_);
+        ASSERT_EQ(lhs.audit_->size(), rhs.audit_->size());
+        for (size_t i = 0; i < rhs.audit_->size(); ++i)
+        {
+            EXPECT_EQ(lhs.audit_.get()[i].version_, rhs.audit_.get()[i].version_);
+            EXPECT_EQ(lhs.audit_.get()[i].user_, rhs.audit_.get()[i].user_);
+            EXPECT_TRUE(lhs.audit_.get()[i].initialized_);
+        }
+    }
+};
+
+TEST_F(LazyTest, BinaryDecodesOnFirstAccess)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+    serialization::save(buffer, std::string("trailer"));
+
+    test::document lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_EQ(lhs.revision_, 7);
+    EXPECT_FALSE(lhs.audit_.decoded());
+    EXPECT_FALSE(lhs.payload_.decoded());
+
+    std::string trailer;
+    serialization::load(buffer, trailer);
+    EXPECT_EQ(trailer, "trailer");
+
+    expect_same(lhs, rhs);
+    EXPECT_TRUE(lhs.audit_.decoded());
+}
+
+TEST_F(LazyTest, UntouchedMembersAreCopiedVerbatim)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+    const auto original = buffer.GetRawData();
+
+    test::document lhs;
+    serialization::load(buffer, lhs);
+
+    // Saving neither decodes the members nor changes their bytes
+    serialization::multi_process_stream copy;
+    serialization::save(copy, lhs);
+    EXPECT_FALSE(lhs.audit_.decoded());
+    EXPECT_EQ(copy.GetRawData(), original);
+
+    // Reading keeps the captured bytes; modifying discards them
+    EXPECT_EQ(lhs.payload_->size(), 1000u);
+    lhs.audit_.get_mutable().emplace_back(50, "carol");
+
+    serialization::multi_process_stream edited;
+    serialization::save(edited, lhs);
+    test::document reloaded;
+    serialization::load(edited, reloaded);
+    ASSERT_EQ(reloaded.audit_->size(), 51u);
+    EXPECT_EQ(reloaded.audit_->back().user_, "carol");
+    EXPECT_EQ(*reloaded.payload_, *rhs.payload_);
+}
+
+TEST_F(LazyTest, JsonDecodesOnFirstAccess)
+{
+    serialization::json buffer;
+    serialization::save(buffer, rhs);
+
+    test::document lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_FALSE(lhs.audit_.decoded());
+
+    serialization::json copy;
+    serialization::save(copy, lhs);
+    EXPECT_EQ(copy, buffer);
+
+    expect_same(lhs, rhs);
+}
+
+TEST_F(LazyTest, ConcurrentFirstAccess)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+    test::document lhs;
+    serialization::load(buffer, lhs);
+
+    // Every thread sees the single decoded value
+    std::vector<const std::vector<test::audit_entry>*> seen(8);
+    std::vector<std::thread>                           workers;
+    for (size_t t = 0; t < seen.size(); ++t)
+    {
+        workers.emplace_back([&lhs, &seen, t] { seen[t] = &lhs.audit_.get(); });
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+    for (const auto* value : seen)
+    {
+        EXPECT_EQ(value, &lhs.audit_.get());
+    }
+    EXPECT_EQ(lhs.audit_->size(), 50u);
+}
+
+TEST_F(LazyTest, DictionaryStreamsDecodeEagerly)
+{
+    serialization::multi_process_stream buffer;
+    buffer.EnableStringDictionary(true);
+    serialization::save(buffer, rhs);
+
+    test::document lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_TRUE(lhs.audit_.decoded());
+    expect_same(lhs, rhs);
+}
+
+TEST_F(LazyTest, CopyAndProjection)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+    test::document lhs;
+    serialization::load(buffer, lhs);
+
+    const test::document copy = lhs;
+    EXPECT_FALSE(copy.audit_.decoded());
+    expect_same(copy, rhs);
+
+    // Projections skip lazy members like any other
+    buffer.Reset();
+    serialization::save(buffer, rhs);
+    const auto projected = serialization::load_projection<test::document>(buffer, {"revision_"});
+    EXPECT_EQ(projected.revision_, 7);
+    EXPECT_TRUE(projected.audit_->empty());
+    EXPECT_TRUE(buffer.Empty());
+}
+
+TEST_F(LazyTest, MalformedMemberThrowsOnAccess)
+{
+    serialization::json buffer;
+    serialization::save(buffer, rhs);
+    buffer["audit_"][0]["version_"] = "not a number";
+
+    test::document lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_THROW(lhs.audit_.get(), serialization::serialization_error);
+    EXPECT_FALSE(lhs.audit_.decoded());
+
+    // Inside a try_load() scope the error is recorded instead
+    serialization::detail::error_scope scope;
+    EXPECT_TRUE(lhs.audit_.get().empty());
+    EXPECT_TRUE(scope.failed());
+    EXPECT_FALSE(lhs.audit_.decoded());
+}
+
+TEST_F(LazyTest, BitPackedPayloads)
+{
+    test::lazy_flags rhs;
+    rhs.a_ = true;
+    rhs.b_ = true;
+    rhs.v_ = std::vector<bool>{true, false, true};
+    rhs.d_ = true;
+
+    const auto expect_flags = [](const test::lazy_flags& lhs)
+    {
+        EXPECT_TRUE(lhs.a_);
+        EXPECT_TRUE(lhs.b_.get());
+        EXPECT_EQ(lhs.v_.get(), std::vector<bool>({true, false, true}));
+        EXPECT_FALSE(lhs.c_);
+        EXPECT_TRUE(lhs.d_);
+    };
+
+    serialization::multi_process_stream buffer;
+    buffer.EnableBitPacking(true);
+    serialization::save(buffer, rhs);
+
+    test::lazy_flags lhs;
+    serialization::load(buffer, lhs);
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_FALSE(lhs.v_.decoded());
+    const test::lazy_flags copy = lhs;
+    expect_flags(lhs);
+
+    // Captured payloads are copied back verbatim, still in groups of their own
+    EXPECT_FALSE(copy.v_.decoded());
+    buffer.Reset();
+    serialization::save(buffer, copy);
+    serialization::load(buffer, lhs);
+    expect_flags(lhs);
+
+    // Payloads sharing groups with their neighbours are decoded right away
+    test::packed_flags packed;
+    packed.a_ = packed.b_ = packed.d_ = true;
+    packed.v_                         = {true, false, true};
+    buffer.Reset();
+    serialization::save(buffer, packed);
+    serialization::load(buffer, lhs);
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_TRUE(lhs.v_.decoded());
+    expect_flags(lhs);
+}
@@ -0,0 +1,257 @@
+#include <gtest/gtest.h>
+
+#if !defined(_WIN32)
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization.h"
+#include "serialization_impl.h"
+#include "util/local_socket.h"
+#include "util/multi_process_stream.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class sensor_frame
+{
+public:
+    sensor_frame() = default;
+    sensor_frame(int id, std::string source, std::vector<double> samples)
+        : id_(id), source_(std::move(source)), samples_(std::move(samples))
+    {
+    }
+
+    int                 id_{0};
+    std::string         source_;
+    std::vector<double> samples_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(sensor_frame, id_, source_, samples_);
+};
+}  // namespace test
+
+//=============================================================================
+// Local Socket Tests
+//=============================================================================
+
+class LocalSocketTest : public ::testing::Test
+{
+protected:
+    static void send_frame(serialization::local_socket& socket, int id, std::size_t samples)
+    {
+        serialization::multi_process_stream buffer;
+        serialization::save(
+            buffer, test::sensor_frame(id, "probe", std::vector<double>(samples, 0.5 * id)));
+        socket.Send(buffer);
+    }
+
+    static test::sensor_frame receive_frame(
+        serialization::local_socket& socket, serialization::multi_process_stream& buffer)
+    {
+        test::sensor_frame frame;
+        EXPECT_TRUE(socket.Receive(buffer));
+        serialization::load(buffer, frame);
+        EXPECT_TRUE(buffer.Empty());
+        return frame;
+    }
+};
+
+TEST_F(LocalSocketTest, PairRoundTrip)
+{
+    auto [left, right] = serialization::local_socket::Pair();
+    ASSERT_TRUE(left.IsOpen());
+
+    std::thread sender(
+        [&left]
+        {
+            for (int i = 0; i < 200; ++i)
+            {
+                send_frame(left, i, static_cast<std::size_t>(i % 7) * 100);
+            }
+            left.Close();
+        });
+
+    // One stream receives every frame and keeps its storage
+    serialization::multi_process_stream buffer;
+    for (int i = 0; i < 200; ++i)
+    {
+        const auto frame = receive_frame(right, buffer);
+        EXPECT_EQ(frame.id_, i);
+        EXPECT_EQ(frame.source_, "probe");
+        EXPECT_EQ(
+            frame.samples_, std::vector<double>(static_cast<std::size_t>(i % 7) * 100, 0.5 * i));
+    }
+    sender.join();
+
+    // The peer closed between two frames
+    EXPECT_FALSE(right.Receive(buffer));
+}
+
+TEST_F(LocalSocketTest, ListenAndConnect)
+{
+    const std::string path = "test_local_socket.sock";
+    std::filesystem::remove(path);
+    {
+        serialization::local_socket_listener listener(path);
+        std::thread                          client(
+            [&path]
+            {
+                auto socket = serialization::local_socket::Connect(path);
+                send_frame(socket, 7, 3);
+
+                // Echo back whatever the server sends
+                serialization::multi_process_stream buffer;
+                ASSERT_TRUE(socket.Receive(buffer));
+                socket.Send(buffer);
+            });
+
+        auto                                server = listener.Accept();
+        serialization::multi_process_stream buffer;
+        EXPECT_EQ(receive_frame(server, buffer).id_, 7);
+
+        send_frame(server, 8, 4);
+        const auto echoed = receive_frame(server, buffer);
+        EXPECT_EQ(echoed.id_, 8);
+        EXPECT_EQ(echoed.samples_.size(), 4u);
+        client.join();
+    }
+    EXPECT_FALSE(std::filesystem::exists(path));
+    EXPECT_THROW(
+        serialization::local_socket::Connect(path), serialization::serialization_error);
+}
+
+TEST_F(LocalSocketTest, LargePayloadInMemfd)
+{
+    auto [left, right] = serialization::local_socket::Pair({.memfd_threshold = 4096});
+
+    // Small frames still travel inline on the same connection
+    std::thread sender(
+        [&left]
+        {
+            send_frame(left, 1, 100000);
+            send_frame(left, 2, 2);
+            send_frame(left, 3, 50000);
+        });
+
+    serialization::multi_process_stream buffer;
+    EXPECT_EQ(receive_frame(right, buffer).samples_.size(), 100000u);
+    EXPECT_EQ(receive_frame(right, buffer).samples_.size(), 2u);
+    const auto last = receive_frame(right, buffer);
+    EXPECT_EQ(last.id_, 3);
+    EXPECT_EQ(last.samples_.back(), 1.5);
+    sender.join();
+}
+
+TEST_F(LocalSocketTest, BetweenProcesses)
+{
+    auto [parent, child] = serialization::local_socket::Pair({.memfd_threshold = 1 << 16});
+
+    const pid_t pid = ::fork();
+    ASSERT_GE(pid, 0);
+    if (pid == 0)
+    {
+        parent.Close();
+        serialization::multi_process_stream buffer;
+        while (child.Receive(buffer))
+        {
+            test::sensor_frame frame;
+            serialization::load(buffer, frame);
+            frame.id_ += 1000;
+            buffer.Reset();
+            serialization::save(buffer, frame);
+            child.Send(buffer);
+        }
+        ::_exit(0);
+    }
+
+    child.Close();
+    serialization::multi_process_stream buffer;
+    for (int i = 0; i < 20; ++i)
+    {
+        send_frame(parent, i, i % 2 == 0 ? 10 : 20000);
+        const auto reply = receive_frame(parent, buffer);
+        EXPECT_EQ(reply.id_, 1000 + i);
+        EXPECT_EQ(reply.samples_.size(), i % 2 == 0 ? 10u : 20000u);
+    }
+    parent.Close();
+
+    int status = 0;
+    ASSERT_EQ(::waitpid(pid, &status, 0), pid);
+    EXPECT_TRUE(WIFEXITED(status));
+    EXPECT_EQ(WEXITSTATUS(status), 0);
+}
+
+TEST_F(LocalSocketTest, RejectsBadFrames)
+{
+    const std::string path = "test_local_socket_bad_frames.sock";
+    std::filesystem::remove(path);
+    serialization::local_socket_listener listener(path, {.max_frame_size = 1024});
+
+    // Sends raw bytes from a plain socket and closes it
+    const auto receive_raw = [&](std::vector<unsigned char> bytes)
+    {
+        std::thread client(
+            [&path, &bytes]
+            {
+                const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+                sockaddr_un address{};
+                address.sun_family = AF_UNIX;
+                path.copy(address.sun_path, path.size());
+                ASSERT_EQ(
+                    ::connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)),
+                    0);
+                ASSERT_EQ(
+                    ::write(fd, bytes.data(), bytes.size()), static_cast<ssize_t>(bytes.size()));
+                ::close(fd);
+            });
+        auto server = listener.Accept();
+        client.join();
+
+        serialization::multi_process_stream buffer;
+        try
+        {
+            server.Receive(buffer);
+        }
+        catch (const serialization::serialization_error& error)
+        {
+            return error.code();
+        }
+        return serialization::serialization_error::error_code::none;
+    };
+
+    using error_code = serialization::serialization_error::error_code;
+    std::vector<unsigned char> header(serialization::local_socket::FrameHeaderSize, 0);
+
+    // Larger than max_frame_size
+    header[1] = 8;
+    EXPECT_EQ(receive_raw(header), error_code::malformed_input);
+
+    // A memfd frame without a descriptor
+    header[1] = 0;
+    header[9] = 1;
+    EXPECT_EQ(receive_raw(header), error_code::malformed_input);
+
+    // Cut short by the peer closing the connection
+    header[0] = 100;
+    header[9] = 0;
+    header.resize(header.size() + 10, 'x');
+    EXPECT_EQ(receive_raw(header), error_code::io_error);
+
+    // A torn header
+    header.resize(5);
+    EXPECT_EQ(receive_raw(header), error_code::io_error);
+}
+#endif
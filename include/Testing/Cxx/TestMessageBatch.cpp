@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization.h"
+#include "serialization_impl.h"
+#include "util/message_batch.h"
+#include "util/multi_process_stream.h"
+#include "util/pointer.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class quote_tick
+{
+public:
+    quote_tick() = default;
+    quote_tick(int id, std::string symbol, double bid)
+        : id_(id), symbol_(std::move(symbol)), bid_(bid)
+    {
+    }
+
+    int         id_{0};
+    std::string symbol_;
+    double      bid_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(quote_tick, id_, symbol_, bid_);
+};
+}  // namespace test
+
+//=============================================================================
+// Message Batch Tests
+//=============================================================================
+
+class MessageBatchTest : public ::testing::Test
+{
+protected:
+    static std::vector<unsigned char> write_ticks(int count)
+    {
+        serialization::message_batch_writer batch;
+        serialization::multi_process_stream buffer;
+        for (int i = 0; i < count; ++i)
+        {
+            buffer.Reset();
+            serialization::save(buffer, test::quote_tick(i, "EURUSD", 1.0 + i));
+            batch.Append(buffer);
+        }
+        const auto data = batch.Finish();
+        return {data.begin(), data.end()};
+    }
+};
+
+TEST_F(MessageBatchTest, RoundTrip)
+{
+    const auto data = write_ticks(1000);
+
+    const serialization::message_batch_reader batch(data);
+    ASSERT_TRUE(batch.IsValid());
+    ASSERT_EQ(batch.Count(), 1000u);
+
+    serialization::multi_process_stream buffer;
+    for (std::size_t i = 0; i < batch.Count(); ++i)
+    {
+        // Messages are views into the batch
+        const auto message = batch.Message(i);
+        EXPECT_GE(message.data(), data.data());
+        EXPECT_LE(message.data() + message.size(), data.data() + data.size());
+
+        batch.Load(i, buffer);
+        test::quote_tick tick;
+        serialization::load(buffer, tick);
+        EXPECT_EQ(tick.id_, static_cast<int>(i));
+        EXPECT_EQ(tick.symbol_, "EURUSD");
+        EXPECT_EQ(tick.bid_, 1.0 + i);
+    }
+}
+
+TEST_F(MessageBatchTest, FramingIsSmallerThanSeparateMessages)
+{
+    constexpr int count = 100;
+
+    std::size_t separate = 0;
+    for (int i = 0; i < count; ++i)
+    {
+        serialization::multi_process_stream buffer;
+        serialization::save(buffer, test::quote_tick(i, "EURUSD", 1.0 + i));
+        // Each message on its own also needs a length prefix on the wire
+        separate += buffer.GetRawData().size() + sizeof(uint32_t);
+    }
+
+    const auto data = write_ticks(count);
+    EXPECT_LT(data.size(), separate - count * 3);
+}
+
+TEST_F(MessageBatchTest, WriterIsReused)
+{
+    serialization::message_batch_writer batch;
+    for (int round = 0; round < 3; ++round)
+    {
+        batch.Clear();
+        EXPECT_EQ(batch.Count(), 0u);
+        for (int i = 0; i <= round; ++i)
+        {
+            const std::vector<unsigned char> message(static_cast<std::size_t>(i) * 200, 'x');
+            batch.Append(message);
+        }
+
+        // Appending after Finish() extends the batch
+        batch.Finish();
+        batch.Append(std::vector<unsigned char>{1, 2, 3});
+
+        const serialization::message_batch_reader reader(batch.Finish());
+        ASSERT_TRUE(reader.IsValid());
+        ASSERT_EQ(reader.Count(), static_cast<std::size_t>(round) + 2);
+        for (int i = 0; i <= round; ++i)
+        {
+            EXPECT_EQ(reader.Message(i).size(), static_cast<std::size_t>(i) * 200);
+        }
+        EXPECT_EQ(reader.Message(round + 1).size(), 3u);
+        EXPECT_EQ(reader.Message(round + 1)[2], 3);
+    }
+}
+
+TEST_F(MessageBatchTest, EmptyBatch)
+{
+    serialization::message_batch_writer batch;
+    const auto                          data = batch.Finish();
+    EXPECT_EQ(data.size(), serialization::message_batch_writer::HeaderSize);
+
+    const serialization::message_batch_reader reader(data);
+    EXPECT_TRUE(reader.IsValid());
+    EXPECT_EQ(reader.Count(), 0u);
+}
+
+TEST_F(MessageBatchTest, RejectsMixedEndianness)
+{
+    serialization::multi_process_stream native;
+    serialization::save(native, test::quote_tick(1, "EURUSD", 1.5));
+    const auto bytes = native.UnreadData();
+
+    // The same bytes, claimed to come from a stream of the other byte order
+    serialization::multi_process_stream foreign;
+    foreign.SetRawData(bytes, static_cast<unsigned char>(native.endianness() ^ 1));
+
+    serialization::message_batch_writer batch;
+    batch.Append(native);
+    EXPECT_THROW(batch.Append(foreign), serialization::serialization_error);
+    EXPECT_EQ(batch.Count(), 1u);
+
+    // A batch starting from a foreign stream takes its byte order
+    batch.Clear();
+    batch.Append(foreign);
+    EXPECT_THROW(batch.Append(native), serialization::serialization_error);
+
+    const serialization::message_batch_reader reader(batch.Finish());
+    ASSERT_TRUE(reader.IsValid());
+    ASSERT_EQ(reader.Count(), 1u);
+    EXPECT_EQ(reader.endianness(), foreign.endianness());
+}
+
+TEST_F(MessageBatchTest, RejectsMalformedBatches)
+{
+    const auto data = write_ticks(10);
+    EXPECT_FALSE(serialization::message_batch_reader().IsValid());
+
+    // Truncated anywhere
+    for (std::size_t size : {std::size_t{0}, std::size_t{10}, data.size() / 2, data.size() - 1})
+    {
+        const serialization::message_batch_reader reader(std::span(data.data(), size));
+        EXPECT_FALSE(reader.IsValid()) << size;
+        EXPECT_EQ(reader.Count(), 0u);
+    }
+
+    // Bad magic, a count the index cannot hold, a length past the index
+    auto corrupt = data;
+    corrupt[0]   = 'X';
+    EXPECT_FALSE(serialization::message_batch_reader(corrupt).IsValid());
+
+    corrupt     = data;
+    corrupt[15] = 0x7f;
+    EXPECT_FALSE(serialization::message_batch_reader(corrupt).IsValid());
+
+    corrupt        = data;
+    corrupt.back() = 0x7f;
+    EXPECT_FALSE(serialization::message_batch_reader(corrupt).IsValid());
+
+    EXPECT_THROW(
+        serialization::serialization_impl::access::batch_deserialize<test::quote_tick>(corrupt),
+        serialization::serialization_error);
+}
+
+TEST_F(MessageBatchTest, AccessHelpers)
+{
+    serialization::message_batch_writer batch;
+    for (int i = 0; i < 50; ++i)
+    {
+        serialization::serialization_impl::access::append_to_batch(
+            batch, serialization::util::make_ptr_const<test::quote_tick>(i, "GBPUSD", 0.5 * i));
+    }
+
+    const auto ticks =
+        serialization::serialization_impl::access::batch_deserialize<test::quote_tick>(
+            batch.Finish());
+    ASSERT_EQ(ticks.size(), 50u);
+    EXPECT_EQ(ticks[49]->id_, 49);
+    EXPECT_EQ(ticks[49]->symbol_, "GBPUSD");
+    EXPECT_EQ(ticks[49]->bid_, 24.5);
+}
@@ -0,0 +1,251 @@
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization_impl.h"
+#include "serialization_parallel.h"
+#include "util/multi_process_stream.h"
+#include "util/numa.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class fill
+{
+public:
+    fill() = default;
+
+    std::string           venue_;
+    double                price_{0};
+    std::vector<int>      lots_;
+    std::optional<double> fee_;
+    bool                  aggressive_{false};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(fill, venue_, price_, lots_, fee_, aggressive_);
+};
+
+inline fill make_fill(int i)
+{
+    fill f;
+    f.venue_      = "XNAS" + std::to_string(i % 7);
+    f.price_      = 100.25 + i;
+    f.lots_       = std::vector<int>(i % 4, i);
+    f.aggressive_ = i % 2 == 0;
+    if (i % 3 == 0)
+    {
+        f.fee_ = 0.5 * i;
+    }
+    return f;
+}
+
+inline std::vector<fill> make_fills(int count)
+{
+    std::vector<fill> fills;
+    for (int i = 0; i < count; ++i)
+    {
+        fills.push_back(make_fill(i));
+    }
+    return fills;
+}
+
+inline void expect_equal(const std::vector<fill>& lhs, const std::vector<fill>& rhs)
+{
+    ASSERT_EQ(lhs.size(), rhs.size());
+    for (std::size_t i = 0; i < lhs.size(); ++i)
+    {
+        EXPECT_EQ(lhs[i].venue_, rhs[i].venue_);
+        EXPECT_EQ(lhs[i].price_, rhs[i].price_);
+        EXPECT_EQ(lhs[i].lots_, rhs[i].lots_);
+        EXPECT_EQ(lhs[i].fee_, rhs[i].fee_);
+        EXPECT_EQ(lhs[i].aggressive_, rhs[i].aggressive_);
+    }
+}
+}  // namespace test
+
+//=============================================================================
+// Parallel Load Tests
+//=============================================================================
+
+class ParallelLoadTest : public ::testing::Test
+{
+protected:
+    std::vector<test::fill> rhs = test::make_fills(1000);
+
+    serialization::parallel_load_options options(serialization::numa_placement placement)
+    {
+        serialization::parallel_load_options result;
+        result.threads          = 4;
+        result.placement        = placement;
+        result.min_elements     = 0;
+        result.interleave_bytes = 16 * sizeof(test::fill);
+        return result;
+    }
+};
+
+TEST_F(ParallelLoadTest, Placements)
+{
+    for (const auto placement :
+         {serialization::numa_placement::none,
+          serialization::numa_placement::per_node,
+          serialization::numa_placement::interleaved})
+    {
+        serialization::multi_process_stream buffer;
+        serialization::save(buffer, rhs);
+        buffer << 42;
+
+        std::vector<test::fill> lhs = test::make_fills(3);
+        serialization::load_parallel(buffer, lhs, options(placement));
+        test::expect_equal(lhs, rhs);
+
+        // The archive is left after the vector
+        int tail = 0;
+        buffer >> tail;
+        EXPECT_EQ(tail, 42);
+        EXPECT_TRUE(buffer.Empty());
+    }
+}
+
+TEST_F(ParallelLoadTest, Partitions)
+{
+    auto opts = options(serialization::numa_placement::none);
+    auto parts =
+        serialization::detail::partition_parallel_load(1000, sizeof(test::fill), opts);
+    ASSERT_EQ(parts.size(), 4u);
+    EXPECT_EQ(parts.front().first, 0u);
+    EXPECT_EQ(parts.back().last, 1000u);
+    for (std::size_t i = 1; i < parts.size(); ++i)
+    {
+        EXPECT_EQ(parts[i].first, parts[i - 1].last);
+    }
+
+    // Blocks go to the nodes in turn
+    opts  = options(serialization::numa_placement::interleaved);
+    parts = serialization::detail::partition_parallel_load(1000, sizeof(test::fill), opts);
+    ASSERT_EQ(parts.size(), 63u);
+    const auto nodes = serialization::numa_nodes().size();
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+        EXPECT_EQ(parts[i].first, 16 * i);
+        EXPECT_EQ(parts[i].node, i % nodes);
+    }
+}
+
+TEST_F(ParallelLoadTest, SequentialFallbacks)
+{
+    const auto opts = options(serialization::numa_placement::per_node);
+
+    // Strings of the dictionary are shared between elements
+    {
+        serialization::multi_process_stream buffer;
+        buffer.EnableStringDictionary(true);
+        serialization::save(buffer, rhs);
+
+        std::vector<test::fill> lhs;
+        serialization::load_parallel(buffer, lhs, opts);
+        test::expect_equal(lhs, rhs);
+        EXPECT_TRUE(buffer.Empty());
+    }
+
+    // Bits of neighbouring elements share a group
+    {
+        std::vector<std::pair<bool, bool>> flags;
+        for (int i = 0; i < 100; ++i)
+        {
+            flags.emplace_back(i % 3 == 0, i % 5 == 0);
+        }
+
+        serialization::multi_process_stream buffer;
+        buffer.EnableBitPacking(true);
+        serialization::save(buffer, flags);
+
+        std::vector<std::pair<bool, bool>> lhs;
+        serialization::load_parallel(buffer, lhs, opts);
+        EXPECT_EQ(lhs, flags);
+        EXPECT_TRUE(buffer.Empty());
+    }
+
+    // Too small to split
+    {
+        serialization::multi_process_stream buffer;
+        serialization::save(buffer, rhs);
+
+        std::vector<test::fill> lhs;
+        serialization::load_parallel(buffer, lhs);
+        test::expect_equal(lhs, rhs);
+    }
+}
+
+TEST_F(ParallelLoadTest, Errors)
+{
+    // Skipping accepts any value, decoding an int rejects a double
+    serialization::multi_process_stream buffer;
+    buffer.PushLength(100);
+    for (int i = 0; i < 100; ++i)
+    {
+        if (i == 70)
+        {
+            buffer << 1.5;
+        }
+        else
+        {
+            buffer << i;
+        }
+    }
+
+    std::vector<int> lhs = {1, 2, 3};
+    EXPECT_THROW(
+        serialization::load_parallel(
+            buffer, lhs, options(serialization::numa_placement::per_node)),
+        serialization::serialization_error);
+    EXPECT_EQ(lhs, (std::vector<int>{1, 2, 3}));
+
+    // A truncated archive fails while skipping
+    serialization::multi_process_stream truncated;
+    serialization::save(truncated, rhs);
+    auto data = truncated.GetRawData();
+    data.erase(data.begin() + data.size() / 2, data.end() - 1);
+    truncated.SetRawData(data);
+
+    std::vector<test::fill> fills;
+    EXPECT_THROW(
+        serialization::load_parallel(
+            truncated, fills, options(serialization::numa_placement::interleaved)),
+        serialization::serialization_error);
+}
+
+TEST_F(ParallelLoadTest, NumaNodes)
+{
+    const auto& nodes = serialization::numa_nodes();
+    ASSERT_FALSE(nodes.empty());
+
+    std::set<int> ids;
+    for (const auto& node : nodes)
+    {
+        EXPECT_TRUE(ids.insert(node.id).second);
+    }
+
+    // Placement never changes the data
+    std::vector<double> values(1 << 16, 2.5);
+    serialization::prefer_numa_node(values.data(), values.size() * sizeof(double), nodes[0].id);
+    EXPECT_EQ(values[12345], 2.5);
+
+#if defined(__linux__)
+    if (!nodes[0].cpus.empty())
+    {
+        bool bound = false;
+        std::thread([&] { bound = serialization::bind_thread_to_numa_node(nodes[0]); }).join();
+        EXPECT_TRUE(bound);
+    }
+#endif
+}
@@ -0,0 +1,300 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization_impl.h"
+#include "serialization_projection.h"
+#include "serialization_verify.h"
+#include "util/multi_process_stream.h"
+#include "util/pointer.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class position
+{
+public:
+    position() = default;
+
+    std::string              instrument_;
+    double                   notional_{0};
+    int                      quantity_{0};
+    std::vector<std::string> tags_;
+    std::optional<double>    limit_;
+    bool                     initialized_{false};
+
+private:
+    void initialize() { initialized_ = true; }
+    SERIALIZATION_MACRO(position, instrument_, notional_, quantity_, tags_, limit_);
+};
+
+class book
+{
+public:
+    book() = default;
+
+    std::string                     name_;
+    std::vector<position>           positions_;
+    std::map<std::string, position> hedges_;
+    std::vector<int64_t>            timestamps_;
+    std::unique_ptr<position>       largest_;
+    std::pair<int, std::string>     desk_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(book, name_, positions_, hedges_, timestamps_, largest_, desk_);
+    SERIALIZATION_FIELD_ENCODINGS(
+        serialization::encode("timestamps_", serialization::encoding::delta_of_delta()));
+};
+
+class tick
+{
+public:
+    tick() = default;
+
+    short          exchange_{0};
+    unsigned short lot_{0};
+    double         price_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(tick, exchange_, lot_, price_);
+};
+
+// Same layout as tick under another class name
+class legacy_tick
+{
+public:
+    legacy_tick() = default;
+
+    short          exchange_{0};
+    unsigned short lot_{0};
+    double         price_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(legacy_tick, exchange_, lot_, price_);
+};
+
+inline position make_position(int i)
+{
+    position p;
+    p.instrument_ = "BOND" + std::to_string(i % 5);
+    p.notional_   = 1e6 * (i + 1);
+    p.quantity_   = i;
+    p.tags_       = {"EUR", i % 2 == 0 ? "long" : "short"};
+    if (i % 3 == 0)
+    {
+        p.limit_ = 2.5 * i;
+    }
+    return p;
+}
+
+inline book make_book()
+{
+    book b;
+    b.name_ = "rates";
+    for (int i = 0; i < 20; ++i)
+    {
+        b.positions_.push_back(make_position(i));
+        b.timestamps_.push_back(1'700'000'000 + 5 * i);
+    }
+    b.hedges_.emplace("swap", make_position(100));
+    b.hedges_.emplace("future", make_position(101));
+    b.largest_ = std::make_unique<position>(make_position(19));
+    b.desk_    = {7, "London"};
+    return b;
+}
+}  // namespace test
+
+//=============================================================================
+// Projection Tests
+//=============================================================================
+
+class ProjectionTest : public ::testing::Test
+{
+protected:
+    test::book rhs = test::make_book();
+};
+
+TEST_F(ProjectionTest, BinaryNestedField)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+
+    const auto lhs =
+        serialization::load_projection<test::book>(buffer, {"positions_", "notional_"});
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_FALSE(buffer.HasError());
+
+    ASSERT_EQ(lhs.positions_.size(), rhs.positions_.size());
+    for (size_t i = 0; i < rhs.positions_.size(); ++i)
+    {
+        EXPECT_EQ(lhs.positions_[i].notional_, rhs.positions_[i].notional_);
+        EXPECT_TRUE(lhs.positions_[i].instrument_.empty());
+        EXPECT_TRUE(lhs.positions_[i].tags_.empty());
+        EXPECT_FALSE(lhs.positions_[i].limit_.has_value());
+        EXPECT_FALSE(lhs.positions_[i].initialized_);
+    }
+    EXPECT_TRUE(lhs.name_.empty());
+    EXPECT_TRUE(lhs.hedges_.empty());
+    EXPECT_TRUE(lhs.timestamps_.empty());
+    EXPECT_EQ(lhs.largest_, nullptr);
+}
+
+TEST_F(ProjectionTest, BinarySkipsShorts)
+{
+    std::vector<test::tick> ticks(3);
+    for (int i = 0; i < 3; ++i)
+    {
+        ticks[i].exchange_ = static_cast<short>(-7 * i);
+        ticks[i].lot_      = static_cast<unsigned short>(100 * i);
+        ticks[i].price_    = 99.5 + i;
+    }
+
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, ticks);
+
+    std::vector<test::tick> lhs;
+    serialization::load_projection(buffer, lhs, {"price_"});
+    EXPECT_TRUE(buffer.Empty());
+    EXPECT_FALSE(buffer.HasError());
+
+    ASSERT_EQ(lhs.size(), 3u);
+    for (int i = 0; i < 3; ++i)
+    {
+        EXPECT_EQ(lhs[i].price_, ticks[i].price_);
+        EXPECT_EQ(lhs[i].exchange_, 0);
+    }
+}
+
+TEST_F(ProjectionTest, BinaryWholeMembers)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+    serialization::save(buffer, std::string("trailer"));
+
+    test::book lhs;
+    serialization::load_projection(buffer, lhs, {"timestamps_"});
+    EXPECT_EQ(lhs.timestamps_, rhs.timestamps_);
+    EXPECT_TRUE(lhs.positions_.empty());
+
+    // The whole object was consumed
+    std::string trailer;
+    serialization::load(buffer, trailer);
+    EXPECT_EQ(trailer, "trailer");
+
+    buffer.Reset();
+    serialization::save(buffer, rhs);
+    serialization::load_projection(buffer, lhs, {"desk_"});
+    EXPECT_EQ(lhs.desk_, rhs.desk_);
+}
+
+TEST_F(ProjectionTest, BinaryMapValues)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+
+    const auto lhs = serialization::load_projection<test::book>(buffer, {"hedges_", "quantity_"});
+    ASSERT_EQ(lhs.hedges_.size(), 2u);
+    EXPECT_EQ(lhs.hedges_.at("swap").quantity_, 100);
+    EXPECT_EQ(lhs.hedges_.at("future").quantity_, 101);
+    EXPECT_TRUE(lhs.hedges_.at("swap").instrument_.empty());
+}
+
+TEST_F(ProjectionTest, BinarySkipsDictionaryStrings)
+{
+    // Skipped strings still define dictionary entries used by later references
+    serialization::multi_process_stream buffer;
+    buffer.EnableStringDictionary(true);
+    serialization::save(buffer, rhs);
+
+    const auto lhs =
+        serialization::load_projection<test::book>(buffer, {"positions_", "instrument_"});
+    ASSERT_EQ(lhs.positions_.size(), rhs.positions_.size());
+    for (size_t i = 0; i < rhs.positions_.size(); ++i)
+    {
+        EXPECT_EQ(lhs.positions_[i].instrument_, rhs.positions_[i].instrument_);
+    }
+    EXPECT_TRUE(buffer.Empty());
+}
+
+TEST_F(ProjectionTest, JsonNestedField)
+{
+    serialization::json buffer;
+    serialization::save(buffer, rhs);
+
+    const auto lhs = serialization::load_projection<test::book>(buffer, {"positions_", "tags_"});
+    ASSERT_EQ(lhs.positions_.size(), rhs.positions_.size());
+    for (size_t i = 0; i < rhs.positions_.size(); ++i)
+    {
+        EXPECT_EQ(lhs.positions_[i].tags_, rhs.positions_[i].tags_);
+        EXPECT_EQ(lhs.positions_[i].notional_, 0.0);
+    }
+    EXPECT_TRUE(lhs.name_.empty());
+}
+
+TEST_F(ProjectionTest, JsonMapValues)
+{
+    serialization::json buffer;
+    serialization::save(buffer, rhs);
+    ASSERT_TRUE(buffer["hedges_"].is_object());
+
+    const auto lhs = serialization::load_projection<test::book>(buffer, {"hedges_", "quantity_"});
+    ASSERT_EQ(lhs.hedges_.size(), 2u);
+    EXPECT_EQ(lhs.hedges_.at("swap").quantity_, 100);
+    EXPECT_TRUE(lhs.hedges_.at("future").instrument_.empty());
+}
+
+TEST_F(ProjectionTest, UnknownField)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+
+    test::book lhs;
+    EXPECT_THROW(
+        serialization::load_projection(buffer, lhs, {"positions_", "price_"}),
+        serialization::serialization_error);
+
+    serialization::json json_buffer;
+    serialization::save(json_buffer, rhs);
+    EXPECT_THROW(
+        serialization::load_projection(json_buffer, lhs, {"name_", "size"}),
+        serialization::serialization_error);
+}
+
+TEST_F(ProjectionTest, SkipAgreesWithLoadOnClassNames)
+{
+    // As archived by releases that spelled class names differently
+    std::vector<test::legacy_tick> legacy(2);
+    legacy[1].price_ = 101.5;
+
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, legacy);
+    serialization::save(buffer, 42);
+    const auto raw = buffer.GetRawData();
+
+    std::vector<test::tick> lhs;
+    serialization::load(buffer, lhs);
+    ASSERT_EQ(lhs.size(), 2u);
+    EXPECT_EQ(lhs[1].price_, 101.5);
+
+    buffer.SetRawData(raw);
+    EXPECT_TRUE(serialization::verify<std::vector<test::tick>>(buffer).has_value());
+    serialization::projection::skip<std::vector<test::tick>>(buffer);
+    EXPECT_FALSE(buffer.HasError());
+
+    int trailer = 0;
+    serialization::load(buffer, trailer);
+    EXPECT_EQ(trailer, 42);
+}
@@ -0,0 +1,352 @@
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization.h"
+#include "serialization_impl.h"
+#include "util/multi_process_stream.h"
+#include "util/concurrent_record_appender.h"
+#include "util/pointer.h"
+#include "util/record_log.h"
+
+#if !defined(_WIN32)
+#include <sys/resource.h>
+
+#include <csignal>
+#endif
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class trade_event
+{
+public:
+    trade_event() = default;
+    trade_event(int id, std::string venue, double price)
+        : id_(id), venue_(std::move(venue)), price_(price)
+    {
+    }
+
+    int         id_{0};
+    std::string venue_;
+    double      price_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(trade_event, id_, venue_, price_);
+};
+}  // namespace test
+
+//=============================================================================
+// Record Log Tests
+//=============================================================================
+
+class RecordLogTest : public ::testing::Test
+{
+protected:
+    std::string path;
+
+    // One file per test, so that tests can run in parallel
+    void SetUp() override
+    {
+        path = std::string("test_record_log_") +
+               ::testing::UnitTest::GetInstance()->current_test_info()->name() + ".bin";
+        std::filesystem::remove(path);
+    }
+
+    void TearDown() override { std::filesystem::remove(path); }
+
+    void write_events(int first, int count, serialization::record_log_options options = {})
+    {
+        serialization::record_log_writer log(path, options);
+        for (int i = first; i < first + count; ++i)
+        {
+            serialization::multi_process_stream buffer;
+            serialization::save(buffer, test::trade_event(i, "XLON", 100.0 + i));
+            log.Append(buffer);
+        }
+    }
+
+    std::vector<int> read_ids(serialization::record_log_reader::mode m)
+    {
+        serialization::record_log_reader    log(path, m);
+        serialization::multi_process_stream buffer;
+        std::vector<int>                    ids;
+        while (log.Next(buffer))
+        {
+            test::trade_event event;
+            serialization::load(buffer, event);
+            EXPECT_EQ(event.price_, 100.0 + event.id_);
+            ids.push_back(event.id_);
+        }
+        return ids;
+    }
+
+    static std::vector<int> iota(int count)
+    {
+        std::vector<int> ids(count);
+        for (int i = 0; i < count; ++i)
+        {
+            ids[i] = i;
+        }
+        return ids;
+    }
+};
+
+TEST_F(RecordLogTest, AppendAndRead)
+{
+    write_events(0, 1000, {.sync_every_records = 100});
+
+    EXPECT_EQ(read_ids(serialization::record_log_reader::mode::mapped), iota(1000));
+    EXPECT_EQ(read_ids(serialization::record_log_reader::mode::sequential), iota(1000));
+
+    serialization::record_log_reader log(path);
+    std::span<const unsigned char>   record;
+    while (log.Next(record))
+    {
+    }
+    EXPECT_FALSE(log.Corrupt());
+    EXPECT_EQ(log.ValidSize(), std::filesystem::file_size(path));
+}
+
+TEST_F(RecordLogTest, ReopenAppends)
+{
+    write_events(0, 10);
+    write_events(10, 5, {.sync_every_records = 0});
+
+    serialization::record_log_writer log(path);
+    EXPECT_EQ(log.RecordCount(), 15u);
+    EXPECT_EQ(log.TruncatedBytes(), 0u);
+    EXPECT_EQ(read_ids(serialization::record_log_reader::mode::mapped), iota(15));
+}
+
+TEST_F(RecordLogTest, RecoveryTruncatesTornFrame)
+{
+    write_events(0, 20);
+    const auto good_size = std::filesystem::file_size(path);
+
+    // A crash in the middle of an append leaves a partial frame behind
+    write_events(20, 1);
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+
+    serialization::record_log_reader reader(path);
+    std::span<const unsigned char>   record;
+    int                              count = 0;
+    while (reader.Next(record))
+    {
+        ++count;
+    }
+    EXPECT_EQ(count, 20);
+    EXPECT_TRUE(reader.Corrupt());
+    EXPECT_EQ(reader.ValidSize(), good_size);
+
+    // Reopening truncates the torn frame and appends after the last good one
+    {
+        serialization::record_log_writer log(path);
+        EXPECT_EQ(log.RecordCount(), 20u);
+        EXPECT_GT(log.TruncatedBytes(), 0u);
+        EXPECT_EQ(std::filesystem::file_size(path), good_size);
+    }
+    write_events(20, 5);
+    EXPECT_EQ(read_ids(serialization::record_log_reader::mode::sequential), iota(25));
+}
+
+TEST_F(RecordLogTest, ChecksumStopsAtCorruptFrame)
+{
+    write_events(0, 10);
+
+    // Flip one byte in the payload of the fourth record
+    std::vector<unsigned char> bytes;
+    {
+        std::ifstream in(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(in), {});
+    }
+    serialization::record_log_reader reader(path);
+    std::span<const unsigned char>   record;
+    for (int i = 0; i < 3; ++i)
+    {
+        ASSERT_TRUE(reader.Next(record));
+    }
+    bytes[reader.ValidSize() + serialization::record_log_reader::FrameHeaderSize + 2] ^= 0x40;
+    {
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+    }
+
+    EXPECT_EQ(read_ids(serialization::record_log_reader::mode::mapped), iota(3));
+    EXPECT_EQ(serialization::record_log_reader::Recover(path), 3u);
+    EXPECT_EQ(read_ids(serialization::record_log_reader::mode::sequential), iota(3));
+}
+
+TEST_F(RecordLogTest, RejectsOtherFiles)
+{
+    {
+        std::ofstream out(path);
+        out << "not a record log";
+    }
+    EXPECT_THROW(serialization::record_log_writer log(path), serialization::serialization_error);
+    EXPECT_FALSE(serialization::record_log_reader(path).IsOpen());
+    EXPECT_FALSE(serialization::record_log_reader("missing_record_log.bin").IsOpen());
+}
+
+#if !defined(_WIN32)
+namespace
+{
+// Writes past the file size limit fail with EFBIG once SIGXFSZ is ignored
+void fail_next_write(serialization::record_log_writer& log)
+{
+    rlimit previous{};
+    ASSERT_EQ(::getrlimit(RLIMIT_FSIZE, &previous), 0);
+    rlimit limit   = previous;
+    limit.rlim_cur = 64;
+    const auto handler = std::signal(SIGXFSZ, SIG_IGN);
+    ASSERT_EQ(::setrlimit(RLIMIT_FSIZE, &limit), 0);
+
+    log.Append(std::vector<unsigned char>(256, 2));
+    EXPECT_THROW(log.Flush(), serialization::serialization_error);
+
+    ::setrlimit(RLIMIT_FSIZE, &previous);
+    std::signal(SIGXFSZ, handler);
+}
+
+serialization::record_log_options unbuffered_sync()
+{
+    serialization::record_log_options options;
+    options.sync_every_records = 0;
+    options.sync_every_bytes   = 0;
+    options.buffer_bytes       = std::size_t{1} << 20;
+    return options;
+}
+}  // namespace
+
+TEST_F(RecordLogTest, FailedWriteClosesWriter)
+{
+    serialization::record_log_writer log(path, unbuffered_sync());
+    log.Append(std::vector<unsigned char>(16, 1));
+    log.Sync();
+    fail_next_write(log);
+
+    EXPECT_THROW(
+        log.Append(std::vector<unsigned char>(16, 3)), serialization::serialization_error);
+    EXPECT_THROW(log.Sync(), serialization::serialization_error);
+    EXPECT_THROW(log.Flush(), serialization::serialization_error);
+
+    // Only the record written before the failure survives recovery
+    serialization::record_log_writer reopened(path);
+    EXPECT_EQ(reopened.RecordCount(), 1u);
+}
+
+TEST_F(RecordLogTest, AppenderDestructorDropsErrors)
+{
+    serialization::record_log_writer log(path, unbuffered_sync());
+    fail_next_write(log);
+
+    {
+        serialization::concurrent_record_appender appender(log);
+        appender.Append(std::vector<unsigned char>(16, 1));
+        EXPECT_THROW(appender.Flush(), serialization::serialization_error);
+
+        // Left for the destructor, which must not throw
+        appender.Append(std::vector<unsigned char>(16, 2));
+    }
+    SUCCEED();
+}
+#endif
+
+TEST_F(RecordLogTest, AccessHelpers)
+{
+    {
+        serialization::record_log_writer log(path);
+        for (int i = 0; i < 3; ++i)
+        {
+            serialization::serialization_impl::access::append_to_binary_log(
+                log, serialization::util::make_ptr_const<test::trade_event>(i, "XPAR", 1.5 * i));
+        }
+    }
+
+    const auto events =
+        serialization::serialization_impl::access::read_from_binary_log<test::trade_event>(path);
+    ASSERT_EQ(events.size(), 3u);
+    EXPECT_EQ(events[2]->id_, 2);
+    EXPECT_EQ(events[2]->venue_, "XPAR");
+}
+
+TEST_F(RecordLogTest, ConcurrentAppend)
+{
+    constexpr int threads = 8;
+    constexpr int count   = 2000;
+    {
+        serialization::record_log_writer log(path, {.sync_every_records = 0});
+        // A small ring makes writers wrap around and wait for the drain
+        serialization::concurrent_record_appender appender(log, 4096);
+        EXPECT_EQ(appender.Capacity(), 4096u);
+
+        std::vector<std::thread> workers;
+        for (int t = 0; t < threads; ++t)
+        {
+            workers.emplace_back(
+                [&appender, t]
+                {
+                    for (int i = 0; i < count; ++i)
+                    {
+                        const int id = t * count + i;
+                        serialization::serialization_impl::access::append_to_binary_log(
+                            appender,
+                            serialization::util::make_ptr_const<test::trade_event>(
+                                id, "XLON", 100.0 + id));
+                    }
+                });
+        }
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+        appender.Flush();
+        EXPECT_EQ(log.RecordCount(), static_cast<size_t>(threads * count));
+    }
+
+    // Every record arrives intact and each thread's records keep their order
+    std::map<int, int> last;
+    int                total = 0;
+    for (const auto& event :
+         serialization::serialization_impl::access::read_from_binary_log<test::trade_event>(path))
+    {
+        EXPECT_EQ(event->price_, 100.0 + event->id_);
+        const int  thread   = event->id_ / count;
+        const auto previous = last.find(thread);
+        EXPECT_TRUE(previous == last.end() || previous->second < event->id_);
+        last[thread] = event->id_;
+        ++total;
+    }
+    EXPECT_EQ(total, threads * count);
+    EXPECT_EQ(serialization::record_log_reader::Recover(path), static_cast<size_t>(total));
+}
+
+TEST_F(RecordLogTest, ConcurrentAppendLargeRecords)
+{
+    {
+        serialization::record_log_writer          log(path);
+        serialization::concurrent_record_appender appender(log, 256);
+        for (int i = 0; i < 10; ++i)
+        {
+            // Records alternate between fitting the ring and bypassing it
+            serialization::multi_process_stream buffer;
+            serialization::save(
+                buffer, test::trade_event(i, std::string(i % 2 == 0 ? 8 : 400, 'X'), 100.0 + i));
+            appender.Append(buffer);
+        }
+    }
+    EXPECT_EQ(read_ids(serialization::record_log_reader::mode::mapped), iota(10));
+}
@@ -0,0 +1,198 @@
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization.h"
+#include "serialization_impl.h"
+#include "serialization_profile.h"
+#include "util/multi_process_stream.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class fee
+{
+public:
+    fee() = default;
+    fee(std::string currency, double amount) : currency_(std::move(currency)), amount_(amount) {}
+    virtual ~fee() = default;
+
+    std::string currency_;
+    double      amount_{0};
+
+protected:
+    void initialize() {}
+    SERIALIZATION_MACRO(fee, currency_, amount_);
+};
+
+class tiered_fee final : public fee
+{
+public:
+    tiered_fee() = default;
+    tiered_fee(std::string currency, double amount, std::vector<double> tiers)
+        : fee(std::move(currency), amount), tiers_(std::move(tiers))
+    {
+    }
+
+    std::vector<double> tiers_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO_DERIVED(tiered_fee, fee, tiers_);
+};
+
+class trade
+{
+public:
+    std::string                       id_;
+    std::vector<int64_t>              fills_;
+    std::map<std::string, double>     limits_;
+    std::vector<std::shared_ptr<fee>> fees_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(trade, id_, fills_, limits_, fees_);
+};
+
+SERIALIZATION_REGISTER_DERIVED_SERIALIZATION(tiered_fee);
+}  // namespace test
+
+//=============================================================================
+// Size Profile Tests
+//=============================================================================
+
+class SizeProfileTest : public ::testing::Test
+{
+protected:
+    test::trade rhs;
+
+    void SetUp() override
+    {
+        rhs.id_ = "T-1";
+        for (int i = 0; i < 100; ++i)
+        {
+            rhs.fills_.push_back(1'000'000 + i);
+        }
+        rhs.limits_ = {{"daily", 1e6}, {"single", 5e4}};
+        rhs.fees_.push_back(std::make_shared<test::fee>("EUR", 1.5));
+        rhs.fees_.push_back(std::make_shared<test::fee>("USD", 2.5));
+        rhs.fees_.push_back(
+            std::make_shared<test::tiered_fee>("EUR", 3.5, std::vector<double>{0.1, 0.2}));
+        rhs.fees_.push_back(nullptr);
+    }
+
+    // Every node's children account for at most its own bytes
+    static void expect_consistent(const serialization::size_profile_node& node)
+    {
+        std::size_t children = 0;
+        for (const auto& child : node.children)
+        {
+            children += child.bytes;
+            expect_consistent(child);
+        }
+        EXPECT_LE(children, node.bytes) << node.name;
+        EXPECT_EQ(node.self_bytes(), node.bytes - children);
+    }
+};
+
+TEST_F(SizeProfileTest, AttributesMembers)
+{
+    const auto profile = serialization::profile_size(rhs);
+
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+    EXPECT_EQ(profile.bytes, buffer.Size());
+    expect_consistent(profile);
+
+    const auto* object = profile.find("test::trade");
+    ASSERT_NE(object, nullptr);
+    EXPECT_EQ(object->bytes, profile.bytes);
+    EXPECT_EQ(object->count, 1u);
+
+    const auto* class_name = object->find("(class name)");
+    ASSERT_NE(class_name, nullptr);
+    EXPECT_EQ(class_name->bytes, 2 + std::string("test::trade").size());
+
+    // Members, class name and nothing else make up the object
+    std::size_t members = 0;
+    for (const auto* name : {"(class name)", "id_", "fills_", "limits_", "fees_"})
+    {
+        const auto* member = object->find(name);
+        ASSERT_NE(member, nullptr) << name;
+        members += member->bytes;
+    }
+    EXPECT_EQ(members, object->bytes);
+
+    // 100 tagged int64 values behind a length
+    const auto* fills = object->find("fills_");
+    ASSERT_NE(fills->find("(length)"), nullptr);
+    EXPECT_EQ(fills->find("(length)")->bytes, 2u);
+    EXPECT_EQ(fills->self_bytes(), 100u * 9);
+}
+
+TEST_F(SizeProfileTest, MergesElementsByDynamicType)
+{
+    const auto  profile = serialization::profile_size(rhs);
+    const auto* fees    = profile.find("test::trade")->find("fees_");
+    ASSERT_NE(fees, nullptr);
+
+    const auto* base = fees->find("test::fee");
+    ASSERT_NE(base, nullptr);
+    EXPECT_EQ(base->count, 2u);
+    EXPECT_EQ(base->find("currency_")->count, 2u);
+
+    const auto* derived = fees->find("test::tiered_fee");
+    ASSERT_NE(derived, nullptr);
+    EXPECT_EQ(derived->count, 1u);
+    ASSERT_NE(derived->find("tiers_"), nullptr);
+
+    // Pointer class names of all four elements, including the null one
+    EXPECT_EQ(fees->find("(class name)")->count, 4u);
+
+    const auto report = serialization::format_size_profile(profile);
+    EXPECT_NE(report.find("test::tiered_fee"), std::string::npos);
+    EXPECT_NE(report.find("fills_"), std::string::npos);
+    EXPECT_LT(report.find("fills_"), report.find("id_"));
+}
+
+TEST_F(SizeProfileTest, DictionaryShrinksClassNames)
+{
+    const auto plain      = serialization::profile_size(rhs);
+    const auto dictionary = serialization::profile_size(rhs, true);
+    EXPECT_LT(dictionary.bytes, plain.bytes);
+
+    const auto class_names = [](const serialization::size_profile_node& profile)
+    { return profile.find("test::trade")->find("fees_")->find("test::fee")->find("(class name)"); };
+    EXPECT_LT(class_names(dictionary)->bytes, class_names(plain)->bytes);
+}
+
+TEST_F(SizeProfileTest, DetachedStreamIsNotProfiled)
+{
+    serialization::size_profiler        profiler("trade");
+    serialization::multi_process_stream buffer;
+    buffer.SetSizeProfiler(&profiler);
+    serialization::save(buffer, rhs);
+
+    // Copies do not inherit the profiler
+    serialization::multi_process_stream copy(buffer);
+    EXPECT_EQ(copy.SizeProfiler(), nullptr);
+    serialization::save(copy, rhs);
+
+    buffer.SetSizeProfiler(nullptr);
+    serialization::save(buffer, rhs);
+    profiler.Finish(buffer.Size());
+
+    EXPECT_EQ(profiler.Root().find("test::trade")->count, 1u);
+
+    test::trade lhs;
+    serialization::load(copy, lhs);
+    EXPECT_EQ(lhs.fills_, rhs.fills_);
+}
@@ -0,0 +1,516 @@
+#include <gtest/gtest.h>
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "common/transcoder.h"
+#include "serialization.h"
+#include "serialization_impl.h"
+#include "serialization_iterative.h"
+#include "serialization_schema.h"
+#include "util/multi_process_stream.h"
+#include "util/pointer.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+enum class side
+{
+    buy,
+    sell
+};
+
+class leg
+{
+public:
+    leg() = default;
+    leg(std::string venue, double price) : venue_(std::move(venue)), price_(price) {}
+
+    virtual ~leg() = default;
+
+    std::string venue_;
+    double      price_{0};
+
+protected:
+    void initialize() {}
+    SERIALIZATION_MACRO(leg, venue_, price_);
+    SERIALIZATION_FIELD_ENCODINGS(
+        serialization::encode("price_", serialization::encoding::fixed_point(4)));
+};
+
+class option_leg final : public leg
+{
+public:
+    option_leg() = default;
+    option_leg(std::string venue, double price, double strike)
+        : leg(std::move(venue), price), strike_(strike)
+    {
+    }
+
+    double strike_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO_DERIVED(option_leg, leg, strike_);
+};
+
+SERIALIZATION_REGISTER_DERIVED_SERIALIZATION(option_leg);
+
+class order
+{
+public:
+    order() = default;
+
+    std::string                                    id_;
+    int                                            quantity_{0};
+    uint64_t                                       sequence_{0};
+    short                                          flags_{0};
+    float                                          ratio_{0};
+    bool                                           active_{false};
+    side                                           side_{side::buy};
+    std::vector<std::string>                       tags_;
+    std::map<std::string, int>                     limits_;
+    std::optional<double>                          stop_;
+    std::optional<double>                          target_;
+    std::variant<std::monostate, int, std::string> note_;
+    std::pair<int, std::string>                    desk_;
+    std::unique_ptr<leg>                           primary_;
+    std::vector<std::shared_ptr<leg>>              legs_;
+    std::shared_ptr<leg>                           hedge_;
+    std::vector<int64_t>                           timestamps_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(
+        order,
+        id_,
+        quantity_,
+        sequence_,
+        flags_,
+        ratio_,
+        active_,
+        side_,
+        tags_,
+        limits_,
+        stop_,
+        target_,
+        note_,
+        desk_,
+        primary_,
+        legs_,
+        hedge_,
+        timestamps_);
+    SERIALIZATION_FIELD_ENCODINGS(
+        serialization::encode("timestamps_", serialization::encoding::delta_of_delta()));
+};
+
+class venue_status
+{
+public:
+    bool              open_{false};
+    side              side_{side::buy};
+    bool              halted_{false};
+    std::vector<bool> sessions_;
+    std::bitset<12>   months_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(venue_status, open_, side_, halted_, sessions_, months_);
+    SERIALIZATION_FIELD_ENCODINGS(serialization::encode("side_", serialization::encoding::bits(1)));
+};
+
+class chain_node
+{
+public:
+    int                         value_{0};
+    std::shared_ptr<chain_node> next_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(chain_node, value_, next_);
+};
+
+inline std::shared_ptr<order> make_order()
+{
+    auto o        = std::make_shared<order>();
+    o->id_        = "ORD-1 \"quoted\"\n\ttabbed";
+    o->quantity_  = -250;
+    o->sequence_  = 1ull << 40;
+    o->flags_     = -3;
+    o->ratio_     = 0.5f;
+    o->active_    = true;
+    o->side_      = side::sell;
+    o->tags_      = {"EUR", "swap", "EUR"};
+    o->limits_    = {{"daily", 1000}, {"single", 50}};
+    o->stop_      = 99.25;
+    o->note_      = std::string("urgent");
+    o->desk_      = {7, "London"};
+    o->primary_   = std::make_unique<leg>("XLON", 101.125);
+    o->legs_      = {
+        std::make_shared<leg>("XPAR", 1.5), std::make_shared<option_leg>("XEUR", 2.25, 95.0)};
+    for (int i = 0; i < 300; ++i)
+    {
+        o->timestamps_.push_back(1'700'000'000'000 + 250 * i + (i % 7));
+    }
+    return o;
+}
+}  // namespace test
+
+//=============================================================================
+// Transcoder Tests
+//=============================================================================
+
+class TranscoderTest : public ::testing::Test
+{
+protected:
+    using access = serialization::serialization_impl::access;
+
+    serialization::ptr_const<test::order> rhs = test::make_order();
+    serialization::json                   schema =
+        serialization::export_schema<serialization::ptr_const<test::order>, test::option_leg>();
+
+    std::string binary() const
+    {
+        const auto bytes = access::binary_serialize(rhs);
+        return {bytes.begin(), bytes.end()};
+    }
+
+    // Sizes written by the transcoder are padded, so archives are compared by content
+    static std::string reserialized(const std::string& archive)
+    {
+        const auto object = access::binary_deserialize<test::order>(
+            std::vector<unsigned char>(archive.begin(), archive.end()));
+        const auto bytes = access::binary_serialize(object);
+        return {bytes.begin(), bytes.end()};
+    }
+};
+
+TEST_F(TranscoderTest, SchemaDescribesFields)
+{
+    EXPECT_EQ(schema["root"], serialization::json({{"pointer", "test::order"}}));
+
+    const auto& fields = schema["types"]["test::order"]["fields"];
+    ASSERT_EQ(fields.size(), 17u);
+    EXPECT_EQ(fields[0]["name"], "id_");
+    EXPECT_EQ(fields[0]["type"], "string");
+    EXPECT_EQ(fields[16]["encoding"]["kind"], "delta_of_delta");
+    EXPECT_TRUE(schema["types"].contains("test::option_leg"));
+    EXPECT_EQ(schema["types"]["test::leg"]["fields"][1]["encoding"]["digits"], 4);
+}
+
+TEST_F(TranscoderTest, BinaryToJson)
+{
+    std::istringstream in(binary());
+    std::ostringstream out;
+    serialization::transcode_to_json(in, out, &schema);
+
+    serialization::json expected;
+    access::json_serialize(expected, rhs);
+    EXPECT_EQ(serialization::json::parse(out.str()), expected);
+
+    // The result loads as an ordinary JSON archive
+    serialization::ptr_const<test::order> lhs;
+    access::json_deserialize(serialization::json::parse(out.str()), lhs);
+    ASSERT_NE(lhs, nullptr);
+    EXPECT_EQ(lhs->id_, rhs->id_);
+    EXPECT_EQ(lhs->timestamps_, rhs->timestamps_);
+    EXPECT_NE(std::dynamic_pointer_cast<const test::option_leg>(lhs->legs_[1]), nullptr);
+}
+
+TEST_F(TranscoderTest, JsonToBinary)
+{
+    serialization::json document;
+    access::json_serialize(document, rhs);
+
+    // A buffer smaller than the archive forces sizes to be patched on the stream
+    for (const std::size_t buffer_bytes : {std::size_t{1} << 20, std::size_t{64}})
+    {
+        std::istringstream in(document.dump(2));
+        std::stringstream  out;
+        serialization::transcode_to_binary(in, out, schema, {.buffer_bytes = buffer_bytes});
+        EXPECT_EQ(reserialized(out.str()), binary());
+    }
+}
+
+TEST_F(TranscoderTest, RoundTripWithSmallBuffers)
+{
+    const serialization::transcode_options options{.indent = 1, .buffer_bytes = 64};
+
+    std::istringstream binary_in(binary());
+    std::stringstream  json_out;
+    serialization::transcode_to_json(binary_in, json_out, &schema, options);
+
+    std::stringstream binary_out;
+    serialization::transcode_to_binary(json_out, binary_out, schema, options);
+    EXPECT_EQ(reserialized(binary_out.str()), binary());
+}
+
+TEST_F(TranscoderTest, DictionaryStrings)
+{
+    serialization::multi_process_stream buffer;
+    buffer.EnableStringDictionary(true);
+    serialization::save(buffer, rhs);
+    const auto bytes = buffer.GetRawData();
+
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    std::ostringstream out;
+    serialization::transcode_to_json(in, out, &schema);
+
+    serialization::json expected;
+    access::json_serialize(expected, rhs);
+    EXPECT_EQ(serialization::json::parse(out.str()), expected);
+}
+
+TEST_F(TranscoderTest, WithoutSchema)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, 42);
+    serialization::save(buffer, std::string("label"));
+    serialization::save(buffer, 2.5);
+    buffer.PushBits(0x5, 3);
+    const auto bytes = buffer.GetRawData();
+
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    std::ostringstream out;
+    serialization::transcode_to_json(in, out);
+    EXPECT_EQ(
+        serialization::json::parse(out.str()),
+        serialization::json::parse(R"({"values": [42, "label", 2.5, true, false, true]})"));
+}
+
+TEST_F(TranscoderTest, Mismatches)
+{
+    // Members out of save() order
+    serialization::json document;
+    access::json_serialize(document, rhs);
+    auto& root = document["root"];
+    root.erase("quantity_");
+    root["quantity_"] = 1;
+
+    std::istringstream json_in(document.dump());
+    std::ostringstream binary_out;
+    EXPECT_THROW(
+        serialization::transcode_to_binary(json_in, binary_out, schema),
+        serialization::serialization_error);
+
+    // Truncated binary archive
+    auto               truncated = binary();
+    std::istringstream binary_in(truncated.substr(0, truncated.size() / 2));
+    std::ostringstream json_out;
+    EXPECT_THROW(
+        serialization::transcode_to_json(binary_in, json_out, &schema),
+        serialization::serialization_error);
+
+    // Derived class missing from the schema
+    const auto partial = serialization::export_schema<serialization::ptr_const<test::order>>();
+    std::istringstream derived_in(binary());
+    EXPECT_THROW(
+        serialization::transcode_to_json(derived_in, json_out, &partial),
+        serialization::serialization_error);
+}
+
+TEST_F(TranscoderTest, EscapedStrings)
+{
+    const std::string text =
+        std::string(50, 'a') + "\"quoted\"\tand\\slashed\x01" + std::string(50, 'b') + "\xc3\xa9";
+    const auto string_schema = serialization::export_schema<std::string>();
+
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, text);
+    const auto bytes = buffer.GetRawData();
+
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    std::ostringstream out;
+    serialization::transcode_to_json(in, out, &string_schema, {.buffer_bytes = 64});
+    EXPECT_EQ(out.str(), serialization::json({{"root", text}}).dump());
+
+    // Strings longer than the input buffer are read back in runs
+    std::istringstream json_in(out.str());
+    std::stringstream  binary_out;
+    serialization::transcode_to_binary(json_in, binary_out, string_schema, {.buffer_bytes = 64});
+    serialization::multi_process_stream loaded;
+    const auto                          archive = binary_out.str();
+    loaded.SetRawData(std::vector<unsigned char>(archive.begin(), archive.end()));
+    std::string result;
+    serialization::load(loaded, result);
+    EXPECT_EQ(result, text);
+}
+
+TEST_F(TranscoderTest, RejectsInvalidText)
+{
+    const auto string_schema = serialization::export_schema<std::string>();
+
+    // JSON requires UTF-8, so binary strings holding other bytes cannot be written
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, std::string("caf\xe9"));
+    const auto         bytes = buffer.GetRawData();
+    std::istringstream binary_in(std::string(bytes.begin(), bytes.end()));
+    std::ostringstream json_out;
+    EXPECT_THROW(
+        serialization::transcode_to_json(binary_in, json_out, &string_schema),
+        serialization::serialization_error);
+
+    for (const std::string document : {"{\"root\": \"caf\xe9\"}", "{\"root\": \"tab\there\"}"})
+    {
+        std::istringstream json_in(document);
+        std::ostringstream binary_out;
+        EXPECT_THROW(
+            serialization::transcode_to_binary(json_in, binary_out, string_schema),
+            serialization::serialization_error);
+    }
+}
+
+TEST_F(TranscoderTest, ByteContainers)
+{
+    const std::vector<unsigned char> rhs{0, 1, 2, 253, 254, 255, 'x'};
+    const auto bytes_schema = serialization::export_schema<std::vector<unsigned char>>();
+    EXPECT_EQ(bytes_schema["root"], serialization::json({{"bytes", "uchar"}}));
+
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, rhs);
+    const auto         bytes = buffer.GetRawData();
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    std::ostringstream out;
+    serialization::transcode_to_json(in, out, &bytes_schema);
+
+    serialization::json expected;
+    serialization::save(expected["root"], rhs);
+    EXPECT_EQ(serialization::json::parse(out.str()), expected);
+
+    // Both the base64 string and the array layout convert back
+    const auto        enum_schema = serialization::export_schema<std::vector<std::byte>>();
+    const std::string array       = R"({"root": [0, 1, 2, 253, 254, 255, 120]})";
+    for (const std::string& document : {out.str(), array})
+    {
+        std::istringstream json_in(document);
+        std::stringstream  binary_out;
+        serialization::transcode_to_binary(json_in, binary_out, enum_schema);
+        const auto archive = binary_out.str();
+
+        serialization::multi_process_stream loaded;
+        loaded.SetRawData(std::vector<unsigned char>(archive.begin(), archive.end()));
+        std::vector<std::byte> result;
+        serialization::load(loaded, result);
+        ASSERT_EQ(result.size(), rhs.size());
+        EXPECT_EQ(static_cast<unsigned char>(result[3]), 253);
+    }
+}
+
+TEST_F(TranscoderTest, PackedBits)
+{
+    test::venue_status status;
+    status.open_     = true;
+    status.side_     = test::side::sell;
+    status.sessions_ = {true, false, false, true, true, false, true, true, false, true};
+    status.months_.set(0).set(11);
+
+    const auto status_schema = serialization::export_schema<test::venue_status>();
+    const auto& fields       = status_schema["types"]["test::venue_status"]["fields"];
+    EXPECT_EQ(fields[1]["encoding"], serialization::json({{"kind", "bits"}, {"width", 1}}));
+    EXPECT_EQ(fields[4]["type"], serialization::json({{"sequence", "bool"}}));
+
+    serialization::multi_process_stream buffer;
+    buffer.EnableBitPacking(true);
+    serialization::save(buffer, status);
+    const auto         bytes = buffer.GetRawData();
+    std::istringstream in(std::string(bytes.begin(), bytes.end()));
+    std::ostringstream out;
+    serialization::transcode_to_json(in, out, &status_schema);
+
+    const auto document = serialization::json::parse(out.str());
+    EXPECT_EQ(document["root"]["open_"], true);
+    EXPECT_EQ(document["root"]["sessions_"].size(), status.sessions_.size());
+    EXPECT_EQ(document["root"]["months_"][11], true);
+
+    std::istringstream json_in(out.str());
+    std::stringstream  binary_out;
+    serialization::transcode_to_binary(json_in, binary_out, status_schema);
+    const auto archive = binary_out.str();
+
+    serialization::multi_process_stream loaded;
+    loaded.SetRawData(std::vector<unsigned char>(archive.begin(), archive.end()));
+    test::venue_status result;
+    serialization::load(loaded, result);
+    EXPECT_TRUE(result.open_);
+    EXPECT_EQ(result.side_, test::side::sell);
+    EXPECT_FALSE(result.halted_);
+    EXPECT_EQ(result.sessions_, status.sessions_);
+    EXPECT_EQ(result.months_, status.months_);
+}
+
+TEST_F(TranscoderTest, DeepNesting)
+{
+    using error_code = serialization::serialization_error::error_code;
+    const auto chain_schema =
+        serialization::export_schema<serialization::ptr_const<test::chain_node>>();
+    const auto error_of = [](const auto& transcode)
+    {
+        try
+        {
+            transcode();
+        }
+        catch (const serialization::serialization_error& error)
+        {
+            return error.code();
+        }
+        return error_code::none;
+    };
+
+    // A list too deep for the recursive save(), written by save_iterative()
+    constexpr int                     length = 100000;
+    std::shared_ptr<test::chain_node> head;
+    for (int i = length - 1; i >= 0; --i)
+    {
+        auto node    = std::make_shared<test::chain_node>();
+        node->value_ = i;
+        node->next_  = std::move(head);
+        head         = std::move(node);
+    }
+    serialization::multi_process_stream buffer;
+    serialization::save_iterative(buffer, serialization::ptr_const<test::chain_node>(head));
+    while (head)
+    {
+        head = std::move(head->next_);
+    }
+
+    const auto         bytes = buffer.GetRawData();
+    std::istringstream binary_in(std::string(bytes.begin(), bytes.end()));
+    std::ostringstream json_out;
+    EXPECT_EQ(
+        error_of([&] { serialization::transcode_to_json(binary_in, json_out, &chain_schema); }),
+        error_code::recursion_limit);
+
+    std::string document = R"({"root":)";
+    for (int i = 0; i < length; ++i)
+    {
+        document += R"({"Class":"test::chain_node","value_":0,"next_":)";
+    }
+    document += R"({"Class":"null object!"})" + std::string(length, '}') + "}";
+    std::istringstream json_in(document);
+    std::ostringstream binary_out;
+    EXPECT_EQ(
+        error_of([&] { serialization::transcode_to_binary(json_in, binary_out, chain_schema); }),
+        error_code::recursion_limit);
+
+    // Lists within the limit still convert
+    std::istringstream shallow_in(
+        R"({"root":{"Class":"test::chain_node","value_":1,"next_":{"Class":"null object!"}}})");
+    std::stringstream shallow_out;
+    serialization::transcode_to_binary(shallow_in, shallow_out, chain_schema);
+    EXPECT_EQ(
+        error_of([&] { serialization::transcode_to_json(shallow_out, json_out, &chain_schema); }),
+        error_code::none);
+}
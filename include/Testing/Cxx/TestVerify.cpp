@@ -0,0 +1,218 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "common/serialization_macros.h"
+#include "serialization_impl.h"
+#include "serialization_verify.h"
+#include "util/multi_process_stream.h"
+
+//=============================================================================
+// Test Classes
+//=============================================================================
+
+namespace test
+{
+class leg
+{
+public:
+    leg() = default;
+
+    std::string currency_;
+    double      notional_{0};
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(leg, currency_, notional_);
+};
+
+class swap_trade
+{
+public:
+    swap_trade() = default;
+
+    std::string                    id_;
+    std::vector<double>            rates_;
+    std::map<std::string, int>     counts_;
+    std::optional<int>             cap_;
+    std::variant<int, std::string> book_;
+    std::unique_ptr<leg>           pay_;
+    std::shared_ptr<const leg>     receive_;
+    std::bitset<10>                days_;
+    std::vector<bool>              holidays_;
+    std::tuple<int, std::string>   desk_;
+    std::array<int, 3>             tenor_;
+    std::pair<bool, bool>          flags_;
+    std::vector<int64_t>           fixings_;
+
+private:
+    void initialize() {}
+    SERIALIZATION_MACRO(
+        swap_trade,
+        id_,
+        rates_,
+        counts_,
+        cap_,
+        book_,
+        pay_,
+        receive_,
+        days_,
+        holidays_,
+        desk_,
+        tenor_,
+        flags_,
+        fixings_);
+    SERIALIZATION_FIELD_ENCODINGS(
+        serialization::encode("fixings_", serialization::encoding::delta_of_delta()));
+};
+
+inline swap_trade make_swap(int i)
+{
+    swap_trade s;
+    s.id_       = "SWP" + std::to_string(i);
+    s.rates_    = {0.01 * i, 0.02, 0.03};
+    s.counts_   = {{"fixed", i}, {"float", 2}};
+    s.cap_      = i % 2 == 0 ? std::optional<int>(i) : std::nullopt;
+    s.book_     = i % 3 == 0 ? std::variant<int, std::string>("rates") : i;
+    s.pay_      = std::make_unique<leg>();
+    s.receive_  = i % 4 == 0 ? nullptr : std::make_shared<const leg>(leg{});
+    s.days_     = std::bitset<10>(0x2a5u + i);
+    s.holidays_ = {true, false, i % 2 == 0};
+    s.desk_     = {i, "London"};
+    s.tenor_    = {1, 5, 10};
+    s.flags_    = {true, i % 2 == 0};
+    s.fixings_  = {1'700'000'000 + i, 1'700'000'060 + i, 1'700'000'120 + i};
+    return s;
+}
+}  // namespace test
+
+//=============================================================================
+// Verify Tests
+//=============================================================================
+
+class VerifyTest : public ::testing::Test
+{
+protected:
+    std::vector<test::swap_trade> rhs = []
+    {
+        std::vector<test::swap_trade> trades;
+        for (int i = 0; i < 8; ++i)
+        {
+            trades.push_back(test::make_swap(i));
+        }
+        return trades;
+    }();
+
+    std::vector<unsigned char> encode(bool dictionary, bool bits)
+    {
+        serialization::multi_process_stream buffer;
+        buffer.EnableStringDictionary(dictionary);
+        buffer.EnableBitPacking(bits);
+        serialization::save(buffer, rhs);
+        return buffer.GetRawData();
+    }
+};
+
+TEST_F(VerifyTest, WellFormed)
+{
+    for (const bool dictionary : {false, true})
+    {
+        for (const bool bits : {false, true})
+        {
+            serialization::multi_process_stream buffer;
+            buffer.SetRawData(encode(dictionary, bits));
+            const auto size = buffer.Size();
+
+            EXPECT_TRUE(serialization::verify<std::vector<test::swap_trade>>(buffer));
+
+            // Nothing was consumed, so the archive loads as before
+            EXPECT_EQ(buffer.Size(), size);
+            std::vector<test::swap_trade> lhs;
+            ASSERT_TRUE(serialization::try_load(buffer, lhs));
+            ASSERT_EQ(lhs.size(), rhs.size());
+            EXPECT_EQ(lhs[5].id_, rhs[5].id_);
+            EXPECT_EQ(lhs[5].days_, rhs[5].days_);
+            EXPECT_EQ(lhs[5].fixings_, rhs[5].fixings_);
+            EXPECT_TRUE(buffer.Empty());
+        }
+    }
+}
+
+TEST_F(VerifyTest, Truncated)
+{
+    const auto data = encode(true, true);
+    for (std::size_t size = 0; size + 1 < data.size(); ++size)
+    {
+        std::vector<unsigned char> prefix(data.begin(), data.begin() + size);
+        prefix.push_back(data.back());
+
+        serialization::multi_process_stream buffer;
+        buffer.SetRawData(prefix);
+        EXPECT_FALSE(serialization::verify<std::vector<test::swap_trade>>(buffer)) << size;
+    }
+}
+
+TEST_F(VerifyTest, AgreesWithLoad)
+{
+    // Every corrupted byte is rejected by both or accepted by both
+    for (const bool dictionary : {false, true})
+    {
+        const auto data = encode(dictionary, true);
+        for (std::size_t i = 0; i + 1 < data.size(); ++i)
+        {
+            for (const unsigned char mask : {0x01, 0x80, 0xff})
+            {
+                auto corrupt = data;
+                corrupt[i] ^= mask;
+
+                serialization::multi_process_stream buffer;
+                buffer.SetRawData(corrupt);
+                const bool verified =
+                    serialization::verify<std::vector<test::swap_trade>>(buffer).has_value();
+
+                std::vector<test::swap_trade> lhs;
+                const bool loaded = serialization::try_load(buffer, lhs).has_value();
+                EXPECT_EQ(verified, loaded) << "byte " << i << " mask " << int(mask);
+            }
+        }
+    }
+}
+
+TEST_F(VerifyTest, Mismatches)
+{
+    serialization::multi_process_stream buffer;
+    serialization::save(buffer, std::vector<int>{1, 2, 3});
+    EXPECT_TRUE(serialization::verify<std::vector<int>>(buffer));
+
+    auto result = serialization::verify<std::vector<double>>(buffer);
+    ASSERT_FALSE(result);
+    using error_code = serialization::serialization_error::error_code;
+    EXPECT_EQ(result.error().code(), error_code::malformed_input);
+
+    result = serialization::verify<std::array<int, 4>>(buffer);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().code(), error_code::size_mismatch);
+
+    // Index 2 of a two-type variant
+    serialization::multi_process_stream variant;
+    serialization::save(variant, std::variant<int, double, std::string>("name"));
+    result = serialization::verify<std::variant<int, double>>(variant);
+    ASSERT_FALSE(result);
+    EXPECT_EQ(result.error().code(), error_code::invalid_index);
+
+    serialization::multi_process_stream bits;
+    serialization::save(bits, std::bitset<12>(0xabc));
+    EXPECT_TRUE(serialization::verify<std::bitset<12>>(bits));
+    EXPECT_TRUE(serialization::verify<std::vector<bool>>(bits));
+    EXPECT_FALSE(serialization::verify<std::bitset<13>>(bits));
+}
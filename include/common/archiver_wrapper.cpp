@@ -1,7 +1,15 @@
 #include "common/archiver_wrapper.h"
 
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
 #include "util/export.h"
 #include "util/registry.h"
+#include "util/string_util.h"
 
 namespace serialization
 {
@@ -19,4 +27,150 @@ SERIALIZATION_API SERIALIZATION_DEFINE_FUNCTION_REGISTRY(
 SERIALIZATION_API SERIALIZATION_DEFINE_FUNCTION_REGISTRY(
     BinarySerializationRegistry, binary_serialization_function_t);
 
+//=============================================================================
+// Polymorphic Type Table
+//=============================================================================
+
+namespace
+{
+/// @brief Entries registered since the last lookup, in reverse registration order
+constinit std::atomic<polymorphic_entry*> pending_entries{nullptr};
+
+/// @brief Number of entries ever registered
+constinit std::atomic<std::size_t> registered_entries{0};
+
+/// @brief Lookup tables over all registered entries, built outside static initialization
+struct polymorphic_index
+{
+    std::shared_mutex                                              mutex;
+    std::vector<const polymorphic_entry*>                          entries;
+    std::unordered_map<std::string_view, const polymorphic_entry*> by_name;
+    std::unordered_map<std::type_index, const polymorphic_entry*>  by_type;
+
+    // Demangled RTTI names, only needed to read archives written before type
+    // names were computed at compile time. Filled on the first name miss.
+    std::unordered_map<std::string, const polymorphic_entry*> by_rtti_name;
+    std::size_t                                               rtti_indexed = 0;
+};
+
+polymorphic_index& get_polymorphic_index()
+{
+    static auto* index = new polymorphic_index();
+    return *index;
+}
+
+bool has_pending_entries() noexcept
+{
+    return pending_entries.load(std::memory_order_acquire) != nullptr;
+}
+
+// Requires the unique lock.
+void drain_pending_entries(polymorphic_index& index)
+{
+    auto* entry = pending_entries.exchange(nullptr, std::memory_order_acquire);
+    for (; entry != nullptr; entry = entry->next)
+    {
+        index.entries.push_back(entry);
+        index.by_name.emplace(entry->name, entry);
+        index.by_type.emplace(std::type_index(*entry->type), entry);
+    }
+}
+
+// Requires the unique lock.
+void index_rtti_names(polymorphic_index& index)
+{
+    for (; index.rtti_indexed < index.entries.size(); ++index.rtti_indexed)
+    {
+        const auto* entry = index.entries[index.rtti_indexed];
+        index.by_rtti_name.emplace(demangle(entry->type->name()), entry);
+    }
+}
+
+const polymorphic_entry* find_by_name(const polymorphic_index& index, std::string_view name)
+{
+    if (auto it = index.by_name.find(name); it != index.by_name.end())
+    {
+        return it->second;
+    }
+
+    if (auto it = index.by_rtti_name.find(std::string(name)); it != index.by_rtti_name.end())
+    {
+        return it->second;
+    }
+
+    return nullptr;
+}
+}  // namespace
+
+bool register_polymorphic_entry(polymorphic_entry& entry) noexcept
+{
+    // The same inline entry may be registered from several translation units.
+    if (entry.linked.exchange(true, std::memory_order_relaxed))
+    {
+        return true;
+    }
+
+    auto* head = pending_entries.load(std::memory_order_relaxed);
+    do
+    {
+        entry.next = head;
+    } while (!pending_entries.compare_exchange_weak(
+        head, &entry, std::memory_order_release, std::memory_order_relaxed));
+
+    registered_entries.fetch_add(1, std::memory_order_release);
+    return true;
+}
+
+std::size_t polymorphic_entry_count() noexcept
+{
+    return registered_entries.load(std::memory_order_acquire);
+}
+
+const polymorphic_entry* find_polymorphic_entry(std::string_view name)
+{
+    auto& index = get_polymorphic_index();
+
+    if (!has_pending_entries())
+    {
+        std::shared_lock lock(index.mutex);
+        if (const auto* entry = find_by_name(index, name); entry != nullptr)
+        {
+            return entry;
+        }
+
+        if (index.rtti_indexed == index.entries.size())
+        {
+            return nullptr;
+        }
+    }
+
+    std::unique_lock lock(index.mutex);
+    drain_pending_entries(index);
+    if (const auto* entry = find_by_name(index, name); entry != nullptr)
+    {
+        return entry;
+    }
+
+    index_rtti_names(index);
+    return find_by_name(index, name);
+}
+
+const polymorphic_entry* find_polymorphic_entry(const std::type_info& type)
+{
+    auto&                 index = get_polymorphic_index();
+    const std::type_index key(type);
+
+    if (!has_pending_entries())
+    {
+        std::shared_lock lock(index.mutex);
+        auto             it = index.by_type.find(key);
+        return it != index.by_type.end() ? it->second : nullptr;
+    }
+
+    std::unique_lock lock(index.mutex);
+    drain_pending_entries(index);
+    auto it = index.by_type.find(key);
+    return it != index.by_type.end() ? it->second : nullptr;
+}
+
 }  // namespace serialization
@@ -15,6 +15,7 @@ limitations under the License.
 
 #pragma once
 
+#include <atomic>
 #include <concepts>
 #include <cstddef>
 #include <functional>
@@ -24,9 +25,12 @@ limitations under the License.
 #include <string>
 #include <string_view>
 #include <type_traits>
+#include <typeinfo>
 #include <variant>
 
+#include "common/serialization_error.h"
 #include "common/serialization_type_traits.h"
+#include "common/type_name.h"
 #include "util/export.h"
 #include "util/multi_process_stream.h"
 #include "util/registry.h"
@@ -73,6 +77,46 @@ SERIALIZATION_API SERIALIZATION_DECLARE_FUNCTION_REGISTRY(
 SERIALIZATION_API SERIALIZATION_DECLARE_FUNCTION_REGISTRY(
     BinarySerializationRegistry, binary_serialization_function_t);
 
+//=============================================================================
+// Polymorphic Type Table
+//=============================================================================
+// Note: Entries are constant-initialized by SERIALIZATION_REGISTER_DERIVED_SERIALIZATION,
+// registering one only links it into a lock-free list. The lookup tables are built
+// on first use, so no names are demangled or hashed during static initialization.
+
+/// @brief Constant-initialized description of a registered polymorphic type
+struct polymorphic_entry
+{
+    using json_function_t   = void (*)(json&, void*, bool);
+    using binary_function_t = void (*)(serialization::multi_process_stream&, void*, bool);
+
+    std::string_view      name;
+    const std::type_info* type            = nullptr;
+    json_function_t       json_function   = nullptr;
+    binary_function_t     binary_function = nullptr;
+    polymorphic_entry*    next            = nullptr;
+    std::atomic<bool>     linked{false};
+};
+
+/// @brief Link an entry into the polymorphic type table
+/// @param entry Entry with static storage duration
+/// @return Always true, so that it can initialize a namespace-scope variable
+/// @note Lock-free and allocation-free; safe to call during static initialization
+SERIALIZATION_API bool register_polymorphic_entry(polymorphic_entry& entry) noexcept;
+
+/// @brief Number of entries registered so far; grows when a library registers more types
+SERIALIZATION_API std::size_t polymorphic_entry_count() noexcept;
+
+/// @brief Find a registered type by its archived class name
+/// @param name Compile-time type name, or the demangled RTTI name used by older archives
+/// @return The entry, or nullptr if no such type was registered
+SERIALIZATION_API const polymorphic_entry* find_polymorphic_entry(std::string_view name);
+
+/// @brief Find a registered type by its dynamic type
+/// @param type The type_info of the most derived object
+/// @return The entry, or nullptr if no such type was registered
+SERIALIZATION_API const polymorphic_entry* find_polymorphic_entry(const std::type_info& type);
+
 //=============================================================================
 // Primary Template (Specialization Required)
 //=============================================================================
@@ -193,6 +237,16 @@ struct archiver_wrapper<json>
         requires is_base_serializable<T>::value
     static void pop(json& archive, T& obj)
     {
+        if (!holds<T>(archive)) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::type_mismatch,
+                "Cannot read {} from a JSON {}",
+                type_name<T>(),
+                archive.type_name());
+            return;
+        }
+
         if constexpr (std::is_same_v<T, serialization::datetime>)
         {
             obj = archive.get<double>();
@@ -224,12 +278,41 @@ struct archiver_wrapper<json>
         }
     }
 
+    /// @brief Check that a JSON value can be read as T without throwing
+    /// @tparam T Must satisfy is_base_serializable concept
+    /// @param archive The JSON value to inspect
+    template <typename T>
+    [[nodiscard]] static bool holds(const json& archive) noexcept
+    {
+        if constexpr (std::is_same_v<T, std::monostate>)
+        {
+            return true;
+        }
+        else if constexpr (std::is_same_v<T, bool>)
+        {
+            return archive.is_boolean();
+        }
+        else if constexpr (std::is_enum_v<T>)
+        {
+            return archive.is_string() || archive.is_number_integer();
+        }
+        else if constexpr (
+            std::is_arithmetic_v<T> || std::is_same_v<T, serialization::datetime>)
+        {
+            return archive.is_number();
+        }
+        else
+        {
+            return archive.is_string();
+        }
+    }
+
     /// @brief Store class type information in JSON
     /// @param archive The JSON object to write to
     /// @param name The class name to store
-    static void push_class_name(json& archive, const std::string& name)
+    static void push_class_name(json& archive, std::string_view name)
     {
-        archive[std::string(CLASS_NAME)] = name;
+        archive[std::string(CLASS_NAME)] = std::string(name);
     }
 
     /// @brief Retrieve class type information from JSON
@@ -268,7 +351,16 @@ struct archiver_wrapper<json>
     /// @return The stored index value
     [[nodiscard]] static auto pop_index(json& archive, std::string_view index_name)
     {
-        return archive[std::string(index_name)].get<unsigned int>();
+        const auto& index = archive[std::string(index_name)];
+        if (!index.is_number_unsigned()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::type_mismatch,
+                "Index field '{}' is not an unsigned number",
+                index_name);
+            return 0u;
+        }
+        return index.get<unsigned int>();
     }
 
     /// @brief Get JSON element by string key (const)
@@ -309,11 +401,38 @@ struct archiver_wrapper<json>
     /// @brief Get the size of a JSON array or object
     /// @param archive The JSON object to query
     /// @return The number of elements
-    [[nodiscard]] static auto size(const json& archive) { return archive.size(); }
+    [[nodiscard]] static auto size(const json& archive)
+    {
+        if (!archive.is_array() && !archive.is_null()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::type_mismatch,
+                "Expected a JSON array but found a JSON {}",
+                archive.type_name());
+            return json::size_type{0};
+        }
+        return archive.size();
+    }
+
+    /// @brief Get the size of a JSON array of bools
+    /// @param archive The JSON object to query
+    /// @return The number of elements
+    [[nodiscard]] static auto bit_size(const json& archive) { return size(archive); }
 
     /// @brief Get the JSON serialization registry
     /// @return Pointer to the global JSON serialization registry
     [[nodiscard]] static auto registry() { return serialization::JsonSerializationRegistry(); }
+
+    /// @brief Run the JSON callback of a registered polymorphic type
+    /// @param entry The registered type
+    /// @param archive The JSON object to serialize to/from
+    /// @param obj Pointer to the object (save) or to the owning ptr_const (load)
+    /// @param load_obj True if loading, false if saving
+    static void run_polymorphic(
+        const polymorphic_entry& entry, json& archive, void* obj, bool load_obj)
+    {
+        entry.json_function(archive, obj, load_obj);
+    }
 };
 
 //=============================================================================
@@ -385,13 +504,21 @@ struct archiver_wrapper<serialization::multi_process_stream>
         {
             archive >> obj;
         }
+
+        if (archive.HasError()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed binary stream while reading {}",
+                type_name<T>());
+        }
     }
 
     /// @brief Store class type information in binary stream
     /// @param archive The binary stream to write to
     /// @param name The class name to store
     static void push_class_name(
-        serialization::multi_process_stream& archive, const std::string& name)
+        serialization::multi_process_stream& archive, std::string_view name)
     {
         archive << name;
     }
@@ -403,6 +530,12 @@ struct archiver_wrapper<serialization::multi_process_stream>
     {
         std::string ret;
         archive >> ret;
+        if (archive.HasError()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed binary stream while reading a class name");
+        }
         return ret;
     }
 
@@ -425,8 +558,14 @@ struct archiver_wrapper<serialization::multi_process_stream>
     [[nodiscard]] static auto pop_index(
         serialization::multi_process_stream& archive, [[maybe_unused]] std::string_view index_name)
     {
-        unsigned int idx;
+        unsigned int idx = 0;
         archive >> idx;
+        if (archive.HasError()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed binary stream while reading an index");
+        }
         return idx;
     }
 
@@ -464,7 +603,7 @@ struct archiver_wrapper<serialization::multi_process_stream>
     /// @param n The size value to store
     static void resize(serialization::multi_process_stream& archive, size_t n)
     {
-        archive << static_cast<unsigned int>(n);
+        archive.PushLength(n);
     }
 
     /// @brief Read container size from binary stream
@@ -472,14 +611,57 @@ struct archiver_wrapper<serialization::multi_process_stream>
     /// @return The stored size value
     [[nodiscard]] static auto size(serialization::multi_process_stream& archive)
     {
-        unsigned int n;
-        archive >> n;
-        return static_cast<size_t>(n);
+        size_t n = 0;
+
+        // Every element takes at least one byte, so a larger count is corrupt; checking
+        // here keeps containers from reserving memory for data that cannot exist.
+        if (!archive.PopLength(n) || n > archive.Size()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed binary stream: size {} exceeds the remaining {} bytes",
+                n,
+                archive.Size());
+            return size_t{0};
+        }
+        return n;
+    }
+
+    /// @brief Read the size of a container of bools, which may be packed one bit each
+    /// @param archive The binary stream to read from
+    /// @return The stored size value
+    [[nodiscard]] static auto bit_size(serialization::multi_process_stream& archive)
+    {
+        size_t n = 0;
+        if (!archive.PopLength(n) || n / 8 > archive.Size()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed binary stream: {} bits exceed the remaining {} bytes",
+                n,
+                archive.Size());
+            return size_t{0};
+        }
+        return n;
     }
 
     /// @brief Get the binary serialization registry
     /// @return Pointer to the global binary serialization registry
     [[nodiscard]] static auto registry() { return serialization::BinarySerializationRegistry(); }
+
+    /// @brief Run the binary callback of a registered polymorphic type
+    /// @param entry The registered type
+    /// @param archive The binary stream to serialize to/from
+    /// @param obj Pointer to the object (save) or to the owning ptr_const (load)
+    /// @param load_obj True if loading, false if saving
+    static void run_polymorphic(
+        const polymorphic_entry&             entry,
+        serialization::multi_process_stream& archive,
+        void*                                obj,
+        bool                                 load_obj)
+    {
+        entry.binary_function(archive, obj, load_obj);
+    }
 };
 
 }  // namespace serialization
\ No newline at end of file
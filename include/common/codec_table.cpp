@@ -0,0 +1,94 @@
+#include "common/codec_table.h"
+
+#include <cstddef>
+#include <string>
+
+#include "serialization_impl.h"
+
+namespace serialization
+{
+namespace
+{
+template <typename Archiver>
+void save_members(
+    Archiver&                   archive,
+    const void*                 obj,
+    std::string_view            class_name,
+    const type_codec<Archiver>& codec)
+{
+    {
+        const detail::profile_scope<Archiver> scope(archive, "(class name)");
+        archiver_wrapper<Archiver>::push_class_name(archive, class_name);
+    }
+
+    const auto* base = static_cast<const std::byte*>(obj);
+    for (const auto& member : codec.members)
+    {
+        auto& field = archiver_wrapper<Archiver>::get(archive, member.name);
+        if (member.save != nullptr)
+        {
+            const detail::profile_scope<Archiver> scope(archive, member.name);
+            member.save(field, base + member.offset);
+        }
+    }
+}
+
+template <typename Archiver>
+void load_members(Archiver& archive, void* obj, const type_codec<Archiver>& codec)
+{
+    const auto class_name = archiver_wrapper<Archiver>::pop_class_name(archive);
+
+    SERIALIZATION_CHECK(
+        !class_name.empty(),
+        detail::serialization_error::error_code::missing_field,
+        "Invalid or missing class name");
+
+    if (class_name == EMPTY_NAME)
+    {
+        return;
+    }
+
+    auto* base = static_cast<std::byte*>(obj);
+    for (const auto& member : codec.members)
+    {
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        auto& field = archiver_wrapper<Archiver>::get(archive, member.name);
+        if (member.load != nullptr)
+        {
+            member.load(field, base + member.offset);
+        }
+    }
+
+    SERIALIZATION_RETURN_IF_ERROR();
+    codec.initialize(obj);
+}
+}  // namespace
+
+void save_with_codec(
+    json& archive, const void* obj, std::string_view class_name, const type_codec<json>& codec)
+{
+    save_members(archive, obj, class_name, codec);
+}
+
+void save_with_codec(
+    multi_process_stream&                   archive,
+    const void*                             obj,
+    std::string_view                        class_name,
+    const type_codec<multi_process_stream>& codec)
+{
+    save_members(archive, obj, class_name, codec);
+    archive.EndBitGroup();
+}
+
+void load_with_codec(json& archive, void* obj, const type_codec<json>& codec)
+{
+    load_members(archive, obj, codec);
+}
+
+void load_with_codec(
+    multi_process_stream& archive, void* obj, const type_codec<multi_process_stream>& codec)
+{
+    load_members(archive, obj, codec);
+}
+}  // namespace serialization
@@ -0,0 +1,100 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file codec_table.h
+ * @brief Type-erased member tables for reflected types
+ *
+ * By default every reflected type gets its own fully unrolled save/load. A type
+ * using codec tables is instead described by a table of member offsets and codec
+ * function pointers, and is (de)serialized by one shared, out-of-line loop per
+ * archiver. Codecs are instantiated once per member type, so a program with many
+ * reflected types sharing a few member types emits far less code. The archive
+ * format is unchanged.
+ *
+ * Enable it per type with SERIALIZATION_CODEC_TABLE inside the class, or for all
+ * reflected types by defining SERIALIZATION_CODEC_TABLES to 1. Offsets are
+ * measured on the first object (de)serialized, so members of virtual bases, whose
+ * offsets vary, cannot be described: such types fail to compile when opted in and
+ * keep the unrolled path under SERIALIZATION_CODEC_TABLES.
+ */
+
+#include <cstddef>
+#include <span>
+#include <string_view>
+
+#include "common/archiver_wrapper.h"
+#include "util/export.h"
+#include "util/multi_process_stream.h"
+
+/// @brief Use codec tables for every reflected type
+#ifndef SERIALIZATION_CODEC_TABLES
+#define SERIALIZATION_CODEC_TABLES 0
+#endif
+
+/// @brief Use codec tables for this type; place next to SERIALIZATION_MACRO
+#define SERIALIZATION_CODEC_TABLE static constexpr bool serialization_codec_table = true
+
+namespace serialization
+{
+/**
+ * @brief One reflected member: where it lives and how to (de)serialize it
+ */
+template <typename Archiver>
+struct member_codec
+{
+    using save_function_t = void (*)(Archiver&, const void*);
+    using load_function_t = void (*)(Archiver&, void*);
+
+    std::string_view name;
+    std::size_t      offset = 0;
+    save_function_t  save   = nullptr;  ///< nullptr for reflection_empty entries
+    load_function_t  load   = nullptr;
+};
+
+/**
+ * @brief Member table of a reflected type
+ */
+template <typename Archiver>
+struct type_codec
+{
+    using initialize_function_t = void (*)(void*);
+
+    std::span<const member_codec<Archiver>> members;
+    initialize_function_t                   initialize = nullptr;
+};
+
+//-----------------------------------------------------------------------------
+// Shared interpreters (codec_table.cpp)
+//-----------------------------------------------------------------------------
+
+/// @brief Write the class name, then every member described by the table
+SERIALIZATION_API void save_with_codec(
+    json& archive, const void* obj, std::string_view class_name, const type_codec<json>& codec);
+
+SERIALIZATION_API void save_with_codec(
+    multi_process_stream&                   archive,
+    const void*                             obj,
+    std::string_view                        class_name,
+    const type_codec<multi_process_stream>& codec);
+
+/// @brief Read the class name, then every member described by the table, then initialize
+SERIALIZATION_API void load_with_codec(json& archive, void* obj, const type_codec<json>& codec);
+
+SERIALIZATION_API void load_with_codec(
+    multi_process_stream& archive, void* obj, const type_codec<multi_process_stream>& codec);
+}  // namespace serialization
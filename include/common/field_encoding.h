@@ -0,0 +1,418 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file field_encoding.h
+ * @brief Opt-in compact encodings for floating-point, integer and enum fields
+ *
+ * A field encoding trades precision or generality for size in the binary archive:
+ *
+ * | Encoding                       | Wire value              | Bytes (with tag) |
+ * |--------------------------------|-------------------------|------------------|
+ * | none                           | double / float          | 9 / 5            |
+ * | encoding::float32()            | float                   | 5                |
+ * | encoding::fixed_point(digits)  | int32 of value*10^digits| 5                |
+ * | encoding::quantized(lo,hi,err) | uint16 or uint32 step   | 3 or 5           |
+ *
+ * encoding::delta_of_delta() applies to std::vector members of integers, such
+ * as timestamps or sequence numbers, and is lossless: see
+ * multi_process_stream::PushDeltaEncoded(). encoding::bits(width) applies to
+ * enum and integer members whose values are below 2^width, such as small
+ * enums; they are packed with neighbouring bools and bit-encoded members into
+ * shared bytes (see multi_process_stream::PushBits()). The other encodings
+ * apply to float and double members.
+ *
+ * Encodings are attached to a field with reflection_impl::with_encoding(), or
+ * by name with SERIALIZATION_FIELD_ENCODINGS next to SERIALIZATION_MACRO. They
+ * are honoured by the binary archiver only; JSON keeps the full value. Values
+ * that do not fit the encoding are reported as value_out_of_range.
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "common/serialization_error.h"
+#include "common/type_name.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+enum class encoding_kind : unsigned char
+{
+    none,
+    float32,
+    fixed_point,
+    quantized,
+    delta_of_delta,
+    bits
+};
+
+/**
+ * @brief Wire encoding of a floating-point, integer or enum field
+ */
+struct field_encoding
+{
+    encoding_kind kind      = encoding_kind::none;
+    int           digits    = 0;    ///< fixed_point: decimal digits kept
+    double        min       = 0.0;  ///< quantized: lowest representable value
+    double        max       = 0.0;  ///< quantized: highest representable value
+    double        max_error = 0.0;  ///< quantized: largest absolute rounding error
+    int           width     = 0;    ///< bits: bits per value
+
+    [[nodiscard]] constexpr bool active() const noexcept { return kind != encoding_kind::none; }
+
+    /// @brief Distance between two representable quantized values
+    [[nodiscard]] constexpr double step() const noexcept { return 2.0 * max_error; }
+
+    /// @brief True if quantized steps need more than 16 bits
+    [[nodiscard]] constexpr bool wide() const noexcept
+    {
+        return (max - min) / step() > 65535.0;
+    }
+
+    /// @brief True if the parameters can be encoded: a quantized range must be
+    /// non-empty, with a positive error and at most 2^32 - 1 steps
+    [[nodiscard]] constexpr bool valid() const noexcept
+    {
+        if (kind != encoding_kind::quantized)
+        {
+            return true;
+        }
+        return max_error > 0.0 && max > min && (max - min) / step() <= 4294967295.0;
+    }
+};
+
+namespace encoding
+{
+/// @brief Round to single precision
+constexpr field_encoding float32() noexcept
+{
+    return {encoding_kind::float32};
+}
+
+/// @brief Keep a fixed number of decimal digits, stored as a 32-bit integer
+constexpr field_encoding fixed_point(int digits) noexcept
+{
+    return {encoding_kind::fixed_point, digits};
+}
+
+/// @brief Quantize values in [min, max] with an absolute error of at most max_error
+constexpr field_encoding quantized(double min, double max, double max_error) noexcept
+{
+    return {encoding_kind::quantized, 0, min, max, max_error};
+}
+
+/// @brief Store an integer sequence as bit-packed differences between consecutive deltas
+constexpr field_encoding delta_of_delta() noexcept
+{
+    return {encoding_kind::delta_of_delta};
+}
+
+/// @brief Store a non-negative enumerator or integer below 2^width in width bits
+constexpr field_encoding bits(int width) noexcept
+{
+    return {encoding_kind::bits, 0, 0.0, 0.0, 0.0, width};
+}
+}  // namespace encoding
+
+/// @brief True for member types that encoding::delta_of_delta() applies to
+template <typename T>
+inline constexpr bool is_delta_sequence_v = false;
+
+template <DeltaEncodable Value, typename Allocator>
+inline constexpr bool is_delta_sequence_v<std::vector<Value, Allocator>> = true;
+
+/// @brief True for member types that encoding::bits() applies to
+template <typename T>
+inline constexpr bool is_bit_encodable_v =
+    std::is_enum_v<T> || (std::integral<T> && !std::same_as<T, bool>);
+
+/// @brief True if the encoding can be attached to a member of type T
+template <typename T>
+constexpr bool encoding_applies_to(const field_encoding& encoding) noexcept
+{
+    if (!encoding.active())
+    {
+        return true;
+    }
+    if (!encoding.valid())
+    {
+        return false;
+    }
+    if constexpr (std::is_floating_point_v<T>)
+    {
+        return encoding.kind != encoding_kind::delta_of_delta &&
+               encoding.kind != encoding_kind::bits;
+    }
+    else if constexpr (is_delta_sequence_v<T>)
+    {
+        return encoding.kind == encoding_kind::delta_of_delta;
+    }
+    else if constexpr (is_bit_encodable_v<T>)
+    {
+        return encoding.kind == encoding_kind::bits && encoding.width > 0 &&
+               encoding.width <= static_cast<int>(8 * sizeof(T));
+    }
+    else
+    {
+        return false;
+    }
+}
+
+/**
+ * @brief Field encoding attached by member name (see SERIALIZATION_FIELD_ENCODINGS)
+ */
+struct named_field_encoding
+{
+    std::string_view name;
+    field_encoding   encoding;
+};
+
+/// @brief Attach an encoding to the reflected member with the given name
+constexpr named_field_encoding encode(std::string_view name, field_encoding encoding) noexcept
+{
+    return {name, encoding};
+}
+
+/// @brief Encodings by member name; place next to SERIALIZATION_MACRO
+#define SERIALIZATION_FIELD_ENCODINGS(...) \
+    constexpr static auto field_encodings() \
+    {                                       \
+        return std::array{__VA_ARGS__};     \
+    }
+
+namespace detail
+{
+/// @brief Number of stream values (see multi_process_stream::Skip()) a field takes
+constexpr std::size_t encoded_value_count(const field_encoding& encoding) noexcept
+{
+    return encoding.kind == encoding_kind::bits ? static_cast<std::size_t>(encoding.width) : 1;
+}
+
+inline double power_of_ten(int digits) noexcept
+{
+    return std::pow(10.0, digits);
+}
+
+/// @brief Write a floating-point value with the given encoding
+inline void save_encoded(
+    multi_process_stream& archive, double value, const field_encoding& encoding)
+{
+    switch (encoding.kind)
+    {
+    case encoding_kind::float32:
+        archive << static_cast<float>(value);
+        return;
+
+    case encoding_kind::fixed_point:
+    {
+        const double scaled = std::round(value * power_of_ten(encoding.digits));
+        if (!(std::abs(scaled) <= 2147483647.0)) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::value_out_of_range,
+                "Value {} does not fit a fixed-point encoding with {} digits",
+                value,
+                encoding.digits);
+            return;
+        }
+        archive << static_cast<int>(scaled);
+        return;
+    }
+
+    case encoding_kind::quantized:
+    {
+        if (!(value >= encoding.min && value <= encoding.max)) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::value_out_of_range,
+                "Value {} is outside the quantization range [{}, {}]",
+                value,
+                encoding.min,
+                encoding.max);
+            return;
+        }
+        const double steps = std::round((value - encoding.min) / encoding.step());
+        if (encoding.wide())
+        {
+            if (!(steps <= 4294967295.0)) [[unlikely]]
+            {
+                SERIALIZATION_THROW(
+                    serialization_error::error_code::value_out_of_range,
+                    "Value {} needs {} quantization steps of {}, more than 32 bits hold",
+                    value,
+                    steps,
+                    encoding.step());
+                return;
+            }
+            archive << static_cast<unsigned int>(steps);
+        }
+        else
+        {
+            archive << static_cast<std::uint16_t>(steps);
+        }
+        return;
+    }
+
+    case encoding_kind::none:
+    case encoding_kind::delta_of_delta:
+    case encoding_kind::bits:
+        break;
+    }
+    archive << value;
+}
+
+/// @brief Read a floating-point value written by save_encoded()
+inline double load_encoded_value(multi_process_stream& archive, const field_encoding& encoding)
+{
+    switch (encoding.kind)
+    {
+    case encoding_kind::float32:
+    {
+        float value = 0.0f;
+        archive >> value;
+        return value;
+    }
+
+    case encoding_kind::fixed_point:
+    {
+        int scaled = 0;
+        archive >> scaled;
+        return static_cast<double>(scaled) / power_of_ten(encoding.digits);
+    }
+
+    case encoding_kind::quantized:
+    {
+        double steps = 0.0;
+        if (encoding.wide())
+        {
+            unsigned int wide_steps = 0;
+            archive >> wide_steps;
+            steps = wide_steps;
+        }
+        else
+        {
+            std::uint16_t narrow_steps = 0;
+            archive >> narrow_steps;
+            steps = narrow_steps;
+        }
+        return std::min(encoding.min + steps * encoding.step(), encoding.max);
+    }
+
+    case encoding_kind::none:
+    case encoding_kind::delta_of_delta:
+    case encoding_kind::bits:
+        break;
+    }
+
+    double value = 0.0;
+    archive >> value;
+    return value;
+}
+
+/// @brief Read a floating-point value written by save_encoded() into a float or double
+template <std::floating_point Value>
+void load_encoded(multi_process_stream& archive, Value& value, const field_encoding& encoding)
+{
+    value = static_cast<Value>(load_encoded_value(archive, encoding));
+    if (archive.HasError()) [[unlikely]]
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::malformed_input,
+            "Malformed binary stream while reading an encoded {}",
+            type_name<Value>());
+    }
+}
+
+/// @brief Write an enumerator or integer with encoding::bits()
+template <typename Value>
+    requires is_bit_encodable_v<Value>
+void save_encoded(multi_process_stream& archive, Value value, const field_encoding& encoding)
+{
+    uint64_t bits = 0;
+    if constexpr (std::is_enum_v<Value>)
+    {
+        bits = static_cast<uint64_t>(static_cast<std::underlying_type_t<Value>>(value));
+    }
+    else
+    {
+        bits = static_cast<uint64_t>(value);
+    }
+    if (encoding.width < 64 && (bits >> encoding.width) != 0) [[unlikely]]
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::value_out_of_range,
+            "Value {} of {} does not fit {} bits",
+            static_cast<int64_t>(bits),
+            type_name<Value>(),
+            encoding.width);
+        return;
+    }
+    archive.PushBits(bits, static_cast<unsigned int>(encoding.width));
+}
+
+/// @brief Read an enumerator or integer written with encoding::bits()
+template <typename Value>
+    requires is_bit_encodable_v<Value>
+void load_encoded(multi_process_stream& archive, Value& value, const field_encoding& encoding)
+{
+    value = static_cast<Value>(archive.PopBits(static_cast<unsigned int>(encoding.width)));
+    if (archive.HasError()) [[unlikely]]
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::malformed_input,
+            "Malformed binary stream while reading a bit-encoded {}",
+            type_name<Value>());
+    }
+}
+
+/// @brief Write an integer sequence with encoding::delta_of_delta()
+template <DeltaEncodable Value, typename Allocator>
+void save_encoded(
+    multi_process_stream&                archive,
+    const std::vector<Value, Allocator>& values,
+    const field_encoding& /*encoding*/)
+{
+    archive.PushDeltaEncoded(values);
+}
+
+/// @brief Read an integer sequence written with encoding::delta_of_delta()
+template <DeltaEncodable Value, typename Allocator>
+void load_encoded(
+    multi_process_stream&          archive,
+    std::vector<Value, Allocator>& values,
+    const field_encoding& /*encoding*/)
+{
+    const auto decoded = archive.PopDeltaEncoded<Value>();
+    if (archive.HasError()) [[unlikely]]
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::malformed_input,
+            "Malformed binary stream while reading a delta-encoded sequence of {}",
+            type_name<Value>());
+        return;
+    }
+    values.assign(decoded.begin(), decoded.end());
+}
+}  // namespace detail
+}  // namespace serialization
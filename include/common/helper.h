@@ -70,6 +70,47 @@ struct serializer
     {
         return T::properties();
     }
+
+    // encodings declared with SERIALIZATION_FIELD_ENCODINGS, if any
+    template <typename T>
+    constexpr static bool has_field_encodings()
+    {
+        return requires { T::field_encodings(); };
+    }
+
+    template <typename T>
+    constexpr static auto field_encodings()
+    {
+        return T::field_encodings();
+    }
+
+    // true if the type was declared with SERIALIZATION_CODEC_TABLE
+    template <typename T>
+    constexpr static bool codec_table()
+    {
+        if constexpr (requires { T::serialization_codec_table; })
+        {
+            return T::serialization_codec_table;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    // true if the type was declared with SERIALIZATION_INTERNED
+    template <typename T>
+    constexpr static bool interned()
+    {
+        if constexpr (requires { T::serialization_interned; })
+        {
+            return T::serialization_interned;
+        }
+        else
+        {
+            return false;
+        }
+    }
 };
 }  // namespace access
 }  // namespace serialization
@@ -0,0 +1,116 @@
+#include "common/interning.h"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace serialization
+{
+namespace
+{
+struct entry
+{
+    const std::type_info*      type;
+    std::vector<unsigned char> encoding;
+    std::weak_ptr<const void>  object;
+};
+
+struct shard
+{
+    std::mutex                                  mutex;
+    std::unordered_multimap<std::size_t, entry> entries;
+    std::size_t                                 inserts = 0;
+    std::size_t                                 hits    = 0;
+    std::size_t                                 misses  = 0;
+};
+
+// Expired entries are swept once a shard has seen this many insertions
+constexpr std::size_t sweep_interval = 1024;
+
+using shard_array = std::array<shard, 16>;
+
+shard_array& shards()
+{
+    static shard_array instance;
+    return instance;
+}
+
+std::size_t hash_of(const std::type_info& type, std::span<const unsigned char> encoding)
+{
+    const std::string_view bytes(
+        reinterpret_cast<const char*>(encoding.data()), encoding.size());
+    return std::hash<std::string_view>{}(bytes) ^ (type.hash_code() * 0x9e3779b97f4a7c15ULL);
+}
+}  // namespace
+
+std::shared_ptr<const void> intern(
+    const std::type_info&          type,
+    std::span<const unsigned char> encoding,
+    std::shared_ptr<const void>    candidate)
+{
+    const auto hash  = hash_of(type, encoding);
+    auto&      owner = shards()[hash % shards().size()];
+
+    std::lock_guard lock(owner.mutex);
+
+    auto [first, last] = owner.entries.equal_range(hash);
+    for (auto it = first; it != last; ++it)
+    {
+        auto& item = it->second;
+        if (*item.type != type || !std::ranges::equal(item.encoding, encoding))
+        {
+            continue;
+        }
+
+        if (auto existing = item.object.lock())
+        {
+            ++owner.hits;
+            return existing;
+        }
+        item.object = candidate;
+        ++owner.misses;
+        return candidate;
+    }
+
+    owner.entries.emplace(
+        hash,
+        entry{&type, std::vector<unsigned char>(encoding.begin(), encoding.end()), candidate});
+    ++owner.misses;
+
+    if (++owner.inserts >= sweep_interval)
+    {
+        std::erase_if(owner.entries, [](const auto& item) { return item.second.object.expired(); });
+        owner.inserts = 0;
+    }
+    return candidate;
+}
+
+interning_statistics interning_stats()
+{
+    interning_statistics result;
+    for (auto& owner : shards())
+    {
+        std::lock_guard lock(owner.mutex);
+        result.hits += owner.hits;
+        result.misses += owner.misses;
+        result.entries += owner.entries.size();
+    }
+    return result;
+}
+
+void clear_interning_table()
+{
+    for (auto& owner : shards())
+    {
+        std::lock_guard lock(owner.mutex);
+        owner.entries.clear();
+        owner.inserts = 0;
+        owner.hits    = 0;
+        owner.misses  = 0;
+    }
+}
+}  // namespace serialization
@@ -0,0 +1,78 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file interning.h
+ * @brief Process-wide hash-consing of immutable objects loaded through ptr_const
+ *
+ * Messages often carry identical immutable sub-objects, such as the same
+ * instrument definition or calendar. By default every load creates a fresh
+ * copy. For a type declared with SERIALIZATION_INTERNED, every
+ * ptr_const<T> (std::shared_ptr<const T>) that is loaded is looked up in a
+ * process-wide table keyed by the binary encoding of the object. If an equal
+ * object is still alive, the pointer shares that instance and the fresh copy
+ * is released.
+ *
+ * The table holds weak references, so interned objects are freed as usual once
+ * the last owner lets go. Binary loads key the table by the bytes they
+ * consumed. JSON loads, and binary loads using the string dictionary, encode
+ * the loaded object once to build the key. Objects loaded through a mutable
+ * std::shared_ptr<T>, or through a registered polymorphic entry, are never
+ * shared.
+ */
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <typeinfo>
+
+#include "util/export.h"
+
+/// @brief Share equal instances of this type loaded through ptr_const; place next to
+/// SERIALIZATION_MACRO
+#define SERIALIZATION_INTERNED static constexpr bool serialization_interned = true
+
+namespace serialization
+{
+/**
+ * @brief Counters of the interning table
+ */
+struct interning_statistics
+{
+    std::size_t hits    = 0;  ///< loads that resolved to an existing instance
+    std::size_t misses  = 0;  ///< loads that registered a new instance
+    std::size_t entries = 0;  ///< registered instances, including expired ones not yet swept
+};
+
+/**
+ * @brief Return the live instance of `type` with the given encoding, or register `candidate`
+ * @param type Dynamic type of the object
+ * @param encoding Binary encoding of the object
+ * @param candidate The freshly loaded object
+ * @return The shared instance, which is `candidate` if none was alive
+ */
+SERIALIZATION_API std::shared_ptr<const void> intern(
+    const std::type_info&          type,
+    std::span<const unsigned char> encoding,
+    std::shared_ptr<const void>    candidate);
+
+/// @brief Current counters of the interning table
+SERIALIZATION_API interning_statistics interning_stats();
+
+/// @brief Forget every registered instance and reset the counters; live objects are unaffected
+SERIALIZATION_API void clear_interning_table();
+}  // namespace serialization
@@ -19,6 +19,8 @@ limitations under the License.
 #include <type_traits>
 #include <utility>
 
+#include "common/field_encoding.h"
+
 namespace serialization
 {
 
@@ -47,11 +49,25 @@ public:
     constexpr pointer_type     member() const noexcept { return member_; }
     constexpr std::string_view name() const noexcept { return name_; }
     constexpr std::string_view description() const noexcept { return description_; }
+    constexpr field_encoding   encoding() const noexcept { return encoding_; }
+
+    // Copy of this reflection with a wire encoding hint (floating-point, integer and
+    // enum members, and integer vectors only)
+    constexpr reflection_impl with_encoding(field_encoding encoding) const noexcept
+    {
+        static_assert(
+            std::is_floating_point_v<T> || is_delta_sequence_v<T> || is_bit_encodable_v<T>,
+            "Encodings apply to floating-point, integer and enum members and integer vectors");
+        auto result      = *this;
+        result.encoding_ = encoding;
+        return result;
+    }
 
 private:
     pointer_type     member_;
     std::string_view name_;
     std::string_view description_;
+    field_encoding   encoding_{};
 };
 
 // Factory function
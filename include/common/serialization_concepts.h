@@ -23,9 +23,12 @@ limitations under the License.
 
 static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
 
+#include <bitset>
 #include <concepts>
+#include <cstddef>
 #include <iterator>
 #include <ranges>
+#include <string>
 #include <type_traits>
 
 #include "common/helper.h"
@@ -96,12 +99,42 @@ concept AssociativeContainer = Container<T> && requires { typename T::key_type;
 template <typename T>
 concept MapLike = AssociativeContainer<T> && requires { typename T::mapped_type; };
 
+/**
+ * @brief Concept for maps with unique keys (insert reports whether it inserted)
+ */
+template <typename T>
+concept UniqueKeyMap = MapLike<T> && requires(T& map, const typename T::value_type& item) {
+    { map.insert(item).second } -> std::convertible_to<bool>;
+};
+
+/**
+ * @brief Concept for maps with unique string or enum keys, which JSON archives write as objects
+ */
+template <typename T>
+concept StringKeyedMap =
+    UniqueKeyMap<T> && (std::same_as<typename T::key_type, std::string> ||
+                        std::is_enum_v<typename T::key_type>);
+
 /**
  * @brief Concept for set-like containers (no mapped_type)
  */
 template <typename T>
 concept SetLike = AssociativeContainer<T> && !MapLike<T>;
 
+/**
+ * @brief Concept for byte-like elements, which JSON archives write in bulk as base64
+ */
+template <typename T>
+concept ByteLike = std::same_as<T, unsigned char> || std::same_as<T, std::byte>;
+
+/**
+ * @brief Concept for resizable contiguous containers of bytes (std::vector<std::byte>, ...)
+ */
+template <typename T>
+concept ByteSequence = Container<T> && std::ranges::contiguous_range<T> &&
+                       ByteLike<typename T::value_type> &&
+                       requires(T t, typename T::size_type n) { t.resize(n); };
+
 /**
  * @brief Concept for types that have reflection metadata
  */
@@ -244,6 +277,22 @@ concept OptionalLike = requires(T t) {
     typename T::value_type;
 };
 
+/**
+ * @brief Concept for fixed-size bit sets (std::bitset)
+ */
+template <typename T>
+concept BitsetLike = requires(const T& t) { []<std::size_t N>(const std::bitset<N>&) {}(t); };
+
+/**
+ * @brief Concept for members decoded on first access (see serialization_lazy.h)
+ */
+template <typename T>
+concept LazyLike = requires(const T& t) {
+    typename T::value_type;
+    { t.get() } -> std::same_as<const typename T::value_type&>;
+    { t.decoded() } -> std::same_as<bool>;
+};
+
 //-----------------------------------------------------------------------------
 // Helper Concepts for Implementation Details
 //-----------------------------------------------------------------------------
@@ -0,0 +1,183 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file serialization_error.h
+ * @brief Error type and reporting macros shared by all serializers
+ *
+ * Errors are reported through SERIALIZATION_THROW. Inside a try_load() scope the
+ * first error is recorded in a thread-local slot and the failing function returns;
+ * callers stop early with SERIALIZATION_RETURN_IF_ERROR. Outside such a scope the
+ * error is thrown as serialization_error, or aborts when exceptions are disabled.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <format>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include "util/macros.h"
+
+/// @brief Maximum nesting of pointers followed by the recursive save()/load() and
+/// of objects converted by the transcoder, reported as recursion_limit
+#ifndef SERIALIZATION_MAX_DEPTH
+#define SERIALIZATION_MAX_DEPTH 1000
+#endif
+
+namespace serialization
+{
+/**
+ * @brief Error raised while loading or saving an archive
+ */
+class serialization_error : public std::runtime_error
+{
+public:
+    enum class error_code
+    {
+        none,
+        size_mismatch,
+        missing_field,
+        type_mismatch,
+        malformed_input,
+        invalid_variant,
+        invalid_index,
+        null_pointer,
+        registry_not_found,
+        recursion_limit,
+        value_out_of_range,
+        io_error
+    };
+
+    serialization_error() : std::runtime_error(""), code_(error_code::none) {}
+
+    serialization_error(error_code code, const std::string& message)
+        : std::runtime_error(message), code_(code)
+    {
+    }
+
+    [[nodiscard]] error_code code() const noexcept { return code_; }
+
+private:
+    error_code code_;
+};
+
+namespace detail
+{
+// Kept for the SERIALIZATION_CHECK call sites, which spell the code through detail.
+using serialization_error = serialization::serialization_error;
+
+/**
+ * @brief Per-thread error slot, active while a try_load() scope is open
+ */
+struct error_state
+{
+    std::optional<serialization::serialization_error>* sink   = nullptr;
+    bool                                               failed = false;
+};
+
+inline thread_local constinit error_state current_error_state{};
+
+/// @brief True once an error was recorded in the active try_load() scope
+[[nodiscard]] SERIALIZATION_FORCE_INLINE bool has_error() noexcept
+{
+    return current_error_state.failed;
+}
+
+/**
+ * @brief Report an error: record it in the active scope, otherwise throw or abort
+ */
+SERIALIZATION_COLD SERIALIZATION_NOINLINE inline void raise_error(
+    serialization::serialization_error::error_code code, const std::string& message)
+{
+    auto& state = current_error_state;
+    if (state.sink != nullptr)
+    {
+        if (!state.failed)
+        {
+            state.sink->emplace(code, message);
+            state.failed = true;
+        }
+        return;
+    }
+
+#if SERIALIZATION_HAS_EXCEPTIONS
+    throw serialization::serialization_error(code, message);
+#else
+    std::fprintf(stderr, "serialization error: %s\n", message.c_str());
+    std::abort();
+#endif
+}
+
+/**
+ * @brief RAII scope that turns raised errors into a recorded result
+ */
+class error_scope
+{
+public:
+    error_scope() noexcept : previous_(current_error_state)
+    {
+        current_error_state = {&error_, false};
+    }
+
+    ~error_scope() { current_error_state = previous_; }
+
+    [[nodiscard]] bool failed() const noexcept { return current_error_state.failed; }
+
+    [[nodiscard]] serialization::serialization_error take_error() noexcept
+    {
+        return std::move(*error_);
+    }
+
+    error_scope(const error_scope&)            = delete;
+    error_scope& operator=(const error_scope&) = delete;
+
+private:
+    std::optional<serialization::serialization_error> error_;
+    error_state                                       previous_;
+};
+}  // namespace detail
+}  // namespace serialization
+
+//-----------------------------------------------------------------------------
+// Macros for error handling
+//-----------------------------------------------------------------------------
+#define SERIALIZATION_THROW(code, ...) \
+    serialization::detail::raise_error(code, std::format(__VA_ARGS__))
+
+#define SERIALIZATION_CHECK(condition, code, ...)                                     \
+    do                                                                                \
+    {                                                                                 \
+        if (!(condition)) [[unlikely]]                                                \
+        {                                                                             \
+            SERIALIZATION_THROW(                                                      \
+                code, "Check failed: {} - {}", #condition, std::format(__VA_ARGS__)); \
+            return;                                                                   \
+        }                                                                             \
+    } while (false)
+
+#define SERIALIZATION_RETURN_IF_ERROR()                      \
+    do                                                       \
+    {                                                        \
+        if (serialization::detail::has_error()) [[unlikely]] \
+        {                                                    \
+            return;                                          \
+        }                                                    \
+    } while (false)
@@ -0,0 +1,112 @@
+#include "common/size_profile.h"
+
+#include <algorithm>
+#include <cassert>
+#include <format>
+#include <utility>
+
+namespace serialization
+{
+namespace
+{
+// Pads text with spaces to the given width; negative widths align left
+std::string padded(std::string text, int width)
+{
+    const auto size = static_cast<std::size_t>(width < 0 ? -width : width);
+    if (text.size() < size)
+    {
+        text.insert(width < 0 ? text.end() : text.begin(), size - text.size(), ' ');
+    }
+    return text;
+}
+
+void format_node(
+    std::string& out, const size_profile_node& node, std::size_t total, std::size_t depth)
+{
+    // Share of the root in tenths of a percent
+    const std::size_t share = total == 0 ? 0 : (node.bytes * 1000 + total / 2) / total;
+
+    out += padded(std::string(2 * depth, ' ') + node.name, -48);
+    out += padded(std::to_string(node.bytes), 13) + " B";
+    out += padded(std::format("{}.{}%", share / 10, share % 10), 8);
+    out += padded(std::format("x{}", node.count), 11);
+    out += '\n';
+
+    std::vector<const size_profile_node*> children;
+    children.reserve(node.children.size());
+    for (const auto& child : node.children)
+    {
+        children.push_back(&child);
+    }
+    std::ranges::stable_sort(
+        children, [](const auto* a, const auto* b) { return a->bytes > b->bytes; });
+    for (const auto* child : children)
+    {
+        format_node(out, *child, total, depth + 1);
+    }
+}
+}  // namespace
+
+//----------------------------------------------------------------------------
+std::size_t size_profile_node::self_bytes() const
+{
+    std::size_t attributed = 0;
+    for (const auto& child : children)
+    {
+        attributed += child.bytes;
+    }
+    return bytes - std::min(bytes, attributed);
+}
+
+//----------------------------------------------------------------------------
+const size_profile_node* size_profile_node::find(std::string_view child) const
+{
+    const auto it = std::ranges::find(children, child, &size_profile_node::name);
+    return it != children.end() ? &*it : nullptr;
+}
+
+//----------------------------------------------------------------------------
+size_profiler::size_profiler(std::string rootName)
+{
+    root_.name = std::move(rootName);
+    path_.push_back(&root_);
+}
+
+//----------------------------------------------------------------------------
+void size_profiler::Enter(std::string_view name)
+{
+    auto& children = path_.back()->children;
+    auto  it       = std::ranges::find(children, name, &size_profile_node::name);
+    if (it == children.end())
+    {
+        children.push_back(size_profile_node{.name = std::string(name)});
+        it = children.end() - 1;
+    }
+    path_.push_back(&*it);
+}
+
+//----------------------------------------------------------------------------
+void size_profiler::Leave(std::size_t bytes)
+{
+    assert("pre: Leave() matches an Enter()" && (path_.size() > 1));
+    auto* node = path_.back();
+    node->bytes += bytes;
+    ++node->count;
+    path_.pop_back();
+}
+
+//----------------------------------------------------------------------------
+void size_profiler::Finish(std::size_t bytes)
+{
+    root_.bytes = bytes;
+    root_.count = 1;
+}
+
+//----------------------------------------------------------------------------
+std::string format_size_profile(const size_profile_node& root)
+{
+    std::string out;
+    format_node(out, root, root.bytes, 0);
+    return out;
+}
+}  // namespace serialization
@@ -0,0 +1,151 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file size_profile.h
+ * @brief Attribution of binary archive bytes to types, members and overhead
+ *
+ * A size_profiler attached to a multi_process_stream builds a tree while
+ * save() writes to it. Every reflected object adds a node named after its
+ * class, with one child per member (the properties() names) and an
+ * "(class name)" child for the name string that precedes it. Containers add a
+ * "(length)" child for their length prefix. Nodes with the same name under the
+ * same parent are merged, so the tree aggregates every element of a container
+ * and every object of one type reached through one member; objects saved
+ * through base pointers appear under the name of their dynamic type.
+ *
+ * The bytes of a node include its tag bytes and those of its children; the
+ * difference is the node's own overhead, such as the tags of scalar values.
+ */
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "util/export.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/**
+ * @brief One node of a size profile
+ */
+struct size_profile_node
+{
+    std::string                    name{};
+    std::size_t                    bytes = 0;  ///< including the children
+    std::size_t                    count = 0;  ///< values merged into the node
+    std::vector<size_profile_node> children{};
+
+    /// Bytes not attributed to any child
+    std::size_t self_bytes() const;
+
+    /// Child with the given name, or nullptr
+    const size_profile_node* find(std::string_view child) const;
+};
+
+/**
+ * @brief Builds a size profile from the Enter/Leave calls of save()
+ */
+class SERIALIZATION_API size_profiler
+{
+public:
+    explicit size_profiler(std::string rootName);
+
+    size_profiler(const size_profiler&)            = delete;
+    size_profiler& operator=(const size_profiler&) = delete;
+
+    /**
+     * Starts a child of the current node; the child becomes the current node.
+     */
+    void Enter(std::string_view name);
+
+    /**
+     * Adds the bytes written since the matching Enter() to the current node
+     * and returns to its parent.
+     */
+    void Leave(std::size_t bytes);
+
+    /**
+     * Returns the tree; the root holds the bytes passed to Finish().
+     */
+    const size_profile_node& Root() const { return root_; }
+
+    /**
+     * Records the size of the whole archive in the root.
+     */
+    void Finish(std::size_t bytes);
+
+private:
+    size_profile_node root_;
+    // Nodes from the root to the current node. Entering a child may grow the
+    // children of the current node, which are never on this path.
+    std::vector<size_profile_node*> path_;
+};
+
+/**
+ * @brief Render a size profile as an indented table, largest nodes first
+ *
+ * Each line shows the node's bytes, its share of the root, and the number of
+ * values merged into it.
+ */
+SERIALIZATION_API std::string format_size_profile(const size_profile_node& root);
+
+namespace detail
+{
+/// @brief Attributes the bytes written to an archive during its lifetime to a
+/// profile node; free unless a profiler is attached to a binary stream
+template <typename Archiver>
+class profile_scope
+{
+public:
+    profile_scope(Archiver& /*archive*/, std::string_view /*name*/) {}
+};
+
+template <>
+class profile_scope<multi_process_stream>
+{
+public:
+    profile_scope(multi_process_stream& archive, std::string_view name)
+        : archive_(archive), profiler_(archive.SizeProfiler())
+    {
+        if (profiler_ != nullptr) [[unlikely]]
+        {
+            start_ = archive_.Size();
+            profiler_->Enter(name);
+        }
+    }
+
+    ~profile_scope()
+    {
+        if (profiler_ != nullptr) [[unlikely]]
+        {
+            profiler_->Leave(archive_.Size() - start_);
+        }
+    }
+
+    profile_scope(const profile_scope&)            = delete;
+    profile_scope& operator=(const profile_scope&) = delete;
+
+private:
+    multi_process_stream& archive_;
+    size_profiler*        profiler_;
+    std::size_t           start_ = 0;
+};
+}  // namespace detail
+}  // namespace serialization
@@ -0,0 +1,2405 @@
+#include "common/transcoder.h"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "common/field_encoding.h"
+#include "common/serialization_error.h"
+#include "util/base64.h"
+#include "util/json_text.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+namespace
+{
+//-----------------------------------------------------------------------------
+// Wire format
+//-----------------------------------------------------------------------------
+
+// Type tags of multi_process_stream (serializationInternals::Types)
+enum wire_tag : unsigned char
+{
+    int32_tag,
+    uint32_tag,
+    char_tag,
+    uchar_tag,
+    double_tag,
+    float_tag,
+    string_tag,
+    int64_tag,
+    uint64_tag,
+    size_tag,
+    int16_tag,
+    uint16_tag,
+    string_def_tag,
+    string_ref_tag,
+    delta_tag,
+    string_varint_tag,
+    length_tag,
+    bits_tag
+};
+
+// Container sizes written by the transcoder are padded to a fixed width so that
+// they can be patched once the container is closed
+constexpr std::size_t padded_length_bytes = 5;
+constexpr uint64_t    max_padded_length   = (uint64_t{1} << (7 * padded_length_bytes)) - 1;
+
+// Class name archived for null pointers (see EMPTY_NAME in serialization_impl.h)
+constexpr std::string_view empty_name = "null object!";
+
+constexpr std::string_view class_key = "Class";
+constexpr std::string_view index_key = "Index";
+constexpr std::string_view value_key = "Value";
+
+struct string_hash
+{
+    using is_transparent = void;
+    size_t operator()(std::string_view value) const noexcept
+    {
+        return std::hash<std::string_view>{}(value);
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Compiled schema
+//-----------------------------------------------------------------------------
+enum class shape_kind
+{
+    boolean,
+    character,
+    uchar,
+    short_integer,
+    uint16,
+    int32,
+    uint32,
+    int64,
+    uint64,
+    float32,
+    float64,
+    string,
+    monostate,
+    none,
+    enumeration,
+    object,
+    pointer,
+    sequence,
+    map,
+    pair,
+    tuple,
+    optional,
+    variant
+};
+
+struct type_desc;
+
+struct shape_desc
+{
+    shape_kind                               kind = shape_kind::none;
+    const type_desc*                         type = nullptr;  ///< object, pointer
+    std::vector<const shape_desc*>           children{};
+    std::vector<std::pair<std::string, int>> enumerators{};
+    bool                                     unique_keys = true;   ///< map
+    bool                                     base64      = false;  ///< sequence of bytes
+};
+
+/// Maps with unique string or enum keys are JSON objects; other maps are flat key/value arrays
+bool is_object_map(const shape_desc& shape)
+{
+    return shape.kind == shape_kind::map && shape.unique_keys &&
+           (shape.children[0]->kind == shape_kind::string ||
+            shape.children[0]->kind == shape_kind::enumeration);
+}
+
+struct field_desc
+{
+    std::string       name;
+    const shape_desc* shape = nullptr;
+    field_encoding    encoding;
+};
+
+struct type_desc
+{
+    std::string             name;
+    std::vector<field_desc> fields;
+};
+
+void raise_schema_error(std::string_view message)
+{
+    SERIALIZATION_THROW(
+        serialization_error::error_code::malformed_input, "Invalid schema: {}", message);
+}
+
+// Counts the objects being converted, which nest once per level of the archive;
+// deeper archives raise recursion_limit like load() instead of overflowing the stack
+class nesting_guard
+{
+public:
+    explicit nesting_guard(std::size_t& depth) : depth_(depth)
+    {
+        if (depth_ >= SERIALIZATION_MAX_DEPTH) [[unlikely]]
+        {
+            exceeded_ = true;
+            SERIALIZATION_THROW(
+                serialization_error::error_code::recursion_limit,
+                "Archive nests objects deeper than the maximum {}",
+                SERIALIZATION_MAX_DEPTH);
+            return;
+        }
+        ++depth_;
+    }
+
+    ~nesting_guard()
+    {
+        if (!exceeded_)
+        {
+            --depth_;
+        }
+    }
+
+    nesting_guard(const nesting_guard&)            = delete;
+    nesting_guard& operator=(const nesting_guard&) = delete;
+
+private:
+    std::size_t& depth_;
+    bool         exceeded_ = false;
+};
+
+class compiled_schema
+{
+public:
+    explicit compiled_schema(const json& schema)
+    {
+        if (!schema.is_object() || !schema.contains("root"))
+        {
+            raise_schema_error("missing 'root'");
+            return;
+        }
+
+        // Every class is registered before any shape refers to it
+        const auto types = schema.value("types", json::object());
+        for (const auto& [name, type] : types.items())
+        {
+            types_[name].name = name;
+        }
+        for (const auto& [name, type] : types.items())
+        {
+            auto& fields = types_[name].fields;
+            for (const auto& field : type.value("fields", json::array()))
+            {
+                if (!field.contains("name") || !field["name"].is_string() ||
+                    !field.contains("type"))
+                {
+                    raise_schema_error(std::format("malformed field in {}", name));
+                    return;
+                }
+                auto& entry = fields.emplace_back();
+                entry.name  = field["name"].get<std::string>();
+                entry.shape = Compile(field["type"]);
+                if (field.contains("encoding"))
+                {
+                    entry.encoding = CompileEncoding(field["encoding"]);
+                }
+                SERIALIZATION_RETURN_IF_ERROR();
+            }
+        }
+        root_ = Compile(schema["root"]);
+    }
+
+    const shape_desc* Root() const { return root_; }
+
+    const type_desc* Find(std::string_view class_name) const
+    {
+        const auto it = types_.find(class_name);
+        return it == types_.end() ? nullptr : &it->second;
+    }
+
+private:
+    const shape_desc* Compile(const json& shape)
+    {
+        static const std::unordered_map<std::string_view, shape_kind> scalars = {
+            {"bool", shape_kind::boolean},
+            {"char", shape_kind::character},
+            {"uchar", shape_kind::uchar},
+            {"short", shape_kind::short_integer},
+            {"uint16", shape_kind::uint16},
+            {"int32", shape_kind::int32},
+            {"uint32", shape_kind::uint32},
+            {"int64", shape_kind::int64},
+            {"uint64", shape_kind::uint64},
+            {"float", shape_kind::float32},
+            {"double", shape_kind::float64},
+            {"string", shape_kind::string},
+            {"monostate", shape_kind::monostate},
+            {"none", shape_kind::none}};
+
+        auto& result = shapes_.emplace_back();
+        if (shape.is_string())
+        {
+            const auto it = scalars.find(shape.get_ref<const std::string&>());
+            if (it == scalars.end())
+            {
+                raise_schema_error(std::format("unknown shape {}", shape.dump()));
+                return &result;
+            }
+            result.kind = it->second;
+            return &result;
+        }
+
+        if (!shape.is_object() || shape.size() != 1)
+        {
+            raise_schema_error(std::format("unknown shape {}", shape.dump()));
+            return &result;
+        }
+
+        const auto& [kind, argument] = *shape.items().begin();
+        if (kind == "enum")
+        {
+            result.kind = shape_kind::enumeration;
+            if (argument.is_object())
+            {
+                for (const auto& [name, value] : argument.items())
+                {
+                    result.enumerators.emplace_back(name, value.get<int>());
+                }
+            }
+        }
+        else if (kind == "object" || kind == "pointer")
+        {
+            result.kind = kind == "object" ? shape_kind::object : shape_kind::pointer;
+            result.type = argument.is_string() ? Find(argument.get_ref<const std::string&>())
+                                               : nullptr;
+        }
+        else if (kind == "sequence" || kind == "optional")
+        {
+            result.kind = kind == "sequence" ? shape_kind::sequence : shape_kind::optional;
+            result.children.push_back(Compile(argument));
+        }
+        else if (kind == "bytes")
+        {
+            result.kind   = shape_kind::sequence;
+            result.base64 = true;
+            result.children.push_back(Compile(argument));
+            const auto element = result.children.back()->kind;
+            if (element != shape_kind::uchar && element != shape_kind::enumeration)
+            {
+                raise_schema_error("bytes of a shape other than uchar or enum");
+            }
+        }
+        else if (
+            kind == "map" || kind == "multimap" || kind == "pair" || kind == "tuple" ||
+            kind == "variant")
+        {
+            const bool is_map  = kind == "map" || kind == "multimap";
+            result.unique_keys = kind != "multimap";
+            result.kind        = is_map           ? shape_kind::map
+                                 : kind == "pair"  ? shape_kind::pair
+                                 : kind == "tuple" ? shape_kind::tuple
+                                                   : shape_kind::variant;
+            if (!argument.is_array() || ((is_map || kind == "pair") && argument.size() != 2))
+            {
+                raise_schema_error(std::format("malformed {} shape", kind));
+                return &result;
+            }
+            for (const auto& child : argument)
+            {
+                result.children.push_back(Compile(child));
+            }
+        }
+        else
+        {
+            raise_schema_error(std::format("unknown shape {}", kind));
+        }
+        return &result;
+    }
+
+    static field_encoding CompileEncoding(const json& encoding)
+    {
+        const auto kind = encoding.value("kind", std::string("none"));
+        if (kind == "float32")
+        {
+            return encoding::float32();
+        }
+        if (kind == "fixed_point")
+        {
+            return encoding::fixed_point(encoding.value("digits", 0));
+        }
+        if (kind == "quantized")
+        {
+            return encoding::quantized(
+                encoding.value("min", 0.0),
+                encoding.value("max", 0.0),
+                encoding.value("max_error", 0.0));
+        }
+        if (kind == "delta_of_delta")
+        {
+            return encoding::delta_of_delta();
+        }
+        if (kind == "bits")
+        {
+            const auto width = encoding.value("width", 0);
+            if (width < 1 || width > 64)
+            {
+                raise_schema_error(std::format("invalid bit width {}", width));
+            }
+            return encoding::bits(width);
+        }
+        if (kind != "none")
+        {
+            raise_schema_error(std::format("unknown encoding {}", kind));
+        }
+        return {};
+    }
+
+    std::deque<shape_desc>                                                    shapes_;
+    std::unordered_map<std::string, type_desc, string_hash, std::equal_to<>> types_;
+    const shape_desc*                                                         root_ = nullptr;
+};
+
+//-----------------------------------------------------------------------------
+// Binary input
+//-----------------------------------------------------------------------------
+class binary_source
+{
+public:
+    binary_source(std::istream& in, std::size_t buffer_bytes)
+        : in_(in), buffer_(std::max<std::size_t>(buffer_bytes, 64))
+    {
+    }
+
+    /// True once only the trailing endianness byte is left
+    bool AtEnd()
+    {
+        if (bits_ != 0)
+        {
+            return false;
+        }
+        // Every value takes at least two bytes
+        Fill(2);
+        return end_ - pos_ < 2;
+    }
+
+    unsigned char PeekTag()
+    {
+        // No value starts inside a bit group
+        if (bits_ != 0 || !Fill(1))
+        {
+            return 0xff;
+        }
+        return buffer_[pos_];
+    }
+
+    bool ExpectTag(unsigned char tag, std::string_view what)
+    {
+        if (PeekTag() != tag) [[unlikely]]
+        {
+            Fail(what);
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    /// Raw bytes, valid until the next read
+    const unsigned char* Read(std::size_t length)
+    {
+        if (!Fill(length)) [[unlikely]]
+        {
+            Fail("value");
+            return nullptr;
+        }
+        const auto* data = buffer_.data() + pos_;
+        pos_ += length;
+        return data;
+    }
+
+    template <typename T>
+    T Read()
+    {
+        T value{};
+        if (const auto* data = Read(sizeof(T)); data != nullptr)
+        {
+            std::memcpy(&value, data, sizeof(T));
+        }
+        return value;
+    }
+
+    uint64_t ReadVarint()
+    {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7)
+        {
+            const auto* byte = Read(1);
+            if (byte == nullptr)
+            {
+                return 0;
+            }
+            value |= static_cast<uint64_t>(*byte & 0x7f) << shift;
+            if ((*byte & 0x80) == 0)
+            {
+                return value;
+            }
+        }
+        Fail("varint");
+        return 0;
+    }
+
+    /// A string value in any of its three forms; valid until the next read
+    std::string_view ReadString()
+    {
+        const auto tag = PeekTag();
+        if (tag == string_ref_tag)
+        {
+            ++pos_;
+            const auto index = ReadVarint();
+            if (index >= dictionary_.size()) [[unlikely]]
+            {
+                Fail("string reference");
+                return {};
+            }
+            return dictionary_[index];
+        }
+
+        uint64_t length = 0;
+        if (tag == string_def_tag || tag == string_varint_tag)
+        {
+            ++pos_;
+            length = ReadVarint();
+        }
+        else if (ExpectTag(string_tag, "string"))
+        {
+            const auto size = Read<int>();
+            if (size < 0) [[unlikely]]
+            {
+                Fail("string length");
+                return {};
+            }
+            length = static_cast<uint64_t>(size);
+        }
+
+        const auto* data = Read(static_cast<std::size_t>(length));
+        if (data == nullptr)
+        {
+            return {};
+        }
+        const std::string_view value(reinterpret_cast<const char*>(data), length);
+        if (tag == string_def_tag)
+        {
+            return dictionary_.emplace_back(value);
+        }
+        return value;
+    }
+
+    /// One bit: a bool written as a char value, or the next bit of a group
+    bool ReadBit(std::string_view what)
+    {
+        if (bits_ == 0)
+        {
+            if (PeekTag() == char_tag)
+            {
+                ++pos_;
+                return Read<char>() != 0;
+            }
+            if (!ExpectTag(bits_tag, what))
+            {
+                return false;
+            }
+            const auto count = ReadVarint();
+            if (count == 0) [[unlikely]]
+            {
+                Fail("bit count");
+                return false;
+            }
+            bits_  = count;
+            shift_ = 0;
+        }
+
+        if (shift_ == 0)
+        {
+            const auto* byte = Read(1);
+            if (byte == nullptr)
+            {
+                bits_ = 0;
+                return false;
+            }
+            byte_ = *byte;
+        }
+        const bool value = ((byte_ >> shift_) & 1) != 0;
+        --bits_;
+        shift_ = bits_ == 0 ? 0 : (shift_ + 1) % 8;
+        return value;
+    }
+
+    bool InBitGroup() const { return bits_ != 0; }
+
+    /// count bits, least significant first, as multi_process_stream::PopBits() reads them
+    uint64_t ReadBits(unsigned int count, std::string_view what)
+    {
+        uint64_t value = 0;
+        for (unsigned int i = 0; i < count && !Failed(); ++i)
+        {
+            value |= static_cast<uint64_t>(ReadBit(what)) << i;
+        }
+        return value;
+    }
+
+    /// A container size, also in the unsigned int form of earlier archives
+    uint64_t ReadLength()
+    {
+        if (PeekTag() == uint32_tag)
+        {
+            ++pos_;
+            return Read<unsigned int>();
+        }
+        if (!ExpectTag(length_tag, "container size"))
+        {
+            return 0;
+        }
+        return ReadVarint();
+    }
+
+    /// The tag and payload of one delta-encoded sequence, as written by the stream
+    std::vector<unsigned char> ReadDeltaValue()
+    {
+        std::vector<unsigned char> bytes;
+        const auto                 copy = [&](std::size_t length)
+        {
+            if (const auto* data = Read(length); data != nullptr)
+            {
+                bytes.insert(bytes.end(), data, data + length);
+            }
+        };
+        const auto copy_varint = [&]
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64 && !Failed(); shift += 7)
+            {
+                const auto* byte = Read(1);
+                if (byte == nullptr)
+                {
+                    break;
+                }
+                bytes.push_back(*byte);
+                value |= static_cast<uint64_t>(*byte & 0x7f) << shift;
+                if ((*byte & 0x80) == 0)
+                {
+                    break;
+                }
+            }
+            return value;
+        };
+
+        if (!ExpectTag(delta_tag, "delta-encoded sequence"))
+        {
+            return bytes;
+        }
+        bytes.push_back(delta_tag);
+        const auto count = copy_varint();
+        for (uint64_t i = 0; i < std::min<uint64_t>(count, 2); ++i)
+        {
+            copy_varint();
+        }
+        for (uint64_t begin = 2; begin < count && !Failed();
+             begin += multi_process_stream::DeltaBlockSize)
+        {
+            const auto length =
+                std::min<uint64_t>(multi_process_stream::DeltaBlockSize, count - begin);
+            const auto* width = Read(1);
+            if (width == nullptr || *width > 64)
+            {
+                Fail("delta block");
+                break;
+            }
+            bytes.push_back(*width);
+            copy(static_cast<std::size_t>((length * *width + 7) / 8));
+        }
+        return bytes;
+    }
+
+    bool Failed() const { return failed_; }
+
+    void Fail(std::string_view what)
+    {
+        if (!failed_)
+        {
+            failed_ = true;
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed binary archive: expected a {} at byte {}",
+                what,
+                consumed_ + pos_);
+        }
+    }
+
+private:
+    bool Fill(std::size_t length)
+    {
+        if (failed_)
+        {
+            return false;
+        }
+        if (end_ - pos_ >= length)
+        {
+            return true;
+        }
+
+        // Keep the unread bytes and grow for values larger than the buffer
+        std::memmove(buffer_.data(), buffer_.data() + pos_, end_ - pos_);
+        consumed_ += pos_;
+        end_ -= pos_;
+        pos_ = 0;
+        if (length > buffer_.size())
+        {
+            buffer_.resize(std::max(length, 2 * buffer_.size()));
+        }
+
+        while (end_ < length && in_)
+        {
+            in_.read(
+                reinterpret_cast<char*>(buffer_.data() + end_),
+                static_cast<std::streamsize>(buffer_.size() - end_));
+            end_ += static_cast<std::size_t>(in_.gcount());
+        }
+        return end_ >= length;
+    }
+
+    std::istream&              in_;
+    std::vector<unsigned char> buffer_;
+    std::size_t                pos_      = 0;
+    std::size_t                end_      = 0;
+    uint64_t                   consumed_ = 0;
+    bool                       failed_   = false;
+    std::deque<std::string>    dictionary_;
+    uint64_t                   bits_  = 0;  ///< bits left in the current group
+    unsigned int               shift_ = 0;  ///< position of the next bit in byte_
+    unsigned char              byte_  = 0;
+};
+
+//-----------------------------------------------------------------------------
+// JSON output
+//-----------------------------------------------------------------------------
+class json_sink
+{
+public:
+    json_sink(std::ostream& out, const transcode_options& options)
+        : out_(out),
+          indent_(options.indent),
+          limit_(std::max<std::size_t>(options.buffer_bytes, 64))
+    {
+        buffer_.reserve(limit_);
+    }
+
+    void BeginObject() { Open('{'); }
+    void EndObject() { Close('}'); }
+    void BeginArray() { Open('['); }
+    void EndArray() { Close(']'); }
+
+    void Key(std::string_view name)
+    {
+        Separator();
+        Quote(name);
+        buffer_ += indent_ >= 0 ? ": " : ":";
+        afterKey_ = true;
+    }
+
+    void String(std::string_view value)
+    {
+        Separator();
+        Quote(value);
+    }
+
+    void Bool(bool value)
+    {
+        Separator();
+        buffer_ += value ? "true" : "false";
+    }
+
+    void Null()
+    {
+        Separator();
+        buffer_ += "null";
+    }
+
+    template <typename T>
+        requires std::integral<T>
+    void Number(T value)
+    {
+        Separator();
+        char text[24];
+        const auto result = std::to_chars(text, text + sizeof(text), value);
+        buffer_.append(text, result.ptr);
+    }
+
+    void Number(double value)
+    {
+        Separator();
+        if (!std::isfinite(value))
+        {
+            // As nlohmann::json does
+            buffer_ += "null";
+            return;
+        }
+        char       text[32];
+        const auto result = std::to_chars(text, text + sizeof(text), value);
+        const std::string_view written(text, result.ptr);
+        buffer_ += written;
+        if (written.find_first_of(".e") == std::string_view::npos)
+        {
+            buffer_ += ".0";
+        }
+    }
+
+    void Finish()
+    {
+        if (indent_ >= 0)
+        {
+            buffer_ += '\n';
+        }
+        out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+        buffer_.clear();
+        out_.flush();
+    }
+
+private:
+    void Open(char bracket)
+    {
+        Separator();
+        buffer_ += bracket;
+        ++depth_;
+        first_ = true;
+    }
+
+    void Close(char bracket)
+    {
+        --depth_;
+        if (!first_)
+        {
+            NewLine();
+        }
+        buffer_ += bracket;
+        first_ = false;
+    }
+
+    void Separator()
+    {
+        if (afterKey_)
+        {
+            afterKey_ = false;
+            return;
+        }
+        if (!first_)
+        {
+            buffer_ += ',';
+        }
+        first_ = false;
+        if (depth_ > 0)
+        {
+            NewLine();
+        }
+        if (buffer_.size() >= limit_)
+        {
+            out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            buffer_.clear();
+        }
+    }
+
+    void NewLine()
+    {
+        if (indent_ >= 0)
+        {
+            buffer_ += '\n';
+            buffer_.append(static_cast<std::size_t>(depth_ * indent_), ' ');
+        }
+    }
+
+    void Quote(std::string_view value)
+    {
+        buffer_ += '"';
+        append_json_escaped(buffer_, value);
+        buffer_ += '"';
+    }
+
+    std::ostream& out_;
+    std::string   buffer_;
+    int           indent_;
+    std::size_t   limit_;
+    int           depth_    = 0;
+    bool          first_    = true;
+    bool          afterKey_ = false;
+};
+
+//-----------------------------------------------------------------------------
+// JSON input
+//-----------------------------------------------------------------------------
+struct json_number
+{
+    enum class kind
+    {
+        integer,
+        unsigned_integer,
+        floating
+    };
+
+    kind     type     = kind::integer;
+    int64_t  integer  = 0;
+    uint64_t unsigned_integer = 0;
+    double   floating = 0.0;
+};
+
+class json_source
+{
+public:
+    json_source(std::istream& in, std::size_t buffer_bytes)
+        : in_(in), buffer_(std::max<std::size_t>(buffer_bytes, 64))
+    {
+    }
+
+    /// Next non-blank character, or 0 at the end of the input
+    char Peek()
+    {
+        while (Fill())
+        {
+            const char c = buffer_[pos_];
+            if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+            {
+                return c;
+            }
+            ++pos_;
+        }
+        return 0;
+    }
+
+    bool Expect(char c)
+    {
+        if (Peek() != c) [[unlikely]]
+        {
+            Fail(std::format("'{}'", c));
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    /// Steps to the next element of an array or object; false at the closing bracket
+    bool Element(bool& first, char close)
+    {
+        if (failed_)
+        {
+            return false;
+        }
+        if (Peek() == close)
+        {
+            ++pos_;
+            return false;
+        }
+        if (!first && !Expect(','))
+        {
+            return false;
+        }
+        first = false;
+        return true;
+    }
+
+    /// A string value; valid until the next string is read
+    std::string_view String()
+    {
+        text_.clear();
+        if (!Expect('"'))
+        {
+            return {};
+        }
+        while (Fill())
+        {
+            // The run up to the next quote, backslash or control character is copied at once
+            const std::size_t run = json_escape_position(buffer_.data() + pos_, end_ - pos_);
+            text_.append(buffer_.data() + pos_, run);
+            pos_ += run;
+            if (pos_ == end_)
+            {
+                continue;
+            }
+
+            const char c = buffer_[pos_++];
+            if (c == '"')
+            {
+                if (!is_valid_utf8(text_))
+                {
+                    Fail("UTF-8 string");
+                    return {};
+                }
+                return text_;
+            }
+            if (c != '\\')
+            {
+                Fail("escaped control character");
+                return {};
+            }
+            if (!Fill())
+            {
+                break;
+            }
+            switch (const char escaped = buffer_[pos_++])
+            {
+            case 'b':
+                text_ += '\b';
+                break;
+            case 'f':
+                text_ += '\f';
+                break;
+            case 'n':
+                text_ += '\n';
+                break;
+            case 'r':
+                text_ += '\r';
+                break;
+            case 't':
+                text_ += '\t';
+                break;
+            case 'u':
+                AppendCodePoint();
+                break;
+            default:
+                text_ += escaped;
+                break;
+            }
+        }
+        Fail("end of string");
+        return {};
+    }
+
+    /// An object key followed by its colon
+    std::string_view Key()
+    {
+        String();
+        Expect(':');
+        return text_;
+    }
+
+    json_number Number()
+    {
+        json_number number;
+        std::string text;
+        Peek();
+        while (Fill())
+        {
+            const char c = buffer_[pos_];
+            if ((c < '0' || c > '9') && c != '-' && c != '+' && c != '.' && c != 'e' && c != 'E')
+            {
+                break;
+            }
+            text += c;
+            ++pos_;
+        }
+
+        const char* first = text.data();
+        const char* last  = text.data() + text.size();
+        std::errc   error = std::errc::invalid_argument;
+        if (text.find_first_of(".eE") != std::string::npos)
+        {
+            number.type = json_number::kind::floating;
+            error       = std::from_chars(first, last, number.floating).ec;
+        }
+        else if (!text.empty() && text.front() == '-')
+        {
+            number.type = json_number::kind::integer;
+            error       = std::from_chars(first, last, number.integer).ec;
+        }
+        else
+        {
+            number.type = json_number::kind::unsigned_integer;
+            error       = std::from_chars(first, last, number.unsigned_integer).ec;
+        }
+        if (error != std::errc{} || text.empty())
+        {
+            Fail("number");
+        }
+        return number;
+    }
+
+    bool Bool()
+    {
+        if (Literal("true"))
+        {
+            return true;
+        }
+        if (!Literal("false"))
+        {
+            Fail("boolean");
+        }
+        return false;
+    }
+
+    void Null()
+    {
+        if (!Literal("null"))
+        {
+            Fail("null");
+        }
+    }
+
+    bool Failed() const { return failed_; }
+
+    void Fail(std::string_view what)
+    {
+        if (!failed_)
+        {
+            failed_ = true;
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed JSON archive: expected {} at byte {}",
+                what,
+                consumed_ + pos_);
+        }
+    }
+
+    void Mismatch(std::string_view expected, std::string_view found)
+    {
+        if (!failed_)
+        {
+            failed_ = true;
+            SERIALIZATION_THROW(
+                serialization_error::error_code::missing_field,
+                "JSON archive does not match the schema: expected {} but found {} at byte {}",
+                expected,
+                found,
+                consumed_ + pos_);
+        }
+    }
+
+private:
+    bool Fill()
+    {
+        if (failed_)
+        {
+            return false;
+        }
+        if (pos_ < end_)
+        {
+            return true;
+        }
+        consumed_ += end_;
+        pos_ = end_ = 0;
+        if (in_)
+        {
+            in_.read(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+            end_ = static_cast<std::size_t>(in_.gcount());
+        }
+        return end_ > 0;
+    }
+
+    bool Literal(std::string_view word)
+    {
+        Peek();
+        for (const char c : word)
+        {
+            if (!Fill() || buffer_[pos_] != c)
+            {
+                return false;
+            }
+            ++pos_;
+        }
+        return true;
+    }
+
+    uint32_t HexQuad()
+    {
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i)
+        {
+            if (!Fill())
+            {
+                Fail("\\u escape");
+                return 0;
+            }
+            const char c     = buffer_[pos_++];
+            const int  digit = c >= '0' && c <= '9'   ? c - '0'
+                               : c >= 'a' && c <= 'f' ? c - 'a' + 10
+                               : c >= 'A' && c <= 'F' ? c - 'A' + 10
+                                                      : -1;
+            if (digit < 0)
+            {
+                Fail("\\u escape");
+                return 0;
+            }
+            value = value << 4 | static_cast<uint32_t>(digit);
+        }
+        return value;
+    }
+
+    void AppendCodePoint()
+    {
+        uint32_t code = HexQuad();
+        if (code >= 0xd800 && code < 0xdc00)
+        {
+            // Surrogate pair
+            if (!Literal("\\u"))
+            {
+                Fail("low surrogate");
+                return;
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (HexQuad() - 0xdc00);
+        }
+
+        if (code < 0x80)
+        {
+            text_ += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            text_ += static_cast<char>(0xc0 | code >> 6);
+            text_ += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            text_ += static_cast<char>(0xe0 | code >> 12);
+            text_ += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+            text_ += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else
+        {
+            text_ += static_cast<char>(0xf0 | code >> 18);
+            text_ += static_cast<char>(0x80 | (code >> 12 & 0x3f));
+            text_ += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+            text_ += static_cast<char>(0x80 | (code & 0x3f));
+        }
+    }
+
+    std::istream&     in_;
+    std::vector<char> buffer_;
+    std::size_t       pos_      = 0;
+    std::size_t       end_      = 0;
+    uint64_t          consumed_ = 0;
+    bool              failed_   = false;
+    std::string       text_;
+};
+
+//-----------------------------------------------------------------------------
+// Binary output
+//-----------------------------------------------------------------------------
+class binary_sink
+{
+public:
+    binary_sink(std::ostream& out, const transcode_options& options)
+        : out_(out), start_(out.tellp()), limit_(std::max<std::size_t>(options.buffer_bytes, 64))
+    {
+        buffer_.reserve(limit_);
+    }
+
+    void Bytes(const void* data, std::size_t length)
+    {
+        const auto* bytes = static_cast<const unsigned char*>(data);
+        buffer_.insert(buffer_.end(), bytes, bytes + length);
+        if (buffer_.size() >= limit_)
+        {
+            Flush();
+        }
+    }
+
+    template <typename T>
+    void Value(unsigned char tag, T value)
+    {
+        buffer_.push_back(tag);
+        Bytes(&value, sizeof(T));
+    }
+
+    void Varint(uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            buffer_.push_back(static_cast<unsigned char>(value | 0x80));
+            value >>= 7;
+        }
+        buffer_.push_back(static_cast<unsigned char>(value));
+    }
+
+    void String(std::string_view value)
+    {
+        buffer_.push_back(string_varint_tag);
+        Varint(value.size());
+        Bytes(value.data(), value.size());
+    }
+
+    void Length(uint64_t value)
+    {
+        const unsigned char tag = length_tag;
+        Bytes(&tag, 1);
+        Varint(value);
+    }
+
+    /// Raw data of a stream that holds complete values
+    void Stream(multi_process_stream& stream)
+    {
+        const auto data = stream.GetRawData();
+        Bytes(data.data(), data.size() - 1);
+    }
+
+    /// Writes a container size to be filled in by Patch()
+    uint64_t Placeholder()
+    {
+        buffer_.push_back(length_tag);
+        buffer_.resize(buffer_.size() + padded_length_bytes);
+        const auto position = written_ + buffer_.size() - padded_length_bytes;
+        if (buffer_.size() >= limit_)
+        {
+            Flush();
+        }
+        return position;
+    }
+
+    void Patch(uint64_t position, uint64_t value)
+    {
+        if (value > max_padded_length) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::value_out_of_range,
+                "Container of {} elements exceeds the transcoder limit of {}",
+                value,
+                max_padded_length);
+            return;
+        }
+
+        // A varint with continuation bits on every byte but the last
+        unsigned char bytes[padded_length_bytes];
+        for (std::size_t i = 0; i < padded_length_bytes; ++i)
+        {
+            bytes[i] = static_cast<unsigned char>((value >> (7 * i)) & 0x7f);
+            if (i + 1 < padded_length_bytes)
+            {
+                bytes[i] |= 0x80;
+            }
+        }
+
+        if (position >= written_)
+        {
+            std::memcpy(buffer_.data() + (position - written_), bytes, sizeof(bytes));
+            return;
+        }
+
+        // The size has already been written out
+        if (start_ < 0 || !out_.seekp(start_ + static_cast<std::streamoff>(position)) ||
+            !out_.write(reinterpret_cast<const char*>(bytes), sizeof(bytes)) ||
+            !out_.seekp(start_ + static_cast<std::streamoff>(written_)))
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::io_error,
+                "Cannot patch a container size: the binary output is not seekable");
+        }
+    }
+
+    void Finish()
+    {
+        buffer_.push_back(multi_process_stream().endianness());
+        Flush();
+        out_.flush();
+    }
+
+private:
+    void Flush()
+    {
+        out_.write(
+            reinterpret_cast<const char*>(buffer_.data()),
+            static_cast<std::streamsize>(buffer_.size()));
+        written_ += buffer_.size();
+        buffer_.clear();
+    }
+
+    std::ostream&              out_;
+    std::streamoff             start_;
+    std::size_t                limit_;
+    std::vector<unsigned char> buffer_;
+    uint64_t                   written_ = 0;
+};
+
+//-----------------------------------------------------------------------------
+// Binary to JSON
+//-----------------------------------------------------------------------------
+class json_writer
+{
+public:
+    json_writer(binary_source& in, json_sink& out, const compiled_schema* schema)
+        : in_(in), out_(out), schema_(schema)
+    {
+    }
+
+    void Root()
+    {
+        out_.BeginObject();
+        if (schema_ == nullptr)
+        {
+            out_.Key("values");
+            out_.BeginArray();
+            while (!in_.Failed() && !in_.AtEnd())
+            {
+                Untyped();
+            }
+            out_.EndArray();
+        }
+        else
+        {
+            out_.Key("root");
+            Value(*schema_->Root());
+            if (!in_.Failed() && !in_.AtEnd())
+            {
+                in_.Fail("end of the archive");
+            }
+        }
+        out_.EndObject();
+        out_.Finish();
+    }
+
+private:
+    void Value(const shape_desc& shape)
+    {
+        if (in_.Failed())
+        {
+            return;
+        }
+
+        switch (shape.kind)
+        {
+        case shape_kind::boolean:
+        {
+            const bool value = in_.ReadBit("bool");
+            if (!in_.Failed())
+            {
+                out_.Bool(value);
+            }
+            break;
+        }
+        case shape_kind::character:
+            Scalar<char>(char_tag, "char");
+            break;
+        case shape_kind::uchar:
+            Scalar<unsigned char>(uchar_tag, "unsigned char");
+            break;
+        case shape_kind::short_integer:
+            // Written with the int16 tag, as int64 by 64-bit peers, or by older
+            // streams with the int32 tag and two bytes
+            if (in_.PeekTag() == int64_tag)
+            {
+                Scalar<int64_t>(int64_tag, "short");
+            }
+            else if (in_.PeekTag() == int32_tag)
+            {
+                Scalar<short>(int32_tag, "short");
+            }
+            else
+            {
+                Scalar<short>(int16_tag, "short");
+            }
+            break;
+        case shape_kind::uint16:
+            Scalar<uint16_t>(uint16_tag, "uint16");
+            break;
+        case shape_kind::int32:
+            Scalar<int>(int32_tag, "int32");
+            break;
+        case shape_kind::uint32:
+            Scalar<unsigned int>(uint32_tag, "uint32");
+            break;
+        case shape_kind::int64:
+            Scalar<int64_t>(int64_tag, "int64");
+            break;
+        case shape_kind::uint64:
+            Scalar<uint64_t>(in_.PeekTag() == uint64_tag ? uint64_tag : size_tag, "uint64");
+            break;
+        case shape_kind::float32:
+            if (in_.ExpectTag(float_tag, "float"))
+            {
+                out_.Number(static_cast<double>(in_.Read<float>()));
+            }
+            break;
+        case shape_kind::float64:
+            if (in_.ExpectTag(double_tag, "double"))
+            {
+                out_.Number(in_.Read<double>());
+            }
+            break;
+        case shape_kind::string:
+        {
+            Text(in_.ReadString());
+            break;
+        }
+        case shape_kind::monostate:
+            if (in_.ExpectTag(uchar_tag, "monostate"))
+            {
+                in_.Read<unsigned char>();
+                out_.Null();
+            }
+            break;
+        case shape_kind::none:
+            out_.Null();
+            break;
+        case shape_kind::enumeration:
+            Enumeration(shape);
+            break;
+        case shape_kind::object:
+            Object(in_.ReadString(), shape.type);
+            break;
+        case shape_kind::pointer:
+            if (in_.ReadString() == empty_name)
+            {
+                Object(empty_name, shape.type);
+            }
+            else
+            {
+                // The object repeats the class name of the pointer
+                Object(in_.ReadString(), shape.type);
+            }
+            break;
+        case shape_kind::sequence:
+        case shape_kind::map:
+        case shape_kind::tuple:
+            if (is_object_map(shape))
+            {
+                ObjectMap(shape);
+            }
+            else if (shape.base64)
+            {
+                ByteString(shape);
+            }
+            else
+            {
+                Sequence(shape);
+            }
+            break;
+        case shape_kind::pair:
+            out_.BeginArray();
+            Value(*shape.children[0]);
+            Value(*shape.children[1]);
+            out_.EndArray();
+            break;
+        case shape_kind::optional:
+            Optional(shape);
+            break;
+        case shape_kind::variant:
+            Variant(shape);
+            break;
+        }
+    }
+
+    template <typename T>
+    void Scalar(unsigned char tag, std::string_view what)
+    {
+        if (in_.ExpectTag(tag, what))
+        {
+            const auto value = in_.Read<T>();
+            if constexpr (std::is_signed_v<T>)
+            {
+                out_.Number(static_cast<int64_t>(value));
+            }
+            else
+            {
+                out_.Number(static_cast<uint64_t>(value));
+            }
+        }
+    }
+
+    /// A string value; JSON requires UTF-8, so other bytes are rejected as nlohmann::json does
+    void Text(std::string_view value)
+    {
+        if (in_.Failed())
+        {
+            return;
+        }
+        if (!is_valid_utf8(value))
+        {
+            in_.Fail("UTF-8 string");
+            return;
+        }
+        out_.String(value);
+    }
+
+    void Enumeration(const shape_desc& shape)
+    {
+        if (in_.ExpectTag(int32_tag, "enum"))
+        {
+            out_.String(EnumeratorName(shape, in_.Read<int>()));
+        }
+    }
+
+    static std::string EnumeratorName(const shape_desc& shape, int value)
+    {
+        const auto it = std::ranges::find(
+            shape.enumerators, value, &std::pair<std::string, int>::second);
+        return it != shape.enumerators.end() ? it->first : std::to_string(value);
+    }
+
+    void Object(std::string_view class_name, const type_desc* static_type)
+    {
+        if (in_.Failed())
+        {
+            return;
+        }
+        const nesting_guard nesting(depth_);
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        out_.BeginObject();
+        out_.Key(class_key);
+        out_.String(class_name);
+        if (class_name != empty_name)
+        {
+            const auto* type = static_type != nullptr && static_type->name == class_name
+                                   ? static_type
+                                   : schema_->Find(class_name);
+            if (type == nullptr)
+            {
+                SERIALIZATION_THROW(
+                    serialization_error::error_code::registry_not_found,
+                    "The schema does not describe class {}",
+                    class_name);
+                return;
+            }
+
+            for (const auto& field : type->fields)
+            {
+                out_.Key(field.name);
+                if (field.encoding.active())
+                {
+                    Encoded(field);
+                }
+                else
+                {
+                    Value(*field.shape);
+                }
+                SERIALIZATION_RETURN_IF_ERROR();
+            }
+        }
+        out_.EndObject();
+    }
+
+    void Encoded(const field_desc& field)
+    {
+        if (field.encoding.kind == encoding_kind::bits)
+        {
+            const auto value = in_.ReadBits(
+                static_cast<unsigned int>(field.encoding.width), "bit-encoded value");
+            if (in_.Failed())
+            {
+                return;
+            }
+            if (field.shape->kind == shape_kind::enumeration)
+            {
+                out_.String(EnumeratorName(*field.shape, static_cast<int>(value)));
+            }
+            else
+            {
+                out_.Number(value);
+            }
+            return;
+        }
+
+        multi_process_stream scratch;
+        if (field.encoding.kind == encoding_kind::delta_of_delta)
+        {
+            auto bytes = in_.ReadDeltaValue();
+            bytes.push_back(scratch.endianness());
+            scratch.SetRawData(bytes);
+
+            const auto element = field.shape->children.empty() ? shape_kind::int64
+                                                                : field.shape->children[0]->kind;
+            out_.BeginArray();
+            if (element == shape_kind::uint64 || element == shape_kind::uint32 ||
+                element == shape_kind::uint16 || element == shape_kind::uchar)
+            {
+                for (const auto value : scratch.PopDeltaEncoded<uint64_t>())
+                {
+                    out_.Number(value);
+                }
+            }
+            else
+            {
+                for (const auto value : scratch.PopDeltaEncoded<int64_t>())
+                {
+                    out_.Number(value);
+                }
+            }
+            out_.EndArray();
+        }
+        else
+        {
+            // One scalar: the tag and a payload whose width the tag implies
+            const auto  tag   = in_.PeekTag();
+            std::size_t width = tag == float_tag || tag == int32_tag || tag == uint32_tag ? 4
+                                : tag == uint16_tag                                       ? 2
+                                : tag == double_tag                                       ? 8
+                                                                                          : 0;
+            if (width == 0)
+            {
+                in_.Fail("encoded value");
+                return;
+            }
+            const auto*                data = in_.Read(width + 1);
+            std::vector<unsigned char> bytes;
+            if (data != nullptr)
+            {
+                bytes.assign(data, data + width + 1);
+            }
+            bytes.push_back(scratch.endianness());
+            scratch.SetRawData(bytes);
+            out_.Number(detail::load_encoded_value(scratch, field.encoding));
+        }
+
+        if (scratch.HasError())
+        {
+            in_.Fail("encoded value");
+        }
+    }
+
+    uint64_t Size() { return in_.ReadLength(); }
+
+    void Sequence(const shape_desc& shape)
+    {
+        const auto size = Size();
+        if (shape.kind == shape_kind::tuple && size != shape.children.size())
+        {
+            in_.Fail(std::format("tuple of {} elements", shape.children.size()));
+        }
+
+        out_.BeginArray();
+        for (uint64_t i = 0; i < size && !in_.Failed(); ++i)
+        {
+            const auto child = shape.kind == shape_kind::sequence ? 0
+                               : shape.kind == shape_kind::map    ? i % 2
+                                                                  : i;
+            Value(*shape.children[child]);
+            SERIALIZATION_RETURN_IF_ERROR();
+        }
+        out_.EndArray();
+    }
+
+    /// Byte containers are written to JSON as one base64 string
+    void ByteString(const shape_desc& shape)
+    {
+        const auto size    = Size();
+        const bool is_enum = shape.children[0]->kind == shape_kind::enumeration;
+        bytes_.clear();
+        for (uint64_t i = 0; i < size && !in_.Failed(); ++i)
+        {
+            if (is_enum && in_.ExpectTag(int32_tag, "enum"))
+            {
+                bytes_.push_back(static_cast<unsigned char>(in_.Read<int>()));
+            }
+            else if (!is_enum && in_.ExpectTag(uchar_tag, "unsigned char"))
+            {
+                bytes_.push_back(in_.Read<unsigned char>());
+            }
+        }
+        if (in_.Failed())
+        {
+            return;
+        }
+
+        text_.clear();
+        append_base64(text_, bytes_.data(), bytes_.size());
+        out_.String(text_);
+    }
+
+    void ObjectMap(const shape_desc& shape)
+    {
+        const auto size = Size();
+        if (size % 2 != 0)
+        {
+            in_.Fail("an even number of map elements");
+            return;
+        }
+
+        const auto& key_shape = *shape.children[0];
+        out_.BeginObject();
+        for (uint64_t i = 0; i < size / 2 && !in_.Failed(); ++i)
+        {
+            if (key_shape.kind == shape_kind::string)
+            {
+                const auto key = in_.ReadString();
+                if (!in_.Failed() && !is_valid_utf8(key))
+                {
+                    in_.Fail("UTF-8 string");
+                }
+                out_.Key(key);
+            }
+            else if (in_.ExpectTag(int32_tag, "enum"))
+            {
+                out_.Key(EnumeratorName(key_shape, in_.Read<int>()));
+            }
+            Value(*shape.children[1]);
+            SERIALIZATION_RETURN_IF_ERROR();
+        }
+        out_.EndObject();
+    }
+
+    void Optional(const shape_desc& shape)
+    {
+        Size();
+        const bool has_value = in_.ReadBit("optional flag");
+        if (in_.Failed())
+        {
+            return;
+        }
+
+        out_.BeginArray();
+        out_.Bool(has_value);
+        if (has_value)
+        {
+            Value(*shape.children[0]);
+        }
+        out_.EndArray();
+    }
+
+    void Variant(const shape_desc& shape)
+    {
+        if (!in_.ExpectTag(uint32_tag, "variant index"))
+        {
+            return;
+        }
+        const auto index = in_.Read<unsigned int>();
+        if (index >= shape.children.size())
+        {
+            in_.Fail(std::format("variant index below {}", shape.children.size()));
+            return;
+        }
+
+        out_.BeginObject();
+        out_.Key(index_key);
+        out_.Number(index);
+        out_.Key(value_key);
+        Value(*shape.children[index]);
+        out_.EndObject();
+    }
+
+    // Without a schema every value is written as the scalar its tag names
+    void Untyped()
+    {
+        // Bits of a group are listed one at a time, as bools
+        if (in_.InBitGroup() || in_.PeekTag() == bits_tag)
+        {
+            const bool value = in_.ReadBit("bit");
+            if (!in_.Failed())
+            {
+                out_.Bool(value);
+            }
+            return;
+        }
+
+        switch (in_.PeekTag())
+        {
+        case int32_tag:
+            Scalar<int>(int32_tag, "int32");
+            break;
+        case uint32_tag:
+            Scalar<unsigned int>(uint32_tag, "uint32");
+            break;
+        case char_tag:
+            Scalar<char>(char_tag, "char");
+            break;
+        case uchar_tag:
+            Scalar<unsigned char>(uchar_tag, "unsigned char");
+            break;
+        case double_tag:
+            in_.ExpectTag(double_tag, "double");
+            out_.Number(in_.Read<double>());
+            break;
+        case float_tag:
+            in_.ExpectTag(float_tag, "float");
+            out_.Number(static_cast<double>(in_.Read<float>()));
+            break;
+        case int64_tag:
+            Scalar<int64_t>(int64_tag, "int64");
+            break;
+        case uint64_tag:
+            Scalar<uint64_t>(uint64_tag, "uint64");
+            break;
+        case size_tag:
+            Scalar<std::size_t>(size_tag, "size");
+            break;
+        case int16_tag:
+            Scalar<int16_t>(int16_tag, "int16");
+            break;
+        case uint16_tag:
+            Scalar<uint16_t>(uint16_tag, "uint16");
+            break;
+        case string_tag:
+        case string_varint_tag:
+        case string_def_tag:
+        case string_ref_tag:
+        {
+            Text(in_.ReadString());
+            break;
+        }
+        case length_tag:
+            out_.Number(in_.ReadLength());
+            break;
+        case delta_tag:
+        {
+            const field_desc field{"", nullptr, encoding::delta_of_delta()};
+            const shape_desc sequence{shape_kind::sequence};
+            Encoded({field.name, &sequence, field.encoding});
+            break;
+        }
+        default:
+            in_.Fail("type tag");
+            break;
+        }
+    }
+
+    binary_source&             in_;
+    json_sink&                 out_;
+    const compiled_schema*     schema_;
+    std::vector<unsigned char> bytes_;
+    std::string                text_;
+    std::size_t                depth_ = 0;
+};
+
+//-----------------------------------------------------------------------------
+// JSON to binary
+//-----------------------------------------------------------------------------
+class binary_writer
+{
+public:
+    binary_writer(json_source& in, binary_sink& out, const compiled_schema& schema)
+        : in_(in), out_(out), schema_(schema)
+    {
+    }
+
+    void Root()
+    {
+        bool first = true;
+        in_.Expect('{');
+        if (in_.Element(first, '}'))
+        {
+            if (in_.Key() != "root")
+            {
+                in_.Mismatch("\"root\"", "another member");
+                return;
+            }
+            Value(*schema_.Root());
+            SERIALIZATION_RETURN_IF_ERROR();
+            if (in_.Element(first, '}'))
+            {
+                in_.Mismatch("the end of the document", "another member");
+                return;
+            }
+        }
+        else
+        {
+            in_.Mismatch("\"root\"", "an empty document");
+            return;
+        }
+        if (!in_.Failed())
+        {
+            out_.Finish();
+        }
+    }
+
+private:
+    void Value(const shape_desc& shape)
+    {
+        if (in_.Failed())
+        {
+            return;
+        }
+
+        switch (shape.kind)
+        {
+        case shape_kind::boolean:
+            out_.Value(char_tag, static_cast<char>(in_.Bool()));
+            break;
+        case shape_kind::character:
+            out_.Value(char_tag, static_cast<char>(Integer<int64_t>(-128, 255)));
+            break;
+        case shape_kind::uchar:
+            out_.Value(uchar_tag, static_cast<unsigned char>(Integer<uint64_t>(0, 255)));
+            break;
+        case shape_kind::short_integer:
+            out_.Value(int16_tag, static_cast<short>(Integer<int64_t>(-32768, 32767)));
+            break;
+        case shape_kind::uint16:
+            out_.Value(uint16_tag, static_cast<uint16_t>(Integer<uint64_t>(0, 65535)));
+            break;
+        case shape_kind::int32:
+            out_.Value(int32_tag, static_cast<int>(Integer<int64_t>(INT32_MIN, INT32_MAX)));
+            break;
+        case shape_kind::uint32:
+            out_.Value(uint32_tag, static_cast<unsigned int>(Integer<uint64_t>(0, UINT32_MAX)));
+            break;
+        case shape_kind::int64:
+            out_.Value(int64_tag, Integer<int64_t>(INT64_MIN, INT64_MAX));
+            break;
+        case shape_kind::uint64:
+            out_.Value(size_tag, static_cast<std::size_t>(Integer<uint64_t>(0, UINT64_MAX)));
+            break;
+        case shape_kind::float32:
+            out_.Value(float_tag, static_cast<float>(Floating()));
+            break;
+        case shape_kind::float64:
+            out_.Value(double_tag, Floating());
+            break;
+        case shape_kind::string:
+            out_.String(in_.String());
+            break;
+        case shape_kind::monostate:
+            in_.Null();
+            out_.Value(uchar_tag, static_cast<unsigned char>(0));
+            break;
+        case shape_kind::none:
+            in_.Null();
+            break;
+        case shape_kind::enumeration:
+            Enumeration(shape);
+            break;
+        case shape_kind::object:
+        case shape_kind::pointer:
+            Object(shape);
+            break;
+        case shape_kind::sequence:
+        case shape_kind::map:
+        case shape_kind::tuple:
+            if (is_object_map(shape))
+            {
+                ObjectMap(shape);
+            }
+            else if (shape.base64)
+            {
+                ByteString(shape);
+            }
+            else
+            {
+                Sequence(shape);
+            }
+            break;
+        case shape_kind::pair:
+        {
+            bool first = true;
+            in_.Expect('[');
+            for (const auto* child : shape.children)
+            {
+                if (!in_.Element(first, ']'))
+                {
+                    in_.Mismatch("a pair", "a shorter array");
+                    return;
+                }
+                Value(*child);
+            }
+            if (in_.Element(first, ']'))
+            {
+                in_.Mismatch("a pair", "a longer array");
+            }
+            break;
+        }
+        case shape_kind::optional:
+            Optional(shape);
+            break;
+        case shape_kind::variant:
+            Variant(shape);
+            break;
+        }
+    }
+
+    template <typename T>
+    T Integer(T min, T max)
+    {
+        const auto number = in_.Number();
+        if (in_.Failed())
+        {
+            return 0;
+        }
+
+        bool in_range = false;
+        T    value    = 0;
+        if (number.type == json_number::kind::integer)
+        {
+            in_range = std::cmp_greater_equal(number.integer, min) &&
+                       std::cmp_less_equal(number.integer, max);
+            value = static_cast<T>(number.integer);
+        }
+        else if (number.type == json_number::kind::unsigned_integer)
+        {
+            in_range = std::cmp_greater_equal(number.unsigned_integer, min) &&
+                       std::cmp_less_equal(number.unsigned_integer, max);
+            value = static_cast<T>(number.unsigned_integer);
+        }
+        if (!in_range)
+        {
+            in_.Mismatch("an integer in range", "another number");
+        }
+        return value;
+    }
+
+    double Floating()
+    {
+        const auto number = in_.Number();
+        switch (number.type)
+        {
+        case json_number::kind::integer:
+            return static_cast<double>(number.integer);
+        case json_number::kind::unsigned_integer:
+            return static_cast<double>(number.unsigned_integer);
+        case json_number::kind::floating:
+            break;
+        }
+        return number.floating;
+    }
+
+    void Enumeration(const shape_desc& shape)
+    {
+        if (in_.Peek() != '"')
+        {
+            out_.Value(int32_tag, static_cast<int>(Integer<int64_t>(INT32_MIN, INT32_MAX)));
+            return;
+        }
+
+        Enumerator(shape, in_.String());
+    }
+
+    void Enumerator(const shape_desc& shape, std::string_view name)
+    {
+        const auto value = EnumeratorValue(shape, name);
+        if (!in_.Failed())
+        {
+            out_.Value(int32_tag, value);
+        }
+    }
+
+    /// Value of an enumerator name (in any case) or of a number written as a name
+    int EnumeratorValue(const shape_desc& shape, std::string_view name)
+    {
+        const auto it = std::ranges::find_if(
+            shape.enumerators,
+            [name](const auto& enumerator)
+            {
+                return std::ranges::equal(
+                    enumerator.first,
+                    name,
+                    [](char a, char b) { return std::tolower(a) == std::tolower(b); });
+            });
+
+        int value = 0;
+        if (it != shape.enumerators.end())
+        {
+            value = it->second;
+        }
+        else if (std::from_chars(name.data(), name.data() + name.size(), value).ec != std::errc{})
+        {
+            in_.Mismatch("an enumerator", name);
+            return 0;
+        }
+        return value;
+    }
+
+    void Object(const shape_desc& shape)
+    {
+        const nesting_guard nesting(depth_);
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        bool first = true;
+        if (!in_.Expect('{') || !in_.Element(first, '}') || in_.Key() != class_key)
+        {
+            in_.Mismatch("\"Class\" first", "another member");
+            return;
+        }
+        const std::string class_name(in_.String());
+        out_.String(class_name);
+        if (class_name == empty_name)
+        {
+            if (in_.Element(first, '}'))
+            {
+                in_.Mismatch("a null object", "members");
+            }
+            return;
+        }
+
+        // Pointers are followed by the object, which repeats the class name
+        if (shape.kind == shape_kind::pointer)
+        {
+            out_.String(class_name);
+        }
+
+        const auto* type = shape.type != nullptr && shape.type->name == class_name
+                               ? shape.type
+                               : schema_.Find(class_name);
+        if (type == nullptr)
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::registry_not_found,
+                "The schema does not describe class {}",
+                class_name);
+            return;
+        }
+
+        for (const auto& field : type->fields)
+        {
+            if (!in_.Element(first, '}'))
+            {
+                in_.Mismatch(field.name, "the end of the object");
+                return;
+            }
+            if (const auto key = in_.Key(); key != field.name)
+            {
+                in_.Mismatch(field.name, key);
+                return;
+            }
+
+            if (field.encoding.active())
+            {
+                Encoded(field);
+            }
+            else
+            {
+                Value(*field.shape);
+            }
+            SERIALIZATION_RETURN_IF_ERROR();
+        }
+        if (in_.Element(first, '}'))
+        {
+            in_.Mismatch(std::format("the end of {}", class_name), "another member");
+        }
+    }
+
+    void Encoded(const field_desc& field)
+    {
+        multi_process_stream scratch;
+        if (field.encoding.kind == encoding_kind::delta_of_delta)
+        {
+            const auto element = field.shape->children.empty() ? shape_kind::int64
+                                                                : field.shape->children[0]->kind;
+            const bool is_unsigned = element == shape_kind::uint64 ||
+                                     element == shape_kind::uint32 ||
+                                     element == shape_kind::uint16 || element == shape_kind::uchar;
+
+            std::vector<uint64_t> values;
+            bool                  first = true;
+            in_.Expect('[');
+            while (in_.Element(first, ']'))
+            {
+                values.push_back(
+                    is_unsigned ? Integer<uint64_t>(0, UINT64_MAX)
+                                : static_cast<uint64_t>(Integer<int64_t>(INT64_MIN, INT64_MAX)));
+            }
+            scratch.PushDeltaEncoded(values);
+        }
+        else if (field.encoding.kind == encoding_kind::bits)
+        {
+            uint64_t value = 0;
+            if (field.shape->kind != shape_kind::enumeration)
+            {
+                value = Integer<uint64_t>(0, UINT64_MAX);
+            }
+            else if (in_.Peek() == '"')
+            {
+                value = static_cast<uint64_t>(EnumeratorValue(*field.shape, in_.String()));
+            }
+            else
+            {
+                value = static_cast<uint64_t>(Integer<int64_t>(INT32_MIN, INT32_MAX));
+            }
+            SERIALIZATION_RETURN_IF_ERROR();
+            detail::save_encoded(scratch, value, field.encoding);
+        }
+        else
+        {
+            detail::save_encoded(scratch, Floating(), field.encoding);
+        }
+        out_.Stream(scratch);
+    }
+
+    void Sequence(const shape_desc& shape)
+    {
+        const auto position = out_.Placeholder();
+
+        uint64_t size  = 0;
+        bool     first = true;
+        in_.Expect('[');
+        while (in_.Element(first, ']'))
+        {
+            if (shape.kind == shape_kind::tuple && size == shape.children.size())
+            {
+                in_.Mismatch(std::format("a tuple of {}", shape.children.size()), "more");
+                return;
+            }
+            const auto child = shape.kind == shape_kind::sequence ? 0
+                               : shape.kind == shape_kind::map    ? size % 2
+                                                                  : size;
+            Value(*shape.children[child]);
+            SERIALIZATION_RETURN_IF_ERROR();
+            ++size;
+        }
+
+        if ((shape.kind == shape_kind::tuple && size != shape.children.size()) ||
+            (shape.kind == shape_kind::map && size % 2 != 0))
+        {
+            in_.Mismatch(
+                std::format("a complete {}", shape.kind == shape_kind::map ? "map" : "tuple"),
+                std::format("{} elements", size));
+            return;
+        }
+        out_.Patch(position, size);
+    }
+
+    void ByteString(const shape_desc& shape)
+    {
+        // Accept the arrays of archives written before byte containers became base64 strings
+        if (in_.Peek() != '"')
+        {
+            Sequence(shape);
+            return;
+        }
+
+        const auto text = in_.String();
+        const auto size = base64_decoded_size(text);
+        if (in_.Failed())
+        {
+            return;
+        }
+        bytes_.resize(size == std::string_view::npos ? 0 : size);
+        if (size == std::string_view::npos || !decode_base64(text, bytes_.data()))
+        {
+            in_.Fail("base64 string");
+            return;
+        }
+
+        const bool is_enum = shape.children[0]->kind == shape_kind::enumeration;
+        out_.Length(size);
+        for (const unsigned char byte : bytes_)
+        {
+            if (is_enum)
+            {
+                out_.Value(int32_tag, static_cast<int>(byte));
+            }
+            else
+            {
+                out_.Value(uchar_tag, byte);
+            }
+        }
+    }
+
+    void ObjectMap(const shape_desc& shape)
+    {
+        // Accept the flat key/value arrays of archives written before maps became objects
+        if (in_.Peek() == '[')
+        {
+            Sequence(shape);
+            return;
+        }
+
+        const auto  position  = out_.Placeholder();
+        const auto& key_shape = *shape.children[0];
+
+        uint64_t size  = 0;
+        bool     first = true;
+        in_.Expect('{');
+        while (in_.Element(first, '}'))
+        {
+            const auto name = in_.Key();
+            if (key_shape.kind == shape_kind::string)
+            {
+                out_.String(name);
+            }
+            else
+            {
+                Enumerator(key_shape, name);
+            }
+            Value(*shape.children[1]);
+            SERIALIZATION_RETURN_IF_ERROR();
+            size += 2;
+        }
+        out_.Patch(position, size);
+    }
+
+    void Optional(const shape_desc& shape)
+    {
+        bool first = true;
+        in_.Expect('[');
+        if (!in_.Element(first, ']'))
+        {
+            in_.Mismatch("an optional", "an empty array");
+            return;
+        }
+
+        const bool has_value = in_.Bool();
+        out_.Length(2);
+        out_.Value(char_tag, static_cast<char>(has_value));
+        if (has_value)
+        {
+            if (!in_.Element(first, ']'))
+            {
+                in_.Mismatch("an optional value", "the end of the array");
+                return;
+            }
+            Value(*shape.children[0]);
+        }
+        if (in_.Element(first, ']'))
+        {
+            in_.Mismatch("the end of an optional", "more elements");
+        }
+    }
+
+    void Variant(const shape_desc& shape)
+    {
+        bool first = true;
+        in_.Expect('{');
+        if (!in_.Element(first, '}') || in_.Key() != index_key)
+        {
+            in_.Mismatch("\"Index\"", "another member");
+            return;
+        }
+        const auto index = Integer<uint64_t>(0, shape.children.size() - 1);
+        out_.Value(uint32_tag, static_cast<unsigned int>(index));
+
+        if (!in_.Element(first, '}') || in_.Key() != value_key)
+        {
+            in_.Mismatch("\"Value\"", "another member");
+            return;
+        }
+        Value(*shape.children[static_cast<std::size_t>(index)]);
+        if (in_.Element(first, '}'))
+        {
+            in_.Mismatch("the end of a variant", "another member");
+        }
+    }
+
+    json_source&               in_;
+    binary_sink&               out_;
+    const compiled_schema&     schema_;
+    std::vector<unsigned char> bytes_;
+    std::size_t                depth_ = 0;
+};
+}  // namespace
+
+//----------------------------------------------------------------------------
+void transcode_to_json(
+    std::istream& binary, std::ostream& out, const json* schema, const transcode_options& options)
+{
+    std::optional<compiled_schema> compiled;
+    if (schema != nullptr)
+    {
+        compiled.emplace(*schema);
+        SERIALIZATION_RETURN_IF_ERROR();
+    }
+
+    binary_source in(binary, options.buffer_bytes);
+    json_sink     sink(out, options);
+    json_writer(in, sink, compiled ? &*compiled : nullptr).Root();
+}
+
+//----------------------------------------------------------------------------
+void transcode_to_binary(
+    std::istream& in, std::ostream& binary, const json& schema, const transcode_options& options)
+{
+    const compiled_schema compiled(schema);
+    SERIALIZATION_RETURN_IF_ERROR();
+
+    json_source source(in, options.buffer_bytes);
+    binary_sink sink(binary, options);
+    binary_writer(source, sink, compiled).Root();
+}
+}  // namespace serialization
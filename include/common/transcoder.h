@@ -0,0 +1,86 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file transcoder.h
+ * @brief Convert binary archives to JSON and back without linking the C++ types
+ *
+ * The transcoder reads and writes the file layouts of access::write_to_binary()
+ * and access::write_to_json(), one value at a time: memory is bounded by the
+ * I/O buffers, the nesting depth, the largest single string, byte container or
+ * encoded field, and the string dictionary of the input. Neither side is ever held as a tree.
+ *
+ * The type tags of multi_process_stream identify every scalar, but not which
+ * strings are class names or which unsigned integers are container sizes, so
+ * field names and structure come from a schema written by export_schema() (see
+ * serialization_schema.h). Without a schema, transcode_to_json() lists the
+ * scalars in archive order as {"values": [...]}, bits of a bit group as one
+ * bool each, which is enough to inspect an archive but cannot be converted back.
+ *
+ * The JSON side must keep the member order written by save(), with "Class"
+ * first in every object. Container sizes are written before their elements,
+ * so converting to binary writes each size as a fixed five-byte varint and
+ * patches it once the container is closed; sizes that have already left the
+ * output buffer need a seekable stream. The result therefore loads like the
+ * archive save() writes, but is not byte-identical to it.
+ */
+
+#include <cstddef>
+#include <iosfwd>
+#include <nlohmann/json.hpp>
+
+#include "util/export.h"
+
+namespace serialization
+{
+using json = nlohmann::ordered_json;
+
+/**
+ * @brief Settings of the streaming transcoder
+ */
+struct transcode_options
+{
+    /// JSON indentation in spaces; negative writes compact JSON
+    int indent = -1;
+    /// Size of the input and output buffers
+    std::size_t buffer_bytes = std::size_t{1} << 20;
+};
+
+/**
+ * @brief Convert a binary archive to JSON
+ * @param binary Archive written by access::write_to_binary()
+ * @param out Receives {"root": value}, or {"values": [...]} without a schema
+ * @param schema Document returned by export_schema(), or nullptr
+ */
+SERIALIZATION_API void transcode_to_json(
+    std::istream&            binary,
+    std::ostream&            out,
+    const json*              schema  = nullptr,
+    const transcode_options& options = {});
+
+/**
+ * @brief Convert a JSON archive to binary
+ * @param in Document of the form {"root": value}, as written by access::write_to_json()
+ * @param binary Receives the archive, readable by access::read_from_binary()
+ * @param schema Document returned by export_schema()
+ */
+SERIALIZATION_API void transcode_to_binary(
+    std::istream&            in,
+    std::ostream&            binary,
+    const json&              schema,
+    const transcode_options& options = {});
+}  // namespace serialization
@@ -0,0 +1,125 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file type_name.h
+ * @brief Compile-time type names
+ *
+ * Type names are extracted from the compiler's pretty function signature and
+ * cleaned up the same way demangle() cleans up RTTI names, so that they can be
+ * used as archive class names and registry keys without any work at run time.
+ */
+
+#include <array>
+#include <cstddef>
+#include <string_view>
+
+namespace serialization
+{
+namespace detail
+{
+template <typename T>
+constexpr std::string_view function_signature() noexcept
+{
+#if defined(__clang__) || defined(__GNUC__)
+    return __PRETTY_FUNCTION__;
+#elif defined(_MSC_VER)
+    return __FUNCSIG__;
+#else
+#error "serialization::type_name requires __PRETTY_FUNCTION__ or __FUNCSIG__"
+#endif
+}
+
+// Offsets of the type inside the signature, measured once on a known type.
+inline constexpr std::string_view probe_signature = function_signature<double>();
+inline constexpr std::size_t      signature_prefix = probe_signature.find("double");
+inline constexpr std::size_t      signature_suffix =
+    probe_signature.size() - signature_prefix - std::string_view("double").size();
+
+template <typename T>
+constexpr std::string_view raw_type_name() noexcept
+{
+    constexpr std::string_view signature = function_signature<T>();
+    return signature.substr(
+        signature_prefix, signature.size() - signature_prefix - signature_suffix);
+}
+
+// Same clean-up as demangle(): drop "class ", spaces and the libc++ inline namespace.
+inline constexpr std::array<std::string_view, 3> erased_tokens{"class ", " ", "__1::"};
+
+constexpr std::size_t normalized_length(std::string_view raw, char* out = nullptr) noexcept
+{
+    std::size_t length = 0;
+    for (std::size_t i = 0; i < raw.size();)
+    {
+        bool erased = false;
+        for (const auto token : erased_tokens)
+        {
+            if (raw.substr(i, token.size()) == token)
+            {
+                i += token.size();
+                erased = true;
+                break;
+            }
+        }
+
+        if (!erased)
+        {
+            if (out != nullptr)
+            {
+                out[length] = raw[i];
+            }
+            ++length;
+            ++i;
+        }
+    }
+    return length;
+}
+
+template <typename T>
+struct type_name_storage
+{
+    static constexpr std::string_view raw    = raw_type_name<T>();
+    static constexpr std::size_t      length = normalized_length(raw);
+
+    static constexpr auto buffer = []
+    {
+        std::array<char, length + 1> result{};
+        normalized_length(raw, result.data());
+        return result;
+    }();
+};
+}  // namespace detail
+
+/**
+ * @brief Name of a type, computed at compile time
+ * @tparam T The type to get the name for
+ * @return A view on static storage, e.g. "std::vector<double>" or "test::my_class"
+ * @note Names follow the compiler's spelling, so they are only guaranteed to be
+ *       stable between binaries built with the same toolchain.
+ * @example
+ * @code
+ * static_assert(serialization::type_name<int>() == "int");
+ * @endcode
+ */
+template <typename T>
+[[nodiscard]] constexpr std::string_view type_name() noexcept
+{
+    using storage = detail::type_name_storage<T>;
+    return {storage::buffer.data(), storage::length};
+}
+}  // namespace serialization
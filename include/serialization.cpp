@@ -3,9 +3,12 @@
 #include <algorithm>
 #include <cstddef>
 #include <fstream>
-#include <iomanip>
+#include <iterator>
+#include <string>
 
 #include "common/archiver_wrapper.h"
+#include "common/serialization_error.h"
+#include "util/json_text.h"
 
 namespace serialization::serialization_impl
 {
@@ -35,13 +38,25 @@ void access::read_binary(const std::string& fn, std::vector<unsigned char>& buff
 
 void access::read_json(const std::string& path, json& root)
 {
-    std::ifstream str(path);
-    str >> root;
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::io_error, "Cannot open JSON file {}", path);
+        return;
+    }
+    const std::string text(std::istreambuf_iterator<char>(in), {});
+    parse_json(text, root);
 }
 
 void access::write_json(const std::string& path, const json& root)
 {
-    std::ofstream str(path);
-    str << std::setw(1) << root << std::endl;
+    std::string text;
+    dump_json(text, root, 1);
+    SERIALIZATION_RETURN_IF_ERROR();
+    text += '\n';
+
+    std::ofstream out(path, std::ios::binary);
+    out.write(text.data(), static_cast<std::streamsize>(text.size()));
 }
 }  // namespace serialization::serialization_impl
@@ -17,30 +17,35 @@ limitations under the License.
 
 
 #include <filesystem>
+#include <span>
 #include <string>
 #include <vector>
 
 #include "common/archiver_wrapper.h"
 #include "serialization_impl.h"
 #include "util/export.h"
+#include "util/json_text.h"
 #include "util/multi_process_stream.h"
+#include "util/concurrent_record_appender.h"
+#include "util/message_batch.h"
 #include "util/pointer.h"
+#include "util/record_log.h"
 #include "util/registry.h"
 
 namespace serialization
 {
 #define COMMA ,
-#define SERIALIZATION_REGISTER_DERIVED_SERIALIZATION(type)                                        \
-    static serialization::RegistererJsonSerializationRegistry SERIALIZATION_ANONYMOUS_VARIABLE(   \
-        g_JsonSerializationRegistry)(                                                             \
-        serialization::demangle(typeid(type).name()),                                             \
-        serialization::JsonSerializationRegistry(),                                               \
-        &serialization::register_serializer_impl<serialization::json COMMA type>);                \
-    static serialization::RegistererBinarySerializationRegistry SERIALIZATION_ANONYMOUS_VARIABLE( \
-        g_BinarySerializationRegistry)(                                                           \
-        serialization::demangle(typeid(type).name()),                                             \
-        serialization::BinarySerializationRegistry(),                                             \
-        &serialization::register_serializer_impl<serialization::multi_process_stream COMMA type>);
+
+/**
+ * @brief Register a derived type for polymorphic (de)serialization through base pointers
+ *
+ * The entry is constant-initialized (its name comes from serialization::type_name), so
+ * registration costs a single lock-free list insertion during static initialization.
+ */
+#define SERIALIZATION_REGISTER_DERIVED_SERIALIZATION(type)                                \
+    [[maybe_unused]] static const bool SERIALIZATION_ANONYMOUS_VARIABLE(                  \
+        g_PolymorphicSerialization) =                                                     \
+        serialization::register_polymorphic_entry(serialization::polymorphic_entry_v<type>);
 
 namespace serialization_impl
 {
@@ -68,6 +73,24 @@ public:
         return ptr_t;
     };
 
+    /**
+     * @brief Deserialize without throwing; malformed or truncated buffers yield an error
+     */
+    template <typename T>
+    static expected<ptr_const<T>, serialization_error> try_binary_deserialize(
+        const std::vector<unsigned char>& buffer_ref)
+    {
+        serialization::multi_process_stream buffer;
+        buffer.SetRawData(buffer_ref);
+        ptr_const<T> ptr_t;
+        auto         status = serialization::try_load(buffer, ptr_t);
+        if (!status)
+        {
+            return unexpected(std::move(status.error()));
+        }
+        return ptr_t;
+    };
+
     SERIALIZATION_API static void write_binary(
         const std::string& fn, const std::vector<unsigned char>& buffer);
 
@@ -89,6 +112,86 @@ public:
         return binary_deserialize<T>(buffer);
     }
 
+    /**
+     * @brief Append one object to a record log; O(object) regardless of the log size
+     */
+    template <typename T>
+    static void append_to_binary_log(record_log_writer& log, const ptr_const<T>& obj)
+    {
+        serialization::multi_process_stream buffer;
+        serialization::save<serialization::multi_process_stream, ptr_const<T>>(buffer, obj);
+        log.Append(buffer);
+    }
+
+    /**
+     * @brief Append one object from any thread; each thread reuses its own encode buffer
+     */
+    template <typename T>
+    static void append_to_binary_log(concurrent_record_appender& log, const ptr_const<T>& obj)
+    {
+        thread_local serialization::multi_process_stream buffer;
+        buffer.Reset();
+        serialization::save<serialization::multi_process_stream, ptr_const<T>>(buffer, obj);
+        log.Append(buffer);
+    }
+
+    /**
+     * @brief Read every good record of a record log, stopping at the first bad frame
+     */
+    template <typename T>
+    static std::vector<ptr_const<T>> read_from_binary_log(const std::string& path)
+    {
+        record_log_reader                   log(path);
+        serialization::multi_process_stream buffer;
+        std::vector<ptr_const<T>>           objects;
+        while (log.Next(buffer))
+        {
+            ptr_const<T> obj;
+            serialization::load<serialization::multi_process_stream, ptr_const<T>>(buffer, obj);
+            objects.push_back(std::move(obj));
+        }
+        return objects;
+    }
+
+    /**
+     * @brief Append one object to a message batch; each thread reuses its own encode buffer
+     */
+    template <typename T>
+    static void append_to_batch(message_batch_writer& batch, const ptr_const<T>& obj)
+    {
+        thread_local serialization::multi_process_stream buffer;
+        buffer.Reset();
+        serialization::save<serialization::multi_process_stream, ptr_const<T>>(buffer, obj);
+        batch.Append(buffer);
+    }
+
+    /**
+     * @brief Deserialize every message of a batch written by append_to_batch()
+     */
+    template <typename T>
+    static std::vector<ptr_const<T>> batch_deserialize(std::span<const unsigned char> data)
+    {
+        const message_batch_reader batch(data);
+        if (!batch.IsValid())
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input, "Invalid message batch");
+            return {};
+        }
+
+        serialization::multi_process_stream buffer;
+        std::vector<ptr_const<T>>           objects;
+        objects.reserve(batch.Count());
+        for (std::size_t i = 0; i < batch.Count(); ++i)
+        {
+            batch.Load(i, buffer);
+            ptr_const<T> obj;
+            serialization::load<serialization::multi_process_stream, ptr_const<T>>(buffer, obj);
+            objects.push_back(std::move(obj));
+        }
+        return objects;
+    }
+
     //==========================
     // Json
     //==========================
@@ -98,7 +201,9 @@ public:
         json value;
         serialization::save(value, obj);
 
-        return value.dump(2);
+        std::string text;
+        dump_json(text, value, 2);
+        return text;
     };
 
     template <typename T>
@@ -115,6 +220,28 @@ public:
         serialization::load(data, obj);
     };
 
+    /**
+     * @brief Deserialize without throwing; missing fields or mistyped values yield an error
+     */
+    template <typename T>
+    static expected<ptr_const<T>, serialization_error> try_json_deserialize(const json& value)
+    {
+        if (!value.contains("root"))
+        {
+            return unexpected(serialization_error(
+                serialization_error::error_code::missing_field, "Missing 'root' entry"));
+        }
+
+        auto&        data = const_cast<json&>(value["root"]);
+        ptr_const<T> obj;
+        auto         status = serialization::try_load(data, obj);
+        if (!status)
+        {
+            return unexpected(std::move(status.error()));
+        }
+        return obj;
+    };
+
     SERIALIZATION_API static void read_json(const std::string& path, json& root);
 
     SERIALIZATION_API static void write_json(const std::string& path, const json& root);
@@ -18,7 +18,9 @@ limitations under the License.
 
 static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
 
+#include <algorithm>
 #include <array>
+#include <bitset>
 #include <concepts>
 #include <cstddef>
 #include <exception>
@@ -30,6 +32,7 @@ static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <tuple>
 #include <type_traits>
 #include <typeinfo>
 #include <unordered_map>
@@ -37,10 +40,17 @@ static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
 #include <variant>
 
 #include "common/archiver_wrapper.h"
+#include "common/codec_table.h"
 #include "common/helper.h"
+#include "common/interning.h"
 #include "common/reflection.h"
 #include "common/serialization_concepts.h"
+#include "common/serialization_error.h"
 #include "common/serialization_type_traits.h"
+#include "common/size_profile.h"
+#include "common/type_name.h"
+#include "util/base64.h"
+#include "util/expected.h"
 #include "util/pointer.h"
 #include "util/registry.h"
 #include "util/string_util.h"
@@ -52,67 +62,158 @@ namespace serialization::detail
 {
 
 /**
- * @brief Cached type name to avoid repeated demangling
+ * @brief Type name computed at compile time, no demangling at run time
  */
 template <typename T>
-[[nodiscard]] inline const std::string& cached_type_name() noexcept
+[[nodiscard]] constexpr std::string_view cached_type_name() noexcept
 {
-    static const std::string name = demangle(typeid(T).name());
-    return name;
+    return type_name<T>();
 }
 
 /**
- * @brief Get type name for polymorphic objects with caching
+ * @brief Archived class name of an object and the registered entry of its dynamic type
+ */
+struct dynamic_type
+{
+    std::string_view         name;
+    const polymorphic_entry* entry = nullptr;  ///< nullptr unless a registered derived type
+};
+
+/**
+ * @brief Name and entry of a derived type, looked up once per thread and type
+ *
+ * A type found unregistered is looked up again only once more entries have
+ * been registered, for example by a library loaded later.
+ */
+inline dynamic_type lookup_dynamic_type(const std::type_info& type)
+{
+    struct cached_type
+    {
+        const polymorphic_entry* entry = nullptr;
+        std::string              name;  ///< demangled RTTI name of an unregistered type
+        std::size_t              registered = 0;
+    };
+    static thread_local std::unordered_map<const std::type_info*, cached_type> cache;
+
+    auto it = cache.find(&type);
+    if (it == cache.end()) [[unlikely]]
+    {
+        cached_type fresh;
+        fresh.registered = polymorphic_entry_count();
+        fresh.entry      = find_polymorphic_entry(type);
+        if (fresh.entry == nullptr)
+        {
+            fresh.name = demangle(type.name());
+        }
+        it = cache.emplace(&type, std::move(fresh)).first;
+    }
+
+    auto& cached = it->second;
+    if (cached.entry == nullptr)
+    {
+        if (const auto registered = polymorphic_entry_count(); registered != cached.registered)
+        {
+            cached.entry      = find_polymorphic_entry(type);
+            cached.registered = registered;
+        }
+    }
+
+    if (cached.entry != nullptr)
+    {
+        return {cached.entry->name, cached.entry};
+    }
+    return {cached.name, nullptr};
+}
+
+/**
+ * @brief Get the archived type name and entry of a polymorphic object
+ *
+ * The static type and registered derived types use their compile-time names;
+ * only unregistered derived types fall back to (cached) RTTI demangling.
  */
 template <typename T>
-[[nodiscard]] inline std::string polymorphic_type_name(const T* obj) noexcept
+[[nodiscard]] inline dynamic_type dynamic_type_of(const T* obj) noexcept
 {
     if constexpr (std::is_polymorphic_v<T>)
     {
-        static thread_local std::unordered_map<const std::type_info*, std::string> cache;
         const auto& type_info = typeid(*obj);
-
-        auto it = cache.find(&type_info);
-        if (it != cache.end()) [[likely]]
+        if (type_info != typeid(T)) [[unlikely]]
         {
-            return it->second;
+            return lookup_dynamic_type(type_info);
         }
+    }
+    return {cached_type_name<T>(), nullptr};
+}
+
+/**
+ * @brief Get type name for polymorphic objects
+ */
+template <typename T>
+[[nodiscard]] inline std::string_view polymorphic_type_name(const T* obj) noexcept
+{
+    return dynamic_type_of(obj).name;
+}
 
-        auto name         = demangle(type_info.name());
-        cache[&type_info] = name;
-        return name;
+/**
+ * @brief Address of the most-derived object, as expected by derived-type savers
+ *
+ * A base subobject need not sit at offset 0 of the derived object (multiple
+ * inheritance, non-polymorphic leading bases), so savers registered for the
+ * dynamic type must not receive the base pointer.
+ */
+template <typename T>
+[[nodiscard]] inline void* most_derived_address(const T* obj) noexcept
+{
+    if constexpr (std::is_polymorphic_v<T>)
+    {
+        return const_cast<void*>(dynamic_cast<const void*>(obj));
     }
     else
     {
-        return cached_type_name<T>();
+        return const_cast<std::remove_const_t<T>*>(obj);
     }
 }
 
 /**
  * @brief Serialization context for tracking depth and detecting cycles
+ *
+ * Every recursive pointer save/load enters the calling thread's context; data
+ * nested deeper than max_depth is rejected instead of overflowing the stack.
+ * Use save_iterative()/load_iterative() (serialization_iterative.h) for such data.
  */
 struct serialization_context
 {
     std::size_t                  depth     = 0;
-    static constexpr std::size_t max_depth = 1000;
+    static constexpr std::size_t max_depth = SERIALIZATION_MAX_DEPTH;
 
     struct depth_guard
     {
         serialization_context& ctx;
+        bool                   exceeded = false;
 
+        // Inside a try_load() scope the error is only recorded; callers follow the
+        // guard with SERIALIZATION_RETURN_IF_ERROR().
         explicit depth_guard(serialization_context& c) : ctx(c)
         {
-            ++ctx.depth;
-            if (ctx.depth > ctx.max_depth) [[unlikely]]
+            if (ctx.depth >= ctx.max_depth) [[unlikely]]
             {
-                throw;  //_error(
-                        //serialization_error::error_code::recursion_limit,
-                        //"Serialization depth {} exceeds maximum {}",
-                        //ctx.depth, ctx.max_depth);
+                exceeded = true;
+                SERIALIZATION_THROW(
+                    serialization_error::error_code::recursion_limit,
+                    "Serialization depth exceeds maximum {}, use save_iterative/load_iterative",
+                    ctx.max_depth);
+                return;
             }
+            ++ctx.depth;
         }
 
-        ~depth_guard() { --ctx.depth; }
+        ~depth_guard()
+        {
+            if (!exceeded)
+            {
+                --ctx.depth;
+            }
+        }
 
         depth_guard(const depth_guard&)            = delete;
         depth_guard& operator=(const depth_guard&) = delete;
@@ -121,25 +222,17 @@ struct serialization_context
     };
 
     [[nodiscard]] depth_guard enter() { return depth_guard(*this); }
+
+    /// @brief Context of the calling thread
+    [[nodiscard]] static serialization_context& current() noexcept
+    {
+        thread_local serialization_context context;
+        return context;
+    }
 };
 
 }  // namespace serialization::detail
 
-//-----------------------------------------------------------------------------
-// Macros for error handling
-//-----------------------------------------------------------------------------
-#define SERIALIZATION_THROW(code, ...)
-
-#define SERIALIZATION_CHECK(condition, code, ...)                                     \
-    do                                                                                \
-    {                                                                                 \
-        if (!(condition)) [[unlikely]]                                                \
-        {                                                                             \
-            SERIALIZATION_THROW(                                                      \
-                code, "Check failed: {} - {}", #condition, std::format(__VA_ARGS__)); \
-        }                                                                             \
-    } while (false)
-
 //-----------------------------------------------------------------------------
 namespace serialization
 {
@@ -172,12 +265,12 @@ inline constexpr std::string_view EMPTY_NAME = "null object!";
 //-----------------------------------------------------------------------------
 template <typename Archiver, typename T>
     requires BaseSerializable<T> || Container<T> || Reflectable<T> || SmartPointer<T> ||
-             TupleLike<T> || VariantLike<T> || OptionalLike<T>
+             TupleLike<T> || VariantLike<T> || OptionalLike<T> || LazyLike<T> || BitsetLike<T>
 void save(Archiver& archive, const T& obj);
 
 template <typename Archiver, typename T>
     requires BaseSerializable<T> || Container<T> || Reflectable<T> || SmartPointer<T> ||
-             TupleLike<T> || VariantLike<T> || OptionalLike<T>
+             TupleLike<T> || VariantLike<T> || OptionalLike<T> || LazyLike<T> || BitsetLike<T>
 void load(Archiver& archive, T& obj);
 
 //-----------------------------------------------------------------------------
@@ -206,6 +299,7 @@ void register_serializer_impl(Archiver& archive, void* obj, bool load_obj)
         auto* obj_ptr       = static_cast<ptr_const<T>*>(obj);
         auto  loaded_object = serialization::access::serializer::make_ptr<T>();
         detail::load_polymorphic(archive, *loaded_object);
+        SERIALIZATION_RETURN_IF_ERROR();
         obj_ptr->reset(loaded_object.release());
     }
     else
@@ -215,6 +309,469 @@ void register_serializer_impl(Archiver& archive, void* obj, bool load_obj)
     }
 }
 
+/**
+ * @brief Polymorphic table entry of a type, constant-initialized at compile time
+ * @note Registered by SERIALIZATION_REGISTER_DERIVED_SERIALIZATION
+ */
+template <typename T>
+inline constinit polymorphic_entry polymorphic_entry_v{
+    type_name<T>(),
+    &typeid(T),
+    &register_serializer_impl<json, T>,
+    &register_serializer_impl<serialization::multi_process_stream, T>};
+
+//-----------------------------------------------------------------------------
+// Field encodings (see common/field_encoding.h)
+//-----------------------------------------------------------------------------
+namespace detail
+{
+template <typename Property>
+constexpr bool is_encodable_property() noexcept
+{
+    if constexpr (is_reflection_empty_v<Property>)
+    {
+        return false;
+    }
+    else
+    {
+        using member_type = typename Property::member_type;
+        return std::is_floating_point_v<member_type> || is_delta_sequence_v<member_type> ||
+               is_bit_encodable_v<member_type>;
+    }
+}
+
+/// @brief Encoding of a member: its reflection hint, else the one declared by name
+template <typename T, typename Property>
+constexpr field_encoding field_encoding_of(const Property& property) noexcept
+{
+    if constexpr (!is_encodable_property<Property>())
+    {
+        return {};
+    }
+    else
+    {
+        if (property.encoding().active())
+        {
+            return property.encoding();
+        }
+        if constexpr (serialization::access::serializer::has_field_encodings<T>())
+        {
+            for (const auto& entry : serialization::access::serializer::field_encodings<T>())
+            {
+                if (entry.name == property.name())
+                {
+                    return entry.encoding;
+                }
+            }
+        }
+        return {};
+    }
+}
+
+template <typename Property>
+constexpr bool encoding_matches_property(const field_encoding& encoding) noexcept
+{
+    if constexpr (is_encodable_property<Property>())
+    {
+        return encoding_applies_to<typename Property::member_type>(encoding);
+    }
+    else
+    {
+        return !encoding.active();
+    }
+}
+
+/// @brief True if every encoding targets a member whose type it applies to
+template <typename T>
+constexpr bool field_encodings_match_members() noexcept
+{
+    constexpr auto properties = serialization::access::serializer::tuple<T>();
+    const bool     hints_match = std::apply(
+        [](const auto&... property)
+        {
+            return (
+                encoding_matches_property<std::decay_t<decltype(property)>>(
+                    field_encoding_of<T>(property)) &&
+                ...);
+        },
+        properties);
+
+    if constexpr (!serialization::access::serializer::has_field_encodings<T>())
+    {
+        return hints_match;
+    }
+    else
+    {
+        for (const auto& entry : serialization::access::serializer::field_encodings<T>())
+        {
+            const bool found = std::apply(
+                [&](const auto&... property)
+                {
+                    return (
+                        (is_encodable_property<std::decay_t<decltype(property)>>() &&
+                         property.name() == entry.name) ||
+                        ...);
+                },
+                properties);
+            if (!found)
+            {
+                return false;
+            }
+        }
+        return hints_match;
+    }
+}
+
+template <typename T, std::size_t I>
+inline constexpr field_encoding field_encoding_v =
+    field_encoding_of<T>(std::get<I>(serialization::access::serializer::tuple<T>()));
+
+/// @brief True if member I of T is written with a field encoding by this archiver
+template <typename Archiver, typename T, std::size_t I>
+inline constexpr bool encodes_field =
+    std::same_as<Archiver, multi_process_stream> && field_encoding_v<T, I>.active();
+
+template <typename Member, typename T, std::size_t I>
+void save_encoded_member(multi_process_stream& archive, const void* member)
+{
+    save_encoded(archive, *static_cast<const Member*>(member), field_encoding_v<T, I>);
+}
+
+template <typename Member, typename T, std::size_t I>
+void load_encoded_member(multi_process_stream& archive, void* member)
+{
+    load_encoded(archive, *static_cast<Member*>(member), field_encoding_v<T, I>);
+}
+}  // namespace detail
+
+//-----------------------------------------------------------------------------
+// Codec tables (see common/codec_table.h)
+//-----------------------------------------------------------------------------
+namespace detail
+{
+template <typename Archiver, typename Member>
+void save_member(Archiver& archive, const void* member)
+{
+    serialization::save(archive, *static_cast<const Member*>(member));
+}
+
+template <typename Archiver, typename Member>
+void load_member(Archiver& archive, void* member)
+{
+    serialization::load<Archiver, Member>(archive, *static_cast<Member*>(member));
+}
+
+template <typename T>
+void initialize_object(void* obj)
+{
+    serialization::access::serializer::initialize(*static_cast<T*>(obj));
+}
+
+// Offset of a (possibly inherited) member, measured on a live object. Members
+// outside virtual bases sit at the same offset in every T, so the first object
+// (de)serialized describes them all.
+template <typename T, typename Pointer>
+std::size_t member_offset(const T& object, Pointer member) noexcept
+{
+    return static_cast<std::size_t>(
+        reinterpret_cast<const std::byte*>(std::addressof(object.*member)) -
+        reinterpret_cast<const std::byte*>(std::addressof(object)));
+}
+
+/// @brief True if a reflected member is not in a virtual base of T
+template <typename T, typename Property>
+inline constexpr bool fixed_member_offset_v = true;
+
+template <typename T, typename Class, typename Member>
+inline constexpr bool fixed_member_offset_v<T, reflection_impl<Class, Member>> =
+    requires(Member Class::* member) { static_cast<Member T::*>(member); };
+
+template <typename T, typename Properties>
+inline constexpr bool fixed_member_offsets_impl_v = false;
+
+template <typename T, typename... Properties>
+inline constexpr bool fixed_member_offsets_impl_v<T, std::tuple<Properties...>> =
+    (fixed_member_offset_v<T, Properties> && ...);
+
+/// @brief True if every reflected member of T can be found by a fixed offset
+template <typename T>
+inline constexpr bool fixed_member_offsets_v = fixed_member_offsets_impl_v<
+    T,
+    std::decay_t<decltype(serialization::access::serializer::tuple<T>())>>;
+
+template <typename Archiver, typename T, std::size_t I, typename Class, typename Member>
+member_codec<Archiver> make_member_codec(
+    const T& object, const reflection_impl<Class, Member>& property)
+{
+    if constexpr (encodes_field<Archiver, T, I>)
+    {
+        return {
+            property.name(),
+            member_offset(object, property.member()),
+            &save_encoded_member<Member, T, I>,
+            &load_encoded_member<Member, T, I>};
+    }
+    else
+    {
+        return {
+            property.name(),
+            member_offset(object, property.member()),
+            &save_member<Archiver, Member>,
+            &load_member<Archiver, Member>};
+    }
+}
+
+template <typename Archiver, typename T, std::size_t I, typename Class>
+member_codec<Archiver> make_member_codec(
+    [[maybe_unused]] const T& object, const reflection_empty<Class>& property)
+{
+    return {property.name()};
+}
+
+/// @brief Member table of T, built from the first object it is used for
+template <typename Archiver, typename T>
+const type_codec<Archiver>& codec_of(const T& object)
+{
+    static_assert(
+        fixed_member_offsets_v<T>,
+        "Codec tables cannot describe members of virtual bases, whose offsets vary");
+
+    static const auto members = [&]<std::size_t... I>(std::index_sequence<I...>)
+    {
+        constexpr auto properties = serialization::access::serializer::tuple<T>();
+        return std::array<member_codec<Archiver>, sizeof...(I)>{
+            make_member_codec<Archiver, T, I>(object, std::get<I>(properties))...};
+    }(std::make_index_sequence<
+        std::tuple_size_v<decltype(serialization::access::serializer::tuple<T>())>>{});
+
+    static const type_codec<Archiver> codec{members, &initialize_object<T>};
+    return codec;
+}
+
+/// @brief True if objects of T are (de)serialized through their codec table
+template <typename Archiver, typename T>
+inline constexpr bool uses_codec_table =
+    (serialization::access::serializer::codec_table<T>() ||
+     (SERIALIZATION_CODEC_TABLES && fixed_member_offsets_v<T>)) &&
+    (std::same_as<Archiver, json> || std::same_as<Archiver, multi_process_stream>);
+}  // namespace detail
+
+//-----------------------------------------------------------------------------
+// Interning (see common/interning.h)
+//-----------------------------------------------------------------------------
+namespace detail
+{
+/// @brief True if pointers of type T are resolved through the interning table
+template <typename T>
+inline constexpr bool interns_pointer_v =
+    SharedPointer<T> && std::is_const_v<typename T::element_type> &&
+    serialization::access::serializer::interned<std::remove_const_t<typename T::element_type>>();
+
+template <typename Archiver>
+std::size_t read_position(const Archiver& archive)
+{
+    if constexpr (std::same_as<Archiver, multi_process_stream>)
+    {
+        return archive.ReadPosition();
+    }
+    else
+    {
+        return 0;
+    }
+}
+
+/// @brief Shared instance equal to a freshly loaded object
+template <typename Archiver, typename Element>
+std::shared_ptr<const Element> intern_loaded(
+    Archiver& archive, std::size_t start, std::shared_ptr<const Element> object)
+{
+    if constexpr (std::same_as<Archiver, multi_process_stream>)
+    {
+        // Dictionary references depend on earlier strings, and bytes written with
+        // the other byte order spell other values, so only plain native streams
+        // can use the consumed bytes as the key; the others are encoded natively
+        static const unsigned char native = multi_process_stream().endianness();
+        if (!archive.StringDictionaryEnabled() && archive.endianness() == native)
+        {
+            return std::static_pointer_cast<const Element>(
+                intern(typeid(Element), archive.ConsumedSince(start), std::move(object)));
+        }
+    }
+
+    multi_process_stream encoded;
+    serialization::save(encoded, *object);
+    const auto raw = encoded.GetRawData();
+    return std::static_pointer_cast<const Element>(intern(
+        typeid(Element),
+        std::span<const unsigned char>(raw).first(raw.size() - 1),
+        std::move(object)));
+}
+}  // namespace detail
+
+//-----------------------------------------------------------------------------
+// String-keyed maps in JSON
+//-----------------------------------------------------------------------------
+namespace detail
+{
+/// @brief True if maps of type C are archived as a JSON object with one member per key
+template <typename Archiver, typename C>
+inline constexpr bool json_object_map_v = std::same_as<Archiver, json> && StringKeyedMap<C>;
+
+inline const std::string& json_member_name(const std::string& key)
+{
+    return key;
+}
+
+template <typename Key>
+    requires std::is_enum_v<Key>
+std::string json_member_name(Key key)
+{
+    return std::string(enum_to_string(key));
+}
+
+/// @brief Write a map as a JSON object; its keys are unique, so members are appended
+/// without the lookup of json::operator[]
+template <typename C>
+void save_json_object_map(json& archive, const C& container)
+{
+    archive       = json::object();
+    auto& members = static_cast<json::object_t::Container&>(archive.get_ref<json::object_t&>());
+    members.reserve(container.size());
+    for (const auto& [key, value] : container)
+    {
+        serialization::save(members.emplace_back(json_member_name(key), nullptr).second, value);
+    }
+}
+
+/// @brief Read a map from the members of a JSON object, in document order
+template <typename C, typename LoadValue>
+void load_json_object_map(json& archive, C& container, LoadValue&& load_value)
+{
+    container.clear();
+    if constexpr (Reservable<C>)
+    {
+        container.reserve(archive.size());
+    }
+
+    for (auto& [name, member] : archive.get_ref<json::object_t&>())
+    {
+        typename C::key_type    key;
+        typename C::mapped_type value;
+        if constexpr (std::is_enum_v<typename C::key_type>)
+        {
+            // Member names follow the rules of enum values
+            json token = name;
+            serialization::load(token, key);
+        }
+        else
+        {
+            key = name;
+        }
+        load_value(member, value);
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        container.emplace(std::move(key), std::move(value));
+    }
+}
+}  // namespace detail
+
+//-----------------------------------------------------------------------------
+// Byte containers in JSON
+//-----------------------------------------------------------------------------
+namespace detail
+{
+/// @brief True if containers of type C are archived as one base64 string rather than an array
+template <typename Archiver, typename C>
+inline constexpr bool json_byte_string_v = std::same_as<Archiver, json> && ByteSequence<C>;
+
+inline void save_json_bytes(json& archive, const void* data, std::size_t size)
+{
+    std::string text;
+    text.reserve((size + 2) / 3 * 4);
+    append_base64(text, data, size);
+    archive = std::move(text);
+}
+
+/// @brief Decode a base64 string of exactly size bytes
+inline void load_json_bytes(const json& archive, void* data, std::size_t size)
+{
+    const auto& text = archive.get_ref<const std::string&>();
+    SERIALIZATION_CHECK(
+        base64_decoded_size(text) == size,
+        serialization_error::error_code::size_mismatch,
+        "Base64 string of {} characters does not hold {} bytes",
+        text.size(),
+        size);
+    SERIALIZATION_CHECK(
+        decode_base64(text, data),
+        serialization_error::error_code::malformed_input,
+        "Invalid base64 string for {} bytes",
+        size);
+}
+
+template <ByteSequence C>
+void load_json_bytes(const json& archive, C& container)
+{
+    const auto size = base64_decoded_size(archive.get_ref<const std::string&>());
+    SERIALIZATION_CHECK(
+        size != std::string_view::npos,
+        serialization_error::error_code::malformed_input,
+        "Invalid base64 length {}",
+        archive.get_ref<const std::string&>().size());
+
+    container.resize(size);
+    load_json_bytes(archive, std::ranges::data(container), size);
+}
+}  // namespace detail
+
+//-----------------------------------------------------------------------------
+// Container sizes
+//-----------------------------------------------------------------------------
+namespace detail
+{
+/// @brief True if a T can take less than a byte: bools are packed one bit each in a
+/// bit group, and pairs are stored as their two values without a length
+template <typename T>
+inline constexpr bool sub_byte_v = std::same_as<T, bool>;
+
+template <typename First, typename Second>
+inline constexpr bool sub_byte_v<std::pair<First, Second>> =
+    sub_byte_v<First> && sub_byte_v<Second>;
+
+/// @brief Read the size of a container of Value, bounded by the bytes left in binary
+/// archives: one bit per element if Value can be packed, else one byte
+template <typename Value, typename Archiver>
+[[nodiscard]] std::size_t container_size(Archiver& archive)
+{
+    if constexpr (sub_byte_v<Value>)
+    {
+        return archiver_wrapper<Archiver>::bit_size(archive);
+    }
+    else
+    {
+        return archiver_wrapper<Archiver>::size(archive);
+    }
+}
+
+/// @brief Elements of Value to reserve for a container of size elements
+///
+/// A length read from a binary archive is only an upper bound, so the reservation
+/// never commits more memory than the bytes left in the stream; containers of
+/// large elements grow as their elements actually load.
+template <typename Value, typename Archiver>
+[[nodiscard]] std::size_t reserve_size(Archiver& archive, std::size_t size)
+{
+    if constexpr (std::same_as<std::remove_cv_t<Archiver>, multi_process_stream>)
+    {
+        return std::min(size, archive.Size() / sizeof(Value));
+    }
+    else
+    {
+        return size;
+    }
+}
+}  // namespace detail
+
 //-----------------------------------------------------------------------------
 namespace impl
 {
@@ -227,13 +784,24 @@ template <typename Archiver, Container C>
     requires(!AssociativeContainer<C>)
 void load_container(Archiver& archive, C& container)
 {
-    const size_t size = archiver_wrapper<Archiver>::size(archive);
+    // Archives written before byte containers became base64 strings hold an array
+    if constexpr (detail::json_byte_string_v<Archiver, C>)
+    {
+        if (archive.is_string())
+        {
+            detail::load_json_bytes(archive, container);
+            return;
+        }
+    }
+
+    const size_t size = detail::container_size<typename C::value_type>(archive);
+    SERIALIZATION_RETURN_IF_ERROR();
 
     container.clear();
 
     if constexpr (Reservable<C>)
     {
-        container.reserve(size);
+        container.reserve(detail::reserve_size<typename C::value_type>(archive, size));
     }
 
     for (size_t i = 0; i < size; ++i)
@@ -242,11 +810,13 @@ void load_container(Archiver& archive, C& container)
         {
             auto& element = container.emplace_back();
             serialization::load(archiver_wrapper<Archiver>::get(archive, i), element);
+            SERIALIZATION_RETURN_IF_ERROR();
         }
         else
         {
             typename C::value_type item;
             serialization::load(archiver_wrapper<Archiver>::get(archive, i), item);
+            SERIALIZATION_RETURN_IF_ERROR();
             container.insert(container.end(), std::move(item));
         }
     }
@@ -256,8 +826,17 @@ template <typename Archiver, Container C>
     requires(!AssociativeContainer<C>)
 void save_container(Archiver& archive, const C& container)
 {
+    if constexpr (detail::json_byte_string_v<Archiver, C>)
+    {
+        detail::save_json_bytes(archive, std::ranges::data(container), container.size());
+        return;
+    }
+
     const size_t size = container.size();
-    archiver_wrapper<Archiver>::resize(archive, size);
+    {
+        const detail::profile_scope<Archiver> scope(archive, "(length)");
+        archiver_wrapper<Archiver>::resize(archive, size);
+    }
 
     if constexpr (RandomAccessContainer<C>)
     {
@@ -291,13 +870,27 @@ void save_container(Archiver& archive, const C& container)
 template <typename Archiver, AssociativeContainer C>
 void load_associative_container(Archiver& archive, C& container)
 {
+    // Archives written before maps became objects hold a flat key/value array
+    if constexpr (detail::json_object_map_v<Archiver, C>)
+    {
+        if (archive.is_object())
+        {
+            detail::load_json_object_map(
+                archive,
+                container,
+                [](json& member, auto& value) { serialization::load(member, value); });
+            return;
+        }
+    }
+
     const size_t size = archiver_wrapper<Archiver>::size(archive);
+    SERIALIZATION_RETURN_IF_ERROR();
 
     container.clear();
 
     if constexpr (Reservable<C>)
     {
-        container.reserve(size);
+        container.reserve(detail::reserve_size<typename C::value_type>(archive, size));
     }
 
     if constexpr (MapLike<C>)
@@ -315,6 +908,7 @@ void load_associative_container(Archiver& archive, C& container)
 
             serialization::load(archiver_wrapper<Archiver>::get(archive, 2 * i), key);
             serialization::load(archiver_wrapper<Archiver>::get(archive, 2 * i + 1), value);
+            SERIALIZATION_RETURN_IF_ERROR();
 
             container.emplace(std::move(key), std::move(value));
         }
@@ -325,6 +919,7 @@ void load_associative_container(Archiver& archive, C& container)
         {
             typename C::value_type value;
             serialization::load(archiver_wrapper<Archiver>::get(archive, i), value);
+            SERIALIZATION_RETURN_IF_ERROR();
             container.emplace(std::move(value));
         }
     }
@@ -335,9 +930,16 @@ void save_associative_container(Archiver& archive, const C& container)
 {
     const size_t size = container.size();
 
-    if constexpr (MapLike<C>)
+    if constexpr (detail::json_object_map_v<Archiver, C>)
+    {
+        detail::save_json_object_map(archive, container);
+    }
+    else if constexpr (MapLike<C>)
     {
-        archiver_wrapper<Archiver>::resize(archive, 2 * size);
+        {
+            const detail::profile_scope<Archiver> scope(archive, "(length)");
+            archiver_wrapper<Archiver>::resize(archive, 2 * size);
+        }
 
         size_t i = 0;
         for (const auto& [key, value] : container)
@@ -348,7 +950,10 @@ void save_associative_container(Archiver& archive, const C& container)
     }
     else  // SetLike
     {
-        archiver_wrapper<Archiver>::resize(archive, size);
+        {
+            const detail::profile_scope<Archiver> scope(archive, "(length)");
+            archiver_wrapper<Archiver>::resize(archive, size);
+        }
 
         size_t i = 0;
         for (const auto& item : container)
@@ -371,15 +976,31 @@ struct serializer_impl
     {
         if (obj == nullptr)
         {
+            const detail::profile_scope<Archiver> scope(archive, "(class name)");
             archiver_wrapper<Archiver>::push_class_name(archive, std::string(EMPTY_NAME));
             return;
         }
 
         constexpr auto nbProperties =
             std::tuple_size_v<decltype(serialization::access::serializer::tuple<T>())>;
+        static_assert(
+            detail::field_encodings_match_members<T>(),
+            "A field encoding names a member that does not exist, whose type it does not "
+            "apply to, or has invalid parameters");
 
-        const std::string& class_name = detail::polymorphic_type_name(obj);
-        archiver_wrapper<Archiver>::push_class_name(archive, class_name);
+        const auto                            class_name = detail::polymorphic_type_name(obj);
+        const detail::profile_scope<Archiver> object_scope(archive, class_name);
+
+        if constexpr (nbProperties > 0 && detail::uses_codec_table<Archiver, T>)
+        {
+            save_with_codec(archive, obj, class_name, detail::codec_of<Archiver>(*obj));
+            return;
+        }
+
+        {
+            const detail::profile_scope<Archiver> scope(archive, "(class name)");
+            archiver_wrapper<Archiver>::push_class_name(archive, class_name);
+        }
 
         if constexpr (nbProperties > 0)
         {
@@ -394,11 +1015,27 @@ struct serializer_impl
 
                     if constexpr (!is_reflection_empty_v<std::decay_t<decltype(property)>>)
                     {
+                        const detail::profile_scope<Archiver> scope(archive, name);
+
                         const auto& member_ref = obj->*(property.member());
-                        serialization::save(archive_tmp, member_ref);
+                        if constexpr (detail::encodes_field<Archiver, T, I>)
+                        {
+                            detail::save_encoded(
+                                archive_tmp, member_ref, detail::field_encoding_v<T, I>);
+                        }
+                        else
+                        {
+                            serialization::save(archive_tmp, member_ref);
+                        }
                     }
                 });
         }
+
+        // Bits of the next value do not share a group with this object's
+        if constexpr (std::same_as<Archiver, multi_process_stream>)
+        {
+            archive.EndBitGroup();
+        }
     }
 
     //-------------------------------------------------------------------------
@@ -409,7 +1046,11 @@ struct serializer_impl
         constexpr auto nbProperties =
             std::tuple_size_v<decltype(serialization::access::serializer::tuple<T>())>;
 
-        if constexpr (nbProperties > 0)
+        if constexpr (nbProperties > 0 && detail::uses_codec_table<Archiver, T>)
+        {
+            load_with_codec(archive, &obj, detail::codec_of<Archiver>(obj));
+        }
+        else if constexpr (nbProperties > 0)
         {
             const auto class_name = archiver_wrapper<Archiver>::pop_class_name(archive);
 
@@ -424,6 +1065,8 @@ struct serializer_impl
                     std::make_index_sequence<nbProperties>{},
                     [&]<auto I>(std::integral_constant<std::size_t, I>)
                     {
+                        SERIALIZATION_RETURN_IF_ERROR();
+
                         constexpr auto property =
                             std::get<I>(serialization::access::serializer::tuple<T>());
                         const auto& name        = property.name();
@@ -434,10 +1077,20 @@ struct serializer_impl
                             using member_type =
                                 typename std::decay_t<decltype(property)>::member_type;
                             auto& member_ref = obj.*(property.member());
-                            serialization::load<Archiver, member_type>(archive_tmp, member_ref);
+                            if constexpr (detail::encodes_field<Archiver, T, I>)
+                            {
+                                detail::load_encoded(
+                                    archive_tmp, member_ref, detail::field_encoding_v<T, I>);
+                            }
+                            else
+                            {
+                                serialization::load<Archiver, member_type>(
+                                    archive_tmp, member_ref);
+                            }
                         }
                     });
 
+                SERIALIZATION_RETURN_IF_ERROR();
                 serialization::access::serializer::initialize(obj);
             }
         }
@@ -527,7 +1180,16 @@ struct serializer_impl<Archiver, std::array<Item, Size>>
 {
     static void load(Archiver& archive, std::array<Item, Size>& array)
     {
-        const auto archive_size = archiver_wrapper<Archiver>::size(archive);
+        if constexpr (std::same_as<Archiver, json> && ByteLike<Item>)
+        {
+            if (archive.is_string())
+            {
+                detail::load_json_bytes(archive, array.data(), Size);
+                return;
+            }
+        }
+
+        const auto archive_size = detail::container_size<Item>(archive);
 
         SERIALIZATION_CHECK(
             archive_size == Size,
@@ -539,11 +1201,18 @@ struct serializer_impl<Archiver, std::array<Item, Size>>
         for (size_t i = 0; i < Size; ++i)
         {
             serialization::load(archiver_wrapper<Archiver>::get(archive, i), array[i]);
+            SERIALIZATION_RETURN_IF_ERROR();
         }
     }
 
     static void save(Archiver& archive, const std::array<Item, Size>& array)
     {
+        if constexpr (std::same_as<Archiver, json> && ByteLike<Item>)
+        {
+            detail::save_json_bytes(archive, array.data(), Size);
+            return;
+        }
+
         archiver_wrapper<Archiver>::resize(archive, Size);
 
         for (size_t i = 0; i < Size; ++i)
@@ -553,9 +1222,128 @@ struct serializer_impl<Archiver, std::array<Item, Size>>
     }
 };
 
+//-----------------------------------------------------------------------------
+// Bit containers: std::vector<bool> and std::bitset
+//-----------------------------------------------------------------------------
+/// @brief Write a length and size bits, packed in binary archives and as bools in JSON
+template <typename Archiver, typename GetBit>
+void save_bits(Archiver& archive, std::size_t size, GetBit&& get_bit)
+{
+    {
+        const detail::profile_scope<Archiver> scope(archive, "(length)");
+        archiver_wrapper<Archiver>::resize(archive, size);
+    }
+
+    if constexpr (std::same_as<Archiver, multi_process_stream>)
+    {
+        for (std::size_t begin = 0; begin < size; begin += 64)
+        {
+            const auto count = std::min<std::size_t>(64, size - begin);
+            uint64_t   word  = 0;
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                word |= static_cast<uint64_t>(get_bit(begin + i)) << i;
+            }
+            archive.PushBits(word, static_cast<unsigned int>(count));
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            serialization::save(
+                archiver_wrapper<Archiver>::get(archive, i), static_cast<bool>(get_bit(i)));
+        }
+    }
+}
+
+/// @brief Read size bits written by save_bits(), after their length
+template <typename Archiver, typename SetBit>
+void load_bits(Archiver& archive, std::size_t size, SetBit&& set_bit)
+{
+    if constexpr (std::same_as<Archiver, multi_process_stream>)
+    {
+        for (std::size_t begin = 0; begin < size; begin += 64)
+        {
+            const auto count = std::min<std::size_t>(64, size - begin);
+            const auto word  = archive.PopBits(static_cast<unsigned int>(count));
+            SERIALIZATION_CHECK(
+                !archive.HasError(),
+                detail::serialization_error::error_code::malformed_input,
+                "Malformed binary stream while reading {} bits",
+                size);
+            for (std::size_t i = 0; i < count; ++i)
+            {
+                set_bit(begin + i, ((word >> i) & 1) != 0);
+            }
+        }
+    }
+    else
+    {
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            bool value = false;
+            serialization::load(archiver_wrapper<Archiver>::get(archive, i), value);
+            SERIALIZATION_RETURN_IF_ERROR();
+            set_bit(i, value);
+        }
+    }
+}
+
+template <typename Archiver, typename Allocator>
+struct serializer_impl<Archiver, std::vector<bool, Allocator>>
+{
+    static void save(Archiver& archive, const std::vector<bool, Allocator>& bits)
+    {
+        save_bits(archive, bits.size(), [&](std::size_t i) { return bits[i]; });
+    }
+
+    static void load(Archiver& archive, std::vector<bool, Allocator>& bits)
+    {
+        const auto size = archiver_wrapper<Archiver>::bit_size(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        bits.assign(size, false);
+        load_bits(archive, size, [&](std::size_t i, bool value) { bits[i] = value; });
+    }
+};
+
+template <typename Archiver, std::size_t Size>
+struct serializer_impl<Archiver, std::bitset<Size>>
+{
+    static void save(Archiver& archive, const std::bitset<Size>& bits)
+    {
+        save_bits(archive, Size, [&](std::size_t i) { return bits.test(i); });
+    }
+
+    static void load(Archiver& archive, std::bitset<Size>& bits)
+    {
+        const auto archive_size = archiver_wrapper<Archiver>::bit_size(archive);
+
+        SERIALIZATION_CHECK(
+            archive_size == Size,
+            detail::serialization_error::error_code::size_mismatch,
+            "Bitset size mismatch: expected {} but got {}",
+            Size,
+            archive_size);
+
+        bits.reset();
+        load_bits(archive, Size, [&](std::size_t i, bool value) { bits.set(i, value); });
+    }
+};
+
 //-----------------------------------------------------------------------------
 // std::variant specialization
 //-----------------------------------------------------------------------------
+/// @brief Destroys a placement-constructed object on every exit path
+template <typename T>
+struct destruct_guard
+{
+    T* object;
+
+    ~destruct_guard() { access::serializer::destruct(*object); }
+};
+
 template <typename Archiver, typename... Types>
 struct serializer_impl<Archiver, std::variant<Types...>>
 {
@@ -615,17 +1403,11 @@ struct serializer_impl<Archiver, std::variant<Types...>>
                     auto*                        ptr =
                         access::serializer::placement_new<Types>(reinterpret_cast<void*>(storage));
 
-                    try
-                    {
-                        serialization::load(archive, *ptr);
-                        variant = std::move(*ptr);
-                    }
-                    catch (...)
-                    {
-                        access::serializer::destruct(*ptr);
-                        throw;
-                    }
-                    access::serializer::destruct(*ptr);
+                    const destruct_guard<Types> guard{ptr};
+
+                    serialization::load(archive, *ptr);
+                    SERIALIZATION_RETURN_IF_ERROR();
+                    variant = std::move(*ptr);
                 }
             }...};
 
@@ -642,6 +1424,7 @@ struct serializer_impl<Archiver, std::pair<First, Second>>
     static void load(Archiver& archive, std::pair<First, Second>& pair)
     {
         serialization::load(archiver_wrapper<Archiver>::get(archive, 0), pair.first);
+        SERIALIZATION_RETURN_IF_ERROR();
         serialization::load(archiver_wrapper<Archiver>::get(archive, 1), pair.second);
     }
 
@@ -662,6 +1445,9 @@ struct serializer_impl<Archiver, T>
 
     static void save(Archiver& archive, const T& object)
     {
+        const auto guard = detail::serialization_context::current().enter();
+        SERIALIZATION_RETURN_IF_ERROR();
+
         SERIALIZATION_CHECK(
             object != nullptr,
             detail::serialization_error::error_code::null_pointer,
@@ -672,9 +1458,13 @@ struct serializer_impl<Archiver, T>
 
     static void load(Archiver& archive, T& object)
     {
+        const auto guard = detail::serialization_context::current().enter();
+        SERIALIZATION_RETURN_IF_ERROR();
+
         using mutable_element_type = std::remove_const_t<element_type>;
         auto loaded_object = serialization::access::serializer::make_ptr<mutable_element_type>();
         serialization::load(archive, *loaded_object);
+        SERIALIZATION_RETURN_IF_ERROR();
         object.reset(loaded_object.release());
     }
 };
@@ -689,24 +1479,48 @@ struct serializer_impl<Archiver, T>
     {
         if (!object)
         {
+            const detail::profile_scope<Archiver> scope(archive, "(class name)");
             archiver_wrapper<Archiver>::push_class_name(archive, std::string(EMPTY_NAME));
             return;
         }
 
-        const std::string& class_name = detail::polymorphic_type_name(object.get());
-        archiver_wrapper<Archiver>::push_class_name(archive, class_name);
+        const auto guard = detail::serialization_context::current().enter();
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        const auto dynamic    = detail::dynamic_type_of(object.get());
+        const auto class_name = dynamic.name;
+        {
+            const detail::profile_scope<Archiver> scope(archive, "(class name)");
+            archiver_wrapper<Archiver>::push_class_name(archive, class_name);
+        }
+
+        using archiver_type = std::remove_cv_t<Archiver>;
 
         if constexpr (Reflectable<element_type>)
         {
+            // Objects held through a base pointer are saved by their registered type
+            if (dynamic.entry != nullptr)
+            {
+                archiver_wrapper<archiver_type>::run_polymorphic(
+                    *dynamic.entry, archive, detail::most_derived_address(object.get()), false);
+                return;
+            }
+
             serialization::save(archive, *object);
         }
         else
         {
-            using archiver_type = std::remove_cv_t<Archiver>;
-            if (archiver_wrapper<archiver_type>::registry()->Has(class_name))
+            auto*             raw = detail::most_derived_address(object.get());
+            const std::string name(class_name);
+            if (const auto* entry =
+                    dynamic.entry != nullptr ? dynamic.entry : find_polymorphic_entry(class_name);
+                entry != nullptr)
             {
-                archiver_wrapper<archiver_type>::registry()->run(
-                    class_name, archive, const_cast<element_type*>(object.get()), false);
+                archiver_wrapper<archiver_type>::run_polymorphic(*entry, archive, raw, false);
+            }
+            else if (archiver_wrapper<archiver_type>::registry()->Has(name))
+            {
+                archiver_wrapper<archiver_type>::registry()->run(name, archive, raw, false);
             }
         }
     }
@@ -715,6 +1529,7 @@ struct serializer_impl<Archiver, T>
     {
         using archiver_type          = std::remove_cv_t<Archiver>;
         const std::string class_name = archiver_wrapper<archiver_type>::pop_class_name(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
 
         if (class_name == EMPTY_NAME)
         {
@@ -722,6 +1537,15 @@ struct serializer_impl<Archiver, T>
             return;
         }
 
+        const auto guard = detail::serialization_context::current().enter();
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        if (const auto* entry = find_polymorphic_entry(class_name); entry != nullptr)
+        {
+            archiver_wrapper<archiver_type>::run_polymorphic(*entry, archive, &object, true);
+            return;
+        }
+
         if (archiver_wrapper<archiver_type>::registry()->Has(class_name))
         {
             archiver_wrapper<archiver_type>::registry()->run(class_name, archive, &object, true);
@@ -731,10 +1555,23 @@ struct serializer_impl<Archiver, T>
         if constexpr (Reflectable<element_type>)
         {
             using mutable_element_type = std::remove_const_t<element_type>;
-            auto loaded_object =
+            [[maybe_unused]] const auto start = detail::read_position(archive);
+            auto                        loaded_object =
                 serialization::access::serializer::make_ptr<mutable_element_type>();
             serialization::load(archive, *loaded_object);
-            object.reset(loaded_object.release());
+            SERIALIZATION_RETURN_IF_ERROR();
+
+            if constexpr (detail::interns_pointer_v<T>)
+            {
+                object = detail::intern_loaded(
+                    archive,
+                    start,
+                    std::shared_ptr<const mutable_element_type>(loaded_object.release()));
+            }
+            else
+            {
+                object.reset(loaded_object.release());
+            }
         }
         else
         {
@@ -754,8 +1591,11 @@ struct serializer_impl<Archiver, T>
 {
     static void load(Archiver& archive, T& tuple)
     {
-        constexpr auto tuple_size   = std::tuple_size_v<T>;
-        const auto     archive_size = archiver_wrapper<Archiver>::size(archive);
+        constexpr auto tuple_size = std::tuple_size_v<T>;
+
+        // Bool elements may be packed one bit each; the size is only compared with
+        // tuple_size and never allocated for
+        const auto archive_size = archiver_wrapper<Archiver>::bit_size(archive);
 
         SERIALIZATION_CHECK(
             archive_size == tuple_size,
@@ -778,8 +1618,11 @@ private:
     template <std::size_t... Is>
     static void load_tuple_impl(Archiver& archive, T& tuple, std::index_sequence<Is...>)
     {
-        (serialization::load(archiver_wrapper<Archiver>::get(archive, Is), std::get<Is>(tuple)),
-         ...);
+        // Stops at the first element that fails to load
+        (void)((serialization::load(
+                    archiver_wrapper<Archiver>::get(archive, Is), std::get<Is>(tuple)),
+                !detail::has_error()) &&
+               ...);
     }
 
     template <std::size_t... Is>
@@ -826,6 +1669,7 @@ struct serializer_impl<Archiver, T>
         // Load the has_value flag
         bool has_value = false;
         serialization::load(archiver_wrapper<Archiver>::get(archive, 0), has_value);
+        SERIALIZATION_RETURN_IF_ERROR();
 
         if (has_value)
         {
@@ -837,6 +1681,7 @@ struct serializer_impl<Archiver, T>
 
             value_type loaded_value;
             serialization::load(archiver_wrapper<Archiver>::get(archive, 1), loaded_value);
+            SERIALIZATION_RETURN_IF_ERROR();
             optional = std::move(loaded_value);
         }
         else
@@ -853,7 +1698,7 @@ struct serializer_impl<Archiver, T>
 //-----------------------------------------------------------------------------
 template <typename Archiver, typename T>
     requires BaseSerializable<T> || Container<T> || Reflectable<T> || SmartPointer<T> ||
-             TupleLike<T> || VariantLike<T> || OptionalLike<T>
+             TupleLike<T> || VariantLike<T> || OptionalLike<T> || LazyLike<T> || BitsetLike<T>
 void save(Archiver& archive, const T& obj)
 {
     impl::serializer_impl<Archiver, T>::save(archive, obj);
@@ -861,10 +1706,59 @@ void save(Archiver& archive, const T& obj)
 
 template <typename Archiver, typename T>
     requires BaseSerializable<T> || Container<T> || Reflectable<T> || SmartPointer<T> ||
-             TupleLike<T> || VariantLike<T> || OptionalLike<T>
+             TupleLike<T> || VariantLike<T> || OptionalLike<T> || LazyLike<T> || BitsetLike<T>
 void load(Archiver& archive, T& obj)
 {
     impl::serializer_impl<Archiver, T>::load(archive, obj);
 }
 
+/**
+ * @brief Load an object without throwing
+ * @param archive The archive to read from
+ * @param obj The object to load into; left partially loaded on failure
+ * @return Nothing on success, otherwise the first error encountered
+ * @note Loading stops at the first error instead of unwinding, so malformed
+ *       input costs no more than well-formed input up to the failure point.
+ */
+template <typename Archiver, typename T>
+    requires BaseSerializable<T> || Container<T> || Reflectable<T> || SmartPointer<T> ||
+             TupleLike<T> || VariantLike<T> || OptionalLike<T> || LazyLike<T> || BitsetLike<T>
+[[nodiscard]] expected<void, serialization_error> try_load(Archiver& archive, T& obj)
+{
+    detail::error_scope scope;
+    impl::serializer_impl<Archiver, T>::load(archive, obj);
+
+    if constexpr (requires { archive.HasError(); })
+    {
+        if (!scope.failed() && archive.HasError()) [[unlikely]]
+        {
+            return unexpected(serialization_error(
+                serialization_error::error_code::malformed_input, "Archive is truncated"));
+        }
+    }
+
+    if (scope.failed()) [[unlikely]]
+    {
+        return unexpected(scope.take_error());
+    }
+    return {};
+}
+
+/**
+ * @brief Load and return a default-constructed object without throwing
+ * @return The loaded object, otherwise the first error encountered
+ */
+template <typename T, typename Archiver>
+    requires std::default_initializable<T>
+[[nodiscard]] expected<T, serialization_error> try_load(Archiver& archive)
+{
+    T    obj{};
+    auto status = serialization::try_load(archive, obj);
+    if (!status) [[unlikely]]
+    {
+        return unexpected(std::move(status.error()));
+    }
+    return obj;
+}
+
 }  // namespace serialization
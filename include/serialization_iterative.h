@@ -0,0 +1,497 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file serialization_iterative.h
+ * @brief Explicit-stack traversal for deeply nested and linked reflected types
+ *
+ * save()/load() recurse once per nesting level, so a shared_ptr linked list or
+ * tree that is 100k nodes deep overflows the call stack. save_iterative() and
+ * load_iterative() walk reflected objects with a heap-allocated frame stack
+ * instead and produce exactly the same archive as save()/load().
+ *
+ * Handled without recursion:
+ * - reflected objects held by value
+ * - unique_ptr/shared_ptr to reflected objects
+ * - random-access sequence containers of such pointers (std::vector, std::deque)
+ *
+ * Any other member is delegated to save()/load(), whose recursion depth is
+ * bounded by the member's type rather than by the data. Objects held through a
+ * base pointer whose dynamic type is a registered derived type are also
+ * delegated, since their layout is only known to the registry callback.
+ * ptr_const of a SERIALIZATION_INTERNED type is interned as load() does, once
+ * its object has loaded.
+ */
+
+static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include "common/archiver_wrapper.h"
+#include "common/helper.h"
+#include "common/serialization_concepts.h"
+#include "serialization_impl.h"
+
+namespace serialization
+{
+namespace iterative
+{
+//-----------------------------------------------------------------------------
+// Concepts
+//-----------------------------------------------------------------------------
+
+/// @brief Reflected type whose members are walked by the frame stack
+template <typename T>
+concept ReflectableNode = Reflectable<T> && !BaseSerializable<T> && !Container<T>;
+
+/// @brief Smart pointer to a reflected type
+template <typename T>
+concept NodeLink =
+    SmartPointer<T> && ReflectableNode<std::remove_const_t<typename T::element_type>>;
+
+/// @brief Sequence container of smart pointers to a reflected type
+template <typename T>
+concept NodeLinkSequence = RandomAccessContainer<T> && EmplaceBackable<T> &&
+                           !AssociativeContainer<T> && NodeLink<typename T::value_type>;
+
+template <typename T>
+inline constexpr std::size_t property_count_v =
+    std::tuple_size_v<decltype(serialization::access::serializer::tuple<T>())>;
+
+//-----------------------------------------------------------------------------
+// Saver
+//-----------------------------------------------------------------------------
+template <typename Archiver>
+class saver
+{
+public:
+    /// @brief Save a value and everything reachable from it
+    template <typename T>
+    void run(Archiver& archive, const T& value)
+    {
+        save_value(archive, value);
+
+        while (!frames_.empty())
+        {
+            const std::size_t index = frames_.size() - 1;
+            if (!frames_[index].step(*this, index))
+            {
+                frames_.pop_back();
+            }
+        }
+    }
+
+private:
+    // Advances the frame at `index` by one member or element. May push new frames,
+    // so it must not touch the frame after doing so. Returns false once complete.
+    using step_function = bool (*)(saver&, std::size_t);
+
+    struct frame
+    {
+        const void*   object;
+        Archiver*     archive;
+        std::size_t   cursor;
+        step_function step;
+    };
+
+    template <typename T>
+    void save_value(Archiver& archive, const T& value)
+    {
+        if constexpr (NodeLink<T>)
+        {
+            save_link(archive, value);
+        }
+        else if constexpr (NodeLinkSequence<T>)
+        {
+            archiver_wrapper<Archiver>::resize(archive, value.size());
+            frames_.push_back({&value, &archive, 0, &saver::sequence_step<T>});
+        }
+        else if constexpr (ReflectableNode<T>)
+        {
+            archiver_wrapper<Archiver>::push_class_name(
+                archive, detail::polymorphic_type_name(&value));
+            push_object(archive, &value);
+        }
+        else
+        {
+            serialization::save(archive, value);
+        }
+    }
+
+    template <typename Pointer>
+    void save_link(Archiver& archive, const Pointer& pointer)
+    {
+        using element_type = std::remove_const_t<typename Pointer::element_type>;
+
+        if (!pointer)
+        {
+            archiver_wrapper<Archiver>::push_class_name(archive, EMPTY_NAME);
+            return;
+        }
+
+        const auto dynamic    = detail::dynamic_type_of(pointer.get());
+        const auto class_name = dynamic.name;
+
+        if constexpr (SharedPointer<Pointer>)
+        {
+            archiver_wrapper<Archiver>::push_class_name(archive, class_name);
+
+            if (dynamic.entry != nullptr)
+            {
+                auto* object = detail::most_derived_address(pointer.get());
+                archiver_wrapper<Archiver>::run_polymorphic(*dynamic.entry, archive, object, false);
+                return;
+            }
+        }
+
+        archiver_wrapper<Archiver>::push_class_name(archive, class_name);
+        push_object(archive, static_cast<const element_type*>(pointer.get()));
+    }
+
+    template <typename T>
+    void push_object(Archiver& archive, const T* object)
+    {
+        if constexpr (property_count_v<T> > 0)
+        {
+            frames_.push_back({object, &archive, 0, &saver::object_step<T>});
+        }
+    }
+
+    template <typename T, std::size_t I>
+    static void save_member(saver& self, Archiver& archive, const void* object)
+    {
+        constexpr auto property = std::get<I>(serialization::access::serializer::tuple<T>());
+        auto&          member_archive = archiver_wrapper<Archiver>::get(archive, property.name());
+
+        if constexpr (!is_reflection_empty_v<std::decay_t<decltype(property)>>)
+        {
+            const auto& member = static_cast<const T*>(object)->*(property.member());
+            if constexpr (detail::encodes_field<Archiver, T, I>)
+            {
+                detail::save_encoded(member_archive, member, detail::field_encoding_v<T, I>);
+            }
+            else
+            {
+                self.save_value(member_archive, member);
+            }
+        }
+    }
+
+    template <typename T, std::size_t... I>
+    static constexpr auto make_member_table(std::index_sequence<I...>)
+    {
+        using member_function = void (*)(saver&, Archiver&, const void*);
+        return std::array<member_function, sizeof...(I)>{&saver::save_member<T, I>...};
+    }
+
+    template <typename T>
+    static bool object_step(saver& self, std::size_t index)
+    {
+        static constexpr auto members =
+            make_member_table<T>(std::make_index_sequence<property_count_v<T>>{});
+
+        auto& current = self.frames_[index];
+        if (current.cursor == members.size())
+        {
+            // As in save(), bits after the object do not share a group with its own
+            if constexpr (std::same_as<Archiver, multi_process_stream>)
+            {
+                current.archive->EndBitGroup();
+            }
+            return false;
+        }
+
+        const std::size_t member = current.cursor++;
+        members[member](self, *current.archive, current.object);
+        return true;
+    }
+
+    template <typename C>
+    static bool sequence_step(saver& self, std::size_t index)
+    {
+        auto&       current   = self.frames_[index];
+        const auto& container = *static_cast<const C*>(current.object);
+        if (current.cursor == container.size())
+        {
+            return false;
+        }
+
+        const std::size_t i = current.cursor++;
+        self.save_link(archiver_wrapper<Archiver>::get(*current.archive, i), container[i]);
+        return true;
+    }
+
+    std::vector<frame> frames_;
+};
+
+//-----------------------------------------------------------------------------
+// Loader
+//-----------------------------------------------------------------------------
+template <typename Archiver>
+class loader
+{
+public:
+    /// @brief Load a value and everything reachable from it
+    template <typename T>
+    void run(Archiver& archive, T& value)
+    {
+        load_value(archive, value);
+
+        // Inside a try_load() scope errors do not unwind; stop at the first one
+        while (!frames_.empty() && !detail::has_error())
+        {
+            const std::size_t index = frames_.size() - 1;
+            if (!frames_[index].step(*this, index))
+            {
+                const frame done = frames_[index];
+                frames_.pop_back();
+
+                if (done.finish != nullptr)
+                {
+                    done.finish(done);
+                }
+            }
+        }
+    }
+
+private:
+    struct frame;
+    using step_function   = bool (*)(loader&, std::size_t);
+    using finish_function = void (*)(const frame&);
+
+    struct frame
+    {
+        void*           object;
+        Archiver*       archive;
+        std::size_t     cursor;
+        std::size_t     size;
+        step_function   step;
+        finish_function finish;
+    };
+
+    template <typename T>
+    void load_value(Archiver& archive, T& value)
+    {
+        if constexpr (NodeLink<T>)
+        {
+            load_link(archive, value);
+        }
+        else if constexpr (NodeLinkSequence<T>)
+        {
+            const std::size_t size = archiver_wrapper<Archiver>::size(archive);
+            SERIALIZATION_RETURN_IF_ERROR();
+
+            value.clear();
+            if constexpr (Reservable<T>)
+            {
+                value.reserve(detail::reserve_size<typename T::value_type>(archive, size));
+            }
+            frames_.push_back({&value, &archive, 0, size, &loader::sequence_step<T>, nullptr});
+        }
+        else if constexpr (ReflectableNode<T>)
+        {
+            push_object(archive, &value);
+        }
+        else
+        {
+            serialization::load(archive, value);
+        }
+    }
+
+    template <typename Pointer>
+    void load_link(Archiver& archive, Pointer& pointer)
+    {
+        using element_type = std::remove_const_t<typename Pointer::element_type>;
+
+        if constexpr (SharedPointer<Pointer>)
+        {
+            const std::string class_name = archiver_wrapper<Archiver>::pop_class_name(archive);
+            SERIALIZATION_RETURN_IF_ERROR();
+
+            SERIALIZATION_CHECK(
+                !class_name.empty(),
+                detail::serialization_error::error_code::missing_field,
+                "Invalid or missing class name");
+
+            if (class_name == EMPTY_NAME)
+            {
+                pointer = nullptr;
+                return;
+            }
+
+            // Registered types other than the element type itself keep their callback
+            if (const auto* entry = find_polymorphic_entry(class_name); entry != nullptr)
+            {
+                if (*entry->type != typeid(element_type))
+                {
+                    archiver_wrapper<Archiver>::run_polymorphic(*entry, archive, &pointer, true);
+                    return;
+                }
+            }
+            else if (archiver_wrapper<Archiver>::registry()->Has(class_name))
+            {
+                archiver_wrapper<Archiver>::registry()->run(class_name, archive, &pointer, true);
+                return;
+            }
+        }
+
+        // Interned once the object and everything below it has loaded
+        if constexpr (detail::interns_pointer_v<Pointer>)
+        {
+            frames_.push_back(
+                {&pointer, &archive, detail::read_position(archive), 0, &loader::done_step,
+                 &loader::finish_interned<Pointer>});
+        }
+
+        auto object = serialization::access::serializer::make_ptr<element_type>();
+        push_object(archive, object.get());
+        pointer.reset(object.release());
+    }
+
+    static bool done_step(loader&, std::size_t) { return false; }
+
+    /// @brief Share the loaded object of an interned pointer; cursor holds its start
+    template <typename Pointer>
+    static void finish_interned(const frame& done)
+    {
+        auto& pointer = *static_cast<Pointer*>(done.object);
+        pointer       = detail::intern_loaded(*done.archive, done.cursor, std::move(pointer));
+    }
+
+    template <typename T>
+    void push_object(Archiver& archive, T* object)
+    {
+        if constexpr (property_count_v<T> > 0)
+        {
+            const auto class_name = archiver_wrapper<Archiver>::pop_class_name(archive);
+            SERIALIZATION_RETURN_IF_ERROR();
+
+            SERIALIZATION_CHECK(
+                !class_name.empty(),
+                detail::serialization_error::error_code::missing_field,
+                "Invalid or missing class name");
+
+            if (class_name != EMPTY_NAME)
+            {
+                frames_.push_back(
+                    {object, &archive, 0, property_count_v<T>, &loader::object_step<T>,
+                     &loader::finish_object<T>});
+            }
+        }
+    }
+
+    template <typename T>
+    static void finish_object(const frame& done)
+    {
+        serialization::access::serializer::initialize(*static_cast<T*>(done.object));
+    }
+
+    template <typename T, std::size_t I>
+    static void load_member(loader& self, Archiver& archive, void* object)
+    {
+        constexpr auto property = std::get<I>(serialization::access::serializer::tuple<T>());
+        auto&          member_archive = archiver_wrapper<Archiver>::get(archive, property.name());
+
+        if constexpr (!is_reflection_empty_v<std::decay_t<decltype(property)>>)
+        {
+            auto& member = static_cast<T*>(object)->*(property.member());
+            if constexpr (detail::encodes_field<Archiver, T, I>)
+            {
+                detail::load_encoded(member_archive, member, detail::field_encoding_v<T, I>);
+            }
+            else
+            {
+                self.load_value(member_archive, member);
+            }
+        }
+    }
+
+    template <typename T, std::size_t... I>
+    static constexpr auto make_member_table(std::index_sequence<I...>)
+    {
+        using member_function = void (*)(loader&, Archiver&, void*);
+        return std::array<member_function, sizeof...(I)>{&loader::load_member<T, I>...};
+    }
+
+    template <typename T>
+    static bool object_step(loader& self, std::size_t index)
+    {
+        static constexpr auto members =
+            make_member_table<T>(std::make_index_sequence<property_count_v<T>>{});
+
+        auto& current = self.frames_[index];
+        if (current.cursor == current.size)
+        {
+            return false;
+        }
+
+        const std::size_t member = current.cursor++;
+        members[member](self, *current.archive, current.object);
+        return true;
+    }
+
+    template <typename C>
+    static bool sequence_step(loader& self, std::size_t index)
+    {
+        auto& current = self.frames_[index];
+        if (current.cursor == current.size)
+        {
+            return false;
+        }
+
+        const std::size_t i       = current.cursor++;
+        auto&             element = static_cast<C*>(current.object)->emplace_back();
+        self.load_link(archiver_wrapper<Archiver>::get(*current.archive, i), element);
+        return true;
+    }
+
+    std::vector<frame> frames_;
+};
+}  // namespace iterative
+
+//-----------------------------------------------------------------------------
+// Public API
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Save without recursing on the data, for arbitrarily deep linked structures
+ * @note The archive is identical to the one written by save()
+ */
+template <typename Archiver, typename T>
+void save_iterative(Archiver& archive, const T& obj)
+{
+    iterative::saver<Archiver>().run(archive, obj);
+}
+
+/**
+ * @brief Load without recursing on the data, for arbitrarily deep linked structures
+ * @note Reads archives written by save() as well as save_iterative()
+ */
+template <typename Archiver, typename T>
+void load_iterative(Archiver& archive, T& obj)
+{
+    iterative::loader<Archiver>().run(archive, obj);
+}
+}  // namespace serialization
@@ -0,0 +1,286 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file serialization_lazy.h
+ * @brief Members decoded on first access
+ *
+ * A lazy<T> member is archived exactly like a T, but load() only captures its
+ * archive and moves past it:
+ *
+ * - the binary archive skips the value by its type tags and keeps a copy of
+ *   the skipped bytes
+ * - the JSON archive is already a tree, so the member's subtree is copied
+ *
+ * get() decodes the captured archive on first access; concurrent callers wait
+ * for a single decode. Saving a lazy<T> that was loaded from the same kind of
+ * archive and never modified writes the captured archive back unchanged, so
+ * an object can be loaded, edited elsewhere and saved again without ever
+ * decoding its large members.
+ *
+ * Binary streams that use the string dictionary refer to strings defined
+ * outside the member, so their lazy members are decoded during load().
+ */
+
+static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
+
+#include <atomic>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "common/archiver_wrapper.h"
+#include "common/serialization_concepts.h"
+#include "common/serialization_error.h"
+#include "serialization_impl.h"
+#include "serialization_projection.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/**
+ * @brief Wrapper that defers decoding a member until it is first read
+ * @tparam T The wrapped type; any type save() and load() accept
+ */
+template <typename T>
+class lazy
+{
+public:
+    using value_type = T;
+
+    lazy() = default;
+    lazy(T value) : value_(std::move(value)) {}
+
+    lazy(const lazy& other) { other.copy_to(*this); }
+
+    lazy(lazy&& other) noexcept
+        : decoded_(other.decoded()),
+          value_(std::move(other.value_)),
+          source_(std::move(other.source_))
+    {
+    }
+
+    lazy& operator=(const lazy& other)
+    {
+        if (this != &other)
+        {
+            other.copy_to(*this);
+        }
+        return *this;
+    }
+
+    lazy& operator=(lazy&& other) noexcept
+    {
+        decoded_.store(other.decoded(), std::memory_order_relaxed);
+        value_  = std::move(other.value_);
+        source_ = std::move(other.source_);
+        return *this;
+    }
+
+    lazy& operator=(T value)
+    {
+        value_ = std::move(value);
+        source_.template emplace<std::monostate>();
+        decoded_.store(true, std::memory_order_release);
+        return *this;
+    }
+
+    /**
+     * @brief The value, decoded on first access
+     * @note An archive that cannot be decoded is reported like a load() error:
+     *       recorded inside try_load(), thrown otherwise; the value is then
+     *       default constructed. Safe to call from several threads at once.
+     */
+    const T& get() const
+    {
+        if (!decoded_.load(std::memory_order_acquire)) [[unlikely]]
+        {
+            decode();
+        }
+        return value_;
+    }
+
+    const T& operator*() const { return get(); }
+    const T* operator->() const { return &get(); }
+
+    /**
+     * @brief The value for modification; the captured archive is discarded
+     */
+    T& get_mutable()
+    {
+        get();
+        source_.template emplace<std::monostate>();
+        return value_;
+    }
+
+    /// @brief True once get() no longer needs to decode
+    bool decoded() const noexcept { return decoded_.load(std::memory_order_acquire); }
+
+private:
+    template <typename Archiver, typename U>
+    friend struct impl::serializer_impl;
+
+    /// Captured binary archive followed by the endianness byte, as GetRawData() writes it
+    using binary_source = std::vector<unsigned char>;
+
+    void copy_to(lazy& target) const
+    {
+        std::scoped_lock lock(mutex_);
+        target.value_  = value_;
+        target.source_ = source_;
+        target.decoded_.store(decoded_.load(std::memory_order_relaxed), std::memory_order_release);
+    }
+
+    void decode() const
+    {
+        std::scoped_lock lock(mutex_);
+        if (decoded_.load(std::memory_order_relaxed))
+        {
+            return;
+        }
+
+        T                                   value{};
+        expected<void, serialization_error> status;
+        if (const auto* binary = std::get_if<binary_source>(&source_))
+        {
+            multi_process_stream archive;
+            archive.SetRawData(*binary);
+            status = serialization::try_load(archive, value);
+        }
+        else if (const auto* tree = std::get_if<json>(&source_))
+        {
+            status = serialization::try_load(const_cast<json&>(*tree), value);
+        }
+        if (!status) [[unlikely]]
+        {
+            // Left undecoded, so a later get() reports the error again
+            SERIALIZATION_THROW(status.error().code(), "{}", status.error().what());
+            return;
+        }
+
+        value_ = std::move(value);
+        decoded_.store(true, std::memory_order_release);
+    }
+
+    mutable std::mutex                                mutex_;
+    mutable std::atomic<bool>                         decoded_{true};
+    mutable T                                         value_{};
+    std::variant<std::monostate, binary_source, json> source_;
+};
+
+namespace impl
+{
+//-----------------------------------------------------------------------------
+// serialization::lazy specialization
+//-----------------------------------------------------------------------------
+template <typename Archiver, LazyLike T>
+struct serializer_impl<Archiver, T>
+{
+    using value_type    = typename T::value_type;
+    using binary_source = typename T::binary_source;
+
+    static void save(Archiver& archive, const T& obj)
+    {
+        if constexpr (std::same_as<Archiver, multi_process_stream>)
+        {
+            // The payload gets bit groups of its own, so that load() can capture
+            // it as whole bytes
+            archive.EndBitGroup();
+            if (const auto* binary = std::get_if<binary_source>(&obj.source_))
+            {
+                archive.PushConsumed(std::span(*binary).first(binary->size() - 1));
+                return;
+            }
+            serialization::save(archive, obj.get());
+            archive.EndBitGroup();
+            return;
+        }
+        else if constexpr (std::same_as<Archiver, json>)
+        {
+            if (const auto* tree = std::get_if<json>(&obj.source_))
+            {
+                archive = *tree;
+                return;
+            }
+        }
+        serialization::save(archive, obj.get());
+    }
+
+    static void load(Archiver& archive, T& obj)
+    {
+        obj.source_.template emplace<std::monostate>();
+        obj.value_ = value_type{};
+
+        if constexpr (std::same_as<Archiver, multi_process_stream>)
+        {
+            // References to earlier dictionary strings only resolve in this stream,
+            // and a payload sharing a bit group with its neighbours does not start
+            // or end on a byte; both are decoded now
+            if (archive.ReadDictionarySize() == 0 && !archive.InBitGroup())
+            {
+                const auto state = archive.SaveReadState();
+                const auto start = archive.ReadPosition();
+                projection::skip<value_type>(archive);
+                SERIALIZATION_RETURN_IF_ERROR();
+                if (archive.HasError()) [[unlikely]]
+                {
+                    return;
+                }
+                if (archive.InBitGroup())
+                {
+                    archive.RestoreReadState(state);
+                    serialization::load(archive, obj.value_);
+                    obj.decoded_.store(true, std::memory_order_release);
+                    return;
+                }
+
+                const auto    consumed = archive.ConsumedSince(start);
+                binary_source binary(consumed.begin(), consumed.end());
+                binary.push_back(archive.endianness());
+
+                // Strings the value defined are decoded the same way from its own
+                // bytes, but copying those bytes would redefine them in the output
+                if (archive.ReadDictionarySize() != 0)
+                {
+                    multi_process_stream scratch;
+                    scratch.SetRawData(binary);
+                    serialization::load(scratch, obj.value_);
+                    obj.decoded_.store(true, std::memory_order_release);
+                    return;
+                }
+
+                obj.source_ = std::move(binary);
+                obj.decoded_.store(false, std::memory_order_release);
+                return;
+            }
+        }
+        else if constexpr (std::same_as<Archiver, json>)
+        {
+            obj.source_.template emplace<json>(archive);
+            obj.decoded_.store(false, std::memory_order_release);
+            return;
+        }
+
+        serialization::load(archive, obj.value_);
+        obj.decoded_.store(true, std::memory_order_release);
+    }
+};
+}  // namespace impl
+}  // namespace serialization
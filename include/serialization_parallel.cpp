@@ -0,0 +1,190 @@
+#include "serialization_parallel.h"
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+
+#include "util/numa.h"
+
+namespace serialization
+{
+namespace detail
+{
+namespace
+{
+// Nodes the elements are spread over; one without placement
+std::size_t placement_node_count(const parallel_load_options& options)
+{
+    return options.placement == numa_placement::none ? 1 : numa_nodes().size();
+}
+
+//----------------------------------------------------------------------------
+// Every node gets at least one worker
+std::size_t worker_count(const parallel_load_options& options)
+{
+    std::size_t threads = options.threads;
+    if (threads == 0)
+    {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    return std::max(threads, placement_node_count(options));
+}
+}  // namespace
+
+//----------------------------------------------------------------------------
+std::vector<parallel_part> partition_parallel_load(
+    std::size_t size, std::size_t element_size, const parallel_load_options& options)
+{
+    const std::size_t          nodes   = placement_node_count(options);
+    const std::size_t          workers = worker_count(options);
+    std::vector<parallel_part> parts;
+
+    if (options.placement == numa_placement::interleaved)
+    {
+        const std::size_t block = std::max<std::size_t>(
+            1, options.interleave_bytes / std::max<std::size_t>(1, element_size));
+        for (std::size_t first = 0, i = 0; first < size; first += block, ++i)
+        {
+            parts.push_back({first, std::min(size, first + block), i % nodes});
+        }
+        return parts;
+    }
+
+    // One range per node, split evenly between the workers of the node
+    for (std::size_t node = 0; node < nodes; ++node)
+    {
+        const std::size_t node_first   = size * node / nodes;
+        const std::size_t node_size    = size * (node + 1) / nodes - node_first;
+        const std::size_t node_workers = workers / nodes + (node < workers % nodes ? 1 : 0);
+        for (std::size_t worker = 0; worker < node_workers; ++worker)
+        {
+            const std::size_t first = node_first + node_size * worker / node_workers;
+            const std::size_t last  = node_first + node_size * (worker + 1) / node_workers;
+            if (first < last)
+            {
+                parts.push_back({first, last, node});
+            }
+        }
+    }
+    return parts;
+}
+
+//----------------------------------------------------------------------------
+void place_parallel_load(
+    void*                          data,
+    std::size_t                    element_size,
+    std::span<const parallel_part> parts,
+    const parallel_load_options&   options)
+{
+    if (placement_node_count(options) < 2)
+    {
+        return;
+    }
+
+    // Best effort: without a policy the pages stay where they are touched first
+    auto* bytes = static_cast<unsigned char*>(data);
+    for (const auto& part : parts)
+    {
+        prefer_numa_node(
+            bytes + part.first * element_size,
+            (part.last - part.first) * element_size,
+            numa_nodes()[part.node].id);
+    }
+}
+
+//----------------------------------------------------------------------------
+std::optional<serialization_error> run_parallel_load(
+    std::span<const parallel_part> parts,
+    const parallel_load_options&   options,
+    const parallel_decoder&        decode)
+{
+    const std::size_t nodes = placement_node_count(options);
+    const bool        pin   = nodes > 1;
+
+    std::vector<std::vector<std::size_t>> queues(nodes);
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+        queues[parts[i].node].push_back(i);
+    }
+    std::vector<std::atomic<std::size_t>> next(nodes);
+
+    std::atomic<bool>                  failed{false};
+    std::mutex                         mutex;
+    std::optional<serialization_error> error;
+    std::size_t                        error_part = parts.size();
+#if SERIALIZATION_HAS_EXCEPTIONS
+    std::exception_ptr exception;
+#endif
+
+    const auto work = [&](std::size_t node)
+    {
+        if (pin)
+        {
+            bind_thread_to_numa_node(numa_nodes()[node]);
+        }
+
+        const auto& queue = queues[node];
+        while (!failed.load(std::memory_order_relaxed))
+        {
+            const std::size_t i = next[node].fetch_add(1, std::memory_order_relaxed);
+            if (i >= queue.size())
+            {
+                break;
+            }
+
+#if SERIALIZATION_HAS_EXCEPTIONS
+            try
+            {
+#endif
+                auto part_error = decode(parts[queue[i]]);
+                if (part_error) [[unlikely]]
+                {
+                    const std::lock_guard lock(mutex);
+                    if (queue[i] < error_part)
+                    {
+                        error_part = queue[i];
+                        error      = std::move(part_error);
+                    }
+                    failed.store(true, std::memory_order_relaxed);
+                }
+#if SERIALIZATION_HAS_EXCEPTIONS
+            }
+            catch (...)
+            {
+                const std::lock_guard lock(mutex);
+                if (!exception)
+                {
+                    exception = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+#endif
+        }
+    };
+
+    {
+        std::vector<std::jthread> workers;
+        const std::size_t         count = worker_count(options);
+        workers.reserve(count);
+        for (std::size_t worker = 0; worker < count; ++worker)
+        {
+            // No more workers on a node than it has parts
+            if (worker / nodes < queues[worker % nodes].size())
+            {
+                workers.emplace_back(work, worker % nodes);
+            }
+        }
+    }
+
+#if SERIALIZATION_HAS_EXCEPTIONS
+    if (exception)
+    {
+        std::rethrow_exception(exception);
+    }
+#endif
+    return error;
+}
+}  // namespace detail
+}  // namespace serialization
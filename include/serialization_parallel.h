@@ -0,0 +1,242 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#pragma once
+
+/**
+ * @file serialization_parallel.h
+ * @brief Decode large vectors on several threads, placed on NUMA nodes
+ *
+ * load_parallel() reads a std::vector written by save() to a binary archive.
+ * The elements are first skipped by their type tags to find where each part of
+ * the vector starts; the parts are then decoded by worker threads into a vector
+ * whose pages were placed on the nodes beforehand:
+ *
+ * | Placement   | Node of an element                             | Workers         |
+ * |-------------|------------------------------------------------|-----------------|
+ * | none        | wherever the allocator puts it                 | not pinned      |
+ * | per_node    | node k holds the k-th of N equal ranges        | pinned per node |
+ * | interleaved | blocks of interleave_bytes go to nodes in turn | pinned per node |
+ *
+ * Each worker decodes only parts placed on its own node, so elements and the
+ * memory they allocate while loading (strings, nested containers) are touched
+ * first by a CPU of that node. With placement, at least one worker runs per
+ * node. A single-node host only gains the parallel decode.
+ *
+ * The vector is loaded sequentially, as by load(), when it has fewer than
+ * min_elements elements, when a single worker would run, and when its elements
+ * depend on one another: strings from the stream's dictionary that were
+ * defined before or inside the vector, and bits packed across elements (see
+ * multi_process_stream::EnableBitPacking()). The result is the same either way.
+ */
+
+static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
+
+#include <concepts>
+#include <cstddef>
+#include <format>
+#include <functional>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "common/archiver_wrapper.h"
+#include "common/serialization_error.h"
+#include "serialization_impl.h"
+#include "serialization_projection.h"
+#include "util/export.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/// @brief Where the elements of a parallel load are placed
+enum class numa_placement
+{
+    none,
+    per_node,
+    interleaved
+};
+
+/**
+ * @brief Settings of load_parallel()
+ */
+struct parallel_load_options
+{
+    /// Decoding threads; 0 runs one per hardware thread
+    std::size_t threads = 0;
+    /// Partitioning of the elements over the NUMA nodes
+    numa_placement placement = numa_placement::per_node;
+    /// Smaller vectors are loaded on the calling thread
+    std::size_t min_elements = std::size_t{1} << 14;
+    /// Bytes of elements per block with interleaved placement
+    std::size_t interleave_bytes = std::size_t{1} << 21;
+};
+
+namespace detail
+{
+/**
+ * @brief Elements [first, last) of a parallel load and the bytes holding them
+ */
+struct parallel_part
+{
+    std::size_t first = 0;
+    std::size_t last  = 0;
+    std::size_t node  = 0;  ///< Index into numa_nodes()
+    std::size_t begin = 0;  ///< Offsets from the first element's bytes
+    std::size_t end   = 0;
+};
+
+using parallel_decoder = std::function<std::optional<serialization_error>(const parallel_part&)>;
+
+/// @brief Parts of a vector of size elements, in element order
+SERIALIZATION_API std::vector<parallel_part> partition_parallel_load(
+    std::size_t size, std::size_t element_size, const parallel_load_options& options);
+
+/// @brief Prefer the node of every part for the memory of its elements
+SERIALIZATION_API void place_parallel_load(
+    void*                           data,
+    std::size_t                     element_size,
+    std::span<const parallel_part>  parts,
+    const parallel_load_options&    options);
+
+/**
+ * @brief Decode every part on the workers of its node
+ * @return The error of a failing part; the other workers stop taking parts
+ */
+SERIALIZATION_API std::optional<serialization_error> run_parallel_load(
+    std::span<const parallel_part> parts,
+    const parallel_load_options&   options,
+    const parallel_decoder&        decode);
+
+template <typename Vector>
+void load_elements(multi_process_stream& archive, Vector& values, std::size_t size)
+{
+    values.clear();
+    values.reserve(detail::reserve_size<typename Vector::value_type>(archive, size));
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        serialization::load(archive, values.emplace_back());
+        SERIALIZATION_RETURN_IF_ERROR();
+    }
+}
+}  // namespace detail
+
+//-----------------------------------------------------------------------------
+// Public API
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Load a vector from a binary archive, decoding on several threads
+ * @param archive The archive to read from
+ * @param values The vector to load into; left unchanged if a parallel decode fails
+ * @param options Threads, placement and the size below which loading is sequential
+ * @note Errors are reported as by load(), including inside try_load()
+ */
+template <typename T, typename Allocator>
+    requires(!std::same_as<T, bool>)
+void load_parallel(
+    multi_process_stream&        archive,
+    std::vector<T, Allocator>&   values,
+    const parallel_load_options& options = {})
+{
+    // Elements could refer to strings defined before the vector
+    if (archive.ReadDictionarySize() != 0)
+    {
+        serialization::load(archive, values);
+        return;
+    }
+
+    const std::size_t size = detail::container_size<T>(archive);
+    SERIALIZATION_RETURN_IF_ERROR();
+
+    auto parts = detail::partition_parallel_load(size, sizeof(T), options);
+    if (size < options.min_elements || parts.size() < 2)
+    {
+        detail::load_elements(archive, values, size);
+        return;
+    }
+
+    // Skipping finds where each part starts without decoding anything
+    const std::size_t start       = archive.ReadPosition();
+    std::size_t       next        = 0;
+    bool              independent = true;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (next < parts.size() && parts[next].first == i)
+        {
+            independent         = independent && !archive.InBitGroup();
+            parts[next++].begin = archive.ReadPosition() - start;
+        }
+        projection::skip<T>(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+    }
+
+    const auto bytes = archive.ConsumedSince(start);
+    for (std::size_t i = 0; i < parts.size(); ++i)
+    {
+        parts[i].end = i + 1 < parts.size() ? parts[i + 1].begin : bytes.size();
+    }
+
+    if (!independent || archive.ReadDictionarySize() != 0)
+    {
+        multi_process_stream stream;
+        stream.SetRawData(bytes, archive.endianness());
+        detail::load_elements(stream, values, size);
+        return;
+    }
+
+    std::vector<T, Allocator> result(values.get_allocator());
+    result.reserve(size);
+    detail::place_parallel_load(result.data(), sizeof(T), parts, options);
+    result.resize(size);
+
+    const auto endianness = archive.endianness();
+    const auto error      = detail::run_parallel_load(
+        parts,
+        options,
+        [&](const detail::parallel_part& part) -> std::optional<serialization_error>
+        {
+            multi_process_stream stream;
+            stream.SetRawData(bytes.subspan(part.begin, part.end - part.begin), endianness);
+            for (std::size_t i = part.first; i < part.last; ++i)
+            {
+                auto status = serialization::try_load(stream, result[i]);
+                if (!status) [[unlikely]]
+                {
+                    return std::move(status.error());
+                }
+            }
+
+            if (!stream.Empty()) [[unlikely]]
+            {
+                return serialization_error(
+                    serialization_error::error_code::malformed_input,
+                    std::format(
+                        "{} bytes left after elements {} to {}",
+                        stream.Size(),
+                        part.first,
+                        part.last - 1));
+            }
+            return std::nullopt;
+        });
+
+    if (error) [[unlikely]]
+    {
+        SERIALIZATION_THROW(error->code(), "{}", error->what());
+        return;
+    }
+    values.swap(result);
+}
+}  // namespace serialization
@@ -0,0 +1,75 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file serialization_profile.h
+ * @brief Find out where the bytes of a binary archive come from
+ *
+ * profile_size() saves a value to a scratch multi_process_stream with a
+ * size_profiler attached and returns the tree described in
+ * common/size_profile.h; format_size_profile() renders it:
+ *
+ * @code
+ * test::trade                                              1063 B  100.0%         x1
+ *   test::trade                                            1063 B  100.0%         x1
+ *     fills_                                                902 B   84.9%         x1
+ *       (length)                                              2 B    0.2%         x1
+ *     fees_                                                 108 B   10.2%         x1
+ *       test::tiered_fee                                     52 B    4.9%         x1
+ *         tiers_                                             20 B    1.9%         x1
+ *         (class name)                                       18 B    1.7%         x1
+ *         ...
+ *       (class name)                                         29 B    2.7%         x2
+ *       test::fee                                            25 B    2.4%         x1
+ *       ...
+ *     (class name)                                           13 B    1.2%         x1
+ *     id_                                                     5 B    0.5%         x1
+ * @endcode
+ *
+ * To profile the archives an application actually writes, attach a profiler
+ * to its own stream with multi_process_stream::SetSizeProfiler().
+ */
+
+static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
+
+#include <string>
+
+#include "common/size_profile.h"
+#include "common/type_name.h"
+#include "serialization_impl.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/**
+ * @brief Attribute the binary archive of a value to its types and members
+ * @param obj The value to profile
+ * @param string_dictionary Profile the archive written with the string dictionary
+ */
+template <typename T>
+size_profile_node profile_size(const T& obj, bool string_dictionary = false)
+{
+    multi_process_stream archive;
+    archive.EnableStringDictionary(string_dictionary);
+
+    size_profiler profiler{std::string(type_name<T>())};
+    archive.SetSizeProfiler(&profiler);
+    serialization::save(archive, obj);
+    profiler.Finish(archive.Size());
+    return profiler.Root();
+}
+}  // namespace serialization
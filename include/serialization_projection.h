@@ -0,0 +1,370 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file serialization_projection.h
+ * @brief Load only the members on a field path
+ *
+ * load_projection() reads an archive written by save() but populates only the
+ * members named by a path such as {"positions", "notional"}:
+ *
+ * - at a reflected object, the member named by the next path entry is followed
+ *   and every other member is skipped
+ * - at a sequence container, the path applies to every element, so the example
+ *   selects positions[*].notional
+ * - at a map, keys are loaded in full and the path applies to every value
+ * - at the end of the path, the member is loaded in full with load()
+ *
+ * The binary archive skips values by their type tags without decoding them;
+ * the JSON archive is already a tree, so unselected members are never visited.
+ * Objects on the path are left partially loaded and their initialize() is not
+ * called. A path entry that names no member is reported as missing_field.
+ */
+
+static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
+
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "common/archiver_wrapper.h"
+#include "common/helper.h"
+#include "common/serialization_concepts.h"
+#include "common/type_name.h"
+#include "serialization_impl.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/// @brief Member names leading from an object to the selected field
+using field_path = std::span<const std::string_view>;
+
+namespace projection
+{
+//-----------------------------------------------------------------------------
+// Concepts
+//-----------------------------------------------------------------------------
+
+/// @brief Reflected type whose members can be selected by name
+template <typename T>
+concept ProjectableObject = Reflectable<T> && !BaseSerializable<T> && !Container<T>;
+
+/// @brief Sequence container whose elements are each projected
+template <typename T>
+concept ProjectableSequence =
+    Container<T> && EmplaceBackable<T> && !AssociativeContainer<T> && !BaseSerializable<T>;
+
+template <typename T>
+inline constexpr std::size_t property_count_v =
+    std::tuple_size_v<decltype(serialization::access::serializer::tuple<T>())>;
+
+//-----------------------------------------------------------------------------
+// Binary skipping
+//-----------------------------------------------------------------------------
+template <typename T>
+void skip(multi_process_stream& archive);
+
+inline void skip_values(multi_process_stream& archive, std::size_t count)
+{
+    if (!archive.Skip(count)) [[unlikely]]
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::malformed_input,
+            "Malformed binary stream while skipping {} values",
+            count);
+    }
+}
+
+template <ProjectableObject T>
+void skip_object(multi_process_stream& archive)
+{
+    const auto class_name = archiver_wrapper<multi_process_stream>::pop_class_name(archive);
+    SERIALIZATION_RETURN_IF_ERROR();
+
+    // Names are not compared, as in load(): archives of older releases spell them differently
+    SERIALIZATION_CHECK(
+        !class_name.empty(),
+        serialization_error::error_code::missing_field,
+        "Invalid or missing class name");
+
+    if (class_name == EMPTY_NAME)
+    {
+        return;
+    }
+
+    for_sequence(
+        std::make_index_sequence<property_count_v<T>>{},
+        [&]<auto I>(std::integral_constant<std::size_t, I>)
+        {
+            SERIALIZATION_RETURN_IF_ERROR();
+
+            using property_type =
+                std::decay_t<decltype(std::get<I>(serialization::access::serializer::tuple<T>()))>;
+            if constexpr (detail::encodes_field<multi_process_stream, T, I>)
+            {
+                skip_values(archive, detail::encoded_value_count(detail::field_encoding_v<T, I>));
+            }
+            else if constexpr (!is_reflection_empty_v<property_type>)
+            {
+                skip<typename property_type::member_type>(archive);
+            }
+        });
+}
+
+/// @brief Consume the archive of a T without materializing it
+template <typename T>
+void skip(multi_process_stream& archive)
+{
+    if constexpr (BaseSerializable<T>)
+    {
+        skip_values(archive, 1);
+    }
+    else if constexpr (ProjectableObject<T>)
+    {
+        skip_object<T>(archive);
+    }
+    else if constexpr (LazyLike<T>)
+    {
+        skip<typename T::value_type>(archive);
+    }
+    else if constexpr (MapLike<T>)
+    {
+        const auto size = archiver_wrapper<multi_process_stream>::size(archive);
+        for (std::size_t i = 0; i < size / 2; ++i)
+        {
+            skip<typename T::key_type>(archive);
+            skip<typename T::mapped_type>(archive);
+            SERIALIZATION_RETURN_IF_ERROR();
+        }
+    }
+    else if constexpr (Container<T>)
+    {
+        using value_type = typename T::value_type;
+        const auto size  = detail::container_size<value_type>(archive);
+        if constexpr (BaseSerializable<value_type>)
+        {
+            skip_values(archive, size);
+        }
+        else
+        {
+            for (std::size_t i = 0; i < size; ++i)
+            {
+                skip<value_type>(archive);
+                SERIALIZATION_RETURN_IF_ERROR();
+            }
+        }
+    }
+    else if constexpr (requires { typename T::first_type; typename T::second_type; })
+    {
+        skip<typename T::first_type>(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+        skip<typename T::second_type>(archive);
+    }
+    else
+    {
+        // Pointers, optionals, variants and tuples carry their layout in the
+        // data; decoding them into a scratch value is the cheapest way past.
+        static_assert(
+            std::default_initializable<T>, "Skipped members must be default constructible");
+        T scratch{};
+        serialization::load(archive, scratch);
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Projection
+//-----------------------------------------------------------------------------
+template <typename Archiver, typename T>
+void load(Archiver& archive, T& obj, field_path path);
+
+template <typename Archiver, ProjectableObject T>
+void load_object(Archiver& archive, T& obj, field_path path)
+{
+    const auto class_name = archiver_wrapper<Archiver>::pop_class_name(archive);
+
+    SERIALIZATION_CHECK(
+        !class_name.empty(),
+        serialization_error::error_code::missing_field,
+        "Invalid or missing class name");
+
+    if (class_name == EMPTY_NAME)
+    {
+        return;
+    }
+
+    bool found = false;
+    for_sequence(
+        std::make_index_sequence<property_count_v<T>>{},
+        [&]<auto I>(std::integral_constant<std::size_t, I>)
+        {
+            SERIALIZATION_RETURN_IF_ERROR();
+
+            constexpr auto property = std::get<I>(serialization::access::serializer::tuple<T>());
+            using property_type     = std::decay_t<decltype(property)>;
+            if constexpr (!is_reflection_empty_v<property_type>)
+            {
+                auto& archive_tmp = archiver_wrapper<Archiver>::get(archive, property.name());
+                auto& member_ref  = obj.*(property.member());
+                if (property.name() != path.front())
+                {
+                    if constexpr (std::same_as<Archiver, multi_process_stream>)
+                    {
+                        if constexpr (detail::encodes_field<Archiver, T, I>)
+                        {
+                            skip_values(
+                                archive_tmp,
+                                detail::encoded_value_count(detail::field_encoding_v<T, I>));
+                        }
+                        else
+                        {
+                            skip<typename property_type::member_type>(archive_tmp);
+                        }
+                    }
+                    return;
+                }
+
+                found = true;
+                if constexpr (detail::encodes_field<Archiver, T, I>)
+                {
+                    SERIALIZATION_CHECK(
+                        path.size() == 1,
+                        serialization_error::error_code::missing_field,
+                        "Field path continues past the encoded member {}",
+                        property.name());
+                    detail::load_encoded(archive_tmp, member_ref, detail::field_encoding_v<T, I>);
+                }
+                else
+                {
+                    projection::load(archive_tmp, member_ref, path.subspan(1));
+                }
+            }
+        });
+
+    SERIALIZATION_RETURN_IF_ERROR();
+    SERIALIZATION_CHECK(
+        found,
+        serialization_error::error_code::missing_field,
+        "{} has no member {}",
+        type_name<T>(),
+        path.front());
+}
+
+template <typename Archiver, typename T>
+void load(Archiver& archive, T& obj, field_path path)
+{
+    if (path.empty())
+    {
+        serialization::load(archive, obj);
+    }
+    else if constexpr (ProjectableObject<T>)
+    {
+        load_object(archive, obj, path);
+    }
+    else if constexpr (ProjectableSequence<T>)
+    {
+        const auto size = archiver_wrapper<Archiver>::size(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        obj.clear();
+        if constexpr (Reservable<T>)
+        {
+            obj.reserve(detail::reserve_size<typename T::value_type>(archive, size));
+        }
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            auto& element = obj.emplace_back();
+            projection::load(archiver_wrapper<Archiver>::get(archive, i), element, path);
+            SERIALIZATION_RETURN_IF_ERROR();
+        }
+    }
+    else if constexpr (MapLike<T>)
+    {
+        if constexpr (detail::json_object_map_v<Archiver, T>)
+        {
+            if (archive.is_object())
+            {
+                detail::load_json_object_map(
+                    archive,
+                    obj,
+                    [path](json& member, auto& value) { projection::load(member, value, path); });
+                return;
+            }
+        }
+
+        const auto size = archiver_wrapper<Archiver>::size(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+
+        obj.clear();
+        for (std::size_t i = 0; i < size / 2; ++i)
+        {
+            typename T::key_type    key;
+            typename T::mapped_type value;
+            serialization::load(archiver_wrapper<Archiver>::get(archive, 2 * i), key);
+            SERIALIZATION_RETURN_IF_ERROR();
+            projection::load(archiver_wrapper<Archiver>::get(archive, 2 * i + 1), value, path);
+            SERIALIZATION_RETURN_IF_ERROR();
+            obj.emplace(std::move(key), std::move(value));
+        }
+    }
+    else
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::missing_field,
+            "Field path continues into {}, which has no members: {}",
+            type_name<T>(),
+            path.front());
+    }
+}
+}  // namespace projection
+
+//-----------------------------------------------------------------------------
+// Public API
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Load only the members on a field path
+ * @param archive The archive to read from, written by save()
+ * @param obj The object to load into; members off the path are left untouched
+ * @param path Member names from obj down to the selected field
+ */
+template <typename Archiver, typename T>
+void load_projection(Archiver& archive, T& obj, field_path path)
+{
+    projection::load(archive, obj, path);
+}
+
+template <typename Archiver, typename T>
+void load_projection(Archiver& archive, T& obj, std::initializer_list<std::string_view> path)
+{
+    projection::load(archive, obj, field_path(path.begin(), path.size()));
+}
+
+/// @brief Load only the members on a field path into a default-constructed object
+template <typename T, typename Archiver>
+    requires std::default_initializable<T>
+[[nodiscard]] T load_projection(Archiver& archive, std::initializer_list<std::string_view> path)
+{
+    T obj{};
+    projection::load(archive, obj, field_path(path.begin(), path.size()));
+    return obj;
+}
+}  // namespace serialization
@@ -0,0 +1,345 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file serialization_schema.h
+ * @brief Describe the archive layout of a type for tools that do not link it
+ *
+ * export_schema<T>() walks the same dispatch as save() and returns a JSON
+ * document naming the shape of every value and the members of every
+ * reflected class, in archive order:
+ *
+ * @code
+ * {
+ *   "root":  {"pointer": "test::book"},
+ *   "types": {"test::book": {"fields": [{"name": "name_", "type": "string"}, ...]}}
+ * }
+ * @endcode
+ *
+ * | Shape                        | C++ types                                        |
+ * |------------------------------|--------------------------------------------------|
+ * | "bool", "char", "uchar"      | bool, char, unsigned char                        |
+ * | "short", "uint16"            | short, uint16_t                                  |
+ * | "int32", "uint32"            | 32-bit integers                                  |
+ * | "int64", "uint64"            | 64-bit integers                                  |
+ * | "float", "double", "string"  | float, double, std::string                       |
+ * | "monostate", "none"          | std::monostate, members without data             |
+ * | {"enum": names}              | enums; names maps enumerator names to values     |
+ * | {"object": class}            | reflected classes held by value or raw pointer   |
+ * | {"pointer": class}           | shared pointers, including ptr_const             |
+ * | {"sequence": shape}          | sequence and set containers, std::array, bitset  |
+ * | {"bytes": shape}             | unsigned char and std::byte sequences and arrays |
+ * | {"map": [key, value]}        | maps                                             |
+ * | {"multimap": [key, value]}   | maps with repeated keys                          |
+ * | {"pair": [first, second]}    | std::pair                                        |
+ * | {"tuple": [shapes]}          | std::tuple                                       |
+ * | {"optional": shape}          | std::optional                                    |
+ * | {"variant": [shapes]}        | std::variant                                     |
+ *
+ * Byte sequences are archived like other sequences in binary, and as one base64
+ * string in JSON. std::vector<bool> and std::bitset are sequences of "bool" whose
+ * bits are packed in binary (see multi_process_stream::PushBits()). unique_ptr
+ * and lazy members take the shape of their element. A field written with a
+ * field encoding carries it as "encoding". Derived classes
+ * saved through base pointers are listed by passing them as extra template arguments.
+ *
+ * The schema drives the streaming transcoder of common/transcoder.h.
+ */
+
+static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+#include "common/archiver_wrapper.h"
+#include "common/field_encoding.h"
+#include "common/helper.h"
+#include "common/serialization_concepts.h"
+#include "common/type_name.h"
+#include "serialization_impl.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+namespace schema
+{
+template <typename T>
+inline constexpr bool is_std_array_v = false;
+
+template <typename Item, std::size_t Size>
+inline constexpr bool is_std_array_v<std::array<Item, Size>> = true;
+
+template <typename T>
+inline constexpr bool is_byte_array_v = false;
+
+template <ByteLike Item, std::size_t Size>
+inline constexpr bool is_byte_array_v<std::array<Item, Size>> = true;
+
+inline json describe_encoding(const field_encoding& encoding)
+{
+    constexpr const char* kinds[] = {
+        "none", "float32", "fixed_point", "quantized", "delta_of_delta", "bits"};
+
+    json result;
+    result["kind"] = kinds[static_cast<int>(encoding.kind)];
+    if (encoding.kind == encoding_kind::fixed_point)
+    {
+        result["digits"] = encoding.digits;
+    }
+    else if (encoding.kind == encoding_kind::quantized)
+    {
+        result["min"]       = encoding.min;
+        result["max"]       = encoding.max;
+        result["max_error"] = encoding.max_error;
+    }
+    else if (encoding.kind == encoding_kind::bits)
+    {
+        result["width"] = encoding.width;
+    }
+    return result;
+}
+
+template <typename T>
+json shape(json& types);
+
+/// @brief Add the members of a reflected class to the type table
+template <typename T>
+void describe_class(json& types)
+{
+    const std::string name(type_name<T>());
+    if (types.contains(name))
+    {
+        return;
+    }
+
+    // Registered before the members, so that recursive types terminate
+    types[name] = json::object();
+
+    json fields = json::array();
+    for_sequence(
+        std::make_index_sequence<
+            std::tuple_size_v<decltype(serialization::access::serializer::tuple<T>())>>{},
+        [&]<auto I>(std::integral_constant<std::size_t, I>)
+        {
+            constexpr auto property = std::get<I>(serialization::access::serializer::tuple<T>());
+            using property_type     = std::decay_t<decltype(property)>;
+
+            json field;
+            field["name"] = std::string(property.name());
+            if constexpr (is_reflection_empty_v<property_type>)
+            {
+                field["type"] = "none";
+            }
+            else
+            {
+                field["type"] = shape<typename property_type::member_type>(types);
+                if constexpr (detail::encodes_field<multi_process_stream, T, I>)
+                {
+                    field["encoding"] = describe_encoding(detail::field_encoding_v<T, I>);
+                }
+            }
+            fields.push_back(std::move(field));
+        });
+
+    types[name]["fields"] = std::move(fields);
+}
+
+template <typename... Types>
+json shapes(json& types)
+{
+    json result = json::array();
+    (result.push_back(shape<Types>(types)), ...);
+    return result;
+}
+
+template <typename T>
+json describe_enum()
+{
+#if SERIALIZATION_HAS_MAGICENUM
+    json names = json::object();
+    for (const auto& [value, name] : magic_enum::enum_entries<T>())
+    {
+        names[std::string(name)] = static_cast<int>(value);
+    }
+    return names;
+#else
+    // Enumerators are archived by value
+    return nullptr;
+#endif
+}
+
+/// @brief Shape of a value of type T, as written by save()
+template <typename T>
+json shape(json& types)
+{
+    using U = std::remove_cv_t<T>;
+
+    if constexpr (std::same_as<U, bool>)
+    {
+        return "bool";
+    }
+    else if constexpr (std::same_as<U, char> || std::same_as<U, signed char>)
+    {
+        return "char";
+    }
+    else if constexpr (std::same_as<U, unsigned char>)
+    {
+        return "uchar";
+    }
+    else if constexpr (std::same_as<U, short>)
+    {
+        return "short";
+    }
+    else if constexpr (std::same_as<U, unsigned short>)
+    {
+        return "uint16";
+    }
+    else if constexpr (std::integral<U>)
+    {
+        static_assert(sizeof(U) == 4 || sizeof(U) == 8, "Unsupported integer width");
+        if constexpr (std::is_signed_v<U>)
+        {
+            return sizeof(U) == 4 ? "int32" : "int64";
+        }
+        else
+        {
+            return sizeof(U) == 4 ? "uint32" : "uint64";
+        }
+    }
+    else if constexpr (std::same_as<U, float>)
+    {
+        return "float";
+    }
+    else if constexpr (std::same_as<U, double>)
+    {
+        return "double";
+    }
+    else if constexpr (std::same_as<U, std::string> || std::same_as<U, const char*>)
+    {
+        return "string";
+    }
+    else if constexpr (std::same_as<U, std::monostate>)
+    {
+        return "monostate";
+    }
+    else if constexpr (std::is_enum_v<U>)
+    {
+        return json{{"enum", describe_enum<U>()}};
+    }
+    else if constexpr (ByteSequence<U> || is_byte_array_v<U>)
+    {
+        return json{{"bytes", shape<typename U::value_type>(types)}};
+    }
+    else if constexpr (BitsetLike<U>)
+    {
+        return json{{"sequence", "bool"}};
+    }
+    else if constexpr (is_std_array_v<U>)
+    {
+        return json{{"sequence", shape<typename U::value_type>(types)}};
+    }
+    else if constexpr (VariantLike<U>)
+    {
+        return [&]<typename... Alternatives>(std::variant<Alternatives...>*)
+        { return json{{"variant", shapes<Alternatives...>(types)}}; }(static_cast<U*>(nullptr));
+    }
+    else if constexpr (requires {
+                           typename U::first_type;
+                           typename U::second_type;
+                       })
+    {
+        return json{{"pair", shapes<typename U::first_type, typename U::second_type>(types)}};
+    }
+    else if constexpr (UniquePointer<U>)
+    {
+        return shape<typename U::element_type>(types);
+    }
+    else if constexpr (LazyLike<U>)
+    {
+        return shape<typename U::value_type>(types);
+    }
+    else if constexpr (SharedPointer<U>)
+    {
+        using element_type = std::remove_const_t<typename U::element_type>;
+        if constexpr (Reflectable<element_type>)
+        {
+            describe_class<element_type>(types);
+        }
+        return json{{"pointer", std::string(type_name<element_type>())}};
+    }
+    else if constexpr (TupleLike<U>)
+    {
+        return [&]<std::size_t... Is>(std::index_sequence<Is...>)
+        {
+            return json{{"tuple", shapes<std::tuple_element_t<Is, U>...>(types)}};
+        }(std::make_index_sequence<std::tuple_size_v<U>>{});
+    }
+    else if constexpr (OptionalLike<U>)
+    {
+        return json{{"optional", shape<typename U::value_type>(types)}};
+    }
+    else if constexpr (MapLike<U>)
+    {
+        return json{
+            {UniqueKeyMap<U> ? "map" : "multimap",
+             shapes<typename U::key_type, typename U::mapped_type>(types)}};
+    }
+    else if constexpr (Container<U>)
+    {
+        return json{{"sequence", shape<typename U::value_type>(types)}};
+    }
+    else if constexpr (std::is_pointer_v<U> && Reflectable<std::remove_pointer_t<U>>)
+    {
+        using element_type = std::remove_cv_t<std::remove_pointer_t<U>>;
+        describe_class<element_type>(types);
+        return json{{"object", std::string(type_name<element_type>())}};
+    }
+    else if constexpr (Reflectable<U>)
+    {
+        describe_class<U>(types);
+        return json{{"object", std::string(type_name<U>())}};
+    }
+    else
+    {
+        static_assert(always_false<T>::value, "Type not supported for serialization");
+    }
+}
+}  // namespace schema
+
+/**
+ * @brief Describe the archive of a T for the transcoder
+ * @tparam T The archived type; ptr_const<T> for files written by access::write_to_binary()
+ * @tparam Derived Classes that may be saved through base pointers inside T
+ */
+template <typename T, typename... Derived>
+json export_schema()
+{
+    json types  = json::object();
+    json result = json::object();
+    result["root"] = schema::shape<T>(types);
+    (schema::describe_class<Derived>(types), ...);
+    result["types"] = std::move(types);
+    return result;
+}
+}  // namespace serialization
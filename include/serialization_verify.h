@@ -0,0 +1,424 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#pragma once
+
+/**
+ * @file serialization_verify.h
+ * @brief Check binary input against a type before loading it
+ *
+ * verify<T>() walks the next value of a binary archive as load() of a T would
+ * read it, but constructs nothing: every type tag must be one load() accepts,
+ * every length must fit in the remaining bytes, array, tuple and bitset sizes
+ * must match, variant indices must be in range and reflected objects must carry
+ * a class name. Strings are viewed in place rather than copied.
+ * The archive is left where it was, ready for load().
+ *
+ * Input that passes loads without structural errors, so receivers of data from
+ * other processes can reject a malformed frame before building any object.
+ * Members with a field encoding, and shared pointers saved as a registered
+ * polymorphic type, are decoded into a scratch value instead, as only their
+ * loaders know their layout. Nesting is limited as for load(). What load()
+ * leaves to the types is not checked: enumerations are not range checked, and
+ * initialize() may still reject an object.
+ */
+
+static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
+
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "common/archiver_wrapper.h"
+#include "common/serialization_concepts.h"
+#include "common/serialization_error.h"
+#include "common/type_name.h"
+#include "serialization_impl.h"
+#include "serialization_projection.h"
+#include "util/expected.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+namespace verification
+{
+//-----------------------------------------------------------------------------
+// Traits
+//-----------------------------------------------------------------------------
+template <typename T>
+inline constexpr bool is_std_array_v = false;
+
+template <typename Item, std::size_t Size>
+inline constexpr bool is_std_array_v<std::array<Item, Size>> = true;
+
+template <typename T>
+inline constexpr bool is_bit_vector_v = false;
+
+template <typename Allocator>
+inline constexpr bool is_bit_vector_v<std::vector<bool, Allocator>> = true;
+
+//-----------------------------------------------------------------------------
+// Checks
+//-----------------------------------------------------------------------------
+template <typename T>
+void check(multi_process_stream& archive);
+
+template <typename T>
+void check_value(multi_process_stream& archive)
+{
+    if constexpr (std::same_as<T, std::string>)
+    {
+        std::string_view value;
+        archive >> value;
+        if (archive.HasError()) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed binary stream while reading {}",
+                type_name<T>());
+        }
+    }
+    else
+    {
+        T value{};
+        archiver_wrapper<multi_process_stream>::pop(archive, value);
+    }
+}
+
+inline std::size_t check_size(multi_process_stream& archive)
+{
+    return archiver_wrapper<multi_process_stream>::size(archive);
+}
+
+/// @brief Size of a container of bools or of a fixed-size tuple, whose bools may be packed
+inline std::size_t check_bit_size(multi_process_stream& archive)
+{
+    return archiver_wrapper<multi_process_stream>::bit_size(archive);
+}
+
+inline void check_bits(multi_process_stream& archive, std::size_t size)
+{
+    for (std::size_t begin = 0; begin < size; begin += 64)
+    {
+        archive.PopBits(static_cast<unsigned int>(std::min<std::size_t>(64, size - begin)));
+        SERIALIZATION_CHECK(
+            !archive.HasError(),
+            serialization_error::error_code::malformed_input,
+            "Malformed binary stream while reading {} bits",
+            size);
+    }
+}
+
+template <typename T>
+void check_elements(multi_process_stream& archive, std::size_t size)
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        check<T>(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+    }
+}
+
+template <projection::ProjectableObject T>
+void check_object(multi_process_stream& archive)
+{
+    // Viewed rather than copied; load() reads it into a string
+    std::string_view class_name;
+    archive >> class_name;
+    SERIALIZATION_CHECK(
+        !archive.HasError(),
+        serialization_error::error_code::malformed_input,
+        "Malformed binary stream while reading a class name");
+    SERIALIZATION_CHECK(
+        !class_name.empty(),
+        serialization_error::error_code::missing_field,
+        "Invalid or missing class name");
+
+    if (class_name == EMPTY_NAME)
+    {
+        return;
+    }
+
+    for_sequence(
+        std::make_index_sequence<projection::property_count_v<T>>{},
+        [&]<auto I>(std::integral_constant<std::size_t, I>)
+        {
+            SERIALIZATION_RETURN_IF_ERROR();
+
+            using property_type =
+                std::decay_t<decltype(std::get<I>(serialization::access::serializer::tuple<T>()))>;
+            if constexpr (detail::encodes_field<multi_process_stream, T, I>)
+            {
+                // Only decoding tells whether an encoded value is consistent
+                typename property_type::member_type scratch{};
+                detail::load_encoded(archive, scratch, detail::field_encoding_v<T, I>);
+            }
+            else if constexpr (!is_reflection_empty_v<property_type>)
+            {
+                check<typename property_type::member_type>(archive);
+            }
+        });
+}
+
+template <typename T>
+void check_variant(multi_process_stream& archive)
+{
+    constexpr std::size_t count = std::variant_size_v<T>;
+    const auto            index =
+        archiver_wrapper<multi_process_stream>::pop_index(archive, INDEX_NAME);
+    SERIALIZATION_RETURN_IF_ERROR();
+    SERIALIZATION_CHECK(
+        index < count,
+        serialization_error::error_code::invalid_index,
+        "Variant index {} out of range (max {})",
+        index,
+        count - 1);
+
+    using checker_type = void (*)(multi_process_stream&);
+    static constexpr auto checkers = []<std::size_t... I>(std::index_sequence<I...>)
+    {
+        return std::array<checker_type, count>{&check<std::variant_alternative_t<I, T>>...};
+    }(std::make_index_sequence<count>{});
+    checkers[index](archive);
+}
+
+template <typename T>
+void check_shared_pointer(multi_process_stream& archive)
+{
+    using element_type = std::remove_const_t<typename T::element_type>;
+
+    const auto       state = archive.SaveReadState();
+    std::string_view class_name;
+    archive >> class_name;
+    SERIALIZATION_CHECK(
+        !archive.HasError(),
+        serialization_error::error_code::malformed_input,
+        "Malformed binary stream while reading a class name");
+
+    if (class_name == EMPTY_NAME)
+    {
+        return;
+    }
+
+    const auto guard = detail::serialization_context::current().enter();
+    SERIALIZATION_RETURN_IF_ERROR();
+
+    // Registered types have their own layout, known only to their loader
+    if (find_polymorphic_entry(class_name) != nullptr ||
+        archiver_wrapper<multi_process_stream>::registry()->Has(std::string(class_name)))
+    {
+        archive.RestoreReadState(state);
+        T scratch;
+        serialization::load(archive, scratch);
+        return;
+    }
+
+    if constexpr (Reflectable<element_type>)
+    {
+        check<element_type>(archive);
+    }
+    else
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::registry_not_found,
+            "Cannot deserialize type '{}': not registered and no reflection available",
+            class_name);
+    }
+}
+
+/// @brief Walk the archive of a T as load() reads it, without constructing it
+template <typename T>
+void check(multi_process_stream& archive)
+{
+    if constexpr (requires { typename T::first_type; typename T::second_type; })
+    {
+        check<typename T::first_type>(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+        check<typename T::second_type>(archive);
+    }
+    else if constexpr (is_bit_vector_v<T>)
+    {
+        const auto size = check_bit_size(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+        check_bits(archive, size);
+    }
+    else if constexpr (BitsetLike<T>)
+    {
+        const auto size = check_bit_size(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+        SERIALIZATION_CHECK(
+            size == T().size(),
+            serialization_error::error_code::size_mismatch,
+            "Bitset size mismatch: expected {} but got {}",
+            T().size(),
+            size);
+        check_bits(archive, size);
+    }
+    else if constexpr (is_std_array_v<T> || TupleLike<T>)
+    {
+        constexpr std::size_t expected_size = std::tuple_size_v<T>;
+        const auto            size          = [&]
+        {
+            if constexpr (is_std_array_v<T>)
+            {
+                return detail::container_size<typename T::value_type>(archive);
+            }
+            else
+            {
+                return check_bit_size(archive);
+            }
+        }();
+        SERIALIZATION_RETURN_IF_ERROR();
+        SERIALIZATION_CHECK(
+            size == expected_size,
+            serialization_error::error_code::size_mismatch,
+            "Size mismatch for {}: expected {} but got {}",
+            type_name<T>(),
+            expected_size,
+            size);
+
+        if constexpr (is_std_array_v<T>)
+        {
+            check_elements<typename T::value_type>(archive, size);
+        }
+        else
+        {
+            [&]<std::size_t... I>(std::index_sequence<I...>)
+            {
+                (void)((check<std::tuple_element_t<I, T>>(archive), !detail::has_error()) &&
+                       ...);
+            }(std::make_index_sequence<expected_size>{});
+        }
+    }
+    else if constexpr (VariantLike<T>)
+    {
+        check_variant<T>(archive);
+    }
+    else if constexpr (OptionalLike<T>)
+    {
+        const auto size = check_size(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+        SERIALIZATION_CHECK(
+            size >= 1,
+            serialization_error::error_code::size_mismatch,
+            "Invalid optional serialization: expected at least 1 element but got {}",
+            size);
+
+        bool has_value = false;
+        archiver_wrapper<multi_process_stream>::pop(archive, has_value);
+        SERIALIZATION_RETURN_IF_ERROR();
+        if (has_value)
+        {
+            SERIALIZATION_CHECK(
+                size >= 2,
+                serialization_error::error_code::size_mismatch,
+                "Invalid optional serialization: has_value=true but only {} elements",
+                size);
+            check<typename T::value_type>(archive);
+        }
+    }
+    else if constexpr (UniquePointer<T>)
+    {
+        const auto guard = detail::serialization_context::current().enter();
+        SERIALIZATION_RETURN_IF_ERROR();
+        check<std::remove_const_t<typename T::element_type>>(archive);
+    }
+    else if constexpr (SharedPointer<T>)
+    {
+        check_shared_pointer<T>(archive);
+    }
+    else if constexpr (LazyLike<T>)
+    {
+        check<typename T::value_type>(archive);
+    }
+    else if constexpr (BaseSerializable<T>)
+    {
+        check_value<T>(archive);
+    }
+    else if constexpr (projection::ProjectableObject<T>)
+    {
+        check_object<T>(archive);
+    }
+    else if constexpr (MapLike<T>)
+    {
+        const auto size = check_size(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+        SERIALIZATION_CHECK(
+            size % 2 == 0,
+            serialization_error::error_code::size_mismatch,
+            "Invalid map serialization: odd number of elements ({})",
+            size);
+        for (std::size_t i = 0; i < size / 2; ++i)
+        {
+            check<typename T::key_type>(archive);
+            SERIALIZATION_RETURN_IF_ERROR();
+            check<typename T::mapped_type>(archive);
+            SERIALIZATION_RETURN_IF_ERROR();
+        }
+    }
+    else if constexpr (Container<T>)
+    {
+        const auto size = detail::container_size<typename T::value_type>(archive);
+        SERIALIZATION_RETURN_IF_ERROR();
+        check_elements<typename T::value_type>(archive, size);
+    }
+    else
+    {
+        static_assert(always_false<T>::value, "Type not supported for verification");
+    }
+}
+}  // namespace verification
+
+//-----------------------------------------------------------------------------
+// Public API
+//-----------------------------------------------------------------------------
+
+/**
+ * @brief Check that the next value of a binary archive loads as a T
+ * @param archive The archive to check; its read position is left unchanged
+ * @return Nothing if load() of a T would find well-formed input, otherwise the
+ *         error it would report
+ */
+template <typename T>
+[[nodiscard]] expected<void, serialization_error> verify(multi_process_stream& archive)
+{
+    const auto state = archive.SaveReadState();
+
+    detail::error_scope scope;
+    verification::check<T>(archive);
+    const bool truncated = !scope.failed() && archive.HasError();
+    archive.RestoreReadState(state);
+
+    if (truncated) [[unlikely]]
+    {
+        return unexpected(serialization_error(
+            serialization_error::error_code::malformed_input, "Archive is truncated"));
+    }
+    if (scope.failed()) [[unlikely]]
+    {
+        return unexpected(scope.take_error());
+    }
+    return {};
+}
+}  // namespace serialization
@@ -0,0 +1,277 @@
+#include "util/base64.h"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+
+#include "util/simd_kernels.h"
+
+#if defined(SERIALIZATION_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace serialization
+{
+namespace
+{
+constexpr char alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+constexpr unsigned char invalid = 0xff;
+
+constexpr std::array<unsigned char, 256> make_decode_table()
+{
+    std::array<unsigned char, 256> table{};
+    table.fill(invalid);
+    for (unsigned char i = 0; i < 64; ++i)
+    {
+        table[static_cast<unsigned char>(alphabet[i])] = i;
+    }
+    return table;
+}
+
+constexpr std::array<unsigned char, 256> decode_table = make_decode_table();
+
+void encode_group(const unsigned char* bytes, char* text)
+{
+    const uint32_t group =
+        uint32_t{bytes[0]} << 16 | uint32_t{bytes[1]} << 8 | uint32_t{bytes[2]};
+    text[0] = alphabet[group >> 18];
+    text[1] = alphabet[(group >> 12) & 0x3f];
+    text[2] = alphabet[(group >> 6) & 0x3f];
+    text[3] = alphabet[group & 0x3f];
+}
+
+bool decode_quad(const char* text, unsigned char* bytes)
+{
+    const unsigned char a = decode_table[static_cast<unsigned char>(text[0])];
+    const unsigned char b = decode_table[static_cast<unsigned char>(text[1])];
+    const unsigned char c = decode_table[static_cast<unsigned char>(text[2])];
+    const unsigned char d = decode_table[static_cast<unsigned char>(text[3])];
+    if ((a | b | c | d) == invalid)
+    {
+        return false;
+    }
+    const uint32_t group = uint32_t{a} << 18 | uint32_t{b} << 12 | uint32_t{c} << 6 | d;
+    bytes[0]             = static_cast<unsigned char>(group >> 16);
+    bytes[1]             = static_cast<unsigned char>(group >> 8);
+    bytes[2]             = static_cast<unsigned char>(group);
+    return true;
+}
+
+#if defined(SERIALIZATION_ARCH_X86)
+/// Base64 characters of the first 12 bytes of a block (W. Mula and D. Lemire)
+SERIALIZATION_TARGET("ssse3")
+__m128i encode_block(__m128i bytes)
+{
+    // Each 32-bit lane receives the three bytes of one output quad
+    const __m128i in =
+        _mm_shuffle_epi8(bytes, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+
+    // Move every 6-bit group into its own byte
+    const __m128i high = _mm_mulhi_epu16(
+        _mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)), _mm_set1_epi32(0x04000040));
+    const __m128i low = _mm_mullo_epi16(
+        _mm_and_si128(in, _mm_set1_epi32(0x003f03f0)), _mm_set1_epi32(0x01000010));
+    const __m128i indices = _mm_or_si128(high, low);
+
+    // Map each range of the alphabet to the offset of its first character
+    __m128i range = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+    range         = _mm_or_si128(
+        range, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+    const __m128i offsets = _mm_setr_epi8(
+        'a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+        '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0);
+    return _mm_add_epi8(_mm_shuffle_epi8(offsets, range), indices);
+}
+
+SERIALIZATION_TARGET("ssse3")
+__m128i in_range(__m128i chars, char first, char last)
+{
+    // Signed comparisons also reject bytes above 0x7f
+    return _mm_and_si128(
+        _mm_cmpgt_epi8(chars, _mm_set1_epi8(static_cast<char>(first - 1))),
+        _mm_cmpgt_epi8(_mm_set1_epi8(static_cast<char>(last + 1)), chars));
+}
+
+/// Decode 16 base64 characters into the first 12 bytes of out; false on a foreign character
+SERIALIZATION_TARGET("ssse3")
+bool decode_block(const char* text, unsigned char* out)
+{
+    const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    const __m128i upper = in_range(chars, 'A', 'Z');
+    const __m128i lower = in_range(chars, 'a', 'z');
+    const __m128i digit = in_range(chars, '0', '9');
+    const __m128i plus  = _mm_cmpeq_epi8(chars, _mm_set1_epi8('+'));
+    const __m128i slash = _mm_cmpeq_epi8(chars, _mm_set1_epi8('/'));
+
+    const __m128i valid =
+        _mm_or_si128(_mm_or_si128(upper, lower), _mm_or_si128(_mm_or_si128(digit, plus), slash));
+    if (_mm_movemask_epi8(valid) != 0xffff)
+    {
+        return false;
+    }
+
+    const __m128i shift = _mm_or_si128(
+        _mm_or_si128(
+            _mm_and_si128(upper, _mm_set1_epi8(-'A')),
+            _mm_and_si128(lower, _mm_set1_epi8(26 - 'a'))),
+        _mm_or_si128(
+            _mm_and_si128(digit, _mm_set1_epi8(52 - '0')),
+            _mm_or_si128(
+                _mm_and_si128(plus, _mm_set1_epi8(62 - '+')),
+                _mm_and_si128(slash, _mm_set1_epi8(63 - '/')))));
+    const __m128i values = _mm_add_epi8(chars, shift);
+
+    // Join the 6-bit groups of each quad into 24 bits, then drop the fourth byte
+    const __m128i pairs = _mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140));
+    const __m128i quads = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+    const __m128i bytes = _mm_shuffle_epi8(
+        quads, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+
+    alignas(16) unsigned char block[16];
+    _mm_store_si128(reinterpret_cast<__m128i*>(block), bytes);
+    std::memcpy(out, block, 12);
+    return true;
+}
+#endif
+}  // namespace
+
+//-----------------------------------------------------------------------------
+std::size_t simd::base64_encode_scalar(
+    const unsigned char* bytes, std::size_t size, char* text) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 3 <= size; i += 3, text += 4)
+    {
+        encode_group(bytes + i, text);
+    }
+    return i;
+}
+
+//-----------------------------------------------------------------------------
+std::size_t simd::base64_decode_scalar(
+    const char* text, std::size_t size, unsigned char* bytes) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 4 <= size && decode_quad(text + i, bytes); i += 4, bytes += 3)
+    {
+    }
+    return i;
+}
+
+#if defined(SERIALIZATION_ARCH_X86)
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("ssse3")
+std::size_t simd::base64_encode_ssse3(
+    const unsigned char* bytes, std::size_t size, char* text) noexcept
+{
+    // Blocks are loaded 16 bytes at a time, of which 12 are encoded
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 12, text += 16)
+    {
+        const __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(text), encode_block(block));
+    }
+    return i + base64_encode_scalar(bytes + i, size - i, text);
+}
+
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("ssse3")
+std::size_t simd::base64_decode_ssse3(
+    const char* text, std::size_t size, unsigned char* bytes) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size && decode_block(text + i, bytes); i += 16, bytes += 12)
+    {
+    }
+    return i + base64_decode_scalar(text + i, size - i, bytes);
+}
+#endif
+
+//-----------------------------------------------------------------------------
+void append_base64(std::string& out, const void* data, std::size_t size)
+{
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    std::size_t at    = out.size();
+    out.resize(at + (size + 2) / 3 * 4);
+    char* text = out.data() + at;
+
+    const std::size_t i = simd::kernels().base64_encode(bytes, size, text);
+    text += i / 3 * 4;
+    if (i < size)
+    {
+        const uint32_t group =
+            uint32_t{bytes[i]} << 16 | (i + 1 < size ? uint32_t{bytes[i + 1]} << 8 : 0);
+        text[0] = alphabet[group >> 18];
+        text[1] = alphabet[(group >> 12) & 0x3f];
+        text[2] = i + 1 < size ? alphabet[(group >> 6) & 0x3f] : '=';
+        text[3] = '=';
+    }
+}
+
+//-----------------------------------------------------------------------------
+std::size_t base64_decoded_size(std::string_view text) noexcept
+{
+    if (text.size() % 4 != 0)
+    {
+        return std::string_view::npos;
+    }
+
+    std::size_t padding = 0;
+    if (!text.empty() && text.back() == '=')
+    {
+        padding = text[text.size() - 2] == '=' ? 2 : 1;
+    }
+    return text.size() / 4 * 3 - padding;
+}
+
+//-----------------------------------------------------------------------------
+bool decode_base64(std::string_view text, void* out) noexcept
+{
+    const std::size_t size = base64_decoded_size(text);
+    if (size == std::string_view::npos)
+    {
+        return false;
+    }
+    if (text.empty())
+    {
+        return true;
+    }
+
+    // The last quad may be padded, so it is decoded on its own
+    auto*             bytes = static_cast<unsigned char*>(out);
+    const std::size_t full  = text.size() - 4;
+    if (simd::kernels().base64_decode(text.data(), full, bytes) != full)
+    {
+        return false;
+    }
+
+    // Final quad: 1 to 3 bytes; padding characters only at its end
+    const std::size_t at    = full / 4 * 3;
+    const std::size_t tail  = size - at;
+    uint32_t          group = 0;
+    for (std::size_t k = 0; k < 4; ++k)
+    {
+        const char c = text[full + k];
+        if (k > tail)
+        {
+            if (c != '=')
+            {
+                return false;
+            }
+            continue;
+        }
+        const unsigned char value = decode_table[static_cast<unsigned char>(c)];
+        if (value == invalid)
+        {
+            return false;
+        }
+        group |= uint32_t{value} << (18 - 6 * k);
+    }
+    for (std::size_t k = 0; k < tail; ++k)
+    {
+        bytes[at + k] = static_cast<unsigned char>(group >> (16 - 8 * k));
+    }
+    return true;
+}
+}  // namespace serialization
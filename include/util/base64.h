@@ -0,0 +1,49 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "util/export.h"
+
+namespace serialization
+{
+/**
+ * @brief Append the standard base64 encoding (RFC 4648, with padding) of a byte block
+ * @param out String receiving the encoding
+ * @param data Bytes to encode
+ * @param size Number of bytes
+ * @note Encodes 12 bytes per step on hosts with SSSE3, and 3 otherwise.
+ */
+SERIALIZATION_API void append_base64(std::string& out, const void* data, std::size_t size);
+
+/**
+ * @brief Number of bytes encoded by a base64 string
+ * @return The decoded size, or std::string_view::npos if the length or padding is invalid
+ */
+SERIALIZATION_API std::size_t base64_decoded_size(std::string_view text) noexcept;
+
+/**
+ * @brief Decode a base64 string
+ * @param text Encoding written by append_base64()
+ * @param out Receives base64_decoded_size(text) bytes
+ * @return False if the text holds characters outside the base64 alphabet
+ * @note Decodes 16 characters per step on hosts with SSSE3, and 4 otherwise.
+ */
+SERIALIZATION_API bool decode_base64(std::string_view text, void* out) noexcept;
+}  // namespace serialization
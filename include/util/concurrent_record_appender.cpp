@@ -0,0 +1,182 @@
+#include "util/concurrent_record_appender.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <thread>
+
+#include "common/serialization_error.h"
+
+namespace serialization
+{
+namespace
+{
+// Ring frames are [u32 length + 1][u32 checksum][payload] padded to 8 bytes, so
+// a frame header never wraps around the end of the ring. The first word is zero
+// until the frame is published.
+constexpr std::size_t frame_header_size = 8;
+constexpr std::size_t min_capacity      = 64;
+
+uint64_t frame_size(std::size_t length)
+{
+    return (frame_header_size + length + 7) & ~uint64_t{7};
+}
+
+void store_le32(unsigned char* out, uint32_t value)
+{
+    for (int k = 0; k < 4; ++k)
+    {
+        out[k] = static_cast<unsigned char>(value >> (8 * k));
+    }
+}
+}  // namespace
+
+//----------------------------------------------------------------------------
+concurrent_record_appender::concurrent_record_appender(
+    record_log_writer& log, std::size_t capacity)
+    : log_(log),
+      capacity_(std::bit_ceil(std::max(capacity, min_capacity))),
+      ring_(new uint64_t[capacity_ / sizeof(uint64_t)]())
+{
+}
+
+//----------------------------------------------------------------------------
+concurrent_record_appender::~concurrent_record_appender()
+{
+    // Errors cannot be reported from here; call Flush() first to see them
+    const detail::error_scope scope;
+    Flush();
+}
+
+//----------------------------------------------------------------------------
+void concurrent_record_appender::Append(std::span<const unsigned char> record)
+{
+    const auto size = frame_size(record.size());
+    if (size > capacity_ || record.size() > record_log_reader::MaxRecordSize) [[unlikely]]
+    {
+        // Records of this thread reserved earlier must reach the log first
+        std::lock_guard<std::mutex> lock(drain_);
+        DrainUntil(tail_.load(std::memory_order_acquire));
+        log_.Append(record);
+        return;
+    }
+
+    const uint64_t position = tail_.fetch_add(size, std::memory_order_relaxed);
+    while (position + size - head_.load(std::memory_order_acquire) > capacity_)
+    {
+        std::unique_lock<std::mutex> lock(drain_, std::try_to_lock);
+        if (!lock.owns_lock() || !Drain())
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    const std::size_t mask   = capacity_ - 1;
+    const std::size_t offset = position & mask;
+    unsigned char*    bytes  = Bytes();
+
+    const uint32_t checksum = record_checksum(record);
+    std::memcpy(bytes + offset + 4, &checksum, sizeof(checksum));
+
+    const std::size_t start = (offset + frame_header_size) & mask;
+    const std::size_t first = std::min(record.size(), capacity_ - start);
+    std::memcpy(bytes + start, record.data(), first);
+    std::memcpy(bytes, record.data() + first, record.size() - first);
+
+    std::atomic_ref<uint32_t> marker(*reinterpret_cast<uint32_t*>(bytes + offset));
+    marker.store(static_cast<uint32_t>(record.size()) + 1, std::memory_order_release);
+
+    // Drain early so that writers rarely find the ring full
+    if (position + size - head_.load(std::memory_order_relaxed) > capacity_ / 2)
+    {
+        std::unique_lock<std::mutex> lock(drain_, std::try_to_lock);
+        if (lock.owns_lock())
+        {
+            Drain();
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+void concurrent_record_appender::Append(multi_process_stream& stream)
+{
+    const auto data = stream.GetRawData();
+    Append(std::span<const unsigned char>(data));
+}
+
+//----------------------------------------------------------------------------
+void concurrent_record_appender::Flush()
+{
+    std::lock_guard<std::mutex> lock(drain_);
+    DrainUntil(tail_.load(std::memory_order_acquire));
+    log_.Flush();
+}
+
+//----------------------------------------------------------------------------
+bool concurrent_record_appender::Drain()
+{
+    const std::size_t mask  = capacity_ - 1;
+    unsigned char*    bytes = Bytes();
+    uint64_t          head  = head_.load(std::memory_order_relaxed);
+    std::size_t       count = 0;
+    std::size_t       total = 0;
+
+    staging_.clear();
+    while (true)
+    {
+        const std::size_t         offset = head & mask;
+        std::atomic_ref<uint32_t> marker(*reinterpret_cast<uint32_t*>(bytes + offset));
+        const uint32_t            word = marker.load(std::memory_order_acquire);
+        if (word == 0)
+        {
+            break;
+        }
+
+        const std::size_t length = word - 1;
+        uint32_t          checksum;
+        std::memcpy(&checksum, bytes + offset + 4, sizeof(checksum));
+
+        const auto frame = staging_.size();
+        staging_.resize(frame + frame_header_size + length);
+        store_le32(staging_.data() + frame, static_cast<uint32_t>(length));
+        store_le32(staging_.data() + frame + 4, checksum);
+
+        const std::size_t start = (offset + frame_header_size) & mask;
+        const std::size_t first = std::min(length, capacity_ - start);
+        std::memcpy(staging_.data() + frame + frame_header_size, bytes + start, first);
+        std::memcpy(staging_.data() + frame + frame_header_size + first, bytes, length - first);
+
+        // Stale bytes must never look like a published frame
+        const auto size  = frame_size(length);
+        const auto clear = std::min<std::size_t>(size, capacity_ - offset);
+        std::memset(bytes + offset, 0, clear);
+        std::memset(bytes, 0, size - clear);
+
+        head += size;
+        total += length;
+        ++count;
+    }
+
+    if (count == 0)
+    {
+        return false;
+    }
+
+    // Writers may reuse the space while the frames are written to the log
+    head_.store(head, std::memory_order_release);
+    log_.AppendFrames(staging_, count, total);
+    return true;
+}
+
+//----------------------------------------------------------------------------
+void concurrent_record_appender::DrainUntil(uint64_t position)
+{
+    while (head_.load(std::memory_order_relaxed) < position)
+    {
+        if (!Drain())
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+}  // namespace serialization
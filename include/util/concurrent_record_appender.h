@@ -0,0 +1,107 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file concurrent_record_appender.h
+ * @brief Many threads appending records to one record log
+ *
+ * Writers share a ring of frames. A writer claims space for its frame with a
+ * single atomic fetch-add on the ring tail, copies its record and checksum in
+ * without holding a lock, and publishes the frame by storing its length word
+ * last. Whichever thread finds the ring filling up drains the published prefix
+ * into the record_log_writer in reservation order; a frame that is still being
+ * copied stops the drain until its writer publishes it.
+ *
+ * The log receives ordinary frames, so the result is read back with
+ * record_log_reader. Records of one thread keep their order; records of
+ * different threads interleave in the order they reserved space.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "util/export.h"
+#include "util/multi_process_stream.h"
+#include "util/record_log.h"
+
+namespace serialization
+{
+/**
+ * @brief Thread-safe front end of a record_log_writer
+ *
+ * The log must outlive the appender and must not be used directly while the
+ * appender exists.
+ */
+class SERIALIZATION_API concurrent_record_appender
+{
+public:
+    /**
+     * @param log The log receiving the records
+     * @param capacity Size of the ring in bytes, rounded up to a power of two;
+     * records that do not fit in the ring are appended under the drain lock
+     */
+    explicit concurrent_record_appender(
+        record_log_writer& log, std::size_t capacity = std::size_t{1} << 22);
+    ~concurrent_record_appender();
+
+    concurrent_record_appender(const concurrent_record_appender&)            = delete;
+    concurrent_record_appender& operator=(const concurrent_record_appender&) = delete;
+
+    //@{
+    /**
+     * Appends one record. Safe to call from any number of threads.
+     */
+    void Append(std::span<const unsigned char> record);
+    void Append(multi_process_stream& stream);
+    //@}
+
+    /**
+     * Hands every record appended before the call to the log and flushes it.
+     * The destructor flushes too but drops errors of the log, so call Flush()
+     * first to see them.
+     */
+    void Flush();
+
+    /**
+     * Returns the ring size in bytes.
+     */
+    std::size_t Capacity() const { return capacity_; }
+
+private:
+    // Both require drain_ to be held
+    bool Drain();
+    void DrainUntil(uint64_t position);
+
+    unsigned char* Bytes() { return reinterpret_cast<unsigned char*>(ring_.get()); }
+
+    record_log_writer&          log_;
+    std::size_t                 capacity_;
+    std::unique_ptr<uint64_t[]> ring_;
+    std::mutex                  drain_;
+    std::vector<unsigned char>  staging_;
+
+    // Reserved and drained byte positions; they only grow and are reduced
+    // modulo the capacity to address the ring
+    alignas(64) std::atomic<uint64_t> tail_{0};
+    alignas(64) std::atomic<uint64_t> head_{0};
+};
+}  // namespace serialization
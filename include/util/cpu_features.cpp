@@ -0,0 +1,235 @@
+#include "util/cpu_features.h"
+
+#include <atomic>
+#include <cstdlib>
+
+#include "util/simd_kernels.h"
+
+#if defined(SERIALIZATION_ARCH_X86) && defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(SERIALIZATION_ARCH_ARM64) && defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+namespace serialization
+{
+namespace
+{
+cpu_features detect() noexcept
+{
+    cpu_features features;
+#if defined(SERIALIZATION_ARCH_X86) && defined(_MSC_VER)
+    int info[4] = {};
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    features.ssse3 = (info[2] & (1 << 9)) != 0;
+    features.sse42 = (info[2] & (1 << 20)) != 0;
+    // AVX state must also be enabled by the operating system
+    const bool os_avx    = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    const bool os_avx512 = os_avx && (_xgetbv(0) & 0xe0) == 0xe0;
+    if (max_leaf >= 7)
+    {
+        __cpuidex(info, 7, 0);
+        features.avx2     = os_avx && (info[1] & (1 << 5)) != 0;
+        // AVX-512F and AVX-512BW
+        features.avx512bw =
+            os_avx512 && (info[1] & (1 << 16)) != 0 && (info[1] & (1 << 30)) != 0;
+    }
+#elif defined(SERIALIZATION_ARCH_X86)
+    // Also checks that the operating system saves the wider registers
+    __builtin_cpu_init();
+    features.ssse3    = __builtin_cpu_supports("ssse3") != 0;
+    features.sse42    = __builtin_cpu_supports("sse4.2") != 0;
+    features.avx2     = __builtin_cpu_supports("avx2") != 0;
+    features.avx512bw = __builtin_cpu_supports("avx512f") != 0 &&
+                        __builtin_cpu_supports("avx512bw") != 0;
+#elif defined(SERIALIZATION_ARCH_ARM64) && defined(__linux__)
+    features.neon = (getauxval(AT_HWCAP) & HWCAP_ASIMD) != 0;
+#elif defined(SERIALIZATION_ARCH_ARM64)
+    // Advanced SIMD is part of every AArch64 core
+    features.neon = true;
+#endif
+    return features;
+}
+
+constexpr simd::kernel_table scalar_kernels = {
+    simd_level::scalar,
+    simd::crc32c_scalar,
+    simd::base64_encode_scalar,
+    simd::base64_decode_scalar,
+    simd::json_escape_position_scalar,
+    simd::ascii_prefix_scalar};
+
+#if defined(SERIALIZATION_ARCH_X86)
+constexpr simd::kernel_table sse42_kernels = {
+    simd_level::sse42,
+    simd::crc32c_sse42,
+    simd::base64_encode_ssse3,
+    simd::base64_decode_ssse3,
+    simd::json_escape_position_sse2,
+    simd::ascii_prefix_sse2};
+
+constexpr simd::kernel_table avx2_kernels = {
+    simd_level::avx2,
+    simd::crc32c_sse42,
+    simd::base64_encode_ssse3,
+    simd::base64_decode_ssse3,
+    simd::json_escape_position_avx2,
+    simd::ascii_prefix_avx2};
+
+constexpr simd::kernel_table avx512_kernels = {
+    simd_level::avx512,
+    simd::crc32c_sse42,
+    simd::base64_encode_ssse3,
+    simd::base64_decode_ssse3,
+    simd::json_escape_position_avx512,
+    simd::ascii_prefix_avx512};
+#elif defined(SERIALIZATION_ARCH_ARM64)
+constexpr simd::kernel_table neon_kernels = {
+    simd_level::neon,
+    simd::crc32c_scalar,
+    simd::base64_encode_scalar,
+    simd::base64_decode_scalar,
+    simd::json_escape_position_neon,
+    simd::ascii_prefix_neon};
+#endif
+
+const simd::kernel_table* table_of(simd_level level) noexcept
+{
+    switch (level)
+    {
+#if defined(SERIALIZATION_ARCH_X86)
+    case simd_level::sse42:
+        return &sse42_kernels;
+    case simd_level::avx2:
+        return &avx2_kernels;
+    case simd_level::avx512:
+        return &avx512_kernels;
+#elif defined(SERIALIZATION_ARCH_ARM64)
+    case simd_level::neon:
+        return &neon_kernels;
+#endif
+    default:
+        return &scalar_kernels;
+    }
+}
+
+/// The level named by SERIALIZATION_SIMD_LEVEL if the host supports it, else the best one
+simd_level startup_level() noexcept
+{
+    if (const char* name = std::getenv("SERIALIZATION_SIMD_LEVEL"); name != nullptr)
+    {
+        for (const auto level :
+             {simd_level::scalar,
+              simd_level::sse42,
+              simd_level::avx2,
+              simd_level::avx512,
+              simd_level::neon})
+        {
+            if (simd_level_name(level) == name && simd_level_supported(level))
+            {
+                return level;
+            }
+        }
+    }
+    return best_simd_level();
+}
+
+std::atomic<const simd::kernel_table*> active_kernels{nullptr};
+}  // namespace
+
+//-----------------------------------------------------------------------------
+const simd::kernel_table& simd::kernels() noexcept
+{
+    const auto* table = active_kernels.load(std::memory_order_acquire);
+    if (table == nullptr) [[unlikely]]
+    {
+        // Every thread that races here selects the same table
+        table = table_of(startup_level());
+        active_kernels.store(table, std::memory_order_release);
+    }
+    return *table;
+}
+
+//-----------------------------------------------------------------------------
+const cpu_features& detected_cpu_features() noexcept
+{
+    static const cpu_features features = detect();
+    return features;
+}
+
+//-----------------------------------------------------------------------------
+bool simd_level_supported(simd_level level) noexcept
+{
+    [[maybe_unused]] const auto& features = detected_cpu_features();
+    switch (level)
+    {
+    case simd_level::scalar:
+        return true;
+#if defined(SERIALIZATION_ARCH_X86)
+    case simd_level::sse42:
+        return features.sse42 && features.ssse3;
+    case simd_level::avx2:
+        return features.sse42 && features.ssse3 && features.avx2;
+    case simd_level::avx512:
+        return features.sse42 && features.ssse3 && features.avx2 && features.avx512bw;
+#elif defined(SERIALIZATION_ARCH_ARM64)
+    case simd_level::neon:
+        return features.neon;
+#endif
+    default:
+        return false;
+    }
+}
+
+//-----------------------------------------------------------------------------
+simd_level best_simd_level() noexcept
+{
+    for (const auto level :
+         {simd_level::avx512, simd_level::avx2, simd_level::sse42, simd_level::neon})
+    {
+        if (simd_level_supported(level))
+        {
+            return level;
+        }
+    }
+    return simd_level::scalar;
+}
+
+//-----------------------------------------------------------------------------
+simd_level active_simd_level() noexcept
+{
+    return simd::kernels().level;
+}
+
+//-----------------------------------------------------------------------------
+bool set_simd_level(simd_level level) noexcept
+{
+    if (!simd_level_supported(level))
+    {
+        return false;
+    }
+    active_kernels.store(table_of(level), std::memory_order_release);
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+std::string_view simd_level_name(simd_level level) noexcept
+{
+    switch (level)
+    {
+    case simd_level::sse42:
+        return "sse42";
+    case simd_level::avx2:
+        return "avx2";
+    case simd_level::avx512:
+        return "avx512";
+    case simd_level::neon:
+        return "neon";
+    default:
+        return "scalar";
+    }
+}
+}  // namespace serialization
@@ -0,0 +1,74 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+#include <string_view>
+
+#include "util/export.h"
+
+namespace serialization
+{
+/**
+ * @brief Instruction sets of the vectorized kernels (checksums, base64, JSON text)
+ *
+ * The library is built for the baseline of its target, and the faster kernels are
+ * compiled alongside for specific instruction sets. One level is selected when a
+ * kernel is first used: the best the host supports, or the one named by the
+ * SERIALIZATION_SIMD_LEVEL environment variable ("scalar", "sse42", "avx2",
+ * "avx512" or "neon") if the host supports it.
+ */
+enum class simd_level
+{
+    scalar,  ///< Portable C++
+    sse42,   ///< x86 with SSE4.2 and SSSE3
+    avx2,    ///< x86 with AVX2 as well
+    avx512,  ///< x86 with AVX-512BW as well
+    neon     ///< AArch64 Advanced SIMD
+};
+
+/**
+ * @brief Instruction set extensions reported by the host
+ */
+struct cpu_features
+{
+    bool sse42    = false;
+    bool ssse3    = false;
+    bool avx2     = false;
+    bool avx512bw = false;
+    bool neon     = false;
+};
+
+/// @brief Extensions of the host, detected once with cpuid or getauxval
+SERIALIZATION_API const cpu_features& detected_cpu_features() noexcept;
+
+/// @brief True if the host and the build support the kernels of a level
+SERIALIZATION_API bool simd_level_supported(simd_level level) noexcept;
+
+/// @brief Fastest level supported by the host
+SERIALIZATION_API simd_level best_simd_level() noexcept;
+
+/// @brief Level of the kernels in use
+SERIALIZATION_API simd_level active_simd_level() noexcept;
+
+/**
+ * @brief Switch every kernel to another level, for tests and benchmarks
+ * @return False, leaving the kernels unchanged, if the level is not supported
+ */
+SERIALIZATION_API bool set_simd_level(simd_level level) noexcept;
+
+/// @brief Name of a level, as accepted by SERIALIZATION_SIMD_LEVEL
+SERIALIZATION_API std::string_view simd_level_name(simd_level level) noexcept;
+}  // namespace serialization
@@ -0,0 +1,99 @@
+#include "util/crc32c.h"
+
+#include <array>
+#include <cstring>
+
+#include "util/simd_kernels.h"
+
+#if defined(SERIALIZATION_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+namespace serialization
+{
+namespace
+{
+constexpr uint32_t castagnoli = 0x82f63b78u;
+
+using crc_tables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr crc_tables make_tables()
+{
+    crc_tables tables{};
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; ++bit)
+        {
+            crc = (crc >> 1) ^ ((crc & 1) != 0 ? castagnoli : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; ++i)
+    {
+        for (size_t t = 1; t < 8; ++t)
+        {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xff];
+        }
+    }
+    return tables;
+}
+
+constexpr crc_tables tables = make_tables();
+}  // namespace
+
+//-----------------------------------------------------------------------------
+uint32_t simd::crc32c_scalar(const unsigned char* bytes, std::size_t size, uint32_t crc) noexcept
+{
+    // Slicing-by-8: eight table lookups per 8 input bytes
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+        const uint32_t low = crc ^ (uint32_t{bytes[0]} | uint32_t{bytes[1]} << 8 |
+                                    uint32_t{bytes[2]} << 16 | uint32_t{bytes[3]} << 24);
+        crc = tables[7][low & 0xff] ^ tables[6][(low >> 8) & 0xff] ^
+              tables[5][(low >> 16) & 0xff] ^ tables[4][low >> 24] ^ tables[3][bytes[4]] ^
+              tables[2][bytes[5]] ^ tables[1][bytes[6]] ^ tables[0][bytes[7]];
+    }
+    for (; size > 0; --size, ++bytes)
+    {
+        crc = (crc >> 8) ^ tables[0][(crc ^ *bytes) & 0xff];
+    }
+    return crc;
+}
+
+#if defined(SERIALIZATION_ARCH_X86)
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("sse4.2")
+uint32_t simd::crc32c_sse42(const unsigned char* bytes, std::size_t size, uint32_t crc) noexcept
+{
+#if defined(__x86_64__) || defined(_M_X64)
+    uint64_t wide = crc;
+    for (; size >= 8; size -= 8, bytes += 8)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, bytes, 8);
+        wide = _mm_crc32_u64(wide, word);
+    }
+    crc = static_cast<uint32_t>(wide);
+#else
+    for (; size >= 4; size -= 4, bytes += 4)
+    {
+        uint32_t word = 0;
+        std::memcpy(&word, bytes, 4);
+        crc = _mm_crc32_u32(crc, word);
+    }
+#endif
+    for (; size > 0; --size, ++bytes)
+    {
+        crc = _mm_crc32_u8(crc, *bytes);
+    }
+    return crc;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+uint32_t crc32c(const void* data, std::size_t size, uint32_t crc) noexcept
+{
+    return ~simd::kernels().crc32c(static_cast<const unsigned char*>(data), size, ~crc);
+}
+}  // namespace serialization
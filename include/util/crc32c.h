@@ -0,0 +1,35 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "util/export.h"
+
+namespace serialization
+{
+/**
+ * @brief CRC-32C (Castagnoli) checksum
+ * @param data Bytes to checksum
+ * @param size Number of bytes
+ * @param crc Checksum of the preceding bytes, to extend a running checksum
+ * @return Checksum of the preceding bytes followed by data
+ * @note Uses the SSE4.2 crc32 instruction when the host has it, and a
+ *       slicing-by-8 table otherwise (see cpu_features.h).
+ */
+SERIALIZATION_API uint32_t crc32c(const void* data, std::size_t size, uint32_t crc = 0) noexcept;
+}  // namespace serialization
@@ -0,0 +1,150 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file expected.h
+ * @brief serialization::expected, std::expected when the standard library has it
+ *
+ * The fallback implements the subset of std::expected used by the library
+ * (construction, has_value, value, error, operator*, operator->) so that the
+ * try_* API has the same spelling in C++20 and C++23 builds.
+ */
+
+#include <version>
+
+#if defined(__cpp_lib_expected) && __cpp_lib_expected >= 202202L
+#include <expected>
+
+namespace serialization
+{
+template <typename T, typename E>
+using expected = std::expected<T, E>;
+
+template <typename E>
+using unexpected = std::unexpected<E>;
+}  // namespace serialization
+
+#else
+#include <cstdlib>
+#include <type_traits>
+#include <utility>
+#include <variant>
+
+namespace serialization
+{
+template <typename E>
+class unexpected
+{
+public:
+    constexpr explicit unexpected(E error) : error_(std::move(error)) {}
+
+    constexpr const E& error() const& noexcept { return error_; }
+    constexpr E&       error() & noexcept { return error_; }
+    constexpr E&&      error() && noexcept { return std::move(error_); }
+
+private:
+    E error_;
+};
+
+template <typename E>
+unexpected(E) -> unexpected<E>;
+
+template <typename T, typename E>
+class expected
+{
+public:
+    using value_type = T;
+    using error_type = E;
+
+    constexpr expected()
+        requires std::is_default_constructible_v<T>
+        : storage_(std::in_place_index<0>)
+    {
+    }
+
+    constexpr expected(T value) : storage_(std::in_place_index<0>, std::move(value)) {}
+
+    template <typename G>
+    constexpr expected(unexpected<G> error)
+        : storage_(std::in_place_index<1>, std::move(error).error())
+    {
+    }
+
+    [[nodiscard]] constexpr bool has_value() const noexcept { return storage_.index() == 0; }
+    constexpr explicit           operator bool() const noexcept { return has_value(); }
+
+    constexpr T&       value() & { return *get_if_value(); }
+    constexpr const T& value() const& { return *get_if_value(); }
+    constexpr T&&      value() && { return std::move(*get_if_value()); }
+
+    constexpr T&       operator*() & noexcept { return *std::get_if<0>(&storage_); }
+    constexpr const T& operator*() const& noexcept { return *std::get_if<0>(&storage_); }
+    constexpr T*       operator->() noexcept { return std::get_if<0>(&storage_); }
+    constexpr const T* operator->() const noexcept { return std::get_if<0>(&storage_); }
+
+    constexpr const E& error() const& noexcept { return *std::get_if<1>(&storage_); }
+    constexpr E&       error() & noexcept { return *std::get_if<1>(&storage_); }
+
+private:
+    // Accessing the value of an error result is a precondition violation.
+    constexpr T* get_if_value()
+    {
+        if (!has_value()) [[unlikely]]
+        {
+            std::abort();
+        }
+        return std::get_if<0>(&storage_);
+    }
+
+    constexpr const T* get_if_value() const
+    {
+        if (!has_value()) [[unlikely]]
+        {
+            std::abort();
+        }
+        return std::get_if<0>(&storage_);
+    }
+
+    std::variant<T, E> storage_;
+};
+
+template <typename E>
+class expected<void, E>
+{
+public:
+    using value_type = void;
+    using error_type = E;
+
+    constexpr expected() noexcept = default;
+
+    template <typename G>
+    constexpr expected(unexpected<G> error) : error_(std::move(error).error()), failed_(true)
+    {
+    }
+
+    [[nodiscard]] constexpr bool has_value() const noexcept { return !failed_; }
+    constexpr explicit           operator bool() const noexcept { return has_value(); }
+
+    constexpr const E& error() const& noexcept { return error_; }
+    constexpr E&       error() & noexcept { return error_; }
+
+private:
+    E    error_{};
+    bool failed_ = false;
+};
+}  // namespace serialization
+#endif
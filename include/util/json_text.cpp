@@ -0,0 +1,894 @@
+#include "util/json_text.h"
+
+#include <array>
+#include <bit>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "common/serialization_error.h"
+#include "util/simd_kernels.h"
+
+#if defined(SERIALIZATION_ARCH_X86)
+#include <immintrin.h>
+#elif defined(SERIALIZATION_ARCH_ARM64)
+#include <arm_neon.h>
+#endif
+
+namespace serialization
+{
+namespace
+{
+constexpr std::array<bool, 256> make_escape_table()
+{
+    std::array<bool, 256> table{};
+    for (int c = 0; c < 0x20; ++c)
+    {
+        table[c] = true;
+    }
+    table['"']  = true;
+    table['\\'] = true;
+    return table;
+}
+
+constexpr std::array<bool, 256> escape_table = make_escape_table();
+
+bool needs_escape(char c)
+{
+    return escape_table[static_cast<unsigned char>(c)];
+}
+
+/// Length of the well-formed UTF-8 sequence at text[i], or 0
+std::size_t utf8_sequence(std::string_view text, std::size_t i)
+{
+    const auto byte = [&](std::size_t k) { return static_cast<unsigned char>(text[i + k]); };
+    const auto tail = [&](std::size_t k) { return (byte(k) & 0xc0) == 0x80; };
+
+    const unsigned char lead = byte(0);
+    const std::size_t   left = text.size() - i;
+    if (lead < 0x80)
+    {
+        return 1;
+    }
+    if (lead >= 0xc2 && lead <= 0xdf)
+    {
+        return left >= 2 && tail(1) ? 2 : 0;
+    }
+    if (lead >= 0xe0 && lead <= 0xef)
+    {
+        if (left < 3 || !tail(1) || !tail(2))
+        {
+            return 0;
+        }
+        // Overlong forms below U+0800 and UTF-16 surrogates
+        if ((lead == 0xe0 && byte(1) < 0xa0) || (lead == 0xed && byte(1) > 0x9f))
+        {
+            return 0;
+        }
+        return 3;
+    }
+    if (lead >= 0xf0 && lead <= 0xf4)
+    {
+        if (left < 4 || !tail(1) || !tail(2) || !tail(3))
+        {
+            return 0;
+        }
+        // Overlong forms below U+10000 and code points above U+10FFFF
+        if ((lead == 0xf0 && byte(1) < 0x90) || (lead == 0xf4 && byte(1) > 0x8f))
+        {
+            return 0;
+        }
+        return 4;
+    }
+    return 0;
+}
+}  // namespace
+
+//-----------------------------------------------------------------------------
+std::size_t simd::json_escape_position_scalar(const char* data, std::size_t size) noexcept
+{
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        if (needs_escape(data[i]))
+        {
+            return i;
+        }
+    }
+    return size;
+}
+
+//-----------------------------------------------------------------------------
+std::size_t simd::ascii_prefix_scalar(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8)
+    {
+        uint64_t word = 0;
+        std::memcpy(&word, data + i, 8);
+        if ((word & 0x8080808080808080ull) != 0)
+        {
+            break;
+        }
+    }
+    for (; i < size && static_cast<unsigned char>(data[i]) < 0x80; ++i)
+    {
+    }
+    return i;
+}
+
+#if defined(SERIALIZATION_ARCH_X86)
+// Each variant scans whole vectors and leaves the tail to the next narrower one
+
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("sse2")
+std::size_t simd::json_escape_position_sse2(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        // Unsigned c <= 0x1f exactly when min(c, 0x1f) == c
+        const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(chunk, _mm_set1_epi8(0x1f)), chunk);
+        const __m128i special = _mm_or_si128(
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('"')),
+            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\')));
+        if (const auto mask = static_cast<uint32_t>(
+                _mm_movemask_epi8(_mm_or_si128(control, special)));
+            mask != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + json_escape_position_scalar(data + i, size - i);
+}
+
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("avx2")
+std::size_t simd::json_escape_position_avx2(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        const __m256i control =
+            _mm256_cmpeq_epi8(_mm256_min_epu8(chunk, _mm256_set1_epi8(0x1f)), chunk);
+        const __m256i special = _mm256_or_si256(
+            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('"')),
+            _mm256_cmpeq_epi8(chunk, _mm256_set1_epi8('\\')));
+        if (const auto mask = static_cast<uint32_t>(
+                _mm256_movemask_epi8(_mm256_or_si256(control, special)));
+            mask != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + json_escape_position_sse2(data + i, size - i);
+}
+
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("avx512f,avx512bw")
+std::size_t simd::json_escape_position_avx512(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        const __m512i   chunk = _mm512_loadu_si512(data + i);
+        const __mmask64 mask  = _mm512_cmple_epu8_mask(chunk, _mm512_set1_epi8(0x1f)) |
+                               _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('"')) |
+                               _mm512_cmpeq_epi8_mask(chunk, _mm512_set1_epi8('\\'));
+        if (mask != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + json_escape_position_avx2(data + i, size - i);
+}
+
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("sse2")
+std::size_t simd::ascii_prefix_sse2(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+        if (const auto mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk)); mask != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + ascii_prefix_scalar(data + i, size - i);
+}
+
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("avx2")
+std::size_t simd::ascii_prefix_avx2(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 32 <= size; i += 32)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+        if (const auto mask = static_cast<uint32_t>(_mm256_movemask_epi8(chunk)); mask != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + ascii_prefix_sse2(data + i, size - i);
+}
+
+//-----------------------------------------------------------------------------
+SERIALIZATION_TARGET("avx512f,avx512bw")
+std::size_t simd::ascii_prefix_avx512(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 64 <= size; i += 64)
+    {
+        if (const __mmask64 mask = _mm512_movepi8_mask(_mm512_loadu_si512(data + i)); mask != 0)
+        {
+            return i + static_cast<std::size_t>(std::countr_zero(mask));
+        }
+    }
+    return i + ascii_prefix_avx2(data + i, size - i);
+}
+#elif defined(SERIALIZATION_ARCH_ARM64)
+//-----------------------------------------------------------------------------
+std::size_t simd::json_escape_position_neon(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        const uint8x16_t chunk   = vld1q_u8(reinterpret_cast<const uint8_t*>(data + i));
+        const uint8x16_t matches = vorrq_u8(
+            vcleq_u8(chunk, vdupq_n_u8(0x1f)),
+            vorrq_u8(vceqq_u8(chunk, vdupq_n_u8('"')), vceqq_u8(chunk, vdupq_n_u8('\\'))));
+        if (vmaxvq_u8(matches) != 0)
+        {
+            // NEON has no movemask; the rare hit is located byte by byte
+            break;
+        }
+    }
+    return i + json_escape_position_scalar(data + i, size - i);
+}
+
+//-----------------------------------------------------------------------------
+std::size_t simd::ascii_prefix_neon(const char* data, std::size_t size) noexcept
+{
+    std::size_t i = 0;
+    for (; i + 16 <= size; i += 16)
+    {
+        if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(data + i))) >= 0x80)
+        {
+            break;
+        }
+    }
+    return i + ascii_prefix_scalar(data + i, size - i);
+}
+#endif
+
+//-----------------------------------------------------------------------------
+std::size_t json_escape_position(const char* data, std::size_t size) noexcept
+{
+    return simd::kernels().json_escape_position(data, size);
+}
+
+//-----------------------------------------------------------------------------
+void append_json_escaped(std::string& out, std::string_view text)
+{
+    static constexpr char hex[] = "0123456789abcdef";
+
+    const auto scan = simd::kernels().json_escape_position;
+    while (!text.empty())
+    {
+        const std::size_t run = scan(text.data(), text.size());
+        out.append(text.data(), run);
+        if (run == text.size())
+        {
+            return;
+        }
+
+        const auto c = static_cast<unsigned char>(text[run]);
+        text.remove_prefix(run + 1);
+        switch (c)
+        {
+        case '"':
+            out += "\\\"";
+            break;
+        case '\\':
+            out += "\\\\";
+            break;
+        case '\b':
+            out += "\\b";
+            break;
+        case '\f':
+            out += "\\f";
+            break;
+        case '\n':
+            out += "\\n";
+            break;
+        case '\r':
+            out += "\\r";
+            break;
+        case '\t':
+            out += "\\t";
+            break;
+        default:
+            out += "\\u00";
+            out += hex[c >> 4];
+            out += hex[c & 0xf];
+            break;
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+bool is_valid_utf8(std::string_view text) noexcept
+{
+    const auto  ascii = simd::kernels().ascii_prefix;
+    std::size_t i     = 0;
+    while (i < text.size())
+    {
+        i += ascii(text.data() + i, text.size() - i);
+        if (i == text.size())
+        {
+            break;
+        }
+        const std::size_t length = utf8_sequence(text, i);
+        if (length == 0)
+        {
+            return false;
+        }
+        i += length;
+    }
+    return true;
+}
+namespace
+{
+bool is_json_space(char c)
+{
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+// Containers are written from an explicit stack of the members left to write
+class json_dumper
+{
+public:
+    json_dumper(std::string& out, int indent)
+        : out_(out),
+          scalars_(nlohmann::detail::output_adapter<char>(out), ' '),
+          indent_(indent)
+    {
+    }
+
+    void Dump(const json& value)
+    {
+        if (!Value(value))
+        {
+            return;
+        }
+        while (!stack_.empty())
+        {
+            auto&             frame = stack_.back();
+            const bool        is_object = frame.container->is_object();
+            const std::size_t size      = frame.container->size();
+            if (frame.index == size)
+            {
+                stack_.pop_back();
+                NewLine();
+                out_ += is_object ? '}' : ']';
+                continue;
+            }
+
+            if (frame.index > 0)
+            {
+                out_ += ',';
+            }
+            const std::size_t index = frame.index++;
+            NewLine();
+
+            const json* child = nullptr;
+            if (is_object)
+            {
+                const auto& members = frame.container->get_ref<const json::object_t&>();
+                const auto& member  = *(members.begin() + static_cast<std::ptrdiff_t>(index));
+                if (!String(member.first))
+                {
+                    return;
+                }
+                out_ += indent_ >= 0 ? ": " : ":";
+                child = &member.second;
+            }
+            else
+            {
+                child = &frame.container->get_ref<const json::array_t&>()[index];
+            }
+            if (!Value(*child))
+            {
+                return;
+            }
+        }
+    }
+
+private:
+    struct frame
+    {
+        const json* container;
+        std::size_t index;
+    };
+
+    // Writes a scalar or opens a container; false on an error
+    bool Value(const json& value)
+    {
+        switch (value.type())
+        {
+        case json::value_t::object:
+        case json::value_t::array:
+            if (value.empty())
+            {
+                out_ += value.is_object() ? "{}" : "[]";
+            }
+            else
+            {
+                out_ += value.is_object() ? '{' : '[';
+                stack_.push_back({&value, 0});
+            }
+            return true;
+        case json::value_t::string:
+            return String(value.get_ref<const json::string_t&>());
+        default:
+            scalars_.dump(value, false, false, 0);
+            return true;
+        }
+    }
+
+    bool String(std::string_view text)
+    {
+        if (!is_valid_utf8(text)) [[unlikely]]
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "JSON string is not valid UTF-8 at byte {} of the output",
+                out_.size());
+            return false;
+        }
+        out_ += '"';
+        append_json_escaped(out_, text);
+        out_ += '"';
+        return true;
+    }
+
+    // Line break before a member or a closing bracket, as dump(indent) writes
+    void NewLine()
+    {
+        if (indent_ >= 0)
+        {
+            out_ += '\n';
+            out_.append(stack_.size() * static_cast<std::size_t>(indent_), ' ');
+        }
+    }
+
+    std::string&                       out_;
+    nlohmann::detail::serializer<json> scalars_;
+    int                                indent_;
+    std::vector<frame>                 stack_;
+};
+
+// Containers being filled are kept on an explicit stack
+class json_parser
+{
+public:
+    explicit json_parser(std::string_view text) : text_(text)
+    {
+        if (text_.starts_with("\xef\xbb\xbf"))
+        {
+            pos_ = 3;
+        }
+    }
+
+    void Parse(json& root)
+    {
+        json* slot = &root;
+        do
+        {
+            if (!Value(*slot))
+            {
+                return;
+            }
+        } while (NextSlot(slot));
+
+        if (!failed_ && (Peek(), pos_ != text_.size()))
+        {
+            Fail("the end of the document");
+        }
+    }
+
+private:
+    struct frame
+    {
+        json* container;
+        bool  first;
+    };
+
+    // Steps to the next member or element to fill; false once the document is complete
+    bool NextSlot(json*& slot)
+    {
+        while (!failed_ && !stack_.empty())
+        {
+            auto&      frame     = stack_.back();
+            const bool is_object = frame.container->is_object();
+            if (Peek() == (is_object ? '}' : ']'))
+            {
+                ++pos_;
+                stack_.pop_back();
+                continue;
+            }
+            if (!frame.first && !Expect(','))
+            {
+                return false;
+            }
+            frame.first = false;
+
+            if (is_object)
+            {
+                if (Peek() != '"')
+                {
+                    Fail("a member name");
+                    return false;
+                }
+                if (!String(key_) || !Expect(':'))
+                {
+                    return false;
+                }
+                slot = &(*frame.container)[key_];
+            }
+            else
+            {
+                slot = &frame.container->emplace_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Parses a scalar or opens a container; false on an error
+    bool Value(json& value)
+    {
+        switch (Peek())
+        {
+        case '{':
+            ++pos_;
+            value = json::object();
+            stack_.push_back({&value, true});
+            return true;
+        case '[':
+            ++pos_;
+            value = json::array();
+            stack_.push_back({&value, true});
+            return true;
+        case '"':
+        {
+            std::string text;
+            if (!String(text))
+            {
+                return false;
+            }
+            value = std::move(text);
+            return true;
+        }
+        case 't':
+            return Literal("true", value, true);
+        case 'f':
+            return Literal("false", value, false);
+        case 'n':
+            return Literal("null", value, nullptr);
+        default:
+            return Number(value);
+        }
+    }
+
+    /// Next non-blank character, or 0 at the end of the text
+    char Peek()
+    {
+        while (pos_ < text_.size() && is_json_space(text_[pos_]))
+        {
+            ++pos_;
+        }
+        return pos_ < text_.size() ? text_[pos_] : 0;
+    }
+
+    bool Expect(char c)
+    {
+        if (Peek() != c)
+        {
+            Fail(std::format("'{}'", c));
+            return false;
+        }
+        ++pos_;
+        return true;
+    }
+
+    template <typename T>
+    bool Literal(std::string_view word, json& value, T literal)
+    {
+        if (!text_.substr(pos_).starts_with(word))
+        {
+            Fail(std::format("'{}'", word));
+            return false;
+        }
+        pos_ += word.size();
+        value = literal;
+        return true;
+    }
+
+    bool String(std::string& text)
+    {
+        text.clear();
+        ++pos_;
+        while (true)
+        {
+            // The run up to the next quote, backslash or control character is copied at once
+            const std::size_t run =
+                json_escape_position(text_.data() + pos_, text_.size() - pos_);
+            text.append(text_.data() + pos_, run);
+            pos_ += run;
+            if (pos_ == text_.size())
+            {
+                Fail("the end of the string");
+                return false;
+            }
+
+            const char c = text_[pos_++];
+            if (c == '"')
+            {
+                if (!is_valid_utf8(text))
+                {
+                    Fail("a UTF-8 string");
+                    return false;
+                }
+                return true;
+            }
+            if (c != '\\')
+            {
+                Fail("an escaped control character");
+                return false;
+            }
+            if (!Escape(text))
+            {
+                return false;
+            }
+        }
+    }
+
+    bool Escape(std::string& text)
+    {
+        const char c = pos_ < text_.size() ? text_[pos_++] : 0;
+        switch (c)
+        {
+        case '"':
+        case '\\':
+        case '/':
+            text += c;
+            return true;
+        case 'b':
+            text += '\b';
+            return true;
+        case 'f':
+            text += '\f';
+            return true;
+        case 'n':
+            text += '\n';
+            return true;
+        case 'r':
+            text += '\r';
+            return true;
+        case 't':
+            text += '\t';
+            return true;
+        case 'u':
+            return CodePoint(text);
+        default:
+            Fail("an escape sequence");
+            return false;
+        }
+    }
+
+    bool CodePoint(std::string& text)
+    {
+        uint32_t code = 0;
+        if (!HexQuad(code))
+        {
+            return false;
+        }
+        if (code >= 0xdc00 && code <= 0xdfff)
+        {
+            Fail("a high surrogate before the low one");
+            return false;
+        }
+        if (code >= 0xd800 && code <= 0xdbff)
+        {
+            uint32_t low = 0;
+            if (!text_.substr(pos_).starts_with("\\u"))
+            {
+                Fail("a low surrogate");
+                return false;
+            }
+            pos_ += 2;
+            if (!HexQuad(low))
+            {
+                return false;
+            }
+            if (low < 0xdc00 || low > 0xdfff)
+            {
+                Fail("a low surrogate");
+                return false;
+            }
+            code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+        }
+
+        if (code < 0x80)
+        {
+            text += static_cast<char>(code);
+        }
+        else if (code < 0x800)
+        {
+            text += static_cast<char>(0xc0 | code >> 6);
+            text += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else if (code < 0x10000)
+        {
+            text += static_cast<char>(0xe0 | code >> 12);
+            text += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+            text += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        else
+        {
+            text += static_cast<char>(0xf0 | code >> 18);
+            text += static_cast<char>(0x80 | (code >> 12 & 0x3f));
+            text += static_cast<char>(0x80 | (code >> 6 & 0x3f));
+            text += static_cast<char>(0x80 | (code & 0x3f));
+        }
+        return true;
+    }
+
+    bool HexQuad(uint32_t& value)
+    {
+        const auto digits = text_.substr(pos_, 4);
+        const auto result =
+            std::from_chars(digits.data(), digits.data() + digits.size(), value, 16);
+        if (digits.size() < 4 || result.ptr != digits.data() + 4)
+        {
+            Fail("four hex digits");
+            return false;
+        }
+        pos_ += 4;
+        return true;
+    }
+
+    // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?, typed as nlohmann::json does
+    bool Number(json& value)
+    {
+        const std::size_t start  = pos_;
+        const auto        digits = [&]
+        {
+            const std::size_t first = pos_;
+            while (pos_ < text_.size() && text_[pos_] >= '0' && text_[pos_] <= '9')
+            {
+                ++pos_;
+            }
+            return pos_ - first;
+        };
+        const auto next_is = [&](char c) { return pos_ < text_.size() && text_[pos_] == c; };
+
+        const bool negative = next_is('-');
+        pos_ += negative ? 1 : 0;
+        const std::size_t integral = pos_;
+        if (digits() == 0 || (text_[integral] == '0' && pos_ - integral > 1))
+        {
+            pos_ = start;
+            Fail("a value");
+            return false;
+        }
+        bool floating = false;
+        if (next_is('.'))
+        {
+            ++pos_;
+            floating = true;
+            if (digits() == 0)
+            {
+                Fail("a digit after the decimal point");
+                return false;
+            }
+        }
+        if (next_is('e') || next_is('E'))
+        {
+            ++pos_;
+            floating = true;
+            if (next_is('+') || next_is('-'))
+            {
+                ++pos_;
+            }
+            if (digits() == 0)
+            {
+                Fail("an exponent");
+                return false;
+            }
+        }
+
+        const char* first = text_.data() + start;
+        const char* last  = text_.data() + pos_;
+        if (!floating)
+        {
+            // Integers out of range are read as floating-point numbers
+            if (negative)
+            {
+                int64_t integer = 0;
+                if (std::from_chars(first, last, integer).ec == std::errc{})
+                {
+                    value = integer;
+                    return true;
+                }
+            }
+            else
+            {
+                uint64_t integer = 0;
+                if (std::from_chars(first, last, integer).ec == std::errc{})
+                {
+                    value = integer;
+                    return true;
+                }
+            }
+        }
+
+        double number = 0.0;
+        if (std::from_chars(first, last, number).ec == std::errc::result_out_of_range)
+        {
+            // Underflow rounds to zero as strtod() does; overflow is an error
+            const std::string copy(first, last);
+            number = std::strtod(copy.c_str(), nullptr);
+        }
+        if (!std::isfinite(number))
+        {
+            pos_ = start;
+            Fail("a number within the range of double");
+            return false;
+        }
+        value = number;
+        return true;
+    }
+
+    void Fail(std::string_view what)
+    {
+        if (!failed_)
+        {
+            failed_ = true;
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "Malformed JSON: expected {} at byte {}",
+                what,
+                pos_);
+        }
+    }
+
+    std::string_view   text_;
+    std::size_t        pos_    = 0;
+    bool               failed_ = false;
+    std::string        key_;
+    std::vector<frame> stack_;
+};
+}  // namespace
+
+//-----------------------------------------------------------------------------
+void dump_json(std::string& out, const json& value, int indent)
+{
+    json_dumper(out, indent).Dump(value);
+}
+
+//-----------------------------------------------------------------------------
+void parse_json(std::string_view text, json& value)
+{
+    value = nullptr;
+    json_parser(text).Parse(value);
+}
+}  // namespace serialization
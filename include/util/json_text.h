@@ -0,0 +1,74 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+#include <cstddef>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <string_view>
+
+#include "util/export.h"
+
+namespace serialization
+{
+using json = nlohmann::ordered_json;
+
+/**
+ * @brief Position of the first byte that JSON requires to be escaped
+ * @param data Bytes of a string value
+ * @param size Number of bytes
+ * @return Index of the first '"', '\\' or control character, or size if there is none
+ * @note Scans 64 bytes per step with AVX-512, 32 with AVX2, 16 with SSE2 or NEON, and
+ *       one otherwise, as selected for the host (see cpu_features.h).
+ */
+SERIALIZATION_API std::size_t json_escape_position(const char* data, std::size_t size) noexcept;
+
+/**
+ * @brief Append a string to a JSON document, escaped as nlohmann::json::dump() does
+ * @param out Document being written
+ * @param text String value, without the surrounding quotes
+ * @note Runs without escapes are copied in bulk.
+ */
+SERIALIZATION_API void append_json_escaped(std::string& out, std::string_view text);
+
+/**
+ * @brief Check that a string is well-formed UTF-8 (RFC 3629)
+ * @return False on truncated or overlong sequences, surrogates and code points above U+10FFFF
+ * @note ASCII runs are skipped a vector at a time; only multi-byte sequences are decoded.
+ */
+SERIALIZATION_API bool is_valid_utf8(std::string_view text) noexcept;
+
+/**
+ * @brief Append a document as nlohmann::json::dump(indent) writes it
+ * @param out Text being written
+ * @param value Document
+ * @param indent Spaces per nesting level; negative writes compact JSON
+ * @note Strings are checked with is_valid_utf8() and escaped with append_json_escaped();
+ *       invalid UTF-8 raises malformed_input where dump() throws type_error 316.
+ */
+SERIALIZATION_API void dump_json(std::string& out, const json& value, int indent = -1);
+
+/**
+ * @brief Parse a document as nlohmann::json::parse() does
+ * @param text Whole document; a leading byte order mark is skipped
+ * @param value Receives the document
+ * @note String runs without escapes are copied at once and checked with
+ *       is_valid_utf8(). Nesting is followed with an explicit stack, so deep
+ *       documents cannot overflow the call stack. Malformed text raises
+ *       malformed_input.
+ */
+SERIALIZATION_API void parse_json(std::string_view text, json& value);
+}  // namespace serialization
@@ -0,0 +1,567 @@
+#include "util/local_socket.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string_view>
+
+#include "common/serialization_error.h"
+
+#if !defined(_WIN32)
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace serialization
+{
+namespace
+{
+void raise_io_error(std::string_view operation)
+{
+    SERIALIZATION_THROW(
+        serialization_error::error_code::io_error,
+        "Local socket {} failed: {}",
+        operation,
+        std::strerror(errno));
+}
+
+#if !defined(_WIN32)
+enum frame_kind : unsigned char
+{
+    inline_frame,
+    memfd_frame
+};
+
+void store_le64(unsigned char* out, uint64_t value)
+{
+    for (int k = 0; k < 8; ++k)
+    {
+        out[k] = static_cast<unsigned char>(value >> (8 * k));
+    }
+}
+
+uint64_t load_le64(const unsigned char* in)
+{
+    uint64_t value = 0;
+    for (int k = 0; k < 8; ++k)
+    {
+        value |= uint64_t{in[k]} << (8 * k);
+    }
+    return value;
+}
+
+#if defined(MSG_NOSIGNAL)
+constexpr int send_flags = MSG_NOSIGNAL;
+#else
+constexpr int send_flags = 0;
+#endif
+
+void close_fd(int fd)
+{
+    if (fd >= 0)
+    {
+        ::close(fd);
+    }
+}
+
+int open_socket()
+{
+#if defined(SOCK_CLOEXEC)
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+#else
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd >= 0)
+    {
+        ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+    }
+#endif
+#if defined(SO_NOSIGPIPE)
+    if (fd >= 0)
+    {
+        const int on = 1;
+        ::setsockopt(fd, SOL_SOCKET, SO_NOSIGPIPE, &on, sizeof(on));
+    }
+#endif
+    return fd;
+}
+
+bool make_address(const std::string& path, sockaddr_un& address)
+{
+    address            = {};
+    address.sun_family = AF_UNIX;
+    if (path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        errno = ENAMETOOLONG;
+        return false;
+    }
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+    return true;
+}
+
+// Sends every byte of the buffers; the descriptor, if any, travels with the first byte
+bool send_all(int fd, iovec* buffers, int count, int passedFd)
+{
+    msghdr message     = {};
+    message.msg_iov    = buffers;
+    message.msg_iovlen = count;
+
+    alignas(cmsghdr) unsigned char control[CMSG_SPACE(sizeof(int))] = {};
+    if (passedFd >= 0)
+    {
+        message.msg_control    = control;
+        message.msg_controllen = sizeof(control);
+        cmsghdr* header        = CMSG_FIRSTHDR(&message);
+        header->cmsg_level     = SOL_SOCKET;
+        header->cmsg_type      = SCM_RIGHTS;
+        header->cmsg_len       = CMSG_LEN(sizeof(int));
+        std::memcpy(CMSG_DATA(header), &passedFd, sizeof(int));
+    }
+
+    while (message.msg_iovlen > 0)
+    {
+        const auto sent = ::sendmsg(fd, &message, send_flags);
+        if (sent < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        message.msg_control    = nullptr;
+        message.msg_controllen = 0;
+
+        // Skips the buffers sent completely and trims the first partial one
+        auto remaining = static_cast<std::size_t>(sent);
+        while (message.msg_iovlen > 0 && remaining >= message.msg_iov->iov_len)
+        {
+            remaining -= message.msg_iov->iov_len;
+            ++message.msg_iov;
+            --message.msg_iovlen;
+        }
+        if (message.msg_iovlen > 0)
+        {
+            auto* base                = static_cast<unsigned char*>(message.msg_iov->iov_base);
+            message.msg_iov->iov_base = base + remaining;
+            message.msg_iov->iov_len -= remaining;
+        }
+    }
+    return true;
+}
+
+enum class receive_status
+{
+    complete,
+    closed,  ///< the peer closed the connection before the first byte
+    failed
+};
+
+// Receives exactly data.size() bytes and keeps the last descriptor passed along
+receive_status receive_all(int fd, std::span<unsigned char> data, int* passedFd)
+{
+    std::size_t received = 0;
+    while (received < data.size())
+    {
+        iovec buffer{data.data() + received, data.size() - received};
+
+        msghdr message     = {};
+        message.msg_iov    = &buffer;
+        message.msg_iovlen = 1;
+
+        alignas(cmsghdr) unsigned char control[CMSG_SPACE(sizeof(int))] = {};
+        if (passedFd != nullptr)
+        {
+            message.msg_control    = control;
+            message.msg_controllen = sizeof(control);
+        }
+
+#if defined(MSG_CMSG_CLOEXEC)
+        const auto count = ::recvmsg(fd, &message, MSG_CMSG_CLOEXEC);
+#else
+        const auto count = ::recvmsg(fd, &message, 0);
+#endif
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return receive_status::failed;
+        }
+
+        for (cmsghdr* header = passedFd != nullptr ? CMSG_FIRSTHDR(&message) : nullptr;
+             header != nullptr;
+             header = CMSG_NXTHDR(&message, header))
+        {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS)
+            {
+                int descriptor = -1;
+                std::memcpy(&descriptor, CMSG_DATA(header), sizeof(int));
+                close_fd(*passedFd);
+                *passedFd = descriptor;
+            }
+        }
+
+        if (count == 0)
+        {
+            if (received == 0)
+            {
+                return receive_status::closed;
+            }
+            errno = ECONNRESET;
+            return receive_status::failed;
+        }
+        received += static_cast<std::size_t>(count);
+    }
+    return receive_status::complete;
+}
+
+// Creates an anonymous file holding the payload, or returns -1
+int make_memfd(std::span<const unsigned char> payload)
+{
+#if defined(__linux__)
+    const int fd = ::memfd_create("serialization_frame", MFD_CLOEXEC);
+    if (fd < 0)
+    {
+        return -1;
+    }
+    std::size_t written = 0;
+    while (written < payload.size())
+    {
+        const auto count = ::write(fd, payload.data() + written, payload.size() - written);
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            close_fd(fd);
+            return -1;
+        }
+        written += static_cast<std::size_t>(count);
+    }
+    return fd;
+#else
+    (void)payload;
+    return -1;
+#endif
+}
+
+bool read_memfd(int fd, std::span<unsigned char> data)
+{
+    std::size_t received = 0;
+    while (received < data.size())
+    {
+        const auto count = ::pread(
+            fd, data.data() + received, data.size() - received, static_cast<off_t>(received));
+        if (count < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        if (count == 0)
+        {
+            errno = EIO;
+            return false;
+        }
+        received += static_cast<std::size_t>(count);
+    }
+    return true;
+}
+#endif
+}  // namespace
+
+#if !defined(_WIN32)
+//----------------------------------------------------------------------------
+local_socket::~local_socket()
+{
+    Close();
+}
+
+//----------------------------------------------------------------------------
+local_socket::local_socket(local_socket&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)), options_(other.options_)
+{
+}
+
+//----------------------------------------------------------------------------
+local_socket& local_socket::operator=(local_socket&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        fd_      = std::exchange(other.fd_, -1);
+        options_ = other.options_;
+    }
+    return *this;
+}
+
+//----------------------------------------------------------------------------
+void local_socket::Close()
+{
+    close_fd(std::exchange(fd_, -1));
+}
+
+//----------------------------------------------------------------------------
+local_socket local_socket::Connect(const std::string& path, local_socket_options options)
+{
+    sockaddr_un address;
+    if (!make_address(path, address))
+    {
+        raise_io_error("connect");
+        return {};
+    }
+
+    local_socket result(open_socket(), options);
+    if (result.fd_ < 0)
+    {
+        raise_io_error("socket");
+        return {};
+    }
+    int status = 0;
+    do
+    {
+        status = ::connect(
+            result.fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address));
+    } while (status < 0 && errno == EINTR);
+    if (status < 0)
+    {
+        raise_io_error("connect");
+        return {};
+    }
+    return result;
+}
+
+//----------------------------------------------------------------------------
+std::pair<local_socket, local_socket> local_socket::Pair(local_socket_options options)
+{
+    int fds[2] = {-1, -1};
+#if defined(SOCK_CLOEXEC)
+    const int status = ::socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds);
+#else
+    const int status = ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds);
+#endif
+    if (status < 0)
+    {
+        raise_io_error("socketpair");
+        return {};
+    }
+    return {local_socket(fds[0], options), local_socket(fds[1], options)};
+}
+
+//----------------------------------------------------------------------------
+void local_socket::Send(multi_process_stream& stream)
+{
+    const auto payload = stream.UnreadData();
+
+    unsigned char header[FrameHeaderSize] = {};
+    store_le64(header, payload.size());
+    header[8] = stream.endianness();
+
+    int passedFd = -1;
+    if (options_.memfd_threshold > 0 && payload.size() >= options_.memfd_threshold)
+    {
+        passedFd = make_memfd(payload);
+    }
+    header[9] = passedFd >= 0 ? memfd_frame : inline_frame;
+
+    iovec buffers[2] = {
+        {header, sizeof(header)},
+        {const_cast<unsigned char*>(payload.data()), payload.size()}};
+    const bool sent = send_all(fd_, buffers, passedFd >= 0 ? 1 : 2, passedFd);
+    close_fd(passedFd);
+    if (!sent)
+    {
+        raise_io_error("send");
+    }
+}
+
+//----------------------------------------------------------------------------
+bool local_socket::Receive(multi_process_stream& stream)
+{
+    unsigned char header[FrameHeaderSize];
+    int           passedFd = -1;
+    const auto    status   = receive_all(fd_, header, &passedFd);
+    if (status != receive_status::complete)
+    {
+        close_fd(passedFd);
+        if (status == receive_status::failed)
+        {
+            raise_io_error("receive");
+        }
+        return false;
+    }
+
+    const uint64_t length = load_le64(header);
+    const auto     kind   = header[9];
+    if (length > options_.max_frame_size || kind > memfd_frame ||
+        (kind == memfd_frame) != (passedFd >= 0))
+    {
+        close_fd(passedFd);
+        SERIALIZATION_THROW(
+            serialization_error::error_code::malformed_input,
+            "Invalid local socket frame: {} bytes, kind {}",
+            length,
+            kind);
+        return false;
+    }
+
+    const auto data = stream.PrepareRawData(static_cast<std::size_t>(length), header[8]);
+    bool       received = false;
+    if (kind == memfd_frame)
+    {
+        received = read_memfd(passedFd, data);
+        close_fd(passedFd);
+    }
+    else
+    {
+        received = receive_all(fd_, data, nullptr) == receive_status::complete;
+    }
+    if (!received)
+    {
+        stream.Reset();
+        raise_io_error("receive");
+        return false;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+local_socket_listener::local_socket_listener(
+    const std::string& path, local_socket_options options)
+    : path_(path), options_(options)
+{
+    sockaddr_un address;
+    if (!make_address(path_, address))
+    {
+        raise_io_error("bind");
+        return;
+    }
+
+    fd_ = open_socket();
+    if (fd_ < 0)
+    {
+        raise_io_error("socket");
+        return;
+    }
+    if (::bind(fd_, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) < 0 ||
+        ::listen(fd_, SOMAXCONN) < 0)
+    {
+        const int error = errno;
+        close_fd(std::exchange(fd_, -1));
+        errno = error;
+        raise_io_error("bind");
+    }
+}
+
+//----------------------------------------------------------------------------
+local_socket_listener::~local_socket_listener()
+{
+    if (fd_ >= 0)
+    {
+        close_fd(fd_);
+        ::unlink(path_.c_str());
+    }
+}
+
+//----------------------------------------------------------------------------
+local_socket local_socket_listener::Accept()
+{
+    int fd = -1;
+    do
+    {
+#if defined(SOCK_CLOEXEC)
+        fd = ::accept4(fd_, nullptr, nullptr, SOCK_CLOEXEC);
+#else
+        fd = ::accept(fd_, nullptr, nullptr);
+#endif
+    } while (fd < 0 && errno == EINTR);
+    if (fd < 0)
+    {
+        raise_io_error("accept");
+        return {};
+    }
+#if !defined(SOCK_CLOEXEC)
+    // Racy against a fork() in another thread; accept4() closes that window
+    ::fcntl(fd, F_SETFD, FD_CLOEXEC);
+#endif
+    return local_socket(fd, options_);
+}
+#else
+//----------------------------------------------------------------------------
+// Unix-domain sockets are not supported on Windows builds
+//----------------------------------------------------------------------------
+local_socket::~local_socket() = default;
+
+local_socket::local_socket(local_socket&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)), options_(other.options_)
+{
+}
+
+local_socket& local_socket::operator=(local_socket&& other) noexcept
+{
+    fd_      = std::exchange(other.fd_, -1);
+    options_ = other.options_;
+    return *this;
+}
+
+void local_socket::Close()
+{
+    fd_ = -1;
+}
+
+local_socket local_socket::Connect(const std::string& /*path*/, local_socket_options /*options*/)
+{
+    errno = ENOSYS;
+    raise_io_error("connect");
+    return {};
+}
+
+std::pair<local_socket, local_socket> local_socket::Pair(local_socket_options /*options*/)
+{
+    errno = ENOSYS;
+    raise_io_error("socketpair");
+    return {};
+}
+
+void local_socket::Send(multi_process_stream& /*stream*/)
+{
+    errno = ENOSYS;
+    raise_io_error("send");
+}
+
+bool local_socket::Receive(multi_process_stream& /*stream*/)
+{
+    errno = ENOSYS;
+    raise_io_error("receive");
+    return false;
+}
+
+local_socket_listener::local_socket_listener(
+    const std::string& path, local_socket_options options)
+    : path_(path), options_(options)
+{
+    errno = ENOSYS;
+    raise_io_error("bind");
+}
+
+local_socket_listener::~local_socket_listener() = default;
+
+local_socket local_socket_listener::Accept()
+{
+    errno = ENOSYS;
+    raise_io_error("accept");
+    return {};
+}
+#endif
+}  // namespace serialization
@@ -0,0 +1,147 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file local_socket.h
+ * @brief Framed transport of multi_process_stream data over Unix-domain sockets
+ *
+ * Every message is a 16-byte frame header followed by the stream's bytes:
+ *
+ * | Field      | Size | Content                                          |
+ * |------------|------|--------------------------------------------------|
+ * | length     | 8    | payload size, little endian                      |
+ * | endianness | 1    | endian byte of the sending stream                |
+ * | kind       | 1    | 0: payload follows inline, 1: payload in a memfd |
+ * | reserved   | 6    | zero                                             |
+ *
+ * Send() gathers the header and the stream's unread bytes in one sendmsg()
+ * call, so the payload is never copied into a staging buffer. Receive() reads
+ * the payload straight into the receiving stream's storage, which is reused
+ * from one message to the next, and the stream is then loaded in place.
+ *
+ * On Linux, payloads of at least memfd_threshold bytes are written to a
+ * memfd whose descriptor travels with the header (SCM_RIGHTS); the socket
+ * then carries only the header.
+ */
+
+#include <cstddef>
+#include <string>
+#include <utility>
+
+#include "util/export.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/**
+ * @brief Settings of a local_socket
+ */
+struct local_socket_options
+{
+    /// Payloads of at least this many bytes travel in a memfd; 0 never uses one
+    std::size_t memfd_threshold = 0;
+    /// Largest payload accepted by Receive()
+    std::size_t max_frame_size = std::size_t{1} << 30;
+};
+
+/**
+ * @brief One end of a connected Unix-domain stream socket
+ *
+ * Failures raise serialization_error with io_error; a frame header that does
+ * not parse raises malformed_input. A socket is used by one thread at a time.
+ */
+class SERIALIZATION_API local_socket
+{
+public:
+    local_socket() = default;
+    ~local_socket();
+
+    local_socket(local_socket&& other) noexcept;
+    local_socket& operator=(local_socket&& other) noexcept;
+
+    local_socket(const local_socket&)            = delete;
+    local_socket& operator=(const local_socket&) = delete;
+
+    /**
+     * Connects to a socket bound by local_socket_listener.
+     */
+    static local_socket Connect(const std::string& path, local_socket_options options = {});
+
+    /**
+     * Returns two connected sockets, for example to talk to a forked child.
+     */
+    static std::pair<local_socket, local_socket> Pair(local_socket_options options = {});
+
+    /**
+     * Sends the bytes of the stream not popped yet as one frame.
+     */
+    void Send(multi_process_stream& stream);
+
+    /**
+     * Replaces the stream's content with the next frame. Returns false when
+     * the peer closed the connection between two frames.
+     */
+    bool Receive(multi_process_stream& stream);
+
+    /**
+     * Returns true if the socket holds a connection.
+     */
+    bool IsOpen() const { return fd_ >= 0; }
+
+    /**
+     * Closes the connection; the peer's next Receive() returns false.
+     */
+    void Close();
+
+    static constexpr std::size_t FrameHeaderSize = 16;
+
+private:
+    local_socket(int fd, local_socket_options options) : fd_(fd), options_(options) {}
+
+    friend class local_socket_listener;
+
+    int                  fd_ = -1;
+    local_socket_options options_;
+};
+
+/**
+ * @brief Accepts connections on a Unix-domain socket path
+ *
+ * The path must not exist yet; the listener removes it when destroyed.
+ */
+class SERIALIZATION_API local_socket_listener
+{
+public:
+    explicit local_socket_listener(const std::string& path, local_socket_options options = {});
+    ~local_socket_listener();
+
+    local_socket_listener(const local_socket_listener&)            = delete;
+    local_socket_listener& operator=(const local_socket_listener&) = delete;
+
+    /**
+     * Waits for the next connection.
+     */
+    local_socket Accept();
+
+    const std::string& Path() const { return path_; }
+
+private:
+    std::string          path_;
+    local_socket_options options_;
+    int                  fd_ = -1;
+};
+}  // namespace serialization
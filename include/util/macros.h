@@ -141,6 +141,14 @@ inline constexpr int SERIALIZATION_COMPILE_TIME_MAX_GPUS = 16;
 #define SERIALIZATION_COLD
 #endif
 
+//------------------------------------------------------------------------
+// Exception support (off with -fno-exceptions or /EHs-c-)
+#if defined(__cpp_exceptions) || defined(__EXCEPTIONS) || defined(_CPPUNWIND)
+#define SERIALIZATION_HAS_EXCEPTIONS 1
+#else
+#define SERIALIZATION_HAS_EXCEPTIONS 0
+#endif
+
 //------------------------------------------------------------------------
 #ifdef NDEBUG
 #define SERIALIZATION_SIMD_RETURN_TYPE \
@@ -149,6 +157,22 @@ inline constexpr int SERIALIZATION_COMPILE_TIME_MAX_GPUS = 16;
 #define SERIALIZATION_SIMD_RETURN_TYPE static void
 #endif
 
+//------------------------------------------------------------------------
+// Instruction sets of the kernels dispatched at run time (util/cpu_features.h)
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SERIALIZATION_ARCH_X86 1
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define SERIALIZATION_ARCH_ARM64 1
+#endif
+
+// Compiles one function for an instruction set the rest of the build does not target
+#if defined(__GNUC__) || defined(__clang__)
+#define SERIALIZATION_TARGET(isa) __attribute__((target(isa)))
+#else
+// MSVC accepts every intrinsic without a per-function switch
+#define SERIALIZATION_TARGET(isa)
+#endif
+
 //------------------------------------------------------------------------
 // set function attribute for CUDA
 #if defined(__CUDACC__) || defined(__HIPCC__)
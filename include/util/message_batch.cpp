@@ -0,0 +1,178 @@
+#include "util/message_batch.h"
+
+#include <cassert>
+#include <cstring>
+
+#include "common/serialization_error.h"
+
+namespace serialization
+{
+namespace
+{
+constexpr unsigned char magic[7] = {'S', 'B', 'A', 'T', 'C', 'H', '1'};
+
+constexpr std::size_t endianness_offset = 7;
+constexpr std::size_t count_offset      = 8;
+constexpr std::size_t index_offset      = 16;
+
+void store_le64(unsigned char* out, uint64_t value)
+{
+    for (int k = 0; k < 8; ++k)
+    {
+        out[k] = static_cast<unsigned char>(value >> (8 * k));
+    }
+}
+
+uint64_t load_le64(const unsigned char* in)
+{
+    uint64_t value = 0;
+    for (int k = 0; k < 8; ++k)
+    {
+        value |= uint64_t{in[k]} << (8 * k);
+    }
+    return value;
+}
+
+void push_varint(std::vector<unsigned char>& out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        out.push_back(static_cast<unsigned char>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+}
+
+bool pop_varint(const unsigned char*& in, const unsigned char* end, uint64_t& value)
+{
+    value = 0;
+    for (int shift = 0; shift < 64 && in != end; shift += 7)
+    {
+        const unsigned char byte = *in++;
+        value |= uint64_t{byte & 0x7fu} << shift;
+        if ((byte & 0x80) == 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+unsigned char native_endianness()
+{
+    static const unsigned char endianness = multi_process_stream().endianness();
+    return endianness;
+}
+}  // namespace
+
+//----------------------------------------------------------------------------
+message_batch_writer::message_batch_writer(std::size_t reserveBytes)
+    : endianness_(native_endianness())
+{
+    buffer_.reserve(HeaderSize + reserveBytes);
+    buffer_.resize(HeaderSize);
+}
+
+//----------------------------------------------------------------------------
+void message_batch_writer::Append(std::span<const unsigned char> message)
+{
+    // Drops the index left behind by Finish()
+    buffer_.resize(payloadEnd_);
+    buffer_.insert(buffer_.end(), message.begin(), message.end());
+    payloadEnd_ = buffer_.size();
+    push_varint(index_, message.size());
+    ++count_;
+}
+
+//----------------------------------------------------------------------------
+void message_batch_writer::Append(multi_process_stream& stream)
+{
+    SERIALIZATION_CHECK(
+        count_ == 0 || stream.endianness() == endianness_,
+        serialization_error::error_code::malformed_input,
+        "Message batch holds endianness {}, the appended stream has {}",
+        static_cast<int>(endianness_),
+        static_cast<int>(stream.endianness()));
+    endianness_ = stream.endianness();
+    Append(stream.UnreadData());
+}
+
+//----------------------------------------------------------------------------
+std::span<const unsigned char> message_batch_writer::Finish()
+{
+    std::memcpy(buffer_.data(), magic, sizeof(magic));
+    buffer_[endianness_offset] = endianness_;
+    store_le64(buffer_.data() + count_offset, count_);
+    store_le64(buffer_.data() + index_offset, payloadEnd_);
+
+    buffer_.resize(payloadEnd_);
+    buffer_.insert(buffer_.end(), index_.begin(), index_.end());
+    return buffer_;
+}
+
+//----------------------------------------------------------------------------
+void message_batch_writer::Clear()
+{
+    buffer_.resize(HeaderSize);
+    index_.clear();
+    payloadEnd_ = HeaderSize;
+    count_      = 0;
+}
+
+//----------------------------------------------------------------------------
+message_batch_reader::message_batch_reader(std::span<const unsigned char> batch)
+    : batch_(batch)
+{
+    constexpr std::size_t header_size = message_batch_writer::HeaderSize;
+    if (batch.size() < header_size || std::memcmp(batch.data(), magic, sizeof(magic)) != 0)
+    {
+        return;
+    }
+
+    const uint64_t count = load_le64(batch.data() + count_offset);
+    const uint64_t index = load_le64(batch.data() + index_offset);
+    // Every message takes at least one index byte, which bounds the count
+    // before anything is allocated for it
+    if (index < header_size || index > batch.size() || count > batch.size() - index)
+    {
+        return;
+    }
+
+    offsets_.reserve(static_cast<std::size_t>(count) + 1);
+    offsets_.push_back(header_size);
+
+    const unsigned char* in  = batch.data() + index;
+    const unsigned char* end = batch.data() + batch.size();
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        uint64_t length = 0;
+        if (!pop_varint(in, end, length) || length > index - offsets_.back())
+        {
+            offsets_.clear();
+            return;
+        }
+        offsets_.push_back(offsets_.back() + static_cast<std::size_t>(length));
+    }
+
+    if (in != end || offsets_.back() != index)
+    {
+        offsets_.clear();
+        return;
+    }
+    endianness_ = batch[endianness_offset];
+    valid_      = true;
+}
+
+//----------------------------------------------------------------------------
+std::span<const unsigned char> message_batch_reader::Message(std::size_t i) const
+{
+    assert("pre: message index is in range" && (i < Count()));
+    return batch_.subspan(offsets_[i], offsets_[i + 1] - offsets_[i]);
+}
+
+//----------------------------------------------------------------------------
+void message_batch_reader::Load(std::size_t i, multi_process_stream& stream) const
+{
+    stream.SetRawData(Message(i), endianness_);
+}
+}  // namespace serialization
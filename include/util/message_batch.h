@@ -0,0 +1,143 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file message_batch.h
+ * @brief Many small binary messages packed into one buffer
+ *
+ * A batch is a 24-byte header, the message bytes back to back, and an index
+ * holding the length of every message as a varint:
+ *
+ * | Field      | Size | Content                                            |
+ * |------------|------|----------------------------------------------------|
+ * | magic      | 7    | "SBATCH1"                                          |
+ * | endianness | 1    | endian byte shared by every message                |
+ * | count      | 8    | number of messages, little endian                  |
+ * | index      | 8    | offset of the length index, little endian          |
+ * | messages   | n    | multi_process_stream data without the endian byte  |
+ * | lengths    | m    | one varint per message, in message order           |
+ *
+ * Compared with one GetRawData() vector per message, a batch costs a single
+ * growing buffer on the writer side, one to three bytes of framing per
+ * message, and one write or send for the whole batch. The reader validates
+ * the header and index once and then hands out views of the messages.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "util/export.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/**
+ * @brief Packs messages into a batch
+ *
+ * The buffer and index are reused across Clear(), so a writer kept for the
+ * lifetime of a connection stops allocating once it has seen its largest
+ * batch.
+ */
+class SERIALIZATION_API message_batch_writer
+{
+public:
+    explicit message_batch_writer(std::size_t reserveBytes = 0);
+
+    //@{
+    /**
+     * Appends one message. The stream overload copies the bytes not popped
+     * yet; every message of a batch must come from streams of one endianness,
+     * a stream of another one raises malformed_input.
+     */
+    void Append(std::span<const unsigned char> message);
+    void Append(multi_process_stream& stream);
+    //@}
+
+    /**
+     * Completes the batch and returns it. The view is valid until the writer
+     * is changed; appending after Finish() extends the same batch.
+     */
+    std::span<const unsigned char> Finish();
+
+    /**
+     * Starts a new, empty batch, keeping the allocated memory.
+     */
+    void Clear();
+
+    /**
+     * Returns the number of messages appended since the last Clear().
+     */
+    std::size_t Count() const { return count_; }
+
+    /**
+     * Returns the message bytes appended since the last Clear().
+     */
+    std::size_t PayloadSize() const { return payloadEnd_ - HeaderSize; }
+
+    static constexpr std::size_t HeaderSize = 24;
+
+private:
+    std::vector<unsigned char> buffer_;
+    std::vector<unsigned char> index_;
+    std::size_t                payloadEnd_ = HeaderSize;
+    std::size_t                count_      = 0;
+    unsigned char              endianness_;
+};
+
+/**
+ * @brief Views the messages of a batch without copying them
+ *
+ * The batch must outlive the reader. A batch whose header, index or lengths
+ * are inconsistent reads as invalid and holds no messages.
+ */
+class SERIALIZATION_API message_batch_reader
+{
+public:
+    message_batch_reader() = default;
+    explicit message_batch_reader(std::span<const unsigned char> batch);
+
+    /**
+     * Returns true if the batch was read completely.
+     */
+    bool IsValid() const { return valid_; }
+
+    /**
+     * Returns the number of messages in the batch.
+     */
+    std::size_t Count() const { return offsets_.empty() ? 0 : offsets_.size() - 1; }
+
+    /**
+     * Returns a view of message i, valid as long as the batch.
+     */
+    std::span<const unsigned char> Message(std::size_t i) const;
+
+    /**
+     * Replaces the stream's content with message i.
+     */
+    void Load(std::size_t i, multi_process_stream& stream) const;
+
+    unsigned char endianness() const { return endianness_; }
+
+private:
+    std::span<const unsigned char> batch_;
+    std::vector<std::size_t>       offsets_;
+    unsigned char                  endianness_ = 0;
+    bool                           valid_      = false;
+};
+}  // namespace serialization
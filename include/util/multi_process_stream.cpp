@@ -1,10 +1,115 @@
 #include "util/multi_process_stream.h"
 
+#include <bit>
 #include <cassert>
-#include <deque>
+#include <cstring>
+#include <limits>
+#include <string>
 
 namespace serialization
 {
+namespace
+{
+// Block count announcing that the real count follows as 64 bits
+constexpr unsigned int LongBlockSize = std::numeric_limits<unsigned int>::max();
+
+uint64_t zigzag(uint64_t value)
+{
+    const auto signed_value = static_cast<int64_t>(value);
+    return (value << 1) ^ static_cast<uint64_t>(signed_value >> 63);
+}
+
+uint64_t unzigzag(uint64_t value)
+{
+    return (value >> 1) ^ (0 - (value & 1));
+}
+
+// Compiles to a single load on little-endian targets.
+uint64_t load_le64(const unsigned char* bytes)
+{
+    uint64_t value = 0;
+    for (int k = 0; k < 8; ++k)
+    {
+        value |= static_cast<uint64_t>(bytes[k]) << (8 * k);
+    }
+    return value;
+}
+
+size_t varint_size(uint64_t value)
+{
+    return std::max<size_t>(1, (static_cast<size_t>(std::bit_width(value)) + 6) / 7);
+}
+
+// Writes all varint_size(value) bytes of value
+void write_varint(unsigned char* out, uint64_t value)
+{
+    while (value >= 0x80)
+    {
+        *out++ = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    *out = static_cast<unsigned char>(value);
+}
+
+// Packs values of `width` bits, least significant bit first.
+void pack_bits(const uint64_t* values, size_t count, unsigned width, unsigned char* out)
+{
+    uint64_t accumulator = 0;
+    unsigned filled      = 0;
+    for (size_t i = 0; i < count; ++i)
+    {
+        accumulator |= values[i] << filled;
+        if (filled + width >= 64)
+        {
+            for (int k = 0; k < 8; ++k)
+            {
+                *out++ = static_cast<unsigned char>(accumulator >> (8 * k));
+            }
+            accumulator = filled == 0 ? 0 : values[i] >> (64 - filled);
+            filled      = filled + width - 64;
+        }
+        else
+        {
+            filled += width;
+        }
+    }
+    for (unsigned k = 0; k * 8 < filled; ++k)
+    {
+        *out++ = static_cast<unsigned char>(accumulator >> (8 * k));
+    }
+}
+
+// Inverse of pack_bits. `in` must be readable 8 bytes past the packed data.
+// Each value is extracted independently, so the loop vectorizes for the
+// common widths.
+void unpack_bits(const unsigned char* in, size_t count, unsigned width, uint64_t* values)
+{
+    const uint64_t mask = width == 64 ? ~uint64_t{0} : (uint64_t{1} << width) - 1;
+    if (width <= 56)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const size_t bit = i * width;
+            values[i]        = (load_le64(in + bit / 8) >> (bit % 8)) & mask;
+        }
+        return;
+    }
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        const size_t   bit   = i * width;
+        const unsigned shift = bit % 8;
+        const auto*    bytes = in + bit / 8;
+        uint64_t       value = load_le64(bytes) >> shift;
+        if (shift != 0)
+        {
+            value |= static_cast<uint64_t>(bytes[8]) << (64 - shift);
+        }
+        values[i] = value & mask;
+    }
+}
+}  // namespace
+
 //----------------------------------------------------------------------------
 multi_process_stream::multi_process_stream()
 {
@@ -26,9 +131,18 @@ multi_process_stream::~multi_process_stream()
 //----------------------------------------------------------------------------
 multi_process_stream::multi_process_stream(const multi_process_stream& other)
 {
-    internals_        = new multi_process_stream::serializationInternals();
-    internals_->data_ = other.internals_->data_;
-    endianness_       = other.endianness_;
+    internals_ = new multi_process_stream::serializationInternals();
+    internals_->data_.assign(
+        other.internals_->data_.begin() + static_cast<std::ptrdiff_t>(other.internals_->head_),
+        other.internals_->data_.end());
+    internals_->failed_          = other.internals_->failed_;
+    internals_->useDictionary_   = other.internals_->useDictionary_;
+    internals_->dictionaryIndex_ = other.internals_->dictionaryIndex_;
+    internals_->dictionary_      = other.internals_->dictionary_;
+    internals_->packBits_        = other.internals_->packBits_;
+    internals_->readBits_        = other.internals_->readBits_;
+    internals_->readShift_       = other.internals_->readShift_;
+    endianness_                  = other.endianness_;
 }
 
 //----------------------------------------------------------------------------
@@ -36,390 +150,748 @@ multi_process_stream& multi_process_stream::operator=(const multi_process_stream
 {
     if (&other != this)
     {
-        internals_->data_ = other.internals_->data_;
-        endianness_       = other.endianness_;
+        internals_->data_.assign(
+            other.internals_->data_.begin() + static_cast<std::ptrdiff_t>(other.internals_->head_),
+            other.internals_->data_.end());
+        internals_->head_            = 0;
+        internals_->failed_          = other.internals_->failed_;
+        internals_->useDictionary_   = other.internals_->useDictionary_;
+        internals_->dictionaryIndex_ = other.internals_->dictionaryIndex_;
+        internals_->dictionary_      = other.internals_->dictionary_;
+        internals_->packBits_        = other.internals_->packBits_;
+        internals_->bitsStart_       = serializationInternals::npos;
+        internals_->readBits_        = other.internals_->readBits_;
+        internals_->readShift_       = other.internals_->readShift_;
+        endianness_                  = other.endianness_;
     }
     return (*this);
 }
 
+//----------------------------------------------------------------------------
+void multi_process_stream::EnableStringDictionary(bool enable)
+{
+    internals_->useDictionary_ = enable;
+}
+
+//----------------------------------------------------------------------------
+bool multi_process_stream::StringDictionaryEnabled() const
+{
+    return internals_->useDictionary_;
+}
+
+//----------------------------------------------------------------------------
+std::size_t multi_process_stream::ReadDictionarySize() const
+{
+    return internals_->dictionary_.size();
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::EnableBitPacking(bool enable)
+{
+    internals_->packBits_ = enable;
+}
+
+//----------------------------------------------------------------------------
+bool multi_process_stream::BitPackingEnabled() const
+{
+    return internals_->packBits_;
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::PushBits(uint64_t bits, unsigned int count)
+{
+    assert("pre: more than 64 bits" && (count <= 64));
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        PushBit(((bits >> i) & 1) != 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+uint64_t multi_process_stream::PopBits(unsigned int count)
+{
+    assert("pre: more than 64 bits" && (count <= 64));
+    uint64_t bits = 0;
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        bits |= static_cast<uint64_t>(PopBit()) << i;
+    }
+    return internals_->failed_ ? 0 : bits;
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::EndBitGroup()
+{
+    internals_->bitsStart_ = serializationInternals::npos;
+}
+
+//----------------------------------------------------------------------------
+bool multi_process_stream::InBitGroup() const
+{
+    return internals_->readBits_ != 0;
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::PushBit(bool value)
+{
+    auto& data = internals_->data_;
+
+    // Bits that were read already are not extended
+    if (internals_->bitsStart_ == serializationInternals::npos ||
+        internals_->head_ > internals_->bitsStart_)
+    {
+        // A lone bit is a char value, as unpacked bools are
+        internals_->PushType(serializationInternals::char_value);
+        internals_->bitsStart_ = data.size() - 1;
+        internals_->bitsCount_ = 1;
+        data.push_back(static_cast<unsigned char>(value));
+        return;
+    }
+
+    const auto index = internals_->bitsCount_;
+    if (index == 1)
+    {
+        // The second bit turns the char value into a group
+        const auto first = static_cast<unsigned char>(data.back() != 0);
+        data.resize(internals_->bitsStart_);
+        data.push_back(serializationInternals::bits_value);
+        data.push_back(0);
+        data.push_back(first);
+    }
+
+    // Rewrite the count in place; its varint grows a byte at a time
+    const auto count     = index + 1;
+    const auto position  = internals_->bitsStart_ + 1;
+    const auto old_width = varint_size(index);
+    const auto new_width = varint_size(count);
+    if (new_width > old_width)
+    {
+        data.insert(
+            data.begin() + static_cast<std::ptrdiff_t>(position + old_width),
+            new_width - old_width,
+            0);
+    }
+    write_varint(data.data() + position, count);
+    internals_->bitsCount_ = count;
+
+    if (index % 8 == 0)
+    {
+        data.push_back(0);
+    }
+    data.back() |= static_cast<unsigned char>(static_cast<unsigned>(value) << (index % 8));
+}
+
+//----------------------------------------------------------------------------
+bool multi_process_stream::OpenBitGroup()
+{
+    uint64_t count = 0;
+    if (!internals_->PopType(serializationInternals::bits_value) ||
+        !internals_->PopVarint(count))
+    {
+        return false;
+    }
+    if (count == 0 || (count - 1) / 8 >= internals_->Size())
+    {
+        internals_->failed_ = true;
+        return false;
+    }
+    internals_->readBits_  = count;
+    internals_->readShift_ = 0;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool multi_process_stream::PopBit()
+{
+    if (internals_->readBits_ == 0)
+    {
+        if (!internals_->failed_ && !internals_->Empty() &&
+            internals_->Front() == serializationInternals::char_value)
+        {
+            char value = 0;
+            *this >> value;
+            return value != 0;
+        }
+        if (!OpenBitGroup())
+        {
+            return false;
+        }
+    }
+
+    const auto byte  = internals_->data_[internals_->head_];
+    const bool value = ((byte >> internals_->readShift_) & 1) != 0;
+    --internals_->readBits_;
+    if (++internals_->readShift_ == 8 || internals_->readBits_ == 0)
+    {
+        ++internals_->head_;
+        internals_->readShift_ = 0;
+    }
+    return value;
+}
+
 //----------------------------------------------------------------------------
 void multi_process_stream::Reset()
 {
-    internals_->data_.clear();
+    internals_->Clear();
 }
 
 //----------------------------------------------------------------------------
-int multi_process_stream::Size()
+std::size_t multi_process_stream::Size()
 {
-    return (static_cast<int>(internals_->data_.size()));
+    return internals_->Size();
 }
 
 //----------------------------------------------------------------------------
-int multi_process_stream::RawSize()
+std::size_t multi_process_stream::RawSize()
 {
     return (Size() + 1);
 };
 //----------------------------------------------------------------------------
 bool multi_process_stream::Empty()
 {
-    return (internals_->data_.empty());
+    return (internals_->Empty());
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const double* array, unsigned int size)
+bool multi_process_stream::HasError() const
 {
-    assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::double_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(double) * size);
+    return internals_->failed_;
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const float* array, unsigned int size)
+void multi_process_stream::ClearError()
 {
-    assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::float_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(float) * size);
+    internals_->failed_ = false;
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const int* array, unsigned int size)
+void multi_process_stream::Push(const double* array, std::size_t size)
 {
     assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::int32_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(int) * size);
+    PushBlock(serializationInternals::double_value, array, size, sizeof(double));
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const char* array, unsigned int size)
+void multi_process_stream::Push(const float* array, std::size_t size)
 {
     assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::char_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(char) * size);
+    PushBlock(serializationInternals::float_value, array, size, sizeof(float));
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const unsigned int* array, unsigned int size)
+void multi_process_stream::Push(const int* array, std::size_t size)
 {
     assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::uint32_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(unsigned int) * size);
+    PushBlock(serializationInternals::int32_value, array, size, sizeof(int));
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const unsigned char* array, unsigned int size)
+void multi_process_stream::Push(const char* array, std::size_t size)
 {
     assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::uchar_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(array, size);
+    PushBlock(serializationInternals::char_value, array, size, sizeof(char));
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const int64_t* array, unsigned int size)
+void multi_process_stream::Push(const unsigned int* array, std::size_t size)
 {
     assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::int64_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(uint64_t) * size);
+    PushBlock(serializationInternals::uint32_value, array, size, sizeof(unsigned int));
 }
 
 //----------------------------------------------------------------------------
-//void multi_process_stream::Push(const uint64_t* array, unsigned int size)
-//{
-//    assert("pre: array is nullptr!" && (array != nullptr));
-//    internals_->data_.push_back(serializationInternals::uint64_value);
-//    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-//    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(uint64_t) * size);
-//}
+void multi_process_stream::Push(const unsigned char* array, std::size_t size)
+{
+    assert("pre: array is nullptr!" && (array != nullptr));
+    PushBlock(serializationInternals::uchar_value, array, size, sizeof(unsigned char));
+}
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Push(const size_t* array, unsigned int size)
+void multi_process_stream::Push(const int64_t* array, std::size_t size)
 {
     assert("pre: array is nullptr!" && (array != nullptr));
-    internals_->data_.push_back(serializationInternals::size_value);
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-    internals_->Push(reinterpret_cast<const unsigned char*>(array), sizeof(size_t) * size);
+    PushBlock(serializationInternals::int64_value, array, size, sizeof(int64_t));
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(double*& array, unsigned int& size)
+void multi_process_stream::Push(const size_t* array, std::size_t size)
 {
-    assert(
-        "pre: stream data must be double" &&
-        internals_->data_.front() == serializationInternals::double_value);
-    internals_->data_.pop_front();
+    assert("pre: array is nullptr!" && (array != nullptr));
+    PushBlock(serializationInternals::size_value, array, size, sizeof(size_t));
+}
 
-    if (array == nullptr)
+//----------------------------------------------------------------------------
+template <typename T>
+void multi_process_stream::PopArray(T*& array, std::size_t& size, int type)
+{
+    const auto sz = PopBlockSize(type, type, sizeof(T));
+    if (internals_->failed_)
     {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-
-        // Allocate array
-        array = new double[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
+        return;
     }
-    else
+
+    // Reject sizes that do not match the caller's array before allocating anything
+    if (array != nullptr && sz != size)
     {
-        unsigned int sz;
+        internals_->failed_ = true;
+        return;
+    }
 
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
+    if (array == nullptr)
+    {
+        size  = sz;
+        array = new T[size];
     }
 
     // Pop the array data
-    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(double) * size);
+    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(T) * size);
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(float*& array, unsigned int& size)
+void multi_process_stream::PushBlock(
+    int type, const void* data, std::size_t count, std::size_t element_size)
 {
-    assert(
-        "pre: stream data must be float" &&
-        internals_->data_.front() == serializationInternals::float_value);
-    internals_->data_.pop_front();
+    internals_->PushType(static_cast<serializationInternals::Types>(type));
 
-    if (array == nullptr)
+    // Counts that do not fit an unsigned int follow an escape value
+    const auto size = static_cast<unsigned int>(std::min<std::size_t>(count, LongBlockSize));
+    internals_->Push(reinterpret_cast<const unsigned char*>(&size), sizeof(unsigned int));
+    if (size == LongBlockSize)
     {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
+        const auto wide = static_cast<uint64_t>(count);
+        internals_->Push(reinterpret_cast<const unsigned char*>(&wide), sizeof(uint64_t));
+    }
+    internals_->Push(static_cast<const unsigned char*>(data), element_size * count);
+}
 
-        // Allocate array
-        array = new float[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
+//----------------------------------------------------------------------------
+std::size_t multi_process_stream::PopBlockSize(
+    int type, int alternative_type, std::size_t element_size)
+{
+    if (internals_->failed_ || internals_->Empty() || internals_->readBits_ != 0 ||
+        (internals_->Front() != type && internals_->Front() != alternative_type))
+    {
+        internals_->failed_ = true;
+        return 0;
     }
-    else
+    ++internals_->head_;
+
+    unsigned int size = 0;
+    if (!internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int)))
+    {
+        return 0;
+    }
+    uint64_t count = size;
+    if (size == LongBlockSize &&
+        !internals_->Pop(reinterpret_cast<unsigned char*>(&count), sizeof(uint64_t)))
     {
-        unsigned int sz;
+        return 0;
+    }
 
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
+    // Validate against the remaining data before the caller allocates anything
+    if (internals_->Size() / element_size < count)
+    {
+        internals_->failed_ = true;
+        return 0;
     }
+    return static_cast<std::size_t>(count);
+}
 
-    // Pop the array data
-    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(float) * size);
+//----------------------------------------------------------------------------
+bool multi_process_stream::PopBlockData(void* data, std::size_t bytes)
+{
+    return internals_->Pop(static_cast<unsigned char*>(data), bytes);
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(int*& array, unsigned int& size)
+void multi_process_stream::MarkFailed()
 {
-    assert(
-        "pre: stream data must be int" &&
-        internals_->data_.front() == serializationInternals::int32_value);
-    internals_->data_.pop_front();
+    internals_->failed_ = true;
+}
 
-    if (array == nullptr)
+//----------------------------------------------------------------------------
+void multi_process_stream::PushDeltaValues(const uint64_t* values, std::size_t count)
+{
+    internals_->PushType(serializationInternals::delta_value);
+    internals_->PushVarint(count);
+    if (count == 0)
     {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
+        return;
+    }
 
-        // Allocate the array
-        array = new int[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
+    internals_->PushVarint(zigzag(values[0]));
+    if (count == 1)
+    {
+        return;
     }
-    else
+
+    uint64_t previous_delta = values[1] - values[0];
+    internals_->PushVarint(zigzag(previous_delta));
+
+    uint64_t      block[DeltaBlockSize];
+    unsigned char packed[DeltaBlockSize * 8];
+    for (size_t begin = 2; begin < count; begin += DeltaBlockSize)
     {
-        unsigned int sz;
+        const size_t length = std::min(DeltaBlockSize, count - begin);
+        uint64_t     bits   = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            const uint64_t delta = values[begin + i] - values[begin + i - 1];
+            block[i]             = zigzag(delta - previous_delta);
+            bits |= block[i];
+            previous_delta = delta;
+        }
 
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
+        const auto width = static_cast<unsigned char>(std::bit_width(bits));
+        const auto bytes = (length * width + 7) / 8;
+        pack_bits(block, length, width, packed);
+        internals_->Push(&width, 1);
+        internals_->Push(packed, bytes);
     }
-
-    // Pop the array data
-    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(int) * size);
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(char*& array, unsigned int& size)
+std::size_t multi_process_stream::PopDeltaCount()
 {
-    assert(
-        "pre: stream data must be of type char" &&
-        internals_->data_.front() == serializationInternals::char_value);
-    internals_->data_.pop_front();
-
-    if (array == nullptr)
+    uint64_t count = 0;
+    if (!internals_->PopType(serializationInternals::delta_value) ||
+        !internals_->PopVarint(count))
     {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-
-        // Allocate the array
-        array = new char[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
+        return 0;
     }
-    else
-    {
-        unsigned int sz;
 
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
+    // Every block of values takes at least one byte
+    if (count > 2 + DeltaBlockSize * internals_->Size())
+    {
+        internals_->failed_ = true;
+        return 0;
     }
-
-    // Pop the array data
-    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(char) * size);
+    return static_cast<size_t>(count);
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(unsigned int*& array, unsigned int& size)
+void multi_process_stream::PopDeltaValues(uint64_t* values, std::size_t count)
 {
-    assert(
-        "pre: stream data must be of type unsigned int" &&
-        internals_->data_.front() == serializationInternals::uint32_value);
-    internals_->data_.pop_front();
-
-    if (array == nullptr)
+    if (count == 0)
     {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
+        return;
+    }
 
-        // Allocate the array
-        array = new unsigned int[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
+    uint64_t first = 0;
+    if (!internals_->PopVarint(first))
+    {
+        return;
     }
-    else
+    values[0] = unzigzag(first);
+    if (count == 1)
     {
-        unsigned int sz;
+        return;
+    }
 
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
+    uint64_t delta = 0;
+    if (!internals_->PopVarint(delta))
+    {
+        return;
     }
+    delta     = unzigzag(delta);
+    values[1] = values[0] + delta;
 
-    // Pop the array data
-    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(unsigned int) * size);
+    // Packed bytes plus the 8 bytes of padding unpack_bits reads past them
+    unsigned char packed[DeltaBlockSize * 8 + 8] = {};
+    for (size_t begin = 2; begin < count; begin += DeltaBlockSize)
+    {
+        const size_t  length = std::min(DeltaBlockSize, count - begin);
+        unsigned char width  = 0;
+        if (!internals_->Pop(&width, 1))
+        {
+            return;
+        }
+        if (width > 64)
+        {
+            internals_->failed_ = true;
+            return;
+        }
+
+        const auto bytes = (length * width + 7) / 8;
+        if (!internals_->Pop(packed, bytes))
+        {
+            return;
+        }
+        std::memset(packed + bytes, 0, 8);
+
+        unpack_bits(packed, length, width, values + begin);
+        for (size_t i = begin; i < begin + length; ++i)
+        {
+            delta += unzigzag(values[i]);
+            values[i] = values[i - 1] + delta;
+        }
+    }
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(unsigned char*& array, unsigned int& size)
+bool multi_process_stream::SkipDeltaValues()
 {
-    assert(
-        "pre: stream data must be of type unsigned char" &&
-        internals_->data_.front() == serializationInternals::uchar_value);
-    internals_->data_.pop_front();
-
-    if (array == nullptr)
+    const auto count   = PopDeltaCount();
+    uint64_t   ignored = 0;
+    if (internals_->failed_ || (count > 0 && !internals_->PopVarint(ignored)) ||
+        (count > 1 && !internals_->PopVarint(ignored)))
     {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
+        return false;
+    }
 
-        // Allocate the array
-        array = new unsigned char[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
+    for (size_t begin = 2; begin < count; begin += DeltaBlockSize)
+    {
+        const size_t  length = std::min(DeltaBlockSize, count - begin);
+        unsigned char width  = 0;
+        if (!internals_->Pop(&width, 1))
+        {
+            return false;
+        }
+        if (width > 64)
+        {
+            internals_->failed_ = true;
+            return false;
+        }
+        if (!internals_->Skip((length * width + 7) / 8))
+        {
+            return false;
+        }
     }
-    else
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool multi_process_stream::Skip(std::size_t count)
+{
+    using Types = serializationInternals::Types;
+
+    for (size_t i = 0; i < count; ++i)
     {
-        unsigned int sz;
+        if (internals_->failed_ || internals_->Empty())
+        {
+            internals_->failed_ = true;
+            return false;
+        }
 
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
-    }
+        // Every bit of a group is a value
+        if (internals_->readBits_ == 0 && internals_->Front() == Types::bits_value &&
+            !OpenBitGroup())
+        {
+            return false;
+        }
+        if (internals_->readBits_ > 0)
+        {
+            const auto bits  = std::min<uint64_t>(internals_->readBits_, count - i);
+            const auto shift = internals_->readShift_ + bits;
+            internals_->head_ += static_cast<size_t>(shift / 8);
+            internals_->readShift_ = static_cast<unsigned int>(shift % 8);
+            internals_->readBits_ -= bits;
+            if (internals_->readBits_ == 0 && internals_->readShift_ != 0)
+            {
+                ++internals_->head_;
+                internals_->readShift_ = 0;
+            }
+            i += static_cast<size_t>(bits) - 1;
+            continue;
+        }
 
-    // Pop the array data
-    internals_->Pop(array, size);
+        size_t width = 0;
+        switch (internals_->Front())
+        {
+        case Types::char_value:
+        case Types::uchar_value:
+            width = 1;
+            break;
+        case Types::int16_value:
+        case Types::uint16_value:
+            width = 2;
+            break;
+        case Types::int32_value:
+        case Types::uint32_value:
+        case Types::float_value:
+            width = 4;
+            break;
+        case Types::double_value:
+        case Types::int64_value:
+        case Types::uint64_value:
+            width = 8;
+            break;
+        case Types::size_value:
+            width = sizeof(size_t);
+            break;
+        case Types::string_value:
+        case Types::string_varint_value:
+        case Types::string_def_value:
+        case Types::string_ref_value:
+        {
+            std::string_view ignored;
+            if (!PopString(ignored))
+            {
+                return false;
+            }
+            continue;
+        }
+        case Types::delta_value:
+            if (!SkipDeltaValues())
+            {
+                return false;
+            }
+            continue;
+        case Types::length_value:
+        {
+            std::size_t ignored = 0;
+            if (!PopLength(ignored))
+            {
+                return false;
+            }
+            continue;
+        }
+        default:
+            internals_->failed_ = true;
+            return false;
+        }
+
+        ++internals_->head_;
+        if (!internals_->Skip(width))
+        {
+            return false;
+        }
+    }
+    return true;
 }
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(int64_t*& array, unsigned int& size)
+void multi_process_stream::PushLength(std::size_t length)
 {
-    assert(
-        "pre: stream data must be of type int64_t" &&
-        internals_->data_.front() == serializationInternals::int64_value);
-    internals_->data_.pop_front();
+    internals_->PushType(serializationInternals::length_value);
+    internals_->PushVarint(length);
+}
 
-    if (array == nullptr)
+//----------------------------------------------------------------------------
+bool multi_process_stream::PopLength(std::size_t& length)
+{
+    length = 0;
+    if (!internals_->failed_ && !internals_->Empty() &&
+        internals_->Front() == serializationInternals::uint32_value)
     {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
+        unsigned int legacy = 0;
+        *this >> legacy;
+        length = legacy;
+        return !internals_->failed_;
+    }
 
-        // Allocate the array
-        array = new int64_t[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
+    uint64_t value = 0;
+    if (!internals_->PopType(serializationInternals::length_value) ||
+        !internals_->PopVarint(value))
+    {
+        return false;
     }
-    else
+    if (value > std::numeric_limits<std::size_t>::max())
     {
-        unsigned int sz;
-
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
+        internals_->failed_ = true;
+        return false;
     }
+    length = static_cast<std::size_t>(value);
+    return true;
+}
 
-    // Pop the array data
-    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(int64_t) * size);
+//----------------------------------------------------------------------------
+std::size_t multi_process_stream::ReadPosition() const
+{
+    return internals_->head_;
 }
 
 //----------------------------------------------------------------------------
-//void multi_process_stream::Pop(uint64_t*& array, unsigned int& size)
-//{
-//    assert(
-//        "pre: stream data must be of type uint64_t" &&
-//        internals_->data_.front() == serializationInternals::uint64_value);
-//    internals_->data_.pop_front();
-//
-//    if (array == nullptr)
-//    {
-//        // Get the size of the array
-//        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
-//
-//        // Allocate the array
-//        array = new uint64_t[size];
-//        assert("ERROR: cannot allocate array" && (array != nullptr));
-//    }
-//    else
-//    {
-//        unsigned int sz;
-//
-//        // Get the size of the array
-//        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-//        assert("ERROR: input array size does not match size of data" && (sz == size));
-//    }
-//
-//    // Pop the array data
-//    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(uint64_t) * size);
-//}
+std::span<const unsigned char> multi_process_stream::ConsumedSince(std::size_t position) const
+{
+    assert("pre: position is ahead of the read position" && (position <= internals_->head_));
+    return {internals_->data_.data() + position, internals_->head_ - position};
+}
 
 //----------------------------------------------------------------------------
-void multi_process_stream::Pop(size_t*& array, unsigned int& size)
+multi_process_stream::ReadState multi_process_stream::SaveReadState() const
 {
+    return {
+        internals_->head_,
+        internals_->dictionary_.size(),
+        internals_->readBits_,
+        internals_->readShift_,
+        internals_->failed_};
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::RestoreReadState(const ReadState& state)
+{
+    assert("pre: state is ahead of the read position" && (state.position <= internals_->head_));
     assert(
-        "pre: stream data must be of type size_t" &&
-        internals_->data_.front() == serializationInternals::size_value);
-    internals_->data_.pop_front();
+        "pre: dictionary is smaller than saved" &&
+        (state.dictionary <= internals_->dictionary_.size()));
+    internals_->head_ = state.position;
+    internals_->dictionary_.resize(state.dictionary);
+    internals_->readBits_  = state.bits;
+    internals_->readShift_ = state.shift;
+    internals_->failed_    = state.failed;
+}
 
-    if (array == nullptr)
-    {
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&size), sizeof(unsigned int));
+//----------------------------------------------------------------------------
+void multi_process_stream::PushConsumed(std::span<const unsigned char> values)
+{
+    internals_->bitsStart_ = serializationInternals::npos;
+    internals_->Push(values.data(), values.size());
+}
 
-        // Allocate the array
-        array = new size_t[size];
-        assert("ERROR: cannot allocate array" && (array != nullptr));
-    }
-    else
-    {
-        unsigned int sz;
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(double*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::double_value);
+}
 
-        // Get the size of the array
-        internals_->Pop(reinterpret_cast<unsigned char*>(&sz), sizeof(unsigned int));
-        assert("ERROR: input array size does not match size of data" && (sz == size));
-    }
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(float*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::float_value);
+}
 
-    // Pop the array data
-    internals_->Pop(reinterpret_cast<unsigned char*>(array), sizeof(size_t) * size);
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(int*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::int32_value);
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(char*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::char_value);
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(unsigned int*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::uint32_value);
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(unsigned char*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::uchar_value);
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(int64_t*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::int64_value);
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::Pop(size_t*& array, std::size_t& size)
+{
+    PopArray(array, size, serializationInternals::size_value);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(double value)
 {
-    internals_->data_.push_back(serializationInternals::double_value);
+    internals_->PushType(serializationInternals::double_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(double));
     return (*this);
 }
@@ -427,7 +899,7 @@ multi_process_stream& multi_process_stream::operator<<(double value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(float value)
 {
-    internals_->data_.push_back(serializationInternals::float_value);
+    internals_->PushType(serializationInternals::float_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(float));
     return (*this);
 }
@@ -435,7 +907,7 @@ multi_process_stream& multi_process_stream::operator<<(float value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(int value)
 {
-    internals_->data_.push_back(serializationInternals::int32_value);
+    internals_->PushType(serializationInternals::int32_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(int));
     return (*this);
 }
@@ -443,15 +915,23 @@ multi_process_stream& multi_process_stream::operator<<(int value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(short value)
 {
-    internals_->data_.push_back(serializationInternals::int32_value);
+    internals_->PushType(serializationInternals::int16_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(short));
     return (*this);
 }
 
+//----------------------------------------------------------------------------
+multi_process_stream& multi_process_stream::operator<<(uint16_t value)
+{
+    internals_->PushType(serializationInternals::uint16_value);
+    internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(uint16_t));
+    return (*this);
+}
+
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(char value)
 {
-    internals_->data_.push_back(serializationInternals::char_value);
+    internals_->PushType(serializationInternals::char_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(char));
     return (*this);
 }
@@ -459,8 +939,13 @@ multi_process_stream& multi_process_stream::operator<<(char value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(bool value)
 {
+    if (internals_->packBits_)
+    {
+        PushBit(value);
+        return (*this);
+    }
     auto v = static_cast<char>(value);
-    internals_->data_.push_back(serializationInternals::char_value);
+    internals_->PushType(serializationInternals::char_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&v), sizeof(char));
     return (*this);
 }
@@ -468,7 +953,7 @@ multi_process_stream& multi_process_stream::operator<<(bool value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(unsigned int value)
 {
-    internals_->data_.push_back(serializationInternals::uint32_value);
+    internals_->PushType(serializationInternals::uint32_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(unsigned int));
     return (*this);
 }
@@ -476,7 +961,7 @@ multi_process_stream& multi_process_stream::operator<<(unsigned int value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(unsigned char value)
 {
-    internals_->data_.push_back(serializationInternals::uchar_value);
+    internals_->PushType(serializationInternals::uchar_value);
     internals_->Push(&value, sizeof(unsigned char));
     return (*this);
 }
@@ -484,7 +969,7 @@ multi_process_stream& multi_process_stream::operator<<(unsigned char value)
 //-----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(int64_t value)
 {
-    internals_->data_.push_back(serializationInternals::int64_value);
+    internals_->PushType(serializationInternals::int64_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(int64_t));
     return (*this);
 }
@@ -492,7 +977,7 @@ multi_process_stream& multi_process_stream::operator<<(int64_t value)
 //-----------------------------------------------------------------------------
 //multi_process_stream& multi_process_stream::operator<<(uint64_t value)
 //{
-//    internals_->data_.push_back(serializationInternals::uint64_value);
+//    internals_->PushType(serializationInternals::uint64_value);
 //    internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(uint64_t));
 //    return (*this);
 //}
@@ -500,7 +985,7 @@ multi_process_stream& multi_process_stream::operator<<(int64_t value)
 //-----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(size_t value)
 {
-    internals_->data_.push_back(serializationInternals::size_value);
+    internals_->PushType(serializationInternals::size_value);
     internals_->Push(reinterpret_cast<unsigned char*>(&value), sizeof(size_t));
     return (*this);
 }
@@ -515,68 +1000,151 @@ multi_process_stream& multi_process_stream::operator<<(const char* value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator<<(const std::string& value)
 {
-    // Find the real string size
-    auto size = static_cast<int>(value.size());
-
-    // Set the type
-    internals_->data_.push_back(serializationInternals::string_value);
+    PushString(value);
+    return (*this);
+}
 
-    // Set the string size
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(int));
+//----------------------------------------------------------------------------
+multi_process_stream& multi_process_stream::operator<<(const std::string_view& value)
+{
+    PushString(value);
+    return (*this);
+}
 
-    // Set the string content
-    for (int idx = 0; idx < size; idx++)
+//----------------------------------------------------------------------------
+void multi_process_stream::PushString(std::string_view value)
+{
+    auto& dictionary = internals_->dictionaryIndex_;
+    if (internals_->useDictionary_ && value.size() <= MaxDictionaryStringLength)
     {
-        internals_->Push(reinterpret_cast<const unsigned char*>(&value[idx]), sizeof(char));
+        if (auto it = dictionary.find(value); it != dictionary.end())
+        {
+            internals_->PushType(serializationInternals::string_ref_value);
+            internals_->PushVarint(it->second);
+            return;
+        }
+
+        if (dictionary.size() < MaxDictionaryEntries)
+        {
+            const auto index = static_cast<unsigned int>(dictionary.size());
+            dictionary.emplace(std::string(value), index);
+
+            internals_->PushType(serializationInternals::string_def_value);
+            internals_->PushVarint(value.size());
+            internals_->Push(reinterpret_cast<const unsigned char*>(value.data()), value.size());
+            return;
+        }
     }
-    return (*this);
+
+    internals_->PushType(serializationInternals::string_varint_value);
+    internals_->PushVarint(value.size());
+    internals_->Push(reinterpret_cast<const unsigned char*>(value.data()), value.size());
 }
 
 //----------------------------------------------------------------------------
-multi_process_stream& multi_process_stream::operator<<(const std::string_view& value)
+bool multi_process_stream::PopString(std::string_view& value)
 {
-    // Find the real string_view size
-    auto size = static_cast<int>(value.size());
+    value = {};
+    if (internals_->failed_ || internals_->Empty() || internals_->readBits_ != 0)
+    {
+        internals_->failed_ = true;
+        return false;
+    }
 
-    // Set the type
-    internals_->data_.push_back(serializationInternals::string_value);
+    const auto type = internals_->Front();
+    if (type == serializationInternals::string_ref_value)
+    {
+        ++internals_->head_;
+        uint64_t index = 0;
+        if (!internals_->PopVarint(index))
+        {
+            return false;
+        }
+        if (index >= internals_->dictionary_.size())
+        {
+            internals_->failed_ = true;
+            return false;
+        }
+        value = internals_->dictionary_[index];
+        return true;
+    }
 
-    // Set the string_view size
-    internals_->Push(reinterpret_cast<unsigned char*>(&size), sizeof(int));
+    uint64_t length = 0;
+    if (type == serializationInternals::string_def_value ||
+        type == serializationInternals::string_varint_value)
+    {
+        ++internals_->head_;
+        if (!internals_->PopVarint(length))
+        {
+            return false;
+        }
+    }
+    else
+    {
+        int stringSize = 0;
+        if (!internals_->PopType(serializationInternals::string_value) ||
+            !internals_->Pop(reinterpret_cast<unsigned char*>(&stringSize), sizeof(int)))
+        {
+            return false;
+        }
+        if (stringSize < 0)
+        {
+            internals_->failed_ = true;
+            return false;
+        }
+        length = static_cast<uint64_t>(stringSize);
+    }
 
-    // Set the string_view content
-    for (int idx = 0; idx < size; idx++)
+    if (length > internals_->Size())
     {
-        internals_->Push(reinterpret_cast<const unsigned char*>(&value[idx]), sizeof(char));
+        internals_->failed_ = true;
+        return false;
     }
-    return (*this);
+
+    // Plain strings are viewed in the stream's own buffer, which keeps popped
+    // bytes until the stream is written to, reset or assigned.
+    value = std::string_view(
+        reinterpret_cast<const char*>(internals_->data_.data() + internals_->head_),
+        static_cast<size_t>(length));
+    internals_->head_ += static_cast<size_t>(length);
+
+    if (type == serializationInternals::string_def_value)
+    {
+        value = internals_->dictionary_.emplace_back(value);
+    }
+    return true;
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(double& value)
 {
-    assert(internals_->data_.front() == serializationInternals::double_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(double));
+    value = {};
+    if (internals_->PopType(serializationInternals::double_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(double));
+    }
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(float& value)
 {
-    assert(internals_->data_.front() == serializationInternals::float_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(float));
+    value = {};
+    if (internals_->PopType(serializationInternals::float_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(float));
+    }
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(int& value)
 {
-    value = 0;
-    assert(internals_->data_.front() == serializationInternals::int32_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(int));
+    value = {};
+    if (internals_->PopType(serializationInternals::int32_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(int));
+    }
     return (*this);
 }
 
@@ -585,63 +1153,86 @@ multi_process_stream& multi_process_stream::operator>>(short& value)
 {
     // Automatically convert 64 bit values in case we are trying to transfer
     // int64_t with processes compiled with 32/64 values.
-    if (internals_->data_.front() == serializationInternals::int64_value)
+    if (!internals_->Empty() && internals_->Front() == serializationInternals::int64_value)
     {
         int64_t value64;
         (*this) >> value64;
         value = static_cast<short>(value64);
         return (*this);
     }
-    assert(internals_->data_.front() == serializationInternals::int32_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(short));
+    // Older streams wrote shorts with the int32 tag and two bytes; Skip() cannot
+    // step over those, but they still load.
+    const auto type =
+        !internals_->Empty() && internals_->Front() == serializationInternals::int32_value
+            ? serializationInternals::int32_value
+            : serializationInternals::int16_value;
+    value = {};
+    if (internals_->PopType(type))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(short));
+    }
+    return (*this);
+}
+
+//----------------------------------------------------------------------------
+multi_process_stream& multi_process_stream::operator>>(uint16_t& value)
+{
+    value = {};
+    if (internals_->PopType(serializationInternals::uint16_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(uint16_t));
+    }
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(char& value)
 {
-    assert(internals_->data_.front() == serializationInternals::char_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(char));
+    value = {};
+    if (internals_->PopType(serializationInternals::char_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(char));
+    }
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(bool& value)
 {
-    char v;
-    assert(internals_->data_.front() == serializationInternals::char_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&v), sizeof(char));
-    value = (v != 0);
+    value = PopBit();
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(unsigned int& value)
 {
-    assert(internals_->data_.front() == serializationInternals::uint32_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(unsigned int));
+    value = {};
+    if (internals_->PopType(serializationInternals::uint32_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(unsigned int));
+    }
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(unsigned char& value)
 {
-    assert(internals_->data_.front() == serializationInternals::uchar_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(unsigned char));
+    value = {};
+    if (internals_->PopType(serializationInternals::uchar_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(unsigned char));
+    }
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(int64_t& value)
 {
-    assert(internals_->data_.front() == serializationInternals::int64_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(int64_t));
+    value = {};
+    if (internals_->PopType(serializationInternals::int64_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(int64_t));
+    }
     return (*this);
 }
 
@@ -657,60 +1248,39 @@ multi_process_stream& multi_process_stream::operator>>(int64_t& value)
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(size_t& value)
 {
-    assert(internals_->data_.front() == serializationInternals::size_value);
-    internals_->data_.pop_front();
-    internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(size_t));
+    value = {};
+    if (internals_->PopType(serializationInternals::size_value))
+    {
+        internals_->Pop(reinterpret_cast<unsigned char*>(&value), sizeof(size_t));
+    }
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(std::string& value)
 {
-    value = "";
-    assert(internals_->data_.front() == serializationInternals::string_value);
-    internals_->data_.pop_front();
-    int stringSize;
-    internals_->Pop(reinterpret_cast<unsigned char*>(&stringSize), sizeof(int));
-    char c_value;
-    for (int idx = 0; idx < stringSize; idx++)
-    {
-        internals_->Pop(reinterpret_cast<unsigned char*>(&c_value), sizeof(char));
-        value += c_value;
-    }
+    std::string_view view;
+    PopString(view);
+    value.assign(view);
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 multi_process_stream& multi_process_stream::operator>>(std::string_view& value)
 {
-    assert(internals_->data_.front() == serializationInternals::string_value);
-    internals_->data_.pop_front();
-    int stringSize;
-    internals_->Pop(reinterpret_cast<unsigned char*>(&stringSize), sizeof(int));
-    char        c_value;
-    std::string val = " ";
-    for (int idx = 0; idx < stringSize; idx++)
-    {
-        internals_->Pop(reinterpret_cast<unsigned char*>(&c_value), sizeof(char));
-        val += c_value;
-    }
-
-    value = static_cast<std::string_view>(val);
-    value.remove_prefix(1);
+    PopString(value);
     return (*this);
 }
 
 //----------------------------------------------------------------------------
 std::vector<unsigned char> multi_process_stream::GetRawData()
 {
-    const unsigned int         size = Size() + 1;
-    std::vector<unsigned char> ret(size + 1);
-    int                        idx = 0;
-    for (auto iter = internals_->data_.begin(); iter != internals_->data_.end(); ++iter, ++idx)
-    {
-        ret[idx] = *iter;
-    }
-    ret[idx] = endianness_;
+    std::vector<unsigned char> ret;
+    ret.reserve(static_cast<size_t>(RawSize()));
+    ret.assign(
+        internals_->data_.begin() + static_cast<std::ptrdiff_t>(internals_->head_),
+        internals_->data_.end());
+    ret.push_back(endianness_);
 
     return ret;
 }
@@ -718,16 +1288,11 @@ std::vector<unsigned char> multi_process_stream::GetRawData()
 //----------------------------------------------------------------------------
 void multi_process_stream::SetRawData(const std::vector<unsigned char>& data)
 {
-    internals_->data_.clear();
+    internals_->Clear();
     if (!data.empty())
     {
         const auto endianness = data.back();
-        internals_->data_.resize(data.size() - 1);
-        int cc = 0;
-        for (; cc < static_cast<int>(data.size() - 1); cc++)
-        {
-            internals_->data_[cc] = data[cc];
-        }
+        internals_->data_.assign(data.begin(), data.end() - 1);
         if (endianness_ != endianness)
         {
             endianness_ = endianness;
@@ -735,6 +1300,31 @@ void multi_process_stream::SetRawData(const std::vector<unsigned char>& data)
     }
 }
 
+//----------------------------------------------------------------------------
+std::span<const unsigned char> multi_process_stream::UnreadData() const
+{
+    return {internals_->data_.data() + internals_->head_, internals_->Size()};
+}
+
+//----------------------------------------------------------------------------
+void multi_process_stream::SetRawData(
+    std::span<const unsigned char> data, unsigned char endianness)
+{
+    internals_->Clear();
+    internals_->data_.assign(data.begin(), data.end());
+    endianness_ = endianness;
+}
+
+//----------------------------------------------------------------------------
+std::span<unsigned char> multi_process_stream::PrepareRawData(
+    std::size_t size, unsigned char endianness)
+{
+    internals_->Clear();
+    internals_->data_.resize(size);
+    endianness_ = endianness;
+    return internals_->data_;
+}
+
 //----------------------------------------------------------------------------
 unsigned char multi_process_stream::endianness() const
 {
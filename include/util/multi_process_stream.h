@@ -15,17 +15,37 @@
 
 #pragma once
 
+#include <algorithm>
+#include <concepts>
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 #include <deque>
+#include <functional>
+#include <ranges>
+#include <span>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 #include "util/export.h"
 
 namespace serialization
 {
+/// @brief Element types accepted by the bulk array methods of multi_process_stream
+template <typename T>
+concept StreamArithmetic = std::is_arithmetic_v<T> && !std::same_as<T, bool> &&
+                           !std::same_as<T, long double> &&
+                           (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8);
+
+/// @brief Element types accepted by the delta-of-delta methods of multi_process_stream
+template <typename T>
+concept DeltaEncodable = std::integral<T> && !std::same_as<T, bool> && sizeof(T) <= 8;
+
+class size_profiler;
+
 class SERIALIZATION_API multi_process_stream
 {
 public:
@@ -42,6 +62,7 @@ public:
     multi_process_stream& operator<<(float value);
     multi_process_stream& operator<<(int value);
     multi_process_stream& operator<<(short value);
+    multi_process_stream& operator<<(uint16_t value);
     multi_process_stream& operator<<(char value);
     multi_process_stream& operator<<(bool value);
     multi_process_stream& operator<<(unsigned int value);
@@ -62,6 +83,7 @@ public:
     multi_process_stream& operator>>(float& value);
     multi_process_stream& operator>>(int& value);
     multi_process_stream& operator>>(short& value);
+    multi_process_stream& operator>>(uint16_t& value);
     multi_process_stream& operator>>(char& value);
     multi_process_stream& operator>>(bool& value);
     multi_process_stream& operator>>(unsigned int& value);
@@ -77,15 +99,14 @@ public:
     /**
      * Add-array-to-stream methods. Adds to the end of the stream
      */
-    void Push(const double* array, unsigned int size);
-    void Push(const float* array, unsigned int size);
-    void Push(const int* array, unsigned int size);
-    void Push(const char* array, unsigned int size);
-    void Push(const unsigned int* array, unsigned int size);
-    void Push(const unsigned char* array, unsigned int size);
-    void Push(const int64_t* array, unsigned int size);
-    //void Push(const uint64_t* array, unsigned int size);
-    void Push(const size_t* array, unsigned int size);
+    void Push(const double* array, std::size_t size);
+    void Push(const float* array, std::size_t size);
+    void Push(const int* array, std::size_t size);
+    void Push(const char* array, std::size_t size);
+    void Push(const unsigned int* array, std::size_t size);
+    void Push(const unsigned char* array, std::size_t size);
+    void Push(const int64_t* array, std::size_t size);
+    void Push(const size_t* array, std::size_t size);
     //@}
 
     //@{
@@ -95,16 +116,221 @@ public:
      * and the calling application is responsible for properly de-allocating it.
      * If the input array is not nullptr, it is expected to match the size of the
      * data internally, and this method would just fill in the data.
+     * Prefer PopVector/PopSpan, which never hand out owning raw pointers.
      */
-    void Pop(double*& array, unsigned int& size);
-    void Pop(float*& array, unsigned int& size);
-    void Pop(int*& array, unsigned int& size);
-    void Pop(char*& array, unsigned int& size);
-    void Pop(unsigned int*& array, unsigned int& size);
-    void Pop(unsigned char*& array, unsigned int& size);
-    void Pop(int64_t*& array, unsigned int& size);
-    //void Pop(uint64_t*& array, unsigned int& size);
-    void Pop(size_t*& array, unsigned int& size);
+    void Pop(double*& array, std::size_t& size);
+    void Pop(float*& array, std::size_t& size);
+    void Pop(int*& array, std::size_t& size);
+    void Pop(char*& array, std::size_t& size);
+    void Pop(unsigned int*& array, std::size_t& size);
+    void Pop(unsigned char*& array, std::size_t& size);
+    void Pop(int64_t*& array, std::size_t& size);
+    void Pop(size_t*& array, std::size_t& size);
+    //@}
+
+    //@{
+    /**
+     * Bulk array methods for every arithmetic type (int8_t to uint64_t, float,
+     * double). An array is stored as its type tag, element count and raw bytes,
+     * and is moved with a single block copy. The count is an unsigned int; arrays
+     * of 2^32 - 1 elements or more store that value followed by a 64-bit count.
+     * Arrays written by the Push overloads above can be read back with
+     * PopSpan/PopVector of the same element type.
+     *
+     * PopSpan requires the destination to have exactly the stored element count;
+     * on a mismatch the stream is marked as failed and false is returned.
+     */
+    template <std::ranges::contiguous_range Range>
+        requires StreamArithmetic<std::ranges::range_value_t<Range>>
+    void PushSpan(const Range& values)
+    {
+        using T = std::ranges::range_value_t<Range>;
+        PushBlock(TypeOf<T>(), std::ranges::data(values), std::ranges::size(values), sizeof(T));
+    }
+
+    template <std::ranges::contiguous_range Range>
+        requires StreamArithmetic<std::ranges::range_value_t<Range>> &&
+                 (!std::is_const_v<std::remove_reference_t<std::ranges::range_reference_t<Range>>>)
+    bool PopSpan(Range&& values)
+    {
+        using T           = std::ranges::range_value_t<Range>;
+        const auto stored = PopBlockSize(TypeOf<T>(), AlternativeTypeOf<T>(), sizeof(T));
+        if (HasError())
+        {
+            return false;
+        }
+        if (stored != std::ranges::size(values))
+        {
+            MarkFailed();
+            return false;
+        }
+        return PopBlockData(std::ranges::data(values), stored * sizeof(T));
+    }
+
+    template <StreamArithmetic T>
+    std::vector<T> PopVector()
+    {
+        std::vector<T> values(PopBlockSize(TypeOf<T>(), AlternativeTypeOf<T>(), sizeof(T)));
+        if (!PopBlockData(values.data(), values.size() * sizeof(T)))
+        {
+            values.clear();
+        }
+        return values;
+    }
+    //@}
+
+    //@{
+    /**
+     * Delta-of-delta encoding for integer sequences such as timestamps and
+     * sequence numbers. The count, first value and first delta are stored as
+     * varints; the zigzagged differences between consecutive deltas follow,
+     * bit-packed in blocks of DeltaBlockSize values at the width of each
+     * block's largest value. Evenly spaced values cost one byte per block.
+     * Arithmetic wraps, so any sequence round-trips exactly.
+     */
+    template <std::ranges::contiguous_range Range>
+        requires DeltaEncodable<std::ranges::range_value_t<Range>>
+    void PushDeltaEncoded(const Range& values)
+    {
+        using T = std::ranges::range_value_t<Range>;
+        if constexpr (sizeof(T) == sizeof(uint64_t))
+        {
+            PushDeltaValues(
+                reinterpret_cast<const uint64_t*>(std::ranges::data(values)),
+                std::ranges::size(values));
+        }
+        else
+        {
+            std::vector<uint64_t> wide(std::ranges::size(values));
+            std::ranges::transform(
+                values,
+                wide.begin(),
+                [](T value) { return static_cast<uint64_t>(static_cast<int64_t>(value)); });
+            PushDeltaValues(wide.data(), wide.size());
+        }
+    }
+
+    template <DeltaEncodable T>
+    std::vector<T> PopDeltaEncoded()
+    {
+        std::vector<T> values(PopDeltaCount());
+        if constexpr (sizeof(T) == sizeof(uint64_t))
+        {
+            PopDeltaValues(reinterpret_cast<uint64_t*>(values.data()), values.size());
+        }
+        else
+        {
+            std::vector<uint64_t> wide(values.size());
+            PopDeltaValues(wide.data(), wide.size());
+            std::ranges::transform(
+                wide, values.begin(), [](uint64_t value) { return static_cast<T>(value); });
+        }
+        if (HasError())
+        {
+            values.clear();
+        }
+        return values;
+    }
+
+    static constexpr size_t DeltaBlockSize = 128;
+    //@}
+
+    //@{
+    /**
+     * Bit groups. A run of consecutive bits is stored as one value: the
+     * bits_value tag, the bit count as a varint and the bits packed least
+     * significant first. PushBits() always packs; bools pushed with operator<<
+     * are packed only once EnableBitPacking() was called, and otherwise take a
+     * char value each. A lone bit is still written as a char value, so packing
+     * never makes an archive larger. EndBitGroup() ends the current run; save()
+     * calls it after every reflected object so that no group spans the end of
+     * one.
+     *
+     * Reading needs no setup: operator>>(bool) and PopBits() accept both forms,
+     * and Skip() counts every bit as one value. InBitGroup() is true while bits
+     * of a group read so far remain, so the read position is not a value
+     * boundary.
+     */
+    void EnableBitPacking(bool enable);
+    bool BitPackingEnabled() const;
+    void PushBits(uint64_t bits, unsigned int count);
+    uint64_t PopBits(unsigned int count);
+    void     EndBitGroup();
+    bool     InBitGroup() const;
+    //@}
+
+    //@{
+    /**
+     * Container sizes and other lengths, stored as a varint so that small ones
+     * take a single byte. PopLength() also accepts lengths written as unsigned
+     * int, as archives did before lengths were 64-bit.
+     */
+    void PushLength(std::size_t length);
+    bool PopLength(std::size_t& length);
+    //@}
+
+    /**
+     * Skips `count` values written by the add-to-stream operators or by
+     * PushDeltaEncoded() without decoding them. Dictionary definitions are
+     * still recorded so that later references resolve. Returns false and marks
+     * the stream as failed on malformed data.
+     */
+    bool Skip(std::size_t count = 1);
+
+    //@{
+    /**
+     * Read position, and a view of the bytes popped since an earlier read
+     * position. The view is valid until the stream is written to.
+     * PushConsumed() appends such bytes to another stream unchanged. They must hold
+     * complete values and no dictionary strings, which is the case when
+     * ReadDictionarySize() was 0 before and after they were popped.
+     */
+    std::size_t                    ReadPosition() const;
+    std::span<const unsigned char> ConsumedSince(std::size_t position) const;
+    void                           PushConsumed(std::span<const unsigned char> values);
+    //@}
+
+    //@{
+    /**
+     * Everything popping changes: the read position, the dictionary strings
+     * and the bit group read so far, and the error state. RestoreReadState()
+     * goes back to a saved state so that the values after it are read again;
+     * the stream must not have been written to in between.
+     */
+    struct ReadState
+    {
+        std::size_t  position   = 0;
+        std::size_t  dictionary = 0;
+        uint64_t     bits       = 0;
+        unsigned int shift      = 0;
+        bool         failed     = false;
+    };
+    ReadState SaveReadState() const;
+    void      RestoreReadState(const ReadState& state);
+    //@}
+
+    //@{
+    /**
+     * String dictionary. When enabled, the first occurrence of a string is
+     * written in full and assigned an index; later occurrences are written as
+     * that index (a varint), so repeated names, codes and class names cost 2-3
+     * bytes each. Strings longer than MaxDictionaryStringLength, or written
+     * once the dictionary holds MaxDictionaryEntries, are written in full.
+     *
+     * Reading needs no setup: dictionary entries are recognized from their
+     * tags. A string_view popped from a dictionary entry refers to the
+     * stream's copy, shared by every occurrence and valid until Reset() or
+     * SetRawData(). Reset() and SetRawData() also clear the dictionary; the
+     * setting itself is kept.
+     */
+    void EnableStringDictionary(bool enable);
+    bool StringDictionaryEnabled() const;
+
+    /// Number of dictionary strings popped (or skipped) so far
+    std::size_t ReadDictionarySize() const;
+
+    static constexpr size_t MaxDictionaryStringLength = 256;
+    static constexpr size_t MaxDictionaryEntries      = 1u << 20;
     //@}
 
     /**
@@ -115,19 +341,30 @@ public:
     /**
      * Returns the size of the stream.
      */
-    int Size();
+    std::size_t Size();
 
     /**
      * Returns the size of the raw data returned by GetRawData. This
      * includes 1 byte to store the endian type.
      */
-    int RawSize();
+    std::size_t RawSize();
 
     /**
      * Returns true iff the stream is empty.
      */
     bool Empty();
 
+    //@{
+    /**
+     * Error state. A pop that finds an unexpected type tag or runs past the end
+     * of the data marks the stream as failed; the value is zeroed and nothing
+     * more is consumed until the error is cleared. Reset() and SetRawData()
+     * also clear it.
+     */
+    bool HasError() const;
+    void ClearError();
+    //@}
+
     //@{
     /**
      * Serialization methods used to save/restore the stream to/from raw data.
@@ -137,14 +374,68 @@ public:
     void                       SetRawData(const std::vector<unsigned char>& data);
     //@}
 
+    //@{
+    /**
+     * Raw data without the endian byte. UnreadData() views the bytes not popped
+     * yet and is valid until the stream is written to; SetRawData() replaces the
+     * content with such bytes, written by a stream of the given endianness.
+     * PrepareRawData() replaces the content with size bytes for the caller to
+     * fill in place, for example straight from a socket; the storage is reused.
+     */
+    std::span<const unsigned char> UnreadData() const;
+    void SetRawData(std::span<const unsigned char> data, unsigned char endianness);
+    std::span<unsigned char> PrepareRawData(std::size_t size, unsigned char endianness);
+    //@}
+
     unsigned char endianness() const;
 
+    //@{
+    /**
+     * Size profiler told about the reflected objects, members and lengths that
+     * save() writes to this stream (see serialization_profile.h); null, the
+     * default, disables profiling. Copies of the stream do not inherit it.
+     */
+    void           SetSizeProfiler(size_profiler* profiler) { profiler_ = profiler; }
+    size_profiler* SizeProfiler() const { return profiler_; }
+    //@}
+
 private:
     class serializationInternals
     {
     public:
-        using DataType = std::deque<unsigned char>;
-        DataType data_;
+        // Bytes before head_ were already popped. They are dropped when the
+        // stream is written to again, so popping never moves memory.
+        using DataType = std::vector<unsigned char>;
+        DataType    data_;
+        std::size_t head_   = 0;
+        bool        failed_ = false;
+
+        struct StringHash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view value) const noexcept
+            {
+                return std::hash<std::string_view>{}(value);
+            }
+        };
+
+        // Writer side: index of every string written so far. Reader side:
+        // strings in definition order (a deque, so views into it stay valid).
+        bool useDictionary_ = false;
+        std::unordered_map<std::string, unsigned int, StringHash, std::equal_to<>>
+                                dictionaryIndex_;
+        std::deque<std::string> dictionary_;
+
+        // Writer side: position of the trailing bool value (a char value or a
+        // bit group) that the next bit extends, or npos. Reader side: bits
+        // left in the group being read, and the next bit's position in the
+        // byte at head_.
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+        bool                         packBits_  = false;
+        std::size_t                  bitsStart_ = npos;
+        uint64_t                     bitsCount_ = 0;
+        uint64_t                     readBits_  = 0;
+        unsigned int                 readShift_ = 0;
 
         enum Types
         {
@@ -157,32 +448,193 @@ private:
             string_value,
             int64_value,
             uint64_value,
-            size_value
+            size_value,
+            int16_value,
+            uint16_value,
+            string_def_value,
+            string_ref_value,
+            delta_value,
+            // Lengths are varints; string_value and uint32 sizes are still read
+            string_varint_value,
+            length_value,
+            bits_value
         };
 
+        std::size_t   Size() const { return data_.size() - head_; }
+        bool          Empty() const { return head_ == data_.size(); }
+        unsigned char Front() const { return data_[head_]; }
+
+        void Clear()
+        {
+            data_.clear();
+            head_   = 0;
+            failed_ = false;
+            dictionaryIndex_.clear();
+            dictionary_.clear();
+            bitsStart_ = npos;
+            readBits_  = 0;
+            readShift_ = 0;
+        }
+
+        void PushType(Types type)
+        {
+            Compact();
+            bitsStart_ = npos;
+            data_.push_back(static_cast<unsigned char>(type));
+        }
+
         void Push(const unsigned char* data, size_t length)
         {
-            for (size_t cc = 0; cc < length; cc++)
+            data_.insert(data_.end(), data, data + length);
+        }
+
+        bool PopType(Types type)
+        {
+            if (failed_ || Empty() || readBits_ != 0 || Front() != type)
             {
-                data_.push_back(data[cc]);
+                failed_ = true;
+                return false;
             }
+            ++head_;
+            return true;
         }
 
-        void Pop(unsigned char* data, size_t length)
+        void PushVarint(uint64_t value)
         {
-            if (!data_.empty())
+            while (value >= 0x80)
             {
-                for (size_t cc = 0; cc < length; cc++)
+                data_.push_back(static_cast<unsigned char>(value | 0x80));
+                value >>= 7;
+            }
+            data_.push_back(static_cast<unsigned char>(value));
+        }
+
+        bool PopVarint(uint64_t& value)
+        {
+            value = 0;
+            for (int shift = 0; shift < 64 && !failed_ && !Empty(); shift += 7)
+            {
+                const unsigned char byte = data_[head_++];
+                value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
                 {
-                    data[cc] = data_.front();
-                    data_.pop_front();
+                    return true;
                 }
             }
+            failed_ = true;
+            return false;
+        }
+
+        bool Skip(size_t length)
+        {
+            if (failed_ || Size() < length)
+            {
+                failed_ = true;
+                return false;
+            }
+            head_ += length;
+            return true;
+        }
+
+        bool Pop(unsigned char* data, size_t length)
+        {
+            if (failed_ || Size() < length)
+            {
+                failed_ = true;
+                return false;
+            }
+            if (length > 0)
+            {
+                std::memcpy(data, data_.data() + head_, length);
+            }
+            head_ += length;
+            return true;
+        }
+
+    private:
+        void Compact()
+        {
+            if (head_ == data_.size())
+            {
+                data_.clear();
+                head_ = 0;
+            }
+            else if (head_ > 4096 && head_ > data_.size() / 2)
+            {
+                data_.erase(data_.begin(), data_.begin() + static_cast<std::ptrdiff_t>(head_));
+                head_ = 0;
+            }
         }
     };
 
+    template <typename T>
+    void PopArray(T*& array, std::size_t& size, int type);
+
+    // Type tag of an array element; 8-byte unsigned integers other than size_t
+    // use uint64_value so that both stay readable on every data model.
+    template <typename T>
+    static constexpr int TypeOf()
+    {
+        using Types = serializationInternals::Types;
+        if constexpr (std::same_as<T, char>)
+        {
+            return Types::char_value;
+        }
+        else if constexpr (std::is_floating_point_v<T>)
+        {
+            return sizeof(T) == sizeof(double) ? Types::double_value : Types::float_value;
+        }
+        else if constexpr (std::is_signed_v<T>)
+        {
+            constexpr int tags[] = {
+                Types::char_value, Types::int16_value, 0, Types::int32_value, 0, 0, 0,
+                Types::int64_value};
+            return tags[sizeof(T) - 1];
+        }
+        else if constexpr (sizeof(T) == 8)
+        {
+            return std::same_as<T, size_t> ? Types::size_value : Types::uint64_value;
+        }
+        else
+        {
+            constexpr int tags[] = {
+                Types::uchar_value, Types::uint16_value, 0, Types::uint32_value};
+            return tags[sizeof(T) - 1];
+        }
+    }
+
+    // Tag also accepted when popping: size_t and uint64_t arrays have the same layout.
+    template <typename T>
+    static constexpr int AlternativeTypeOf()
+    {
+        using Types = serializationInternals::Types;
+        if constexpr (std::is_unsigned_v<T> && sizeof(T) == 8)
+        {
+            return TypeOf<T>() == Types::size_value ? Types::uint64_value : Types::size_value;
+        }
+        else
+        {
+            return TypeOf<T>();
+        }
+    }
+
+    void        PushString(std::string_view value);
+    bool        PopString(std::string_view& value);
+    void        PushBlock(int type, const void* data, std::size_t count, std::size_t element_size);
+    std::size_t PopBlockSize(int type, int alternative_type, std::size_t element_size);
+    bool        PopBlockData(void* data, std::size_t bytes);
+    void        MarkFailed();
+    void        PushDeltaValues(const uint64_t* values, std::size_t count);
+    std::size_t PopDeltaCount();
+    void        PopDeltaValues(uint64_t* values, std::size_t count);
+    bool        SkipDeltaValues();
+    void        PushBit(bool value);
+    bool        PopBit();
+    bool        OpenBitGroup();
+
     serializationInternals* internals_;
     unsigned char           endianness_;
+    size_profiler*          profiler_ = nullptr;
     enum
     {
         BigEndian,
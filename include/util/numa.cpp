@@ -0,0 +1,161 @@
+#include "util/numa.h"
+
+#include <array>
+#include <charconv>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <string_view>
+
+#if defined(__linux__)
+#include <linux/mempolicy.h>
+#include <sched.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace serialization
+{
+namespace
+{
+#if defined(__linux__)
+std::string read_file(const std::string& path)
+{
+    std::ifstream file(path);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+//----------------------------------------------------------------------------
+// Parses the kernel's list format, such as "0-3,8-11"; stops at anything else
+std::vector<int> parse_list(std::string_view text)
+{
+    std::vector<int> values;
+    const char*      it  = text.data();
+    const char*      end = it + text.size();
+    while (it != end)
+    {
+        int  first  = 0;
+        auto result = std::from_chars(it, end, first);
+        if (result.ec != std::errc{})
+        {
+            break;
+        }
+
+        int last = first;
+        if (result.ptr != end && *result.ptr == '-')
+        {
+            result = std::from_chars(result.ptr + 1, end, last);
+            if (result.ec != std::errc{} || last < first)
+            {
+                break;
+            }
+        }
+
+        for (int value = first; value <= last; ++value)
+        {
+            values.push_back(value);
+        }
+
+        it = result.ptr;
+        if (it == end || *it != ',')
+        {
+            break;
+        }
+        ++it;
+    }
+    return values;
+}
+#endif
+
+//----------------------------------------------------------------------------
+std::vector<numa_node> read_nodes()
+{
+    std::vector<numa_node> nodes;
+#if defined(__linux__)
+    const std::string root = "/sys/devices/system/node/";
+    for (const int id : parse_list(read_file(root + "online")))
+    {
+        nodes.push_back(
+            {id, parse_list(read_file(root + "node" + std::to_string(id) + "/cpulist"))});
+    }
+#endif
+    if (nodes.empty())
+    {
+        nodes.emplace_back();
+    }
+    return nodes;
+}
+}  // namespace
+
+//----------------------------------------------------------------------------
+const std::vector<numa_node>& numa_nodes()
+{
+    static const std::vector<numa_node> nodes = read_nodes();
+    return nodes;
+}
+
+//----------------------------------------------------------------------------
+bool bind_thread_to_numa_node(const numa_node& node) noexcept
+{
+#if defined(__linux__)
+    if (node.cpus.empty())
+    {
+        return false;
+    }
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (const int cpu : node.cpus)
+    {
+        if (cpu < CPU_SETSIZE)
+        {
+            CPU_SET(cpu, &set);
+        }
+    }
+    return sched_setaffinity(0, sizeof(set), &set) == 0;
+#else
+    (void)node;
+    return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool prefer_numa_node(void* data, std::size_t size, int node) noexcept
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    std::array<unsigned long, 16> mask{};
+    constexpr int                 bits_per_word = sizeof(unsigned long) * 8;
+    constexpr int                 max_nodes     = mask.size() * bits_per_word;
+    if (node < 0 || node >= max_nodes)
+    {
+        return false;
+    }
+
+    const auto page  = static_cast<std::uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto start = reinterpret_cast<std::uintptr_t>(data);
+    const auto begin = (start + page - 1) & ~(page - 1);
+    const auto end   = (start + size) & ~(page - 1);
+    if (end <= begin)
+    {
+        return true;
+    }
+
+    mask[node / bits_per_word] |= 1UL << (node % bits_per_word);
+    // The kernel reads maxnode - 1 bits of the mask
+    return syscall(
+               SYS_mbind,
+               begin,
+               end - begin,
+               MPOL_PREFERRED,
+               mask.data(),
+               max_nodes + 1,
+               MPOL_MF_MOVE) == 0;
+#else
+    (void)data;
+    (void)size;
+    (void)node;
+    return false;
+#endif
+}
+}  // namespace serialization
@@ -0,0 +1,61 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#pragma once
+
+/**
+ * @file numa.h
+ * @brief NUMA nodes of the host, thread pinning and page placement
+ *
+ * The topology is read once from /sys/devices/system/node. Hosts that are not
+ * Linux, or that have no NUMA support, report a single node; pinning to it and
+ * placing pages on it do nothing.
+ */
+
+#include <cstddef>
+#include <vector>
+
+#include "util/export.h"
+
+namespace serialization
+{
+/**
+ * @brief Memory node and the CPUs attached to it
+ */
+struct numa_node
+{
+    int              id = 0;
+    std::vector<int> cpus;  ///< Empty when the CPUs are not known
+};
+
+/// @brief Nodes of the host in id order, never empty
+SERIALIZATION_API const std::vector<numa_node>& numa_nodes();
+
+/**
+ * @brief Restrict the calling thread to the CPUs of a node
+ * @return False, leaving the thread unchanged, if that is not supported
+ */
+SERIALIZATION_API bool bind_thread_to_numa_node(const numa_node& node) noexcept;
+
+/**
+ * @brief Prefer a node for the pages that lie wholly inside [data, data + size)
+ *
+ * Pages touched later are allocated on the node while it has free memory;
+ * resident pages are moved there. Pages the range shares with other memory,
+ * such as neighbouring heap allocations, are left alone and stay where first
+ * touched.
+ * @return False if the policy could not be applied
+ */
+SERIALIZATION_API bool prefer_numa_node(void* data, std::size_t size, int node) noexcept;
+}  // namespace serialization
@@ -0,0 +1,575 @@
+#include "util/record_log.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <filesystem>
+#include <string_view>
+#include <system_error>
+
+#include "common/serialization_error.h"
+#include "util/crc32c.h"
+
+#if defined(_WIN32)
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace serialization
+{
+namespace
+{
+constexpr unsigned char magic[record_log_reader::HeaderSize] = {
+    'S', 'R', 'E', 'C', 'L', 'O', 'G', '1'};
+
+void store_le32(unsigned char* out, uint32_t value)
+{
+    for (int k = 0; k < 4; ++k)
+    {
+        out[k] = static_cast<unsigned char>(value >> (8 * k));
+    }
+}
+
+uint32_t load_le32(const unsigned char* in)
+{
+    return uint32_t{in[0]} | uint32_t{in[1]} << 8 | uint32_t{in[2]} << 16 |
+           uint32_t{in[3]} << 24;
+}
+
+void raise_io_error(std::string_view operation, const std::string& path)
+{
+    SERIALIZATION_THROW(
+        serialization_error::error_code::io_error,
+        "Record log {} failed for {}: {}",
+        operation,
+        path,
+        std::strerror(errno));
+}
+
+#if defined(_WIN32)
+int open_file(const std::string& path)
+{
+    return ::_open(path.c_str(), _O_RDWR | _O_CREAT | _O_BINARY, _S_IREAD | _S_IWRITE);
+}
+
+bool write_all(int fd, const unsigned char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const auto chunk   = static_cast<unsigned int>(std::min<std::size_t>(size, INT_MAX));
+        const int  written = ::_write(fd, data, chunk);
+        if (written < 0)
+        {
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool sync_file(int fd)
+{
+    return ::_commit(fd) == 0;
+}
+
+bool seek_end(int fd)
+{
+    return ::_lseeki64(fd, 0, SEEK_END) >= 0;
+}
+
+void close_file(int fd)
+{
+    ::_close(fd);
+}
+
+void sync_directory(const std::string& /*path*/) {}
+#else
+int open_file(const std::string& path)
+{
+    return ::open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+}
+
+bool write_all(int fd, const unsigned char* data, std::size_t size)
+{
+    while (size > 0)
+    {
+        const auto written = ::write(fd, data, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += written;
+        size -= static_cast<std::size_t>(written);
+    }
+    return true;
+}
+
+bool sync_file(int fd)
+{
+#if defined(__linux__)
+    return ::fdatasync(fd) == 0;
+#else
+    return ::fsync(fd) == 0;
+#endif
+}
+
+bool seek_end(int fd)
+{
+    return ::lseek(fd, 0, SEEK_END) >= 0;
+}
+
+void close_file(int fd)
+{
+    ::close(fd);
+}
+
+// Makes the directory entry of a newly created file durable
+void sync_directory(const std::string& path)
+{
+    auto directory = std::filesystem::path(path).parent_path();
+    if (directory.empty())
+    {
+        directory = ".";
+    }
+    const int fd = ::open(directory.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd >= 0)
+    {
+        ::fsync(fd);
+        ::close(fd);
+    }
+}
+#endif
+
+struct scan_result
+{
+    bool        is_log  = false;
+    std::size_t records = 0;
+    std::size_t valid   = 0;  ///< bytes up to the end of the last good frame
+    std::size_t size    = 0;
+};
+
+scan_result scan(const std::string& path)
+{
+    scan_result       result;
+    std::error_code   error;
+    const auto        size = std::filesystem::file_size(path, error);
+    record_log_reader reader(path, record_log_reader::mode::sequential);
+    if (error || !reader.IsOpen())
+    {
+        return result;
+    }
+
+    std::span<const unsigned char> record;
+    while (reader.Next(record))
+    {
+        ++result.records;
+    }
+    result.is_log = true;
+    result.valid  = reader.ValidSize();
+    result.size   = static_cast<std::size_t>(size);
+    return result;
+}
+
+// A file shorter than the header is a log whose creation was interrupted if
+// its bytes are a prefix of the header.
+bool is_partial_header(const std::string& path, std::size_t size)
+{
+    unsigned char header[record_log_reader::HeaderSize] = {};
+    std::FILE*    file                                  = std::fopen(path.c_str(), "rb");
+    if (file == nullptr)
+    {
+        return false;
+    }
+    const auto read = std::fread(header, 1, size, file);
+    std::fclose(file);
+    return read == size && std::memcmp(header, magic, size) == 0;
+}
+}  // namespace
+
+//----------------------------------------------------------------------------
+uint32_t record_checksum(std::span<const unsigned char> record) noexcept
+{
+    unsigned char length[4];
+    store_le32(length, static_cast<uint32_t>(record.size()));
+    return crc32c(record.data(), record.size(), crc32c(length, sizeof(length)));
+}
+
+//----------------------------------------------------------------------------
+record_log_writer::record_log_writer(const std::string& path, record_log_options options)
+    : path_(path), options_(options)
+{
+    std::error_code error;
+    const auto      existing =
+        std::filesystem::exists(path, error) ? std::filesystem::file_size(path, error) : 0;
+    if (error)
+    {
+        errno = error.value();
+        raise_io_error("open", path_);
+        return;
+    }
+
+    if (existing >= record_log_reader::HeaderSize)
+    {
+        const auto scanned = scan(path);
+        if (!scanned.is_log)
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "{} is not a record log",
+                path);
+            return;
+        }
+        records_   = scanned.records;
+        truncated_ = scanned.size - scanned.valid;
+    }
+    else if (existing > 0)
+    {
+        if (!is_partial_header(path, static_cast<std::size_t>(existing)))
+        {
+            SERIALIZATION_THROW(
+                serialization_error::error_code::malformed_input,
+                "{} is not a record log",
+                path);
+            return;
+        }
+        truncated_ = static_cast<std::size_t>(existing);
+    }
+
+    if (truncated_ > 0)
+    {
+        const auto valid = static_cast<std::uintmax_t>(existing) - truncated_;
+        std::filesystem::resize_file(path, valid, error);
+        if (error)
+        {
+            errno = error.value();
+            raise_io_error("recovery", path_);
+            return;
+        }
+    }
+
+    fd_ = open_file(path);
+    if (fd_ < 0 || !seek_end(fd_))
+    {
+        raise_io_error("open", path_);
+        return;
+    }
+
+    if (existing == truncated_)
+    {
+        if (!write_all(fd_, magic, sizeof(magic)) || !sync_file(fd_))
+        {
+            raise_io_error("write", path_);
+            return;
+        }
+        sync_directory(path);
+    }
+}
+
+//----------------------------------------------------------------------------
+record_log_writer::~record_log_writer()
+{
+    if (fd_ >= 0)
+    {
+        // Errors cannot be reported from here; call Sync() first to see them
+        if (WritePending() && unsyncedRecords_ > 0)
+        {
+            sync_file(fd_);
+        }
+        close_file(fd_);
+    }
+}
+
+//----------------------------------------------------------------------------
+void record_log_writer::Append(std::span<const unsigned char> record)
+{
+    if (!Writable())
+    {
+        return;
+    }
+
+    SERIALIZATION_CHECK(
+        record.size() <= record_log_reader::MaxRecordSize,
+        serialization_error::error_code::value_out_of_range,
+        "Record of {} bytes exceeds the maximum of {}",
+        record.size(),
+        record_log_reader::MaxRecordSize);
+
+    unsigned char header[record_log_reader::FrameHeaderSize];
+    store_le32(header, static_cast<uint32_t>(record.size()));
+    store_le32(header + 4, record_checksum(record));
+
+    pending_.insert(pending_.end(), header, header + sizeof(header));
+    pending_.insert(pending_.end(), record.begin(), record.end());
+    Appended(1, record.size());
+}
+
+//----------------------------------------------------------------------------
+void record_log_writer::AppendFrames(
+    std::span<const unsigned char> frames, std::size_t records, std::size_t payloadBytes)
+{
+    if (!Writable())
+    {
+        return;
+    }
+    pending_.insert(pending_.end(), frames.begin(), frames.end());
+    Appended(records, payloadBytes);
+}
+
+//----------------------------------------------------------------------------
+void record_log_writer::Appended(std::size_t records, std::size_t payloadBytes)
+{
+    records_ += records;
+    unsyncedRecords_ += records;
+    unsyncedBytes_ += payloadBytes;
+
+    if ((options_.sync_every_records > 0 && unsyncedRecords_ >= options_.sync_every_records) ||
+        (options_.sync_every_bytes > 0 && unsyncedBytes_ >= options_.sync_every_bytes))
+    {
+        Sync();
+    }
+    else if (pending_.size() >= options_.buffer_bytes)
+    {
+        Flush();
+    }
+}
+
+//----------------------------------------------------------------------------
+void record_log_writer::Append(multi_process_stream& stream)
+{
+    const auto data = stream.GetRawData();
+    Append(std::span<const unsigned char>(data));
+}
+
+//----------------------------------------------------------------------------
+bool record_log_writer::WritePending()
+{
+    if (pending_.empty())
+    {
+        return true;
+    }
+    const bool written = write_all(fd_, pending_.data(), pending_.size());
+    pending_.clear();
+    if (!written)
+    {
+        // Part of a frame may be in the file: appending after it would bury the
+        // records that follow behind a bad frame, so the writer stops here and
+        // the next open truncates the log back to its last good frame.
+        const int error = errno;
+        close_file(fd_);
+        fd_     = -1;
+        failed_ = true;
+        errno   = error;
+    }
+    return written;
+}
+
+//----------------------------------------------------------------------------
+bool record_log_writer::Writable() const
+{
+    if (failed_)
+    {
+        SERIALIZATION_THROW(
+            serialization_error::error_code::io_error,
+            "Record log {} is closed after a failed write",
+            path_);
+    }
+    return fd_ >= 0;
+}
+
+//----------------------------------------------------------------------------
+void record_log_writer::Flush()
+{
+    if (Writable() && !WritePending())
+    {
+        raise_io_error("write", path_);
+    }
+}
+
+//----------------------------------------------------------------------------
+void record_log_writer::Sync()
+{
+    if (!Writable())
+    {
+        return;
+    }
+    if (!WritePending() || !sync_file(fd_))
+    {
+        raise_io_error("sync", path_);
+        return;
+    }
+    unsyncedRecords_ = 0;
+    unsyncedBytes_   = 0;
+}
+
+//----------------------------------------------------------------------------
+record_log_reader::record_log_reader(const std::string& path, mode m) : mode_(m)
+{
+    std::error_code error;
+    const auto      size = std::filesystem::file_size(path, error);
+    if (error)
+    {
+        return;
+    }
+    size_ = static_cast<std::size_t>(size);
+
+#if !defined(_WIN32)
+    if (mode_ == mode::mapped && size_ > 0)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd >= 0)
+        {
+            void* mapping = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            ::close(fd);
+            if (mapping != MAP_FAILED)
+            {
+                ::madvise(mapping, size_, MADV_SEQUENTIAL);
+                data_   = static_cast<const unsigned char*>(mapping);
+                mapped_ = true;
+            }
+        }
+    }
+#endif
+
+    // Files that cannot be mapped are read sequentially
+    if (!mapped_)
+    {
+        mode_ = mode::sequential;
+        file_ = std::fopen(path.c_str(), "rb");
+        if (file_ == nullptr)
+        {
+            return;
+        }
+    }
+
+    const auto* header = Fetch(HeaderSize);
+    open_              = header != nullptr && std::memcmp(header, magic, HeaderSize) == 0;
+    offset_            = open_ ? HeaderSize : 0;
+}
+
+//----------------------------------------------------------------------------
+record_log_reader::~record_log_reader()
+{
+#if !defined(_WIN32)
+    if (mapped_)
+    {
+        ::munmap(const_cast<unsigned char*>(data_), size_);
+    }
+#endif
+    if (file_ != nullptr)
+    {
+        std::fclose(file_);
+    }
+}
+
+//----------------------------------------------------------------------------
+const unsigned char* record_log_reader::Fetch(std::size_t length)
+{
+    if (size_ - cursor_ < length)
+    {
+        return nullptr;
+    }
+
+    const unsigned char* bytes = nullptr;
+    if (mode_ == mode::mapped)
+    {
+        bytes = data_ + cursor_;
+    }
+    else
+    {
+        buffer_.resize(length);
+        if (std::fread(buffer_.data(), 1, length, file_) != length)
+        {
+            return nullptr;
+        }
+        bytes = buffer_.data();
+    }
+    cursor_ += length;
+    return bytes;
+}
+
+//----------------------------------------------------------------------------
+bool record_log_reader::Next(std::span<const unsigned char>& record)
+{
+    record = {};
+    if (!open_ || corrupt_ || offset_ == size_)
+    {
+        return false;
+    }
+
+    const auto* header = Fetch(FrameHeaderSize);
+    if (header == nullptr)
+    {
+        corrupt_ = true;
+        return false;
+    }
+
+    const uint32_t length   = load_le32(header);
+    const uint32_t checksum = load_le32(header + 4);
+    const uint32_t prefix   = crc32c(header, 4);
+    if (length > MaxRecordSize)
+    {
+        corrupt_ = true;
+        return false;
+    }
+
+    const auto* payload = Fetch(length);
+    if (payload == nullptr || crc32c(payload, length, prefix) != checksum)
+    {
+        corrupt_ = true;
+        return false;
+    }
+
+    record  = std::span<const unsigned char>(payload, length);
+    offset_ = cursor_;
+    return true;
+}
+
+//----------------------------------------------------------------------------
+bool record_log_reader::Next(multi_process_stream& stream)
+{
+    std::span<const unsigned char> record;
+    if (!Next(record))
+    {
+        return false;
+    }
+    if (record.empty())
+    {
+        stream.SetRawData(std::vector<unsigned char>());
+    }
+    else
+    {
+        // The last byte of a record is the writer's endianness
+        stream.SetRawData(record.first(record.size() - 1), record.back());
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------------
+std::size_t record_log_reader::Recover(const std::string& path)
+{
+    const auto scanned = scan(path);
+    if (scanned.is_log && scanned.valid < scanned.size)
+    {
+        std::error_code error;
+        std::filesystem::resize_file(path, scanned.valid, error);
+        if (error)
+        {
+            errno = error.value();
+            raise_io_error("recovery", path);
+        }
+    }
+    return scanned.records;
+}
+}  // namespace serialization
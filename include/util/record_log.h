@@ -0,0 +1,209 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file record_log.h
+ * @brief Crash-safe append-only log of binary records
+ *
+ * A record log is an 8-byte file header followed by frames:
+ *
+ * | Field    | Size | Content                                          |
+ * |----------|------|--------------------------------------------------|
+ * | length   | 4    | payload size, little endian                      |
+ * | checksum | 4    | crc32c of the length bytes and payload, LE       |
+ * | payload  | n    | record bytes, usually multi_process_stream data  |
+ *
+ * Appends cost O(record) and never rewrite earlier data. The writer batches
+ * frames in memory and syncs them to disk in groups (group commit), so a crash
+ * loses at most the records appended since the last sync. A crash in the middle
+ * of a write leaves a torn frame at the end; opening the log again truncates it
+ * at the first frame whose length or checksum does not match.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "util/export.h"
+#include "util/multi_process_stream.h"
+
+namespace serialization
+{
+/**
+ * @brief Durability settings of record_log_writer
+ */
+struct record_log_options
+{
+    /// Records appended between two syncs; 0 syncs only in Sync() and on close
+    std::size_t sync_every_records = 64;
+    /// Payload bytes appended between two syncs; 0 disables the byte limit
+    std::size_t sync_every_bytes = std::size_t{1} << 20;
+    /// Frames buffered in memory before they are written to the file
+    std::size_t buffer_bytes = std::size_t{64} << 10;
+};
+
+/**
+ * @brief Checksum stored in the frame of a record: crc32c of the little-endian
+ * length followed by the record bytes
+ */
+SERIALIZATION_API uint32_t record_checksum(std::span<const unsigned char> record) noexcept;
+
+/**
+ * @brief Appends checksummed records to a record log
+ *
+ * Opening an existing log recovers it first: everything from the first bad
+ * frame on is truncated, then new records are appended after the last good one.
+ */
+class SERIALIZATION_API record_log_writer
+{
+public:
+    explicit record_log_writer(const std::string& path, record_log_options options = {});
+    ~record_log_writer();
+
+    record_log_writer(const record_log_writer&)            = delete;
+    record_log_writer& operator=(const record_log_writer&) = delete;
+
+    //@{
+    /**
+     * Appends one record. The record is durable once the group it belongs to is
+     * synced, or after Sync().
+     */
+    void Append(std::span<const unsigned char> record);
+    void Append(multi_process_stream& stream);
+    //@}
+
+    /**
+     * Writes the buffered frames to the file without syncing them. A failed
+     * write closes the writer: every later Append, Flush or Sync raises io_error.
+     */
+    void Flush();
+
+    /**
+     * Writes the buffered frames and waits until they are on disk.
+     */
+    void Sync();
+
+    /**
+     * Returns the number of records in the log, including recovered ones.
+     */
+    std::size_t RecordCount() const { return records_; }
+
+    /**
+     * Returns the number of bytes dropped by recovery when the log was opened.
+     */
+    std::size_t TruncatedBytes() const { return truncated_; }
+
+private:
+    friend class concurrent_record_appender;
+
+    // Appends complete frames built by the caller
+    void AppendFrames(
+        std::span<const unsigned char> frames, std::size_t records, std::size_t payloadBytes);
+    void Appended(std::size_t records, std::size_t payloadBytes);
+    // Writes the buffered frames; after a failed write the writer is closed
+    bool WritePending();
+    // Raises io_error once a write failed; false if there is no file to write
+    bool Writable() const;
+
+    std::string                path_;
+    record_log_options         options_;
+    std::vector<unsigned char> pending_;
+    int                        fd_              = -1;
+    std::size_t                records_         = 0;
+    std::size_t                truncated_       = 0;
+    std::size_t                unsyncedRecords_ = 0;
+    std::size_t                unsyncedBytes_   = 0;
+    bool                       failed_          = false;
+};
+
+/**
+ * @brief Iterates the records of a record log
+ *
+ * The mapped mode maps the file into memory and hands out views of it; the
+ * sequential mode reads one frame at a time into a reused buffer, for logs
+ * larger than the address space or files that cannot be mapped. Iteration
+ * stops at the end of the file or at the first bad frame.
+ */
+class SERIALIZATION_API record_log_reader
+{
+public:
+    enum class mode
+    {
+        mapped,
+        sequential
+    };
+
+    explicit record_log_reader(const std::string& path, mode m = mode::mapped);
+    ~record_log_reader();
+
+    record_log_reader(const record_log_reader&)            = delete;
+    record_log_reader& operator=(const record_log_reader&) = delete;
+
+    /**
+     * Returns true if the file exists and starts with a record log header.
+     */
+    bool IsOpen() const { return open_; }
+
+    //@{
+    /**
+     * Moves to the next record. Returns false at the end of the log or at the
+     * first bad frame. A view stays valid until the next call in sequential
+     * mode, and for the lifetime of the reader in mapped mode. The stream
+     * overload replaces the stream's content with the record.
+     */
+    bool Next(std::span<const unsigned char>& record);
+    bool Next(multi_process_stream& stream);
+    //@}
+
+    /**
+     * Returns the file offset just past the last good frame read so far.
+     */
+    std::size_t ValidSize() const { return offset_; }
+
+    /**
+     * Returns true if iteration stopped at a bad frame rather than at the end.
+     */
+    bool Corrupt() const { return corrupt_; }
+
+    /**
+     * Truncates the log at its first bad frame and returns the number of good
+     * records. A missing file is left alone.
+     */
+    static std::size_t Recover(const std::string& path);
+
+    static constexpr std::size_t HeaderSize      = 8;
+    static constexpr std::size_t FrameHeaderSize = 8;
+    static constexpr std::size_t MaxRecordSize   = std::size_t{1} << 30;
+
+private:
+    const unsigned char* Fetch(std::size_t length);
+
+    mode                       mode_;
+    bool                       open_    = false;
+    bool                       corrupt_ = false;
+    bool                       mapped_  = false;
+    std::size_t                offset_  = 0;
+    std::size_t                cursor_  = 0;
+    std::size_t                size_    = 0;
+    const unsigned char*       data_    = nullptr;  ///< mapped mode
+    std::FILE*                 file_    = nullptr;  ///< sequential mode
+    std::vector<unsigned char> buffer_;
+};
+}  // namespace serialization
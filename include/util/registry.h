@@ -19,10 +19,13 @@ limitations under the License.
 static_assert(__cplusplus >= 202002L, "This header requires C++20 or later");
 
 #include <concepts>
+#include <cstdio>
+#include <cstdlib>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <shared_mutex>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -109,7 +112,7 @@ public:
         auto             it = registry_.find(key);
         if (it == registry_.end())
         {
-            throw std::out_of_range("Registry key not found: " + std::string(key));
+            key_not_found("Registry key not found: " + std::string(key));
         }
         return it->second(std::forward<Args>(args)...);
     }
@@ -124,7 +127,7 @@ public:
         auto             it = registry_.find(key);
         if (it == registry_.end())
         {
-            throw std::out_of_range("Registry key not found");
+            key_not_found("Registry key not found");
         }
         return it->second(arg1, arg2, args...);
     }
@@ -136,7 +139,7 @@ public:
         auto             it = registry_.find(key);
         if (it == registry_.end())
         {
-            throw std::out_of_range("Registry key not found");
+            key_not_found("Registry key not found");
         }
         return it->second(arg1, arg2, args...);
     }
@@ -193,6 +196,17 @@ public:
     Registry& operator=(Registry&&)      = delete;
 
 private:
+    // Throws std::out_of_range, or aborts when exceptions are disabled.
+    [[noreturn]] static void key_not_found(const std::string& message)
+    {
+#if SERIALIZATION_HAS_EXCEPTIONS
+        throw std::out_of_range(message);
+#else
+        std::fprintf(stderr, "%s\n", message.c_str());
+        std::abort();
+#endif
+    }
+
     std::unordered_map<KeyType, Function> registry_;
     mutable std::shared_mutex             mutex_;  // shared_mutex for read-write locking
 };
@@ -0,0 +1,79 @@
+/* Copyright 2018 The Serialization Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#pragma once
+
+/**
+ * @file simd_kernels.h
+ * @brief Variants of the vectorized kernels, selected at run time (library internal)
+ *
+ * Each kernel is defined next to the public function that uses it, once per
+ * instruction set; cpu_features.cpp gathers them into one table per
+ * simd_level. Every variant computes the same result.
+ */
+
+#include <cstddef>
+#include <cstdint>
+
+#include "util/cpu_features.h"
+#include "util/macros.h"
+
+namespace serialization::simd
+{
+struct kernel_table
+{
+    simd_level level;
+
+    /// CRC-32C of data, extending crc (pre- and post-inversion done by the caller)
+    uint32_t (*crc32c)(const unsigned char* data, std::size_t size, uint32_t crc) noexcept;
+
+    /// Encodes the whole 3-byte groups of data; returns the number of bytes consumed
+    std::size_t (*base64_encode)(const unsigned char* data, std::size_t size, char* out) noexcept;
+
+    /// Decodes whole 4-character quads without padding, stopping before the first
+    /// quad with a foreign character; returns the number of characters consumed
+    std::size_t (*base64_decode)(const char* text, std::size_t size, unsigned char* out) noexcept;
+
+    /// Index of the first '"', '\\' or control character, or size
+    std::size_t (*json_escape_position)(const char* data, std::size_t size) noexcept;
+
+    /// Length of the leading run of bytes below 0x80
+    std::size_t (*ascii_prefix)(const char* data, std::size_t size) noexcept;
+};
+
+/// @brief Kernels of the active level; selected on first use
+const kernel_table& kernels() noexcept;
+
+uint32_t    crc32c_scalar(const unsigned char* data, std::size_t size, uint32_t crc) noexcept;
+std::size_t base64_encode_scalar(const unsigned char* data, std::size_t size, char* out) noexcept;
+std::size_t base64_decode_scalar(const char* text, std::size_t size, unsigned char* out) noexcept;
+std::size_t json_escape_position_scalar(const char* data, std::size_t size) noexcept;
+std::size_t ascii_prefix_scalar(const char* data, std::size_t size) noexcept;
+
+#if defined(SERIALIZATION_ARCH_X86)
+uint32_t    crc32c_sse42(const unsigned char* data, std::size_t size, uint32_t crc) noexcept;
+std::size_t base64_encode_ssse3(const unsigned char* data, std::size_t size, char* out) noexcept;
+std::size_t base64_decode_ssse3(const char* text, std::size_t size, unsigned char* out) noexcept;
+std::size_t json_escape_position_sse2(const char* data, std::size_t size) noexcept;
+std::size_t json_escape_position_avx2(const char* data, std::size_t size) noexcept;
+std::size_t json_escape_position_avx512(const char* data, std::size_t size) noexcept;
+std::size_t ascii_prefix_sse2(const char* data, std::size_t size) noexcept;
+std::size_t ascii_prefix_avx2(const char* data, std::size_t size) noexcept;
+std::size_t ascii_prefix_avx512(const char* data, std::size_t size) noexcept;
+#elif defined(SERIALIZATION_ARCH_ARM64)
+std::size_t json_escape_position_neon(const char* data, std::size_t size) noexcept;
+std::size_t ascii_prefix_neon(const char* data, std::size_t size) noexcept;
+#endif
+}  // namespace serialization::simd